@@ -1,557 +0,0 @@
-/*
-
-FIR filter designed with
-http://t-filter.appspot.com
-
-sampling frequency: 44100 Hz
-
-* 0 Hz - 500 Hz
-  gain = 1
-  desired ripple = 5 dB
-  actual ripple = 4.091889307987946 dB
-
-* 1200 Hz - 22050 Hz
-  gain = 0
-  desired attenuation = -40 dB
-  actual attenuation = -40.170147334969705 dB
-
-*/
-
-#define FILTER_TAP_NUM_0_500Hz 81
-
-static double filter_taps_0_500Hz[FILTER_TAP_NUM_0_500Hz] = {
-  -0.004890735248927051,
-  0.00007112166403412495,
-  0.0001678169192126999,
-  0.00031953736935580424,
-  0.000555217579259967,
-  0.0008521391736440291,
-  0.0012166123151592916,
-  0.0016580987233847306,
-  0.0021738007716847825,
-  0.00276535571073482,
-  0.0034370749871104654,
-  0.004187464017578386,
-  0.005015525273241897,
-  0.005921632187414986,
-  0.006902606882671484,
-  0.007954703392736875,
-  0.009074903968081275,
-  0.010257746128060893,
-  0.0114968268477656,
-  0.012786080879297116,
-  0.014117605342658867,
-  0.01548242991263691,
-  0.016871746135544926,
-  0.01827542337142214,
-  0.01968241716844794,
-  0.021081967272485094,
-  0.022462606444714792,
-  0.023812342063520866,
-  0.025119780613768992,
-  0.026373453112206253,
-  0.027561799158577933,
-  0.028674178224000885,
-  0.029700407528196363,
-  0.030630584846840905,
-  0.03145599577351766,
-  0.032168829823459595,
-  0.03276188440526957,
-  0.033229381335729835,
-  0.03356683117741928,
-  0.03377062068226597,
-  0.03383871488825853,
-  0.03377062068226597,
-  0.03356683117741928,
-  0.033229381335729835,
-  0.03276188440526957,
-  0.032168829823459595,
-  0.03145599577351766,
-  0.030630584846840905,
-  0.029700407528196363,
-  0.028674178224000885,
-  0.027561799158577933,
-  0.026373453112206253,
-  0.025119780613768992,
-  0.023812342063520866,
-  0.022462606444714792,
-  0.021081967272485094,
-  0.01968241716844794,
-  0.01827542337142214,
-  0.016871746135544926,
-  0.01548242991263691,
-  0.014117605342658867,
-  0.012786080879297116,
-  0.0114968268477656,
-  0.010257746128060893,
-  0.009074903968081275,
-  0.007954703392736875,
-  0.006902606882671484,
-  0.005921632187414986,
-  0.005015525273241897,
-  0.004187464017578386,
-  0.0034370749871104654,
-  0.00276535571073482,
-  0.0021738007716847825,
-  0.0016580987233847306,
-  0.0012166123151592916,
-  0.0008521391736440291,
-  0.000555217579259967,
-  0.00031953736935580424,
-  0.0001678169192126999,
-  0.00007112166403412495,
-  -0.004890735248927051
-};
-
-    /*
-
-FIR filter designed with
-http://t-filter.appspot.com
-
-sampling frequency: 44100 Hz
-
-* 0 Hz - 2000 Hz
-  gain = 1
-  desired ripple = 5 dB
-  actual ripple = 3.9671035066680744 dB
-
-* 3000 Hz - 22050 Hz
-  gain = 0
-  desired attenuation = -40 dB
-  actual attenuation = -40.42974287164895 dB
-
-*/
-
-#define FILTER_TAP_NUM_0_2000Hz 53
-
-static float filter_taps_0_2000Hz[FILTER_TAP_NUM_0_2000Hz] = {
-  0.005945694186569448,
-  0.002379828947323354,
-  0.0021157432305207928,
-  0.0011745130003150968,
-  -0.0005631957619652723,
-  -0.0031412504544790464,
-  -0.0065113588095516185,
-  -0.010512173264898868,
-  -0.014869429938002722,
-  -0.019198295284960688,
-  -0.023024641766258406,
-  -0.025818710000432187,
-  -0.027044549728119927,
-  -0.026215662312378457,
-  -0.022943052792091728,
-  -0.016990416124932385,
-  -0.00830698992436266,
-  0.0029183796679326337,
-  0.016281758278071944,
-  0.031189132304646563,
-  0.04682879641017761,
-  0.062311546189196446,
-  0.07667651244026134,
-  0.08899875328967805,
-  0.09845687908522119,
-  0.10440599560183826,
-  0.106436233513719,
-  0.10440599560183826,
-  0.09845687908522119,
-  0.08899875328967805,
-  0.07667651244026134,
-  0.062311546189196446,
-  0.04682879641017761,
-  0.031189132304646563,
-  0.016281758278071944,
-  0.0029183796679326337,
-  -0.00830698992436266,
-  -0.016990416124932385,
-  -0.022943052792091728,
-  -0.026215662312378457,
-  -0.027044549728119927,
-  -0.025818710000432187,
-  -0.023024641766258406,
-  -0.019198295284960688,
-  -0.014869429938002722,
-  -0.010512173264898868,
-  -0.0065113588095516185,
-  -0.0031412504544790464,
-  -0.0005631957619652723,
-  0.0011745130003150968,
-  0.0021157432305207928,
-  0.002379828947323354,
-  0.005945694186569448
-};
-
-/*
-
-FIR filter designed with
-http://t-filter.appspot.com
-
-sampling frequency: 44100 Hz
-
-* 0 Hz - 4000 Hz
-  gain = 1
-  desired ripple = 5 dB
-  actual ripple = 4.100454355839725 dB
-
-* 5000 Hz - 22050 Hz
-  gain = 0
-  desired attenuation = -40 dB
-  actual attenuation = -40.152641364606424 dB
-
-*/
-
-#define FILTER_TAP_NUM_0_4000Hz 47
-
-static double filter_taps_0_4000Hz[FILTER_TAP_NUM_0_4000Hz] = {
-  -0.0008727044726103739,
-  -0.01222722360949031,
-  -0.017049359545169635,
-  -0.024561647065903323,
-  -0.02940625862995445,
-  -0.029605850555121944,
-  -0.02390299889912274,
-  -0.012672042825263161,
-  0.0017624643956482605,
-  0.01553458524844788,
-  0.02426127159545065,
-  0.02445106362213475,
-  0.014903438543490475,
-  -0.002409894571566791,
-  -0.02239106085371535,
-  -0.03790258377664552,
-  -0.04166930972506109,
-  -0.02849596513585312,
-  0.0028628376172771977,
-  0.04881937407956703,
-  0.10142948789789152,
-  0.15017535937155752,
-  0.18459040246207611,
-  0.19700027094257933,
-  0.18459040246207611,
-  0.15017535937155752,
-  0.10142948789789152,
-  0.04881937407956703,
-  0.0028628376172771977,
-  -0.02849596513585312,
-  -0.04166930972506109,
-  -0.03790258377664552,
-  -0.02239106085371535,
-  -0.002409894571566791,
-  0.014903438543490475,
-  0.02445106362213475,
-  0.02426127159545065,
-  0.01553458524844788,
-  0.0017624643956482605,
-  -0.012672042825263161,
-  -0.02390299889912274,
-  -0.029605850555121944,
-  -0.02940625862995445,
-  -0.024561647065903323,
-  -0.017049359545169635,
-  -0.01222722360949031,
-  -0.0008727044726103739
-};
-
-/*
-
-FIR filter designed with
-http://t-filter.appspot.com
-
-sampling frequency: 44100 Hz
-
-* 0 Hz - 1000 Hz
-  gain = 0
-  desired attenuation = -40 dB
-  actual attenuation = -41.98419042351646 dB
-
-* 2000 Hz - 3000 Hz
-  gain = 1
-  desired ripple = 5 dB
-  actual ripple = 3.252199073363484 dB
-
-* 4000 Hz - 22050 Hz
-  gain = 0
-  desired attenuation = -40 dB
-  actual attenuation = -41.98419042351646 dB
-
-*/
-
-#define FILTER_TAP_NUM_2000_3000Hz 55
-
-static float filter_taps_2000_3000Hz [FILTER_TAP_NUM_2000_3000Hz] = {
-  -0.006568774555223744,
-  -0.006020707345188602,
-  -0.0072294899408254865,
-  -0.007129205267594673,
-  -0.005171444334877757,
-  -0.0010791623513964964,
-  0.005030090854589312,
-  0.012506350789646351,
-  0.020237618843063635,
-  0.026742050546813056,
-  0.030427028320210107,
-  0.029892892145968054,
-  0.024258253533892316,
-  0.013448603897352003,
-  -0.0016640831891024826,
-  -0.01927231793858203,
-  -0.03684632037402725,
-  -0.0515079668807762,
-  -0.06051577837648661,
-  -0.061784942887213694,
-  -0.054323069607958234,
-  -0.038504066685061546,
-  -0.016103206803620786,
-  0.009919871636322014,
-  0.03586180909489194,
-  0.05787412189374392,
-  0.07260736653547516,
-  0.0777867103286387,
-  0.07260736653547516,
-  0.05787412189374392,
-  0.03586180909489194,
-  0.009919871636322014,
-  -0.016103206803620786,
-  -0.038504066685061546,
-  -0.054323069607958234,
-  -0.061784942887213694,
-  -0.06051577837648661,
-  -0.0515079668807762,
-  -0.03684632037402725,
-  -0.01927231793858203,
-  -0.0016640831891024826,
-  0.013448603897352003,
-  0.024258253533892316,
-  0.029892892145968054,
-  0.030427028320210107,
-  0.026742050546813056,
-  0.020237618843063635,
-  0.012506350789646351,
-  0.005030090854589312,
-  -0.0010791623513964964,
-  -0.005171444334877757,
-  -0.007129205267594673,
-  -0.0072294899408254865,
-  -0.006020707345188602,
-  -0.006568774555223744
-};
-
-
-/*
-FIR filter designed with
-http://t-filter.appspot.com
-
-sampling frequency: 44100 Hz
-
-* 0 Hz - 1000 Hz
-  gain = 0
-  desired attenuation = -40 dB
-  actual attenuation = -51.13184242748145 dB
-
-* 2000 Hz - 6000 Hz
-  gain = 1
-  desired ripple = 5 dB
-  actual ripple = 1.1390197814953331 dB
-
-* 7000 Hz - 22050 Hz
-  gain = 0
-  desired attenuation = -40 dB
-  actual attenuation = -51.13184242748145 dB
-
-*/
-
-#define FILTER_TAP_NUM_2000_6000Hz 81
-
-static float filter_taps_2000_6000Hz [FILTER_TAP_NUM_2000_6000Hz] = {
-  0.0026113114373257458,
-  0.003465012848518883,
-  0.005140416759022556,
-  0.004845711963148579,
-  0.0010305838749395046,
-  -0.005430890905234302,
-  -0.011387488130617874,
-  -0.013474326768919749,
-  -0.010456312821228778,
-  -0.004162329958901465,
-  0.0015126339810896696,
-  0.0030429303162812418,
-  -0.00020511637235202156,
-  -0.005125585604623583,
-  -0.0067175142605315884,
-  -0.001784711224120511,
-  0.008151422621772484,
-  0.017300197421695394,
-  0.019618943372791475,
-  0.01364247066762266,
-  0.004255785878715754,
-  -0.0004802083670954956,
-  0.004440363542729163,
-  0.016301094871441917,
-  0.025574344119433882,
-  0.02253016354676334,
-  0.005127629197385378,
-  -0.017949181542059673,
-  -0.03238099959972462,
-  -0.028778283793877323,
-  -0.011282130053185752,
-  0.002991840013479553,
-  -0.005002628251555666,
-  -0.04118761128974739,
-  -0.08988863160603658,
-  -0.11941613058167791,
-  -0.1001899999407781,
-  -0.024866749562824277,
-  0.08275208575501229,
-  0.1771486249692682,
-  0.21459060099158592,
-  0.1771486249692682,
-  0.08275208575501229,
-  -0.024866749562824277,
-  -0.1001899999407781,
-  -0.11941613058167791,
-  -0.08988863160603658,
-  -0.04118761128974739,
-  -0.005002628251555666,
-  0.002991840013479553,
-  -0.011282130053185752,
-  -0.028778283793877323,
-  -0.03238099959972462,
-  -0.017949181542059673,
-  0.005127629197385378,
-  0.02253016354676334,
-  0.025574344119433882,
-  0.016301094871441917,
-  0.004440363542729163,
-  -0.0004802083670954956,
-  0.004255785878715754,
-  0.01364247066762266,
-  0.019618943372791475,
-  0.017300197421695394,
-  0.008151422621772484,
-  -0.001784711224120511,
-  -0.0067175142605315884,
-  -0.005125585604623583,
-  -0.00020511637235202156,
-  0.0030429303162812418,
-  0.0015126339810896696,
-  -0.004162329958901465,
-  -0.010456312821228778,
-  -0.013474326768919749,
-  -0.011387488130617874,
-  -0.005430890905234302,
-  0.0010305838749395046,
-  0.004845711963148579,
-  0.005140416759022556,
-  0.003465012848518883,
-  0.0026113114373257458
-};
-
-/*
-
-FIR filter designed with
-http://t-filter.appspot.com
-
-sampling frequency: 44100 Hz
-
-* 0 Hz - 2000 Hz
-  gain = 0
-  desired attenuation = -40 dB
-  actual attenuation = -40.223707859738894 dB
-
-* 2500 Hz - 22050 Hz
-  gain = 1
-  desired ripple = 5 dB
-  actual ripple = 4.065803019738426 dB
-
-*/
-
-#define FILTER_TAP_NUM_2500_22050Hz 87
-
-static float filter_taps_2500_22050Hz[FILTER_TAP_NUM_2500_22050Hz] = {
-  0.08357898656038444,
-  -0.05331786657825686,
-  -0.03575738812766531,
-  -0.02173710159571825,
-  -0.01072945155339444,
-  -0.0023067785000014354,
-  0.0038764802354755478,
-  0.008100303260056962,
-  0.01068670402559714,
-  0.011909783985418374,
-  0.01183203187392473,
-  0.010466626690515473,
-  0.008133980025979478,
-  0.005203229002762171,
-  0.0014547115424293766,
-  -0.002255911817034105,
-  -0.006012707299457941,
-  -0.00928704685973434,
-  -0.011805091850849435,
-  -0.013226396233949805,
-  -0.013355585885170811,
-  -0.012055814321586844,
-  -0.00930280560436407,
-  -0.005250399550447491,
-  -0.00021527675994015538,
-  0.005411352960834699,
-  0.011105820660650734,
-  0.01618477165976971,
-  0.020143648441253076,
-  0.022282313748886635,
-  0.02217335055179564,
-  0.019402311814449156,
-  0.013824559068871927,
-  0.005425954766000047,
-  -0.0055303440845238866,
-  -0.018594122749727503,
-  -0.03312012394160332,
-  -0.04831835467229429,
-  -0.06329169350740824,
-  -0.07712492169989701,
-  -0.08896264316175367,
-  -0.09800230888614701,
-  -0.10369746232491274,
-  0.8943756181824286,
-  -0.10369746232491274,
-  -0.09800230888614701,
-  -0.08896264316175367,
-  -0.07712492169989701,
-  -0.06329169350740824,
-  -0.04831835467229429,
-  -0.03312012394160332,
-  -0.018594122749727503,
-  -0.0055303440845238866,
-  0.005425954766000047,
-  0.013824559068871927,
-  0.019402311814449156,
-  0.02217335055179564,
-  0.022282313748886635,
-  0.020143648441253076,
-  0.01618477165976971,
-  0.011105820660650734,
-  0.005411352960834699,
-  -0.00021527675994015538,
-  -0.005250399550447491,
-  -0.00930280560436407,
-  -0.012055814321586844,
-  -0.013355585885170811,
-  -0.013226396233949805,
-  -0.011805091850849435,
-  -0.00928704685973434,
-  -0.006012707299457941,
-  -0.002255911817034105,
-  0.0014547115424293766,
-  0.005203229002762171,
-  0.008133980025979478,
-  0.010466626690515473,
-  0.01183203187392473,
-  0.011909783985418374,
-  0.01068670402559714,
-  0.008100303260056962,
-  0.0038764802354755478,
-  -0.0023067785000014354,
-  -0.01072945155339444,
-  -0.02173710159571825,
-  -0.03575738812766531,
-  -0.05331786657825686,
-  0.08357898656038444
-};
@@ -1,40 +1,24 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <errno.h>
 #include <poll.h>
-#include <alsa/asoundlib.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <algorithm>
 
-#include <stk/Noise.h>
-#include <stk/Iir.h>
-#include <stk/Echo.h>
-#include <stk/PitShift.h>
-#include <stk/PRCRev.h>
-#include <stk/Guitar.h>
-#include <stk/ADSR.h>
-#include <stk/Cubic.h>
-#include <stk/BiQuad.h>
-#include <stk/Modulate.h>
-#include <stk/SineWave.h>
-
-#include "Filter_taps.h"
-
-#define PLAYBACK_DEVICE "default"
-#define CAPTURE_DEVICE "default"
+#include "MySynth.h"
+#include "rt_alloc_guard.h"
+#include "control.h"
+#include "telemetry.h"
+#include "recovery.h"
+#include "pipeline.h"
+#include "effect_chain.h"
+#include "backend.h"
 
 #define PCM_DEVICE "default"
-#define BUF_SIZE 2048
-
-#define DEBUG
-
-#ifdef DEBUG
-#define D(fmt, args...) fprintf(stderr, fmt, ##args)
-#else
-#define D(fmt, args...)
-#endif
 
 using namespace stk;
 
@@ -42,20 +26,6 @@ using namespace stk;
 snd_pcm_t *capture_handle;
 snd_pcm_t *playback_handle;
 
-enum MySynthEffect { 
-	no_effect,
-	filter_0_500Hz,
-	filter_0_2000Hz,
-	filter_0_4000Hz,
-	filter_2000_3000Hz,
-	filter_2000_6000Hz,
-	filter_2500_22050Hz,	
-	echo,	
-	modulator,
-	distortion,
-	effect_max
- };
-
 const char *effect_str[] = {
 	"no_effect",
 	"filter_0_500Hz",
@@ -67,138 +37,167 @@ const char *effect_str[] = {
 	"echo",	
 	"modulator",
 	"distortion",
+	"convolution",
+	"custom_chain",
 };
 
-struct audio_stream {
-	snd_pcm_hw_params_t *hw_playback_params;
-	snd_pcm_sw_params_t *sw_playback_params;
-	snd_pcm_hw_params_t *hw_capture_params;
-	snd_pcm_sw_params_t *sw_capture_params;
-	unsigned int sample_rate;
-
-	void *buffer;
-	snd_pcm_uframes_t frame_size;
-	unsigned int buffer_size;
-	snd_pcm_format_t format;
-	int channels;
-
-	MySynthEffect current_effect = no_effect;
-
-	//filters
-	stk::Fir filter_0_500Hz;
-	stk::Fir filter_0_2000Hz;
-	stk::Fir filter_0_4000Hz;
-	stk::Fir filter_2000_3000Hz;
-	stk::Fir filter_2000_6000Hz;
-	stk::Fir filter_2500_22050Hz;
-
-	//delay effects
-	stk::Echo echo;
-
-	//modulators
-	stk::SineWave modulator;
-
-	//non linear functions
-	stk::Cubic distortion;	
-};
+// run one effect in place on frames
+static inline void run_effect(struct processing_context *ctx, MySynthEffect effect,
+			      stk::StkFrames &frames)
+{
+	effect_chain_process(ctx->chains[effect], frames);
+}
 
-void applyEffect(struct audio_stream *stream)
+/* Switch to effect without a click.  The incoming effect is cleared and
+ * then runs alongside the outgoing one: first for warmup[effect] samples
+ * while only the old output is heard, so its delay line fills with the
+ * live signal, then for fade_length samples of linear crossfade.
+ */
+void switch_effect(struct audio_stream *stream, MySynthEffect effect)
 {
-	short *buf = (short *)stream->buffer;
-	Stk::setSampleRate( 44100.0 );
+	struct processing_context *ctx = stream->ctx;
 
-	//init StkFrames and convert buf to fit in range -1.0 to 1.0
-	stk::StkFrames output(stream->frame_size, 1 );
-	for (int i=0; i < stream->frame_size; i++){
-		output[i] = static_cast<double>(buf[i])/0x8000;		
+	if (effect == stream->current_effect)
+		return;
+
+	if (ctx->fade_length == 0) {
+		stream->current_effect = effect;
+		return;
 	}
 
-	switch(stream->current_effect)
-	{
-		case no_effect : {
-			break;
-		}
-		case filter_0_500Hz : {
-			stream->filter_0_500Hz.tick(output);
-			break;
-		}
-		case filter_0_2000Hz : {
-			stream->filter_0_2000Hz.tick(output);
-			break;
-		}
-		case filter_0_4000Hz : {
-			stream->filter_0_4000Hz.tick(output);
-			break;
-		}
-		case filter_2000_3000Hz : {
-			stream->filter_2000_3000Hz.tick(output);
-			break;
-		}		
-		case filter_2000_6000Hz : {
-			stream->filter_2000_6000Hz.tick(output);
-			break;
-		}
-		case filter_2500_22050Hz : {
-			stream->filter_2500_22050Hz.tick(output);
-			break;
-		}
-		case echo : {
-			stream->echo.tick(output);
-			break;
-		}
-		case modulator : {
-			stk::StkFrames mod_output(stream->frame_size, 1 );				
-			stream->modulator.tick(mod_output);
-			for (int i=0; i < stream->frame_size; i++){
-				output[i] = output[i]*mod_output[i]*0.5;		
-			}
-			break;
-		}
-		case distortion : {
-			stream->distortion.tick(output);
-			break;
-		}	
-	}	
+	// drop state left over from the last time effect ran
+	effect_chain_clear(ctx->chains[effect]);
+	ctx->fade_from = stream->current_effect;
+	ctx->fade_pos = 0;
+	ctx->fade_warm = ctx->chains[effect]->warmup;
+	ctx->fade_active = 1;
+	stream->current_effect = effect;
+}
 
-	// fill buffer with filtered values	
-	for (int i=0; i < stream->frame_size; i++){			
-		buf[i]=static_cast<short>(output[i]*0x8000);
-	}
+int effect_switching(struct audio_stream *stream)
+{
+	return stream->ctx->fade_active;
+}
 
+/* Blend the incoming effect (in) into the outgoing one (out) for the next
+ * n samples of the transition.  The ramp loop has no dependencies between
+ * iterations, so the compiler vectorizes it.
+ */
+static void crossfade(struct processing_context *ctx, StkFloat *__restrict out,
+		      const StkFloat *__restrict in, unsigned long n)
+{
+	unsigned long fade_end = ctx->fade_warm + ctx->fade_length;
+	unsigned long i = 0;
+	unsigned long k, count;
+	StkFloat step = 1.0 / ctx->fade_length;
+	StkFloat gain;
+
+	// warm-up: the old output stands
+	if (ctx->fade_pos < ctx->fade_warm) {
+		count = std::min(n, ctx->fade_warm - ctx->fade_pos);
+		i += count;
+		ctx->fade_pos += count;
+	}
+
+	// ramp
+	count = std::min(n - i, fade_end - ctx->fade_pos);
+	gain = (ctx->fade_pos - ctx->fade_warm) * step;
+	for (k = 0; k < count; k++)
+		out[i + k] += (gain + k * step) * (in[i + k] - out[i + k]);
+	i += count;
+	ctx->fade_pos += count;
+
+	// past the end of the fade only the new effect is heard
+	for (; i < n; i++)
+		out[i] = in[i];
+
+	if (ctx->fade_pos >= fade_end)
+		ctx->fade_active = 0;
 }
 
-int playback_callback(snd_pcm_sframes_t nframes, short buf[]) {
-	int err;
+/* Process nframes (at most frame_size) from in to out.  in and out may be
+ * the same buffer (readi/writei path) or two DMA areas (mmap path).
+ * During an effect switch both effects run, so the cost is bounded at
+ * twice a single effect and only for the length of the transition.
+ */
+void applyEffect(struct audio_stream *stream, const short *in, short *out,
+		 snd_pcm_uframes_t nframes)
+{
+	struct processing_context *ctx = stream->ctx;
+	// views of the first nframes of the work buffers, nothing is allocated
+	stk::StkFramesView output(ctx->output, 0, nframes);
 
-	//printf("playback callback called with %lu frames\n", nframes);
+	//convert in to fit in range -1.0 to 1.0
+	stk::convertFromInt16(in, &output[0], nframes);
 
-	err = snd_pcm_writei(playback_handle, buf, nframes);
-	if (err < 0) {
-		fprintf(stderr, "write failed (%s)\n", snd_strerror(err));
+	if (ctx->fade_active) {
+		stk::StkFramesView incoming(ctx->fade_input, 0, nframes);
+
+		for (snd_pcm_uframes_t i = 0; i < nframes; i++)
+			incoming[i] = output[i];
+
+		run_effect(ctx, ctx->fade_from, output);
+		run_effect(ctx, stream->current_effect, incoming);
+		crossfade(ctx, &output[0], &incoming[0], nframes);
+	} else {
+		run_effect(ctx, stream->current_effect, output);
 	}
 
-	return err;
+	// fill out with filtered values, clipped to the int16 range
+	stk::convertToInt16(&output[0], out, nframes,
+			    stream->dither ? &ctx->dither : NULL);
 }
 
-int capture_callback(snd_pcm_sframes_t nframes, short buf[]) {
-
-	int err;
+/* A blocking transfer only comes back short when a signal or an xrun cut
+ * it off.  The rest of the period is moved with another call, an xrun then
+ * shows up as its error.
+ */
+int playback_callback(snd_pcm_sframes_t nframes, short buf[]) {
+	snd_pcm_sframes_t done = 0;
+	snd_pcm_sframes_t err;
+
+	while (done < nframes) {
+		err = snd_pcm_writei(playback_handle,
+				     (char *)buf + snd_pcm_frames_to_bytes(playback_handle, done),
+				     nframes - done);
+		if (err < 0) {
+			fprintf(stderr, "write failed (%s)\n", snd_strerror(err));
+			return err;
+		}
+		done += err;
+	}
 
-	//printf("capture callback called with %lu frames\n", nframes);
+	return done;
+}
 
-	/* ... fill buf with data ... */
-	err = snd_pcm_readi(capture_handle, buf, nframes);
-	if (err != nframes)	{
-		fprintf(stderr, "read failed (%s)\n", snd_strerror(err));
+int capture_callback(snd_pcm_sframes_t nframes, short buf[]) {
+	snd_pcm_sframes_t done = 0;
+	snd_pcm_sframes_t err;
+
+	while (done < nframes) {
+		err = snd_pcm_readi(capture_handle,
+				    (char *)buf + snd_pcm_frames_to_bytes(capture_handle, done),
+				    nframes - done);
+		if (err < 0) {
+			fprintf(stderr, "read failed (%s)\n", snd_strerror(err));
+			return err;
+		}
+		done += err;
 	}
 
-	return err;
+	return done;
 }
 
-int open_and_init(struct audio_stream *stream)
+static void open_alsa(struct audio_stream *stream)
 {
 	int err;
 	snd_pcm_uframes_t val;
+	snd_pcm_uframes_t boundary;
+	unsigned int periods;
+	snd_pcm_access_t access = SND_PCM_ACCESS_RW_INTERLEAVED;
+
+	if (stream->io_mode == IO_MMAP)
+		access = SND_PCM_ACCESS_MMAP_INTERLEAVED;
 
 	// open playback device
 	err = snd_pcm_open(&playback_handle, PLAYBACK_DEVICE, SND_PCM_STREAM_PLAYBACK, 0);
@@ -248,14 +247,14 @@ int open_and_init(struct audio_stream *stream)
 	}
 
 	//set access type
-	err = snd_pcm_hw_params_set_access(playback_handle, stream->hw_playback_params, SND_PCM_ACCESS_RW_INTERLEAVED);
+	err = snd_pcm_hw_params_set_access(playback_handle, stream->hw_playback_params, access);
 	if (err < 0) {
 		fprintf(stderr, "cannot set access type (%s)\n",
 				snd_strerror(err));
 		exit(1);
 	}
 
-	err = snd_pcm_hw_params_set_access(capture_handle, stream->hw_capture_params, SND_PCM_ACCESS_RW_INTERLEAVED);
+	err = snd_pcm_hw_params_set_access(capture_handle, stream->hw_capture_params, access);
 	if (err < 0) {
 		fprintf(stderr, "cannot set access type (%s)\n",
 				snd_strerror(err));
@@ -307,6 +306,20 @@ int open_and_init(struct audio_stream *stream)
 		exit(1);
 	}
 
+	/* mmap mode keeps the playback ring to the primed periods plus the
+	 * one being written, so the round trip latency is fixed.  The pipeline
+	 * primes one period more for the one being captured.
+	 */
+	if (stream->io_mode != IO_RW) {
+		periods = stream->latency_periods + (stream->io_mode == IO_MMAP ? 1 : 2);
+		err = snd_pcm_hw_params_set_periods_near(playback_handle, stream->hw_playback_params, &periods, NULL);
+		if (err < 0) {
+			fprintf(stderr, "cannot set playback period count (%s)\n",
+					snd_strerror(err));
+			exit(1);
+		}
+	}
+
 	// set parameters
 	err = snd_pcm_hw_params(playback_handle, stream->hw_playback_params);
 	if (err < 0) {
@@ -315,6 +328,18 @@ int open_and_init(struct audio_stream *stream)
 		exit(1);
 	}
 
+	snd_pcm_hw_params_get_period_size(stream->hw_playback_params, &val, NULL);
+
+	// mmap and pipeline move one period in lockstep, both sides must agree
+	if (stream->io_mode != IO_RW) {
+		err = snd_pcm_hw_params_set_period_size_near(capture_handle, stream->hw_capture_params, &val, NULL);
+		if (err < 0) {
+			fprintf(stderr, "cannot set capture period size (%s)\n",
+					snd_strerror(err));
+			exit(1);
+		}
+	}
+
 	err = snd_pcm_hw_params(capture_handle, stream->hw_capture_params);
 	if (err < 0) {
 		fprintf(stderr, "cannot set parameters (%s)\n",
@@ -322,6 +347,17 @@ int open_and_init(struct audio_stream *stream)
 		exit(1);
 	}
 
+	if (stream->io_mode != IO_RW) {
+		snd_pcm_uframes_t capture_period;
+
+		snd_pcm_hw_params_get_period_size(stream->hw_capture_params, &capture_period, NULL);
+		if (capture_period != val) {
+			fprintf(stderr, "capture period %lu does not match playback period %lu\n",
+					capture_period, val);
+			exit(1);
+		}
+	}
+
 	//free params
 	snd_pcm_hw_params_free(stream->hw_playback_params);
 	snd_pcm_hw_params_free(stream->hw_capture_params);
@@ -345,8 +381,6 @@ int open_and_init(struct audio_stream *stream)
 		exit(1);
 	}
 
-	snd_pcm_hw_params_get_period_size(stream->hw_playback_params, &val, NULL);
-
 	fprintf(stderr, "period_size: %lu\n", val);
 
 	stream->frame_size = val;
@@ -369,9 +403,17 @@ int open_and_init(struct audio_stream *stream)
 		exit(1);
 	}
 
-	//playback device will start to play when 2*BUF_SIZE of frames is available in its internal buffer
+	//playback device will start to play when RW_START_PERIODS periods are queued
 	//increase the latency, but be sure that underflow will not happpen.
-	err = snd_pcm_sw_params_set_start_threshold(playback_handle, stream->sw_playback_params, stream->frame_size * 3);
+	//xrun_recover() moves it with the latency after an xrun.
+	//mmap and pipeline modes start playback themselves after priming it
+	if (stream->io_mode != IO_RW) {
+		snd_pcm_sw_params_get_boundary(stream->sw_playback_params, &boundary);
+		val = boundary;
+	} else {
+		val = stream->frame_size * RW_START_PERIODS;
+	}
+	err = snd_pcm_sw_params_set_start_threshold(playback_handle, stream->sw_playback_params, val);
 	if (err < 0) {
 		fprintf(stderr, "cannot set start mode (%s)\n",
 				snd_strerror(err));
@@ -403,165 +445,340 @@ int open_and_init(struct audio_stream *stream)
 		exit(1);
 	}
 
-	//configure effect classes
-	//filters
-	std::vector<StkFloat> v1(std::begin(filter_taps_0_500Hz), std::end(filter_taps_0_500Hz));	
-	stream->filter_0_500Hz.setCoefficients(v1);
-
-	std::vector<StkFloat> v2(std::begin(filter_taps_0_2000Hz), std::end(filter_taps_0_2000Hz));	
-	stream->filter_0_2000Hz.setCoefficients(v2);	
-
-	std::vector<StkFloat> v3(std::begin(filter_taps_0_4000Hz), std::end(filter_taps_0_4000Hz));	
-	stream->filter_0_4000Hz.setCoefficients(v3);	
+	/* linked handles start, stop and prepare together, so capture and
+	 * playback share one time base.  Cards on different clocks cannot be
+	 * linked; mmap_start() then starts them back to back.
+	 */
+	stream->linked = 0;
+	if (stream->io_mode == IO_MMAP) {
+		err = snd_pcm_link(capture_handle, playback_handle);
+		if (err < 0)
+			fprintf(stderr, "cannot link capture and playback (%s), starting them separately\n",
+					snd_strerror(err));
+		else
+			stream->linked = 1;
+	}
+}
 
-	std::vector<StkFloat> v4(std::begin(filter_taps_2000_3000Hz), std::end(filter_taps_2000_3000Hz));	
-	stream->filter_2000_3000Hz.setCoefficients(v4);	
+/* Open the sound card, or the offline backend, and build the processing
+ * context for the rate and period they settle on.
+ */
+int open_and_init(struct audio_stream *stream)
+{
+	if (stream->backend) {
+		if (stream->backend->open(stream, stream->backend_arg) < 0)
+			exit(1);
+	} else {
+		open_alsa(stream);
+	}
 
-	std::vector<StkFloat> v5(std::begin(filter_taps_2000_6000Hz), std::end(filter_taps_2000_6000Hz));	
-	stream->filter_2000_6000Hz.setCoefficients(v5);	
+	/* STK objects read the global rate when they are built, so set it
+	 * to the negotiated rate before the processing context exists.
+	 */
+	Stk::setSampleRate(stream->sample_rate);
 
-	std::vector<StkFloat> v6(std::begin(filter_taps_2500_22050Hz), std::end(filter_taps_2500_22050Hz));	
-	stream->filter_2500_22050Hz.setCoefficients(v6);	
+	stream->ctx = new processing_context;
+	struct processing_context *ctx = stream->ctx;
 
-	//delay effects
-	stream->echo.setDelay(BUF_SIZE*2);
+	ctx->output.resize(stream->frame_size, 1, 0.0);
+	ctx->fade_input.resize(stream->frame_size, 1, 0.0);
 
-	//modulators
-	stream->modulator.setFrequency(3);;
+	ctx->fade_active = 0;
+	ctx->fade_length = stream->xfade_samples;
 
-	//non linear functions
-	stream->distortion.setThreshold( 0.2 );
-	stream->distortion.setA1( 1.0 );
- 	stream->distortion.setA2( 0.0 );
-	stream->distortion.setA3( -1.0 / 3.0 );
-	stream->distortion.setGain(1.2);	
+	//configure effect classes, compiled once so a period never allocates
+	for (int i = 0; i < effect_max; i++) {
+		ctx->chains[i] = effect_chain_create(stream,
+				i == custom_chain ? stream->chain_spec : effect_str[i]);
+		if (!ctx->chains[i]) {
+			fprintf(stderr, "cannot set up effect %s\n", effect_str[i]);
+			exit(1);
+		}
+	}
 
 	return 0;
 }
 
-void *read_input(void *args)
+/* readi/writei loop on the two unlinked handles, the original engine.
+ * An xrun on either handle restarts both, see recovery.h.
+ */
+static void run_rw(struct audio_stream *stream)
 {
-	FILE *fp;
-	char buf[64];
-	int fd;
-	int ret;
-	int *effect = (int *)args;
+	int err;
+	unsigned long long start;
+	unsigned int dsp_ns;
+	short *buf = (short *)stream->buffer;
 
-	fp = popen("/usr/bin/python3 -u input.py", "r");
-	if (!fp) {
-		perror("popen():");
-		return NULL;
-	}
+	while (1) {
 
-	fd = fileno(fp);
-	if (fd == -1) {
-		perror("fileno():");
-		return NULL;
-	}
+		control_apply(stream);
 
-	while (1) {
-		ret = read(fd, buf, 2);
-		if (ret != 2) {
-			perror("read():");
-			return NULL;
+		/* wait till the capture device is ready for data, or 1 second
+		 * has elapsed.
+		 */
+
+		if ((err = snd_pcm_wait(capture_handle, 1000)) < 0) {
+			fprintf(stderr, "capture poll failed (%s)\n", snd_strerror(err));
+			if (xrun_recover(stream, err) < 0)
+				break;
+			continue;
 		}
-		buf[1] = '\0';
-		ret = atoi(buf);
-		printf("key %d\n", ret);
-
-		if (ret == 7) {
-			if (++*effect == effect_max)
-				*effect = no_effect;	
-		} else if (ret == 6) {
-			if (*effect == no_effect)
-				*effect = effect_max - 1;
-			else
-				(*effect)--;
+
+		// capture data
+		err = capture_callback(stream->frame_size, buf);
+		if (err < 0) {
+			if (xrun_recover(stream, err) < 0)
+				break;
+			continue;
+		}
+
+		start = telemetry_clock();
+		rt_alloc_guard_enter();
+		applyEffect(stream, buf, buf, stream->frame_size);
+		rt_alloc_guard_leave();
+		dsp_ns = telemetry_clock() - start;
+
+		// not playing this period takes one period of latency back
+		if (recovery_period(stream))
+			continue;
+
+		/* wait till the playback device is ready for data, or 1 second
+		 * has elapsed.
+		 */
+
+		if ((err = snd_pcm_wait(playback_handle, 1000)) < 0) {
+			fprintf(stderr, "playback poll failed (%s)\n", snd_strerror(err));
+			if (xrun_recover(stream, err) < 0)
+				break;
+			continue;
 		}
 
-		printf("effect %d\n", *effect);
+		/* deliver the data */
+		err = playback_callback(stream->frame_size, buf);
+		if (err < 0) {
+			if (xrun_recover(stream, err) < 0)
+				break;
+			continue;
+		}
+
+		if (stream->telemetry)
+			telemetry_period(stream, dsp_ns);
+	}
+}
+
+/* linked mmap loop, see alsa_mmap.cpp */
+static void run_mmap(struct audio_stream *stream)
+{
+	int err;
+
+	if (mmap_start(stream) < 0)
+		return;
+
+	while (1) {
+		control_apply(stream);
+
+		err = mmap_transfer_period(stream);
+		if (err < 0 && xrun_recover(stream, err) < 0)
+			break;
+	}
+}
 
-		snprintf(buf, 64, "/usr/bin/python3 display.py %s", effect_str[*effect]);
-		printf("command line %s\n", buf);
-		system(buf);
+static void usage(const char *prog)
+{
+	fprintf(stderr, "usage: %s [-m] [-l periods] [-p periods] [-r priority] [-a cpu]\n"
+			"          [-x samples] [-c file] [-e chain] [-k] [-n] [-i] [-s effect]\n"
+			"          [-o backend] [-d] [-t target]\n"
+			"  -m          mmap I/O on linked capture/playback handles\n"
+			"  -l periods  mmap playback latency in periods, 1 or 2 (default 1)\n"
+			"  -p periods  capture, DSP and playback threads with periods of\n"
+			"              added latency, 1 to %d\n"
+			"  -r priority SCHED_FIFO priority of the audio thread, 0 for normal\n"
+			"              scheduling (default %d)\n"
+			"  -a cpu      CPU the audio thread runs on and input.py and display.py\n"
+			"              stay off, -1 for any (default the last CPU)\n"
+			"  -x samples  effect crossfade length, 0 switches instantly (default 512)\n"
+			"  -c file     impulse response for the convolution effect (WAV, AIFF, SND, MAT)\n"
+			"  -e chain    effects of the custom_chain effect, e.g.\n"
+			"              filter_0_4000Hz,(echo|modulator)@0.5,distortion\n"
+			"              (default %s)\n"
+			"  -k          design filters with a Kaiser window instead of\n"
+			"              equiripple, longer but with less passband ripple\n"
+			"  -n          minimum-phase filters, a few samples of delay instead\n"
+			"              of half their length, for live monitoring\n"
+			"  -i          Chebyshev IIR filters instead of FIR, much cheaper\n"
+			"              but not linear phase\n"
+			"  -s effect   effect to start with, by name (default no_effect)\n"
+			"  -o backend  render offline as fast as possible instead of using the\n"
+			"              sound card: file:in.wav[:out.wav] or null[:seconds]\n"
+			"  -d          TPDF dither the 16-bit output\n"
+			"  -t target   per-period telemetry report every second to a file,\n"
+			"              - for stdout or unix:/path for a datagram socket\n",
+			prog, PIPELINE_MAX_PERIODS, RT_PRIORITY, DEFAULT_CHAIN);
+}
+
+static int effect_by_name(const char *name)
+{
+	for (int i = 0; i < effect_max; i++) {
+		if (!strcmp(effect_str[i], name))
+			return i;
 	}
+	return -1;
+}
 
-	pclose(fp);
-	return NULL;
+static void close_processing(struct audio_stream *stream)
+{
+	for (int i = 0; i < effect_max; i++)
+		effect_chain_destroy(stream->ctx->chains[i]);
+	delete stream->ctx;
 }
 
 int main(int argc, char *argv[]) {
 
 	struct audio_stream stream;
-	int err;
-	int frames_played;
-	int frames_captured;
-	snd_pcm_uframes_t val;
-	pthread_t thread;
+	struct control_plane control;
+	struct telemetry telemetry;
+	struct recovery recovery;
+	int opt;
+	int ret;
 
 	stream.format = SND_PCM_FORMAT_S16_LE;
 	stream.sample_rate = (unsigned int)44100; // set sample rate
 	stream.channels = 1;
 	stream.current_effect = no_effect;
-
-	err = pthread_create(&thread, NULL, read_input, &stream.current_effect);
-	if (err) {
-		perror("ptrhead_create():");
-		return -1;
+	stream.io_mode = IO_RW;
+	stream.latency_periods = 1;
+	stream.xfade_samples = 512;
+	stream.ir_file = NULL;
+	stream.chain_spec = DEFAULT_CHAIN;
+	stream.fir_kaiser = 0;
+	stream.fir_minimum_phase = 0;
+	stream.iir_filters = 0;
+	stream.dither = 0;
+	stream.telemetry = NULL;
+	stream.recovery = NULL;
+	stream.rt_priority = RT_PRIORITY;
+	stream.rt_cpu = stk::Realtime::defaultCpu();
+	stream.backend = NULL;
+	stream.backend_arg = NULL;
+	stream.backend_data = NULL;
+
+	while ((opt = getopt(argc, argv, "ml:p:r:a:x:c:e:knis:o:dt:h")) != -1) {
+		switch (opt) {
+		case 'm':
+			stream.io_mode = IO_MMAP;
+			break;
+		case 'l':
+			stream.latency_periods = atoi(optarg);
+			if (stream.latency_periods < 1 || stream.latency_periods > 2) {
+				usage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'p':
+			stream.io_mode = IO_PIPELINE;
+			stream.latency_periods = atoi(optarg);
+			if (stream.latency_periods < 1 ||
+			    stream.latency_periods > PIPELINE_MAX_PERIODS) {
+				usage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'r':
+			stream.rt_priority = atoi(optarg);
+			break;
+		case 'a':
+			stream.rt_cpu = atoi(optarg);
+			break;
+		case 'x':
+			stream.xfade_samples = atoi(optarg);
+			break;
+		case 'c':
+			stream.ir_file = optarg;
+			break;
+		case 'e':
+			stream.chain_spec = optarg;
+			break;
+		case 'k':
+			stream.fir_kaiser = 1;
+			break;
+		case 'n':
+			stream.fir_minimum_phase = 1;
+			break;
+		case 'i':
+			stream.iir_filters = 1;
+			break;
+		case 's':
+			ret = effect_by_name(optarg);
+			if (ret < 0) {
+				usage(argv[0]);
+				return -1;
+			}
+			stream.current_effect = (MySynthEffect)ret;
+			break;
+		case 'o':
+			stream.backend = backend_find(optarg, &stream.backend_arg);
+			if (!stream.backend) {
+				usage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'd':
+			stream.dither = 1;
+			break;
+		case 't':
+			telemetry_init(&telemetry, optarg, 1000);
+			stream.telemetry = &telemetry;
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
 	}
 
-	open_and_init(&stream);
+	// offline render, no sound card, keys, telemetry or realtime setup
+	if (stream.backend) {
+		open_and_init(&stream);
+		ret = run_offline(&stream);
+		stream.backend->close(&stream);
+		close_processing(&stream);
+		free(stream.buffer);
+		return ret;
+	}
 
-	while (1) {
+	// keep the whole process resident, warns and carries on without the rlimit
+	stk::Realtime::lockMemory();
 
-		/* wait till the capture device is ready for data, or 1 second
-		 * has elapsed.
-		 */
-
-		if ((err = snd_pcm_wait(capture_handle, 1000)) < 0) {
-			fprintf(stderr, "poll failed (%s)\n", strerror(errno));
-			break;
-		}
+	if (control_init(&control) < 0)
+		return -1;
+	// the keys step from the effect -s started with
+	control.selected_effect = stream.current_effect;
+	control.audio_cpu = stream.rt_cpu;
+	stream.control = &control;
 
-		// capture data
-		frames_captured = capture_callback(stream.frame_size, (short *)stream.buffer);
-		if (frames_captured != stream.frame_size) {
-			fprintf(stderr, "capture callback failed\n");
-			break;
-		}
+	if (control_start(&control) < 0)
+		return -1;
 
-		applyEffect(&stream);
-		
+	open_and_init(&stream);
 
-		/* wait till the playback device is ready for data, or 1 second
-		 * has elapsed.
-		 */
+	if (recovery_init(&recovery, &stream) < 0)
+		return -1;
 
-		if ((err = snd_pcm_wait(playback_handle, 1000)) < 0) {
-			fprintf(stderr, "poll failed (%s)\n", strerror(errno));
-			break;
-		}
+	if (stream.telemetry && telemetry_start(stream.telemetry, &stream) < 0)
+		return -1;
 
-		//frames in buffer
-		snd_pcm_status_t *playback_status;
-		snd_pcm_status_alloca(&playback_status);
-		snd_pcm_status(playback_handle, playback_status);	
-		val = snd_pcm_status_get_avail_max(playback_status) - snd_pcm_avail_update(playback_handle);		
-		// D("frames available: %lu\n", val);
+	// the pipeline sets up its own threads
+	if (stream.io_mode != IO_PIPELINE)
+		stk::Realtime::setupThread(stream.rt_priority, stream.rt_cpu);
 
-		/* deliver the data */
-		frames_played = playback_callback(stream.frame_size, (short *)stream.buffer);
-		if (frames_played != stream.frame_size) {
-			fprintf(stderr, "playback callback failed\n");
-			//snd_pcm_recover (playback_handle, frames_played, 0);
-			break;
-		}
-	}
+	if (stream.io_mode == IO_MMAP)
+		run_mmap(&stream);
+	else if (stream.io_mode == IO_PIPELINE)
+		run_pipeline(&stream);
+	else
+		run_rw(&stream);
 
+	close_processing(&stream);
 	snd_pcm_close(playback_handle);
 	snd_pcm_close(capture_handle);
 	exit(0);
 }
-
-
-
@@ -0,0 +1,138 @@
+#ifndef MYSYNTH_H
+#define MYSYNTH_H
+
+#include <alsa/asoundlib.h>
+
+#include <stk/Noise.h>
+#include <stk/Iir.h>
+#include <stk/Echo.h>
+#include <stk/PitShift.h>
+#include <stk/PRCRev.h>
+#include <stk/Guitar.h>
+#include <stk/ADSR.h>
+#include <stk/Cubic.h>
+#include <stk/BiQuad.h>
+#include <stk/Modulate.h>
+#include <stk/SineWave.h>
+#include <stk/ConvolutionFir.h>
+#include <stk/SampleConvert.h>
+#include <stk/Realtime.h>
+
+#define PLAYBACK_DEVICE "default"
+#define CAPTURE_DEVICE "default"
+
+#define DEBUG
+
+#ifdef DEBUG
+#define D(fmt, args...) fprintf(stderr, fmt, ##args)
+#else
+#define D(fmt, args...)
+#endif
+
+extern snd_pcm_t *capture_handle;
+extern snd_pcm_t *playback_handle;
+extern const char *effect_str[];
+
+enum MySynthEffect { 
+	no_effect,
+	filter_0_500Hz,
+	filter_0_2000Hz,
+	filter_0_4000Hz,
+	filter_2000_3000Hz,
+	filter_2000_6000Hz,
+	filter_2500_22050Hz,	
+	echo,	
+	modulator,
+	distortion,
+	convolution,
+	custom_chain,	// the -e chain, see effect_chain.h
+	effect_max
+ };
+
+/* How periods move between the sound card and applyEffect(). */
+enum io_mode {
+	IO_RW,		// snd_pcm_readi/writei through stream->buffer
+	IO_MMAP,	// linked handles, DSP straight on the DMA areas
+	IO_PIPELINE,	// capture, DSP and playback threads, see pipeline.h
+};
+
+// rw playback starts once this many periods are queued
+#define RW_START_PERIODS 3
+
+// SCHED_FIFO priority of the audio thread, -r 0 runs it at normal priority
+#define RT_PRIORITY 80
+
+/* Everything applyEffect() touches in the audio loop.  It is allocated and
+ * sized once in open_and_init(), so processing a period never allocates
+ * and never writes STK global state.
+ */
+struct processing_context {
+	//work buffers, frame_size frames each
+	stk::StkFrames output;
+	stk::StkFrames fade_input;
+
+	//effect switch in progress, see switch_effect()
+	int fade_active;
+	MySynthEffect fade_from;
+	unsigned long fade_pos;
+	unsigned long fade_warm;
+	unsigned long fade_length;
+
+	//one compiled chain per effect, a single node for all but custom_chain
+	struct effect_chain *chains[effect_max];
+
+	//TPDF dither for the int16 output, used when stream->dither is set
+	stk::SampleDither dither;
+};
+
+struct audio_stream {
+	snd_pcm_hw_params_t *hw_playback_params;
+	snd_pcm_sw_params_t *sw_playback_params;
+	snd_pcm_hw_params_t *hw_capture_params;
+	snd_pcm_sw_params_t *sw_capture_params;
+	unsigned int sample_rate;
+
+	void *buffer;
+	snd_pcm_uframes_t frame_size;
+	unsigned int buffer_size;
+	snd_pcm_format_t format;
+	int channels;
+
+	// written by the audio thread only, see control_apply()
+	MySynthEffect current_effect = no_effect;
+
+	enum io_mode io_mode;
+	unsigned int latency_periods;	// mmap and pipeline silence primed, see recovery.h
+	unsigned int xfade_samples;
+	const char *ir_file;	// convolution impulse response, NULL for the built-in room
+	const char *chain_spec;	// custom_chain effects, see effect_chain.h
+	int fir_kaiser;		// Kaiser windowed filters, see filter_design.h
+	int fir_minimum_phase;	// minimum-phase filters, see stk::SymmetricFir
+	int iir_filters;	// Chebyshev IIR filters instead of FIR, see filter_design.h
+	int dither;		// TPDF dither the output samples
+	int linked;
+	int rt_priority;	// audio thread SCHED_FIFO priority, 0 for none
+	int rt_cpu;		// CPU the audio thread is pinned to, -1 for any
+
+	struct processing_context *ctx;
+	struct control_plane *control;
+	struct telemetry *telemetry;	// NULL unless -t was given
+	struct recovery *recovery;
+
+	const struct audio_backend *backend;	// NULL for the sound card, see backend.h
+	const char *backend_arg;
+	void *backend_data;
+};
+
+void applyEffect(struct audio_stream *stream, const short *in, short *out,
+		 snd_pcm_uframes_t nframes);
+int capture_callback(snd_pcm_sframes_t nframes, short buf[]);
+int playback_callback(snd_pcm_sframes_t nframes, short buf[]);
+void switch_effect(struct audio_stream *stream, MySynthEffect effect);
+int effect_switching(struct audio_stream *stream);
+
+// alsa_mmap.cpp
+int mmap_start(struct audio_stream *stream);
+int mmap_transfer_period(struct audio_stream *stream);
+
+#endif
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <errno.h>
+
+#include "MySynth.h"
+#include "rt_alloc_guard.h"
+#include "telemetry.h"
+#include "recovery.h"
+
+/* Linked full-duplex mmap engine.
+ *
+ * Capture and playback are tied with snd_pcm_link() and moved one period
+ * at a time.  applyEffect() reads straight from the capture DMA area and
+ * writes straight into the playback DMA area, so there is no copy through
+ * stream->buffer.  Playback is primed with latency_periods of silence
+ * before the pair is started, which fixes the round trip at the capture
+ * period plus that many playback periods.  Errors are returned to the
+ * caller, xrun_recover() restarts the pair after an xrun.
+ */
+
+// first interleaved frame at offset in an mmap area
+static inline short *area_frames(const snd_pcm_channel_area_t *area,
+				 snd_pcm_uframes_t offset)
+{
+	return (short *)((char *)area->addr + (area->first + offset * area->step) / 8);
+}
+
+// sleep until at least frames can be transferred on handle
+static int mmap_wait_avail(snd_pcm_t *handle, snd_pcm_uframes_t frames)
+{
+	snd_pcm_sframes_t avail;
+	int err;
+
+	while (1) {
+		avail = snd_pcm_avail_update(handle);
+		if (avail < 0)
+			return avail;
+		if ((snd_pcm_uframes_t)avail >= frames)
+			return 0;
+
+		err = snd_pcm_wait(handle, 1000);
+		if (err < 0)
+			return err;
+		if (err == 0)
+			return -EIO;
+	}
+}
+
+int mmap_start(struct audio_stream *stream)
+{
+	const snd_pcm_channel_area_t *areas;
+	snd_pcm_uframes_t offset, frames, remaining;
+	snd_pcm_sframes_t committed;
+	int err;
+
+	// prime playback with silence
+	remaining = stream->frame_size * stream->latency_periods;
+	while (remaining > 0) {
+		frames = remaining;
+		err = snd_pcm_mmap_begin(playback_handle, &areas, &offset, &frames);
+		if (err < 0) {
+			fprintf(stderr, "playback mmap begin failed (%s)\n", snd_strerror(err));
+			return err;
+		}
+
+		snd_pcm_areas_silence(areas, offset, stream->channels, frames, stream->format);
+
+		committed = snd_pcm_mmap_commit(playback_handle, offset, frames);
+		if (committed < 0 || (snd_pcm_uframes_t)committed != frames) {
+			fprintf(stderr, "playback mmap commit failed (%s)\n",
+					snd_strerror(committed < 0 ? committed : -EPIPE));
+			return committed < 0 ? committed : -EPIPE;
+		}
+		remaining -= frames;
+	}
+
+	// starting capture starts playback too when they are linked
+	err = snd_pcm_start(capture_handle);
+	if (err < 0) {
+		fprintf(stderr, "cannot start capture (%s)\n", snd_strerror(err));
+		return err;
+	}
+
+	if (!stream->linked) {
+		err = snd_pcm_start(playback_handle);
+		if (err < 0) {
+			fprintf(stderr, "cannot start playback (%s)\n", snd_strerror(err));
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+int mmap_transfer_period(struct audio_stream *stream)
+{
+	const snd_pcm_channel_area_t *capture_areas, *playback_areas;
+	snd_pcm_uframes_t capture_offset, playback_offset;
+	snd_pcm_uframes_t frames, playback_frames;
+	snd_pcm_uframes_t remaining = stream->frame_size;
+	snd_pcm_sframes_t committed;
+	unsigned long long start;
+	unsigned int dsp_ns = 0;
+	int err;
+
+	err = mmap_wait_avail(capture_handle, remaining);
+	if (err < 0) {
+		fprintf(stderr, "capture wait failed (%s)\n", snd_strerror(err));
+		return err;
+	}
+
+	// skipping a captured period takes one period of latency back
+	if (recovery_period(stream)) {
+		committed = snd_pcm_forward(capture_handle, remaining);
+		return committed < 0 ? committed : 0;
+	}
+
+	err = mmap_wait_avail(playback_handle, remaining);
+	if (err < 0) {
+		fprintf(stderr, "playback wait failed (%s)\n", snd_strerror(err));
+		return err;
+	}
+
+	/* A period normally maps in one piece; it only splits when the
+	 * ring size is not a multiple of the period.
+	 */
+	while (remaining > 0) {
+		frames = remaining;
+		err = snd_pcm_mmap_begin(capture_handle, &capture_areas, &capture_offset, &frames);
+		if (err < 0) {
+			fprintf(stderr, "capture mmap begin failed (%s)\n", snd_strerror(err));
+			return err;
+		}
+
+		playback_frames = frames;
+		err = snd_pcm_mmap_begin(playback_handle, &playback_areas, &playback_offset, &playback_frames);
+		if (err < 0) {
+			fprintf(stderr, "playback mmap begin failed (%s)\n", snd_strerror(err));
+			return err;
+		}
+		if (playback_frames < frames)
+			frames = playback_frames;
+
+		start = telemetry_clock();
+		rt_alloc_guard_enter();
+		applyEffect(stream, area_frames(capture_areas, capture_offset),
+			    area_frames(playback_areas, playback_offset), frames);
+		rt_alloc_guard_leave();
+		dsp_ns += telemetry_clock() - start;
+
+		committed = snd_pcm_mmap_commit(playback_handle, playback_offset, frames);
+		if (committed < 0 || (snd_pcm_uframes_t)committed != frames) {
+			fprintf(stderr, "playback mmap commit failed (%s)\n",
+					snd_strerror(committed < 0 ? committed : -EPIPE));
+			return committed < 0 ? committed : -EPIPE;
+		}
+
+		committed = snd_pcm_mmap_commit(capture_handle, capture_offset, frames);
+		if (committed < 0 || (snd_pcm_uframes_t)committed != frames) {
+			fprintf(stderr, "capture mmap commit failed (%s)\n",
+					snd_strerror(committed < 0 ? committed : -EPIPE));
+			return committed < 0 ? committed : -EPIPE;
+		}
+
+		remaining -= frames;
+	}
+
+	if (stream->telemetry)
+		telemetry_period(stream, dsp_ns);
+
+	return 0;
+}
@@ -0,0 +1,258 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <algorithm>
+
+#include <stk/FileRead.h>
+#include <stk/FileWrite.h>
+
+#include "MySynth.h"
+#include "backend.h"
+#include "rt_alloc_guard.h"
+#include "telemetry.h"
+
+using namespace stk;
+
+struct file_state {
+	FileRead reader;
+	FileWrite writer;
+	int writing;
+	unsigned long position;	// next frame to read
+	StkFrames frames;	// one period, all channels of the file
+	StkFrames mono;		// one period, mixed down
+};
+
+struct null_state {
+	unsigned long remaining;
+	SineWave tone;
+	Noise noise;
+	StkFrames mono;
+};
+
+// period size and work buffer shared by the offline backends
+static int offline_buffer(struct audio_stream *stream)
+{
+	stream->channels = 1;
+	stream->frame_size = OFFLINE_PERIOD;
+	stream->buffer_size = stream->frame_size * sizeof(short) * stream->channels;
+
+	stream->buffer = malloc(stream->buffer_size);
+	if (!stream->buffer) {
+		perror("malloc():");
+		return -1;
+	}
+	return 0;
+}
+
+static int file_open(struct audio_stream *stream, const char *arg)
+{
+	struct file_state *f = new file_state;
+	std::string in(arg ? arg : "");
+	std::string out;
+	size_t colon = in.find(':');
+
+	if (colon != std::string::npos) {
+		out = in.substr(colon + 1);
+		in.erase(colon);
+	}
+	if (in.empty()) {
+		fprintf(stderr, "file backend: input file expected\n");
+		delete f;
+		return -1;
+	}
+
+	f->writing = 0;
+	try {
+		f->reader.open(in);
+
+		// the output header takes the global rate
+		stream->sample_rate = (unsigned int)(f->reader.fileRate() + 0.5);
+		Stk::setSampleRate(stream->sample_rate);
+
+		if (!out.empty()) {
+			f->writer.open(out, 1, FileWrite::FILE_WAV, Stk::STK_SINT16);
+			f->writing = 1;
+		}
+	} catch (StkError &) {
+		fprintf(stderr, "file backend: cannot open %s\n",
+				f->reader.isOpen() ? out.c_str() : in.c_str());
+		delete f;
+		return -1;
+	}
+
+	if (offline_buffer(stream) < 0) {
+		delete f;
+		return -1;
+	}
+
+	f->position = 0;
+	f->frames.resize(stream->frame_size, f->reader.channels());
+	f->mono.resize(stream->frame_size, 1);
+	stream->backend_data = f;
+	return 0;
+}
+
+static long file_capture(struct audio_stream *stream, short *buf, snd_pcm_uframes_t nframes)
+{
+	struct file_state *f = (struct file_state *)stream->backend_data;
+	unsigned long n = std::min((unsigned long)nframes, f->reader.fileSize() - f->position);
+	unsigned int channels = f->reader.channels();
+	unsigned int i, c;
+	StkFloat sum;
+
+	if (n == 0)
+		return 0;
+
+	StkFramesView frames(&f->frames[0], n, channels);
+	f->reader.read(frames, f->position);
+	f->position += n;
+
+	for (i = 0; i < n; i++) {
+		sum = 0.0;
+		for (c = 0; c < channels; c++)
+			sum += frames(i, c);
+		f->mono[i] = sum / channels;
+	}
+
+	convertToInt16(&f->mono[0], buf, n);
+	return n;
+}
+
+static int file_playback(struct audio_stream *stream, const short *buf, snd_pcm_uframes_t nframes)
+{
+	struct file_state *f = (struct file_state *)stream->backend_data;
+
+	if (!f->writing)
+		return 0;
+
+	StkFramesView mono(f->mono, 0, nframes);
+	convertFromInt16(buf, &mono[0], nframes);
+	try {
+		f->writer.write(mono);
+	} catch (StkError &) {
+		fprintf(stderr, "file backend: write failed\n");
+		return -1;
+	}
+	return 0;
+}
+
+static void file_close(struct audio_stream *stream)
+{
+	struct file_state *f = (struct file_state *)stream->backend_data;
+
+	if (f->writing)
+		f->writer.close();
+	delete f;
+	stream->backend_data = NULL;
+}
+
+static int null_open(struct audio_stream *stream, const char *arg)
+{
+	struct null_state *s;
+	double seconds = arg ? atof(arg) : NULL_SECONDS;
+
+	if (seconds <= 0.0) {
+		fprintf(stderr, "null backend: a length in seconds expected\n");
+		return -1;
+	}
+	if (offline_buffer(stream) < 0)
+		return -1;
+
+	s = new null_state;
+	s->remaining = seconds * stream->sample_rate;
+	s->tone.setFrequency(440.0);
+	s->mono.resize(stream->frame_size, 1);
+	stream->backend_data = s;
+	return 0;
+}
+
+static long null_capture(struct audio_stream *stream, short *buf, snd_pcm_uframes_t nframes)
+{
+	struct null_state *s = (struct null_state *)stream->backend_data;
+	unsigned long n = std::min((unsigned long)nframes, s->remaining);
+
+	for (unsigned long i = 0; i < n; i++)
+		s->mono[i] = 0.5 * s->tone.tick() + 0.1 * s->noise.tick();
+
+	convertToInt16(&s->mono[0], buf, n);
+	s->remaining -= n;
+	return n;
+}
+
+static int null_playback(struct audio_stream *stream, const short *buf, snd_pcm_uframes_t nframes)
+{
+	return 0;
+}
+
+static void null_close(struct audio_stream *stream)
+{
+	delete (struct null_state *)stream->backend_data;
+	stream->backend_data = NULL;
+}
+
+const struct audio_backend file_backend = {
+	"file", file_open, file_capture, file_playback, file_close,
+};
+
+const struct audio_backend null_backend = {
+	"null", null_open, null_capture, null_playback, null_close,
+};
+
+const struct audio_backend *backend_find(const char *spec, const char **arg)
+{
+	static const struct audio_backend *backends[] = { &file_backend, &null_backend };
+	size_t len = strcspn(spec, ":");
+
+	*arg = spec[len] == ':' ? spec + len + 1 : NULL;
+	for (unsigned int i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+		if (strlen(backends[i]->name) == len && !strncmp(backends[i]->name, spec, len))
+			return backends[i];
+	}
+	return NULL;
+}
+
+/* The live loop without the sound card.  Capture and playback time is
+ * counted in the wall time, so the realtime factor includes file I/O;
+ * the DSP share is applyEffect() alone.
+ */
+int run_offline(struct audio_stream *stream)
+{
+	const struct audio_backend *backend = stream->backend;
+	short *buf = (short *)stream->buffer;
+	unsigned long long start, wall_ns, dsp_start, period_ns;
+	unsigned long long dsp_ns = 0, worst_ns = 0;
+	unsigned long long frames = 0;
+	double seconds, wall;
+	long n;
+
+	start = telemetry_clock();
+	while ((n = backend->capture(stream, buf, stream->frame_size)) > 0) {
+		dsp_start = telemetry_clock();
+		rt_alloc_guard_enter();
+		applyEffect(stream, buf, buf, n);
+		rt_alloc_guard_leave();
+		period_ns = telemetry_clock() - dsp_start;
+
+		dsp_ns += period_ns;
+		worst_ns = std::max(worst_ns, period_ns);
+
+		if (backend->playback(stream, buf, n) < 0)
+			return -1;
+		frames += n;
+	}
+	wall_ns = telemetry_clock() - start;
+
+	seconds = (double)frames / stream->sample_rate;
+	wall = wall_ns / 1e9;
+	fprintf(stderr, "%s: %s, %llu frames (%.2f s of audio) in %.3f s\n",
+			backend->name, effect_str[stream->current_effect],
+			frames, seconds, wall);
+	if (wall_ns > 0)
+		fprintf(stderr, "%.0f samples/s, %.1fx realtime, DSP %.1f%% of the wall time, "
+				"worst period %.3f ms of %.3f ms\n",
+				frames * stream->channels / wall, seconds / wall,
+				100.0 * dsp_ns / wall_ns, worst_ns / 1e6,
+				1e3 * stream->frame_size / stream->sample_rate);
+	return 0;
+}
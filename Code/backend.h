@@ -0,0 +1,46 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <alsa/asoundlib.h>
+
+struct audio_stream;
+
+/* Offline audio backends.
+ *
+ * With -o the sound card is not opened.  open_and_init() asks the backend
+ * for the sample rate and period instead, and run_offline() moves periods
+ * through the same applyEffect() path as the live loops, as fast as the
+ * CPU allows:
+ *
+ *   -o file:in.wav[:out.wav]  reads any stk::FileRead format, mixed down
+ *                             to mono, and writes a 16-bit WAV if asked
+ *   -o null[:seconds]         a tone plus noise, output thrown away
+ *                             (default NULL_SECONDS)
+ *
+ * At the end the frames processed, samples per second and the realtime
+ * factor (seconds of audio per second of wall time) are printed.
+ */
+
+#define OFFLINE_PERIOD	1024	// frames per period
+#define NULL_SECONDS	60
+
+struct audio_backend {
+	const char *name;
+
+	// set sample_rate, channels and frame_size and allocate stream->buffer
+	int (*open)(struct audio_stream *stream, const char *arg);
+	// up to nframes into buf, the frame count or 0 at the end
+	long (*capture)(struct audio_stream *stream, short *buf, snd_pcm_uframes_t nframes);
+	int (*playback)(struct audio_stream *stream, const short *buf, snd_pcm_uframes_t nframes);
+	void (*close)(struct audio_stream *stream);
+};
+
+extern const struct audio_backend file_backend;
+extern const struct audio_backend null_backend;
+
+// backend named by an -o argument, arg is set to what follows the ':'
+const struct audio_backend *backend_find(const char *spec, const char **arg);
+
+int run_offline(struct audio_stream *stream);
+
+#endif
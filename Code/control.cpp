@@ -0,0 +1,165 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "MySynth.h"
+#include "control.h"
+
+static void *read_input(void *args)
+{
+	struct control_plane *control = (struct control_plane *)args;
+	struct control_cmd cmd;
+	FILE *fp;
+	char buf[64];
+	int fd;
+	int ret;
+	int *effect = &control->selected_effect;
+
+	// python inherits this thread's affinity
+	stk::Realtime::avoidCpu(control->audio_cpu);
+	fp = popen("/usr/bin/python3 -u input.py", "r");
+	if (!fp) {
+		perror("popen():");
+		return NULL;
+	}
+
+	fd = fileno(fp);
+	if (fd == -1) {
+		perror("fileno():");
+		return NULL;
+	}
+
+	while (1) {
+		ret = read(fd, buf, 2);
+		if (ret != 2) {
+			perror("read():");
+			return NULL;
+		}
+		buf[1] = '\0';
+		ret = atoi(buf);
+		printf("key %d\n", ret);
+
+		if (ret == 7) {
+			if (++*effect == effect_max)
+				*effect = no_effect;	
+		} else if (ret == 6) {
+			if (*effect == no_effect)
+				*effect = effect_max - 1;
+			else
+				(*effect)--;
+		} else {
+			continue;
+		}
+
+		printf("effect %d\n", *effect);
+
+		cmd.op = CONTROL_SET_EFFECT;
+		cmd.value = *effect;
+		if (!control->commands.push(cmd))
+			fprintf(stderr, "control queue full, key dropped\n");
+
+		if (control->display.push(*effect))
+			sem_post(&control->display_ready);
+	}
+
+	pclose(fp);
+	return NULL;
+}
+
+/* Keeps one display.py alive for the whole run instead of starting
+ * python on every key press.
+ */
+static void *display_worker(void *args)
+{
+	struct control_plane *control = (struct control_plane *)args;
+	FILE *fp;
+	int effect;
+	int latest;
+
+	stk::Realtime::avoidCpu(control->audio_cpu);
+	fp = popen("/usr/bin/python3 -u display.py", "w");
+	if (!fp) {
+		perror("popen():");
+		return NULL;
+	}
+
+	while (1) {
+		if (sem_wait(&control->display_ready) == -1) {
+			if (errno == EINTR)
+				continue;
+			perror("sem_wait():");
+			break;
+		}
+
+		// only the newest selection is worth drawing
+		latest = -1;
+		while (control->display.pop(effect))
+			latest = effect;
+		if (latest < 0)
+			continue;
+
+		if (fprintf(fp, "%s\n", effect_str[latest]) < 0 || fflush(fp) == EOF) {
+			perror("display write:");
+			break;
+		}
+	}
+
+	pclose(fp);
+	return NULL;
+}
+
+int control_init(struct control_plane *control)
+{
+	control->selected_effect = no_effect;
+	control->audio_cpu = -1;
+
+	if (sem_init(&control->display_ready, 0, 0) == -1) {
+		perror("sem_init():");
+		return -1;
+	}
+
+	return 0;
+}
+
+int control_start(struct control_plane *control)
+{
+	pthread_t thread;
+	int err;
+
+	// draw the starting effect; the input thread is the only producer once it runs
+	if (control->display.push(control->selected_effect))
+		sem_post(&control->display_ready);
+
+	err = pthread_create(&thread, NULL, read_input, control);
+	if (err) {
+		fprintf(stderr, "pthread_create(): %s\n", strerror(err));
+		return -1;
+	}
+	pthread_detach(thread);
+
+	err = pthread_create(&thread, NULL, display_worker, control);
+	if (err) {
+		fprintf(stderr, "pthread_create(): %s\n", strerror(err));
+		return -1;
+	}
+	pthread_detach(thread);
+
+	return 0;
+}
+
+void control_apply(struct audio_stream *stream)
+{
+	struct control_cmd cmd;
+
+	// later keys wait in the ring until the running crossfade finishes
+	while (!effect_switching(stream) && stream->control->commands.pop(cmd)) {
+		switch (cmd.op) {
+		case CONTROL_SET_EFFECT:
+			switch_effect(stream, (MySynthEffect)cmd.value);
+			break;
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <semaphore.h>
+
+#include "spsc_ring.h"
+
+struct audio_stream;
+
+/* Control plane between the key reader, the audio loop and the LCD.
+ *
+ * The input thread owns the selected effect.  It pushes a command to the
+ * audio thread, which drains the ring once per period in
+ * control_apply(), and the effect index to the display worker, which
+ * keeps one display.py process alive and feeds it names over a pipe.
+ * With no key pressed a period costs the audio thread one atomic load.
+ */
+
+enum control_op {
+	CONTROL_SET_EFFECT,
+};
+
+struct control_cmd {
+	enum control_op op;
+	int value;
+};
+
+struct control_plane {
+	spsc_ring<struct control_cmd, 64> commands;	// input -> audio
+	spsc_ring<int, 16> display;			// input -> display worker
+	sem_t display_ready;
+	int selected_effect;				// input thread only, once started
+	int audio_cpu;					// kept free of input.py and display.py
+};
+
+int control_init(struct control_plane *control);
+int control_start(struct control_plane *control);
+
+// audio thread, at a period boundary
+void control_apply(struct audio_stream *stream);
+
+#endif
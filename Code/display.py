@@ -5,5 +5,14 @@ import sys
 
 cad = pifacecad.PiFaceCAD()
 cad.lcd.backlight_on()
-cad.lcd.clear()
-cad.lcd.write(sys.argv[1])
+
+def show(text):
+    cad.lcd.clear()
+    cad.lcd.write(text)
+
+# one-shot with an argument, otherwise one line per update on stdin
+if len(sys.argv) > 1:
+    show(sys.argv[1])
+else:
+    for line in sys.stdin:
+        show(line.strip())
@@ -0,0 +1,585 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <algorithm>
+
+#include <stk/MultirateFir.h>
+#include <stk/FirBank.h>
+#include <stk/Sos.h>
+
+#include "MySynth.h"
+#include "effect_chain.h"
+#include "filter_design.h"
+
+#define ECHO_DELAY 4096	// samples
+
+// node kind of every filter_A_BHz name, see filter_design.h
+#define FIR_NODE effect_max
+// the leading filters of parallel branches, run as one stk::FirBank
+#define BANK_NODE (effect_max + 1)
+// a filter_A_BHz name run as a Chebyshev IIR filter, with -i
+#define IIR_NODE (effect_max + 2)
+
+using namespace stk;
+
+/* One effect instance.  object is the STK class for effect, the period
+ * loop casts it back once per block.
+ */
+struct effect_node {
+	int effect;		// MySynthEffect, FIR_NODE, BANK_NODE or IIR_NODE
+	Stk *object;
+	StkFrames aux;		// modulator output, frame_size frames; bank outputs
+	std::vector<unsigned int> outputs;	// BANK_NODE buffer of each filter
+	unsigned long warmup;	// history length in samples
+};
+
+// parse tree, only alive while the chain is compiled
+struct chain_stage {
+	int effect;		// MySynthEffect or FIR_NODE, -1 for a parallel group
+	struct filter_spec filter;	// FIR_NODE passband
+	std::vector<std::vector<struct chain_stage> > branches;
+	StkFloat wet;
+};
+
+struct chain_compiler {
+	struct audio_stream *stream;
+	struct effect_chain *chain;
+	unsigned int depth;	// buffers in use
+	unsigned int max_depth;
+	int failed;
+};
+
+static struct effect_node *node_create(struct audio_stream *stream, struct chain_stage &stage)
+{
+	struct effect_node *node = new effect_node;
+
+	node->effect = stage.effect;
+	node->object = NULL;
+	node->warmup = 0;
+
+	if (stage.effect == FIR_NODE && stream->iir_filters) {
+		Sos *sos = new Sos;
+
+		if (filter_design_iir(&stage.filter, stream->sample_rate, sos) < 0) {
+			delete sos;
+			delete node;
+			return NULL;
+		}
+		node->effect = IIR_NODE;
+		node->object = sos;
+		node->warmup = sos->getDecayLength(stage.filter.attenuation);
+		return node;
+	}
+
+	switch (stage.effect) {
+	case FIR_NODE: {
+		MultirateFir *fir = new MultirateFir;
+
+		stage.filter.kaiser = stream->fir_kaiser;
+		stage.filter.minimum_phase = stream->fir_minimum_phase;
+		if (filter_design(&stage.filter, stream->sample_rate, fir) < 0) {
+			delete fir;
+			delete node;
+			return NULL;
+		}
+		node->object = fir;
+		node->warmup = fir->getLength();
+		break;
+	}
+	case echo: {
+		Echo *e = new Echo;
+		e->setDelay(ECHO_DELAY);
+		node->object = e;
+		break;
+	}
+	case modulator: {
+		SineWave *sine = new SineWave;
+		sine->setFrequency(3);
+		node->aux.resize(stream->frame_size, 1, 0.0);
+		node->object = sine;
+		break;
+	}
+	case distortion: {
+		Cubic *cubic = new Cubic;
+		cubic->setThreshold( 0.2 );
+		cubic->setA1( 1.0 );
+		cubic->setA2( 0.0 );
+		cubic->setA3( -1.0 / 3.0 );
+		cubic->setGain(1.2);
+		node->object = cubic;
+		break;
+	}
+	case convolution: {
+		ConvolutionFir *conv = new ConvolutionFir;
+		node->object = conv;
+
+		/* partitions match the period, so a whole period takes one
+		 * transform; a period split where the mmap ring wraps costs
+		 * more but, like every call, adds no latency
+		 */
+		conv->setBlockSize(stream->frame_size);
+		if (stream->ir_file) {
+			try {
+				conv->openFile(stream->ir_file);
+			} catch (StkError &) {
+				fprintf(stderr, "cannot load impulse response %s\n", stream->ir_file);
+				delete conv;
+				delete node;
+				return NULL;
+			}
+		} else {
+			// half a second of exponentially decaying noise, a plain room
+			std::vector<StkFloat> room(stream->sample_rate / 2);
+			Noise noise(1);
+			for (unsigned int i = 0; i < room.size(); i++)
+				room[i] = 0.05 * noise.tick() * exp(-6.9 * i / room.size());
+			conv->setCoefficients(room, true);
+			conv->setEffectMix(0.4);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+
+	return node;
+}
+
+// run one effect in place on frames
+static void run_node(struct effect_node *node, StkFrames &frames)
+{
+	switch (node->effect) {
+	case FIR_NODE:
+		static_cast<MultirateFir *>(node->object)->tick(frames);
+		break;
+	case IIR_NODE:
+		static_cast<Sos *>(node->object)->tick(frames);
+		break;
+	case echo:
+		static_cast<Echo *>(node->object)->tick(frames);
+		break;
+	case modulator: {
+		StkFramesView mod_output(node->aux, 0, frames.frames());
+		static_cast<SineWave *>(node->object)->tick(mod_output);
+		for (unsigned int i = 0; i < frames.frames(); i++)
+			frames[i] = frames[i]*mod_output[i]*0.5;
+		break;
+	}
+	case distortion:
+		static_cast<Cubic *>(node->object)->tick(frames);
+		break;
+	case convolution:
+		static_cast<ConvolutionFir *>(node->object)->tick(frames);
+		break;
+	default:
+		break;
+	}
+}
+
+// drop state left over from the last time the node ran
+static void clear_node(struct effect_node *node)
+{
+	switch (node->effect) {
+	case FIR_NODE:
+		static_cast<MultirateFir *>(node->object)->clear();
+		break;
+	case BANK_NODE:
+		static_cast<FirBank *>(node->object)->clear();
+		break;
+	case IIR_NODE:
+		static_cast<Sos *>(node->object)->clear();
+		break;
+	case echo:
+		static_cast<Echo *>(node->object)->clear();
+		break;
+	case convolution:
+		static_cast<ConvolutionFir *>(node->object)->clear();
+		break;
+	default:
+		break;
+	}
+}
+
+static void node_destroy(struct effect_node *node)
+{
+	switch (node->effect) {
+	case FIR_NODE:
+		delete static_cast<MultirateFir *>(node->object);
+		break;
+	case BANK_NODE:
+		delete static_cast<FirBank *>(node->object);
+		break;
+	case IIR_NODE:
+		delete static_cast<Sos *>(node->object);
+		break;
+	case echo:
+		delete static_cast<Echo *>(node->object);
+		break;
+	case modulator:
+		delete static_cast<SineWave *>(node->object);
+		break;
+	case distortion:
+		delete static_cast<Cubic *>(node->object);
+		break;
+	case convolution:
+		delete static_cast<ConvolutionFir *>(node->object);
+		break;
+	default:
+		break;
+	}
+	delete node;
+}
+
+static const char *skip_space(const char *s)
+{
+	while (isspace((unsigned char)*s))
+		s++;
+	return s;
+}
+
+static const char *parse_chain(const char *s, std::vector<struct chain_stage> &chain);
+
+static const char *parse_stage(const char *s, struct chain_stage &stage)
+{
+	const char *name;
+	size_t len;
+	char *end;
+	int i;
+
+	s = skip_space(s);
+	stage.effect = -1;
+	stage.wet = 1.0;
+
+	if (*s == '(') {
+		do {
+			stage.branches.push_back(std::vector<struct chain_stage>());
+			s = parse_chain(s + 1, stage.branches.back());
+			if (!s)
+				return NULL;
+		} while (*s == '|');
+
+		if (*s != ')') {
+			fprintf(stderr, "effect chain: ')' expected at \"%s\"\n", s);
+			return NULL;
+		}
+		s++;
+	} else {
+		name = s;
+		while (isalnum((unsigned char)*s) || *s == '_')
+			s++;
+		len = s - name;
+
+		// custom_chain itself is not a valid node
+		for (i = 0; i < custom_chain; i++) {
+			if (strlen(effect_str[i]) == len && !strncmp(effect_str[i], name, len))
+				break;
+		}
+		if (filter_spec_parse(name, len, &stage.filter)) {
+			i = FIR_NODE;
+		} else if (i == custom_chain) {
+			fprintf(stderr, "effect chain: unknown effect \"%.*s\"\n", (int)len, name);
+			return NULL;
+		}
+		stage.effect = i;
+	}
+
+	s = skip_space(s);
+	if (*s == '@') {
+		stage.wet = strtod(s + 1, &end);
+		if (end == s + 1 || stage.wet < 0.0 || stage.wet > 1.0) {
+			fprintf(stderr, "effect chain: wet mix from 0 to 1 expected at \"%s\"\n", s);
+			return NULL;
+		}
+		s = skip_space(end);
+	}
+
+	return s;
+}
+
+static const char *parse_chain(const char *s, std::vector<struct chain_stage> &chain)
+{
+	while (1) {
+		chain.push_back(chain_stage());
+		s = parse_stage(s, chain.back());
+		if (!s || *s != ',')
+			return s;
+		s++;
+	}
+}
+
+static unsigned int get_buffer(struct chain_compiler *c)
+{
+	c->depth++;
+	c->max_depth = std::max(c->max_depth, c->depth);
+	return c->depth;
+}
+
+// CHAIN_RUN runs the node created last
+static void emit(struct chain_compiler *c, enum chain_op_type type,
+		 unsigned int src, unsigned int dst, StkFloat gain)
+{
+	struct chain_op op;
+
+	op.type = type;
+	op.node = c->chain->nodes.empty() ? 0 : c->chain->nodes.size() - 1;
+	op.src = src;
+	op.dst = dst;
+	op.gain = gain;
+	c->chain->plan.push_back(op);
+}
+
+static void compile_chain(struct chain_compiler *c, std::vector<struct chain_stage> &chain,
+			  unsigned int buf, unsigned int from);
+
+/* A bank for the branches of a group that start with a plain linear-phase
+ * filter at the full rate, writing to the buffers the branches will run
+ * on: first onwards, and buf for the last one.  Every filter is padded to
+ * the longest, so the bank takes as many of them as it can, shortest
+ * first, within FIR_BANK_PADDING.  banked[i] is set for each branch that
+ * takes its first filter from the bank.  NULL with no bank worth
+ * building, or when c->failed is set.
+ */
+static struct effect_node *bank_create(struct chain_compiler *c, struct chain_stage &stage,
+				       unsigned int buf, unsigned int first,
+				       std::vector<int> &banked)
+{
+	unsigned int k = stage.branches.size();
+	std::vector<std::vector<StkFloat> > taps(k), filters;
+	std::vector<std::pair<size_t, unsigned int> > lengths;	// taps, branch
+	std::vector<unsigned int> outputs;
+	struct effect_node *node;
+	unsigned int count = 0, stride, i, j;
+	size_t sum = 0;
+	FirBank *bank;
+	int status;
+
+	// minimum-phase filters have no folded history to share and run faster apart
+	if (c->stream->fir_minimum_phase || c->stream->iir_filters)
+		return NULL;
+
+	for (i = 0; i < k; i++) {
+		struct chain_stage &head = stage.branches[i][0];
+
+		if (head.effect != FIR_NODE || head.wet < 1.0)
+			continue;
+		head.filter.kaiser = c->stream->fir_kaiser;
+		head.filter.minimum_phase = 0;
+		status = filter_taps(&head.filter, c->stream->sample_rate, taps[i]);
+		if (status < 0) {
+			c->failed = 1;
+			return NULL;
+		}
+		if (status == 0)
+			lengths.push_back(std::make_pair(taps[i].size(), i));
+	}
+
+	std::sort(lengths.begin(), lengths.end());
+	for (j = 0; j < lengths.size(); j++) {
+		sum += lengths[j].first;
+		stride = (j + SIMD_LANES) / SIMD_LANES * SIMD_LANES;
+		if (stride * lengths[j].first <= FIR_BANK_PADDING * sum)
+			count = j + 1;
+	}
+	if (count < FIR_BANK_FILTERS)
+		return NULL;
+
+	for (j = 0; j < count; j++) {
+		i = lengths[j].second;
+		banked[i] = 1;
+		filters.push_back(taps[i]);
+		outputs.push_back(i + 1 < k ? first + i : buf);
+	}
+
+	bank = new FirBank(filters);
+	node = new effect_node;
+	node->effect = BANK_NODE;
+	node->object = bank;
+	node->aux.resize(c->stream->frame_size, count, 0.0);
+	node->outputs = outputs;
+	node->warmup = bank->getLength();
+	return node;
+}
+
+/* Emit stage processing buf in place.  A group copies buf to a new buffer
+ * for every branch but the last, which runs on buf itself, and then sums
+ * the copies back into it.  When enough branches start with a filter, a
+ * bank runs those filters in one pass and writes their buffers instead
+ * of the copies.
+ */
+static void compile_stage(struct chain_compiler *c, struct chain_stage &stage,
+			  unsigned int buf)
+{
+	struct effect_node *node;
+	unsigned int dry = 0;
+	unsigned int first, dst, k, i;
+
+	if (stage.wet < 1.0) {
+		dry = get_buffer(c);
+		emit(c, CHAIN_COPY, buf, dry, 0.0);
+	}
+
+	if (stage.effect >= 0) {
+		if (stage.effect != no_effect) {
+			node = node_create(c->stream, stage);
+			if (!node) {
+				c->failed = 1;
+				return;
+			}
+			c->chain->nodes.push_back(node);
+			c->chain->warmup += node->warmup;
+			emit(c, CHAIN_RUN, buf, buf, 0.0);
+		}
+	} else {
+		k = stage.branches.size();
+		first = c->depth + 1;
+		std::vector<int> banked(k, 0);
+		node = bank_create(c, stage, buf, first, banked);
+		if (c->failed)
+			return;
+		for (i = 0; i + 1 < k; i++) {
+			dst = get_buffer(c);
+			if (!banked[i])
+				emit(c, CHAIN_COPY, buf, dst, 0.0);
+		}
+		if (node) {
+			c->chain->nodes.push_back(node);
+			c->chain->warmup += node->warmup;
+			emit(c, CHAIN_BANK, buf, buf, 0.0);
+		}
+		for (i = 0; i + 1 < k; i++)
+			compile_chain(c, stage.branches[i], first + i, banked[i]);
+		compile_chain(c, stage.branches[k - 1], buf, banked[k - 1]);
+		for (i = 0; i + 1 < k; i++)
+			emit(c, CHAIN_ADD, first + i, buf, 0.0);
+		if (k > 1)
+			emit(c, CHAIN_SCALE, buf, buf, 1.0 / k);
+		c->depth -= k - 1;
+	}
+
+	if (dry) {
+		emit(c, CHAIN_BLEND, dry, buf, stage.wet);
+		c->depth--;
+	}
+}
+
+// from skips the stages already run by a bank
+static void compile_chain(struct chain_compiler *c, std::vector<struct chain_stage> &chain,
+			  unsigned int buf, unsigned int from)
+{
+	for (unsigned int i = from; i < chain.size() && !c->failed; i++)
+		compile_stage(c, chain[i], buf);
+}
+
+struct effect_chain *effect_chain_create(struct audio_stream *stream, const char *spec)
+{
+	std::vector<struct chain_stage> stages;
+	struct chain_compiler c;
+	const char *end;
+
+	end = parse_chain(spec, stages);
+	if (!end)
+		return NULL;
+	if (*end) {
+		fprintf(stderr, "effect chain: unexpected \"%s\"\n", end);
+		return NULL;
+	}
+
+	c.stream = stream;
+	c.chain = new effect_chain;
+	c.chain->warmup = 0;
+	c.depth = 0;
+	c.max_depth = 0;
+	c.failed = 0;
+
+	compile_chain(&c, stages, 0, 0);
+	if (c.failed) {
+		effect_chain_destroy(c.chain);
+		return NULL;
+	}
+
+	c.chain->buffers.resize(c.max_depth);
+	for (unsigned int i = 0; i < c.max_depth; i++)
+		c.chain->buffers[i].resize(stream->frame_size, 1, 0.0);
+
+	return c.chain;
+}
+
+void effect_chain_destroy(struct effect_chain *chain)
+{
+	for (unsigned int i = 0; i < chain->nodes.size(); i++)
+		node_destroy(chain->nodes[i]);
+	delete chain;
+}
+
+static inline StkFloat *chain_buffer(struct effect_chain *chain, StkFrames &frames,
+				     unsigned int index)
+{
+	return index ? &chain->buffers[index - 1][0] : &frames[0];
+}
+
+void effect_chain_process(struct effect_chain *chain, StkFrames &frames)
+{
+	unsigned int n = frames.frames();
+	StkFloat *__restrict src;
+	StkFloat *__restrict dst;
+	StkFloat gain;
+	unsigned int i;
+
+	for (const struct chain_op &op : chain->plan) {
+		dst = chain_buffer(chain, frames, op.dst);
+
+		switch (op.type) {
+		case CHAIN_RUN:
+			if (op.dst) {
+				StkFramesView view(dst, n);
+				run_node(chain->nodes[op.node], view);
+			} else {
+				run_node(chain->nodes[op.node], frames);
+			}
+			break;
+		case CHAIN_BANK: {
+			struct effect_node *node = chain->nodes[op.node];
+			unsigned int filters = node->outputs.size();
+			StkFramesView input(dst, n);
+			StkFramesView output(&node->aux[0], n, filters);
+
+			static_cast<FirBank *>(node->object)->tick(input, output);
+			for (unsigned int k = 0; k < filters; k++) {
+				dst = chain_buffer(chain, frames, node->outputs[k]);
+				for (i = 0; i < n; i++)
+					dst[i] = output[i * filters + k];
+			}
+			break;
+		}
+		case CHAIN_COPY:
+			src = chain_buffer(chain, frames, op.src);
+			for (i = 0; i < n; i++)
+				dst[i] = src[i];
+			break;
+		case CHAIN_ADD:
+			src = chain_buffer(chain, frames, op.src);
+			for (i = 0; i < n; i++)
+				dst[i] += src[i];
+			break;
+		case CHAIN_SCALE:
+			gain = op.gain;
+			for (i = 0; i < n; i++)
+				dst[i] *= gain;
+			break;
+		case CHAIN_BLEND:
+			src = chain_buffer(chain, frames, op.src);
+			gain = op.gain;
+			for (i = 0; i < n; i++)
+				dst[i] = src[i] + gain * (dst[i] - src[i]);
+			break;
+		}
+	}
+}
+
+void effect_chain_clear(struct effect_chain *chain)
+{
+	for (unsigned int i = 0; i < chain->nodes.size(); i++)
+		clear_node(chain->nodes[i]);
+}
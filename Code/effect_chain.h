@@ -0,0 +1,79 @@
+#ifndef EFFECT_CHAIN_H
+#define EFFECT_CHAIN_H
+
+#include <vector>
+#include <stk/Stk.h>
+
+struct audio_stream;
+
+/* Serial/parallel effect chains.
+ *
+ * A chain is written as effect names separated by commas, run one after
+ * the other.  Parentheses hold parallel branches separated by '|'; each
+ * branch is a chain of its own and their outputs are averaged.  Any
+ * effect or group may end in @wet, a wet/dry mix from 0 to 1:
+ *
+ *   filter_0_4000Hz,(echo|modulator,distortion)@0.5,convolution@0.3
+ *
+ * Names are the effect_str[] names, and no_effect passes its input, so
+ * (no_effect|echo) is a half dry echo.  Any filter_A_BHz name is also a
+ * filter, not only those of the effect list, see filter_design.h.  Each
+ * name gets its own STK object and state.
+ *
+ * effect_chain_create() compiles the chain once into a flat list of block
+ * operations on preallocated period buffers.  A period is one pass over
+ * that list: one tick(StkFrames&) call per effect and plain loops for the
+ * copies and mixes, nothing is allocated and nothing is dispatched per
+ * sample.
+ *
+ * When at least FIR_BANK_FILTERS branches of a group start with a
+ * linear-phase filter that runs at the full rate, those filters share one
+ * stk::FirBank: a single pass over the group's input writes the start of
+ * each branch.
+ */
+
+// custom_chain when -e is not given
+#define DEFAULT_CHAIN "filter_0_4000Hz,(no_effect|echo),distortion@0.3"
+
+/* Fewest filters worth a bank.  Below this, separate filters vectorize
+ * along their own taps and beat the shared pass.
+ */
+#define FIR_BANK_FILTERS 4
+// most taps a bank may run, zero padding included, per tap of its filters
+#define FIR_BANK_PADDING 1.25
+
+enum chain_op_type {
+	CHAIN_RUN,	// run node in place on dst
+	CHAIN_COPY,	// dst = src
+	CHAIN_ADD,	// dst += src
+	CHAIN_SCALE,	// dst *= gain
+	CHAIN_BLEND,	// dst = gain * dst + (1 - gain) * src
+	CHAIN_BANK,	// run bank node on src, filter k to buffer outputs[k]
+};
+
+struct chain_op {
+	enum chain_op_type type;
+	unsigned int node;
+	unsigned int src;	// buffer 0 is the period being processed
+	unsigned int dst;
+	stk::StkFloat gain;
+};
+
+struct effect_node;
+
+struct effect_chain {
+	std::vector<struct effect_node *> nodes;
+	std::vector<struct chain_op> plan;
+	std::vector<stk::StkFrames> buffers;	// buffer n is buffers[n - 1]
+	unsigned long warmup;			// history of all nodes, in samples
+};
+
+// NULL and a message on stderr when spec does not parse
+struct effect_chain *effect_chain_create(struct audio_stream *stream, const char *spec);
+void effect_chain_destroy(struct effect_chain *chain);
+
+// audio thread, frames holds at most frame_size frames
+void effect_chain_process(struct effect_chain *chain, stk::StkFrames &frames);
+void effect_chain_clear(struct effect_chain *chain);
+
+#endif
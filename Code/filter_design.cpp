@@ -0,0 +1,247 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <string>
+#include <algorithm>
+
+#include <stk/FirDesign.h>
+#include <stk/IirDesign.h>
+#include <stk/MultirateFir.h>
+
+#include "filter_design.h"
+
+using namespace stk;
+
+// the effect list filters, as designed for 44.1 kHz at http://t-filter.appspot.com
+static const struct {
+	double low, high, transition;
+} named_filters[] = {
+	{ 0, 500, 700 },
+	{ 0, 2000, 1000 },
+	{ 0, 4000, 1000 },
+	{ 2000, 3000, 1000 },
+	{ 2000, 6000, 1000 },
+	{ 2500, 22050, 500 },
+};
+
+int filter_spec_parse(const char *name, size_t len, struct filter_spec *spec)
+{
+	std::string s(name, len);
+	char *end;
+
+	if (s.compare(0, 7, "filter_") || len < 10 || s.compare(len - 2, 2, "Hz"))
+		return 0;
+
+	spec->low = strtod(s.c_str() + 7, &end);
+	if (end == s.c_str() + 7 || *end != '_')
+		return 0;
+	const char *b = end + 1;
+	spec->high = strtod(b, &end);
+	if (end == b || end != s.c_str() + len - 2)
+		return 0;
+	if (spec->low < 0.0 || spec->high <= spec->low)
+		return 0;
+
+	spec->transition = FIR_TRANSITION;
+	spec->attenuation = FIR_ATTENUATION;
+	spec->ripple = FIR_RIPPLE;
+	spec->kaiser = 0;
+	spec->minimum_phase = 0;
+
+	for (unsigned int i = 0; i < sizeof(named_filters) / sizeof(named_filters[0]); i++) {
+		if (named_filters[i].low == spec->low && named_filters[i].high == spec->high)
+			spec->transition = named_filters[i].transition;
+	}
+	return 1;
+}
+
+static std::string cache_dir(void)
+{
+	const char *env;
+	std::string dir;
+
+	if ((env = getenv("MYSYNTH_FIR_CACHE")) && *env)
+		return env;
+	if ((env = getenv("XDG_CACHE_HOME")) && *env)
+		dir = env;
+	else if ((env = getenv("HOME")) && *env)
+		dir = std::string(env) + "/.cache";
+	else
+		return "";
+
+	mkdir(dir.c_str(), 0755);
+	return dir + "/mysynth";
+}
+
+static int cache_read(const std::string &path, std::vector<StkFloat> &taps)
+{
+	FILE *f = fopen(path.c_str(), "r");
+	unsigned int n, i;
+	double tap;
+
+	if (!f)
+		return -1;
+	if (fscanf(f, "%u", &n) != 1 || n == 0 || n > 65536) {
+		fclose(f);
+		return -1;
+	}
+	taps.resize(n);
+	for (i = 0; i < n && fscanf(f, "%lg", &tap) == 1; i++)
+		taps[i] = tap;
+	fclose(f);
+	return i == n ? 0 : -1;
+}
+
+// written to a temporary name first, so a reader never sees half a file
+static void cache_write(const std::string &dir, const std::string &path,
+			const std::vector<StkFloat> &taps)
+{
+	std::string tmp = path + "." + std::to_string(getpid());
+	FILE *f;
+
+	if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST)
+		return;
+	f = fopen(tmp.c_str(), "w");
+	if (!f)
+		return;
+
+	fprintf(f, "%zu\n", taps.size());
+	for (unsigned int i = 0; i < taps.size(); i++)
+		fprintf(f, "%.17g\n", (double)taps[i]);
+
+	if (fclose(f) != 0 || rename(tmp.c_str(), path.c_str()) < 0)
+		unlink(tmp.c_str());
+}
+
+// taps for one rate, from the cache when it has them
+static int design_taps(const struct filter_spec *spec, FirDesign::Type type, double f1,
+		       double transition, double rate, std::vector<StkFloat> &taps)
+{
+	std::string dir, path;
+	char name[160];
+
+	snprintf(name, sizeof(name), "fir%u-%s-%d-%g-%g-%g-%g-%g-%g.txt",
+		 FirDesign::REVISION, spec->kaiser ? "kaiser" : "remez", (int)type, spec->low, spec->high,
+		 transition, spec->attenuation, spec->ripple, rate);
+	dir = cache_dir();
+	if (!dir.empty()) {
+		path = dir + "/" + name;
+		if (cache_read(path, taps) == 0)
+			return 0;
+	}
+
+	try {
+		if (spec->kaiser)
+			taps = FirDesign::windowedSinc(type, f1, spec->high, transition,
+						       spec->attenuation, rate);
+		else
+			taps = FirDesign::equiripple(type, f1, spec->high, transition,
+						     spec->attenuation, spec->ripple, rate);
+	} catch (StkError &) {
+		fprintf(stderr, "cannot design filter %g-%g Hz at %g Hz\n",
+			spec->low, spec->high, rate);
+		return -1;
+	}
+
+	if (!path.empty())
+		cache_write(dir, path, taps);
+	return 0;
+}
+
+/* The filter type for spec, its lower edge for FirDesign and its
+ * transition band, narrowed to fit the rate.
+ */
+static int filter_type(const struct filter_spec *spec, unsigned int rate,
+		       FirDesign::Type *type, double *f1, double *transition)
+{
+	double nyquist = rate / 2.0;
+	double low = spec->low, high = spec->high;
+
+	*f1 = low;
+	*transition = spec->transition;
+	if (low == 0.0) {
+		*type = FirDesign::LOWPASS;
+		*f1 = high;
+		*transition = std::min(*transition, (nyquist - high) / 2);
+	} else if (high + *transition / 2 >= nyquist) {
+		*type = FirDesign::HIGHPASS;
+		*transition = std::min(*transition, low / 2);
+	} else {
+		*type = FirDesign::BANDPASS;
+		*transition = std::min(*transition, std::min(low, nyquist - high) / 2);
+	}
+	if (*transition <= 0.0) {
+		fprintf(stderr, "filter %g-%g Hz does not fit a %u Hz rate\n", low, high, rate);
+		return -1;
+	}
+	return 0;
+}
+
+// long enough to pay for the half-band stages, and nothing to keep up high
+static unsigned int multirate_stages(const struct filter_spec *spec, FirDesign::Type type,
+				     double transition, size_t taps, unsigned int rate)
+{
+	if (spec->minimum_phase || type == FirDesign::HIGHPASS || taps <= FIR_MULTIRATE_TAPS)
+		return 0;
+	return MultirateFir::stagesFor(spec->high + transition, rate);
+}
+
+int filter_design(const struct filter_spec *spec, unsigned int rate, MultirateFir *fir)
+{
+	std::vector<StkFloat> taps;
+	FirDesign::Type type;
+	unsigned int stages;
+	double f1, transition;
+
+	if (filter_type(spec, rate, &type, &f1, &transition) < 0 ||
+	    design_taps(spec, type, f1, transition, rate, taps) < 0)
+		return -1;
+
+	stages = multirate_stages(spec, type, transition, taps.size(), rate);
+	if (stages > 0 &&
+	    design_taps(spec, type, f1, transition, (double)rate / (1 << stages), taps) < 0)
+		return -1;
+
+	fir->setStages(stages, spec->high + transition, spec->attenuation + FIR_MULTIRATE_MARGIN, rate);
+	fir->setCoefficients(taps, true);
+	fir->setMinimumPhase(spec->minimum_phase);
+	return 0;
+}
+
+int filter_taps(const struct filter_spec *spec, unsigned int rate, std::vector<StkFloat> &taps)
+{
+	FirDesign::Type type;
+	double f1, transition;
+
+	if (filter_type(spec, rate, &type, &f1, &transition) < 0 ||
+	    design_taps(spec, type, f1, transition, rate, taps) < 0)
+		return -1;
+
+	if (multirate_stages(spec, type, transition, taps.size(), rate) > 0)
+		return 1;
+	if (spec->minimum_phase && taps.size() > 1)
+		taps = SymmetricFir::minimumPhase(taps);
+	return 0;
+}
+
+int filter_design_iir(const struct filter_spec *spec, unsigned int rate, Sos *sos)
+{
+	FirDesign::Type type;
+	double f1, transition;
+
+	if (filter_type(spec, rate, &type, &f1, &transition) < 0)
+		return -1;
+
+	try {
+		sos->setSections(IirDesign::chebyshev(type, f1, spec->high, transition,
+						       spec->attenuation, spec->ripple, rate), true);
+	} catch (StkError &) {
+		fprintf(stderr, "cannot design IIR filter %g-%g Hz at %u Hz\n",
+			spec->low, spec->high, rate);
+		return -1;
+	}
+	return 0;
+}
@@ -0,0 +1,68 @@
+#ifndef FILTER_DESIGN_H
+#define FILTER_DESIGN_H
+
+#include <stddef.h>
+#include <stk/MultirateFir.h>
+#include <stk/Sos.h>
+
+/* FIR filters designed at startup.
+ *
+ * An effect named filter_A_BHz passes A to B Hz: a lowpass when A is 0,
+ * a highpass when B is within half a transition band of Nyquist, a
+ * bandpass otherwise.  The taps are designed for the stream's own sample
+ * rate with stk::FirDesign, equiripple unless -k asks for a Kaiser
+ * window.  The six filters of the effect list keep the transition bands
+ * they were first designed with; other names get FIR_TRANSITION Hz,
+ * narrowed where it would not fit.
+ *
+ * A lowpass or bandpass filter longer than FIR_MULTIRATE_TAPS runs in an
+ * stk::MultirateFir: decimated by 2 as often as its highest band edge
+ * allows, filtered by a shorter design for the reduced rate and
+ * interpolated back.  Shorter filters cost less at the full rate than
+ * the half-band stages do.
+ *
+ * A design is cached as a text file named after its parameters and
+ * stk::FirDesign::REVISION, in $MYSYNTH_FIR_CACHE, else
+ * $XDG_CACHE_HOME/mysynth, else ~/.cache/mysynth, so later runs read
+ * the taps instead of running the Remez exchange again, and taps from
+ * an older design revision are never reused.
+ *
+ * With -i the same specifications are met by Chebyshev IIR filters
+ * instead, stk::IirDesign sections in an stk::Sos: a few dozen
+ * multiplies a sample where the FIRs need hundreds, but the phase is no
+ * longer linear.
+ */
+
+#define FIR_RIPPLE	5.0	// passband ripple, dB
+#define FIR_ATTENUATION	40.0	// stopband attenuation, dB
+#define FIR_TRANSITION	1000.0	// Hz
+
+#define FIR_MULTIRATE_TAPS	96
+#define FIR_MULTIRATE_MARGIN	10.0	// dB more for the half-band stages
+
+struct filter_spec {
+	double low;		// passband, Hz
+	double high;
+	double transition;
+	double attenuation;
+	double ripple;
+	int kaiser;		// windowed sinc instead of equiripple
+	int minimum_phase;	// full rate and minimum phase, see stk::SymmetricFir
+};
+
+// 0 when the len characters at name are not a filter_A_BHz name
+int filter_spec_parse(const char *name, size_t len, struct filter_spec *spec);
+
+// set up fir for rate, -1 and a message on stderr on failure
+int filter_design(const struct filter_spec *spec, unsigned int rate, stk::MultirateFir *fir);
+
+/* The full rate taps of spec, minimum phase if asked, for running it in
+ * an stk::FirBank.  1 when filter_design() would decimate it instead, -1
+ * and a message on stderr on failure.
+ */
+int filter_taps(const struct filter_spec *spec, unsigned int rate, std::vector<stk::StkFloat> &taps);
+
+// set up sos as the Chebyshev IIR filter for spec, -1 and a message on stderr on failure
+int filter_design_iir(const struct filter_spec *spec, unsigned int rate, stk::Sos *sos);
+
+#endif
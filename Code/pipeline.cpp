@@ -0,0 +1,275 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+
+#include "MySynth.h"
+#include "pipeline.h"
+#include "rt_alloc_guard.h"
+#include "control.h"
+#include "telemetry.h"
+
+static inline short *period_buffer(struct pipeline *p, unsigned int index)
+{
+	return p->buffers + index * p->stream->frame_size * p->stream->channels;
+}
+
+// tell every stage to stop and wake the ones waiting on a ring
+static void pipeline_stop(struct pipeline *p)
+{
+	p->running.store(0, std::memory_order_release);
+	sem_post(&p->captured_ready);
+	sem_post(&p->processed_ready);
+}
+
+static int ring_wait(struct pipeline *p, sem_t *ready)
+{
+	while (sem_wait(ready) == -1) {
+		if (errno != EINTR) {
+			perror("sem_wait():");
+			return -1;
+		}
+	}
+	return p->running.load(std::memory_order_acquire) ? 0 : -1;
+}
+
+// queue the capture period plus latency_periods of silence and start playback
+static int prime_playback(struct pipeline *p)
+{
+	struct audio_stream *stream = p->stream;
+	unsigned int i;
+	int err;
+
+	for (i = 0; i < stream->latency_periods + 1; i++) {
+		err = playback_callback(stream->frame_size, p->silence);
+		if (err < 0)
+			return err;
+	}
+
+	err = snd_pcm_start(playback_handle);
+	if (err < 0)
+		fprintf(stderr, "cannot start playback (%s)\n", snd_strerror(err));
+	return err;
+}
+
+// below the I/O threads, but still realtime when they are
+static int dsp_priority(struct audio_stream *stream)
+{
+	if (stream->rt_priority <= 0)
+		return 0;
+	return std::max(stream->rt_priority - PIPELINE_DSP_BELOW, 1);
+}
+
+static void *capture_thread(void *args)
+{
+	struct pipeline *p = (struct pipeline *)args;
+	struct audio_stream *stream = p->stream;
+	unsigned int epoch = 0;
+	unsigned char index;
+	int held = 0;
+	short *buf;
+	int err;
+
+	stk::Realtime::setupThread(stream->rt_priority, stream->rt_cpu);
+
+	while (p->running.load(std::memory_order_acquire)) {
+		if (p->resync.load(std::memory_order_acquire) != epoch) {
+			epoch = p->resync.load(std::memory_order_acquire);
+			snd_pcm_drop(capture_handle);
+			err = snd_pcm_prepare(capture_handle);
+			if (err == 0)
+				err = snd_pcm_start(capture_handle);
+			if (err < 0) {
+				fprintf(stderr, "capture restart failed (%s)\n", snd_strerror(err));
+				break;
+			}
+		}
+
+		if (!held)
+			held = p->free.pop(index);
+		buf = held ? period_buffer(p, index) : p->scratch;
+
+		err = capture_callback(stream->frame_size, buf);
+		if (err == -EPIPE || err == -ESTRPIPE) {
+			p->xruns.fetch_add(1, std::memory_order_relaxed);
+			err = snd_pcm_recover(capture_handle, err, 1);
+			if (err == 0)
+				err = snd_pcm_start(capture_handle);
+			if (err == 0)
+				continue;
+		}
+		if (err < 0) {
+			fprintf(stderr, "capture stage failed (%s)\n", snd_strerror(err));
+			break;
+		}
+
+		if (!held) {
+			// DSP and playback hold every buffer, this period is lost
+			p->dropped.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+		p->epoch[index] = epoch;
+		p->captured.push(index);
+		sem_post(&p->captured_ready);
+		held = 0;
+	}
+
+	pipeline_stop(p);
+	return NULL;
+}
+
+static void *dsp_thread(void *args)
+{
+	struct pipeline *p = (struct pipeline *)args;
+	struct audio_stream *stream = p->stream;
+	unsigned long long start;
+	unsigned int dsp_ns;
+	unsigned int xruns_seen = 0;
+	unsigned char index;
+	short *buf;
+
+	stk::Realtime::setupThread(dsp_priority(stream), stream->rt_cpu);
+
+	while (ring_wait(p, &p->captured_ready) == 0) {
+		if (!p->captured.pop(index))
+			continue;
+		buf = period_buffer(p, index);
+
+		control_apply(stream);
+
+		start = telemetry_clock();
+		rt_alloc_guard_enter();
+		applyEffect(stream, buf, buf, stream->frame_size);
+		rt_alloc_guard_leave();
+		dsp_ns = telemetry_clock() - start;
+
+		p->processed.push(index);
+		sem_post(&p->processed_ready);
+
+		// the I/O threads count xruns, telemetry is fed from here only
+		while (xruns_seen != p->xruns.load(std::memory_order_relaxed)) {
+			telemetry_xrun(stream->telemetry);
+			xruns_seen++;
+		}
+		if (stream->telemetry)
+			telemetry_period(stream, dsp_ns);
+	}
+
+	pipeline_stop(p);
+	return NULL;
+}
+
+static void *playback_thread(void *args)
+{
+	struct pipeline *p = (struct pipeline *)args;
+	struct audio_stream *stream = p->stream;
+	unsigned int epoch = 0;
+	unsigned char index;
+	int err;
+
+	stk::Realtime::setupThread(stream->rt_priority, stream->rt_cpu);
+
+	while (ring_wait(p, &p->processed_ready) == 0) {
+		if (!p->processed.pop(index))
+			continue;
+
+		// captured before the last resync, too late to be played
+		if (p->epoch[index] != epoch) {
+			p->free.push(index);
+			continue;
+		}
+
+		err = playback_callback(stream->frame_size, period_buffer(p, index));
+		p->free.push(index);
+
+		if (err == -EPIPE || err == -ESTRPIPE) {
+			p->xruns.fetch_add(1, std::memory_order_relaxed);
+
+			// start over from fresh input, with the latency primed
+			p->resync.store(++epoch, std::memory_order_release);
+
+			err = snd_pcm_recover(playback_handle, err, 1);
+			if (err == 0)
+				err = prime_playback(p);
+		}
+		if (err < 0) {
+			fprintf(stderr, "playback stage failed (%s)\n", snd_strerror(err));
+			break;
+		}
+	}
+
+	pipeline_stop(p);
+	return NULL;
+}
+
+// each stage sets up its own priority and CPU, see stk::Realtime
+static int start_stage(pthread_t *thread, void *(*fn)(void *), void *args)
+{
+	int err;
+
+	err = pthread_create(thread, NULL, fn, args);
+	if (err)
+		fprintf(stderr, "pthread_create(): %s\n", strerror(err));
+	return err;
+}
+
+int run_pipeline(struct audio_stream *stream)
+{
+	struct pipeline *p = new pipeline;
+	size_t period = stream->frame_size * stream->channels;
+	pthread_t capture, dsp, playback;
+	unsigned int i;
+	int err;
+
+	p->stream = stream;
+	// one period being captured, one in the DSP, one being written
+	p->nbuffers = stream->latency_periods + 3;
+	p->buffers = (short *)calloc((p->nbuffers + 2) * period, sizeof(short));
+	if (!p->buffers) {
+		perror("calloc():");
+		delete p;
+		return -1;
+	}
+	p->scratch = p->buffers + p->nbuffers * period;
+	p->silence = p->scratch + period;
+	snd_pcm_format_set_silence(stream->format, p->silence, period);
+
+	for (i = 0; i < p->nbuffers; i++)
+		p->free.push(i);
+	sem_init(&p->captured_ready, 0, 0);
+	sem_init(&p->processed_ready, 0, 0);
+	p->running.store(1, std::memory_order_relaxed);
+	p->resync.store(0, std::memory_order_relaxed);
+	p->xruns.store(0, std::memory_order_relaxed);
+	p->dropped.store(0, std::memory_order_relaxed);
+
+	// both handles start here, back to back
+	err = prime_playback(p);
+	if (err == 0)
+		err = snd_pcm_start(capture_handle);
+	if (err < 0) {
+		fprintf(stderr, "cannot start the pipeline (%s)\n", snd_strerror(err));
+		free(p->buffers);
+		delete p;
+		return err;
+	}
+
+	if (start_stage(&playback, playback_thread, p) ||
+	    start_stage(&dsp, dsp_thread, p) ||
+	    start_stage(&capture, capture_thread, p))
+		exit(1);
+
+	pthread_join(capture, NULL);
+	pthread_join(dsp, NULL);
+	pthread_join(playback, NULL);
+
+	fprintf(stderr, "pipeline stopped, %u xruns, %u periods dropped\n",
+			p->xruns.load(), p->dropped.load());
+
+	sem_destroy(&p->captured_ready);
+	sem_destroy(&p->processed_ready);
+	free(p->buffers);
+	delete p;
+	return 0;
+}
@@ -0,0 +1,65 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <atomic>
+
+#include "spsc_ring.h"
+
+struct audio_stream;
+
+/* Three-stage capture -> DSP -> playback pipeline.
+ *
+ * A capture thread and a playback thread at the -r SCHED_FIFO priority
+ * own one handle each and only move periods; a DSP thread between them,
+ * PIPELINE_DSP_BELOW lower, runs control_apply() and applyEffect().  All
+ * three run on the -a CPU.  Periods travel as buffer indices through
+ * three wait-free rings:
+ *
+ *   free --> capture --> captured --> DSP --> processed --> playback --+
+ *    ^                                                                 |
+ *    +-----------------------------------------------------------------+
+ *
+ * Playback is primed with one period of silence for the period being
+ * captured plus latency_periods more, so a DSP period may run that many
+ * periods late before anything is heard, and capture never waits on the
+ * DSP.  When no free buffer is left the captured period is dropped and
+ * counted.  An xrun on capture restarts capture.  An xrun on playback
+ * primes playback again and has capture restart too; periods captured
+ * before that restart are skipped so they do not stay in the latency.
+ *
+ * The DSP thread is the audio thread as far as control and telemetry
+ * are concerned.
+ */
+
+#define PIPELINE_MAX_PERIODS	8
+#define PIPELINE_SLOTS		16	// ring size, more than the buffers
+
+#define PIPELINE_DSP_BELOW	10	// DSP priority under the I/O threads
+
+struct pipeline {
+	struct audio_stream *stream;
+
+	short *buffers;		// nbuffers periods
+	unsigned int nbuffers;
+	short *scratch;		// capture target when no buffer is free
+	short *silence;		// one period for priming playback
+
+	spsc_ring<unsigned char, PIPELINE_SLOTS> free;		// playback -> capture
+	spsc_ring<unsigned char, PIPELINE_SLOTS> captured;	// capture -> DSP
+	spsc_ring<unsigned char, PIPELINE_SLOTS> processed;	// DSP -> playback
+	sem_t captured_ready;
+	sem_t processed_ready;
+
+	std::atomic<int> running;
+	std::atomic<unsigned int> resync;	// capture restarts requested by playback
+	unsigned int epoch[PIPELINE_SLOTS];	// resync count when a buffer was captured
+	std::atomic<unsigned int> xruns;	// capture and playback threads
+	std::atomic<unsigned int> dropped;	// capture thread
+};
+
+// start the three threads and wait for them to stop
+int run_pipeline(struct audio_stream *stream);
+
+#endif
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "MySynth.h"
+#include "recovery.h"
+#include "telemetry.h"
+
+int recovery_init(struct recovery *r, struct audio_stream *stream)
+{
+	snd_pcm_uframes_t ring;
+	int err;
+
+	err = snd_pcm_hw_params_malloc(&r->hw_params);
+	if (err < 0) {
+		fprintf(stderr, "cannot allocate hardware parameter structure (%s)\n",
+				snd_strerror(err));
+		return err;
+	}
+
+	err = snd_pcm_hw_params_current(playback_handle, r->hw_params);
+	if (err < 0) {
+		fprintf(stderr, "cannot read playback hardware parameters (%s)\n",
+				snd_strerror(err));
+		return err;
+	}
+	snd_pcm_hw_params_get_buffer_size(r->hw_params, &ring);
+	r->ring_periods = ring / stream->frame_size;
+
+	if (stream->io_mode == IO_MMAP) {
+		r->min_periods = stream->latency_periods;
+		// the ring is resized when the latency outgrows it
+		r->max_periods = RECOVERY_MAX_PERIODS;
+	} else {
+		r->min_periods = RW_START_PERIODS;
+		// writei needs a free period on top of the queued ones
+		r->max_periods = std::min(r->ring_periods - 1, (unsigned int)RECOVERY_MAX_PERIODS);
+	}
+	r->max_periods = std::max(r->max_periods, r->min_periods);
+	r->periods = r->min_periods;
+
+	r->xruns = 0;
+	r->burst = 0;
+	r->last_xrun_ns = 0;
+	r->stable_periods = 0;
+	r->lower_after = (unsigned long long)RECOVERY_STABLE_MS * stream->sample_rate /
+			 1000 / stream->frame_size;
+
+	stream->recovery = r;
+	return 0;
+}
+
+// wait for a suspended handle to come back, prepare covers a failed resume
+static void pcm_resume(snd_pcm_t *handle)
+{
+	if (snd_pcm_state(handle) != SND_PCM_STATE_SUSPENDED)
+		return;
+
+	while (snd_pcm_resume(handle) == -EAGAIN)
+		sleep(1);
+}
+
+static int set_start_threshold(struct audio_stream *stream, snd_pcm_uframes_t frames)
+{
+	int err;
+
+	err = snd_pcm_sw_params_current(playback_handle, stream->sw_playback_params);
+	if (err < 0)
+		return err;
+	err = snd_pcm_sw_params_set_start_threshold(playback_handle,
+						    stream->sw_playback_params, frames);
+	if (err < 0)
+		return err;
+	return snd_pcm_sw_params(playback_handle, stream->sw_playback_params);
+}
+
+/* Give the mmap playback ring room for periods queued periods plus the one
+ * being written.  Period size and rate stay as negotiated, the link is
+ * taken down for the change and put back afterwards.
+ */
+static int resize_ring(struct audio_stream *stream, unsigned int periods)
+{
+	struct recovery *r = stream->recovery;
+	snd_pcm_hw_params_t *hw = r->hw_params;
+	snd_pcm_uframes_t period = stream->frame_size;
+	snd_pcm_uframes_t boundary;
+	unsigned int rate = stream->sample_rate;
+	int err;
+
+	if (stream->linked)
+		snd_pcm_unlink(playback_handle);
+
+	if ((err = snd_pcm_hw_params_any(playback_handle, hw)) < 0 ||
+	    (err = snd_pcm_hw_params_set_access(playback_handle, hw, SND_PCM_ACCESS_MMAP_INTERLEAVED)) < 0 ||
+	    (err = snd_pcm_hw_params_set_format(playback_handle, hw, stream->format)) < 0 ||
+	    (err = snd_pcm_hw_params_set_rate_near(playback_handle, hw, &rate, 0)) < 0 ||
+	    (err = snd_pcm_hw_params_set_channels(playback_handle, hw, stream->channels)) < 0 ||
+	    (err = snd_pcm_hw_params_set_period_size_near(playback_handle, hw, &period, NULL)) < 0 ||
+	    (err = snd_pcm_hw_params_set_periods_near(playback_handle, hw, &periods, NULL)) < 0 ||
+	    (err = snd_pcm_hw_params(playback_handle, hw)) < 0) {
+		fprintf(stderr, "cannot resize playback ring (%s)\n", snd_strerror(err));
+		return err;
+	}
+
+	if (rate != stream->sample_rate || period != stream->frame_size) {
+		fprintf(stderr, "playback ring resize changed rate %u or period %lu\n",
+				rate, period);
+		return -EINVAL;
+	}
+	r->ring_periods = periods;
+
+	// new hardware parameters reset the software ones
+	snd_pcm_sw_params_current(playback_handle, stream->sw_playback_params);
+	snd_pcm_sw_params_get_boundary(stream->sw_playback_params, &boundary);
+	snd_pcm_sw_params_set_avail_min(playback_handle, stream->sw_playback_params, period);
+	err = set_start_threshold(stream, boundary);
+	if (err < 0) {
+		fprintf(stderr, "cannot set software parameters (%s)\n", snd_strerror(err));
+		return err;
+	}
+
+	if (stream->linked && snd_pcm_link(capture_handle, playback_handle) < 0) {
+		fprintf(stderr, "cannot relink capture and playback, starting them separately\n");
+		stream->linked = 0;
+	}
+
+	return 0;
+}
+
+/* Restart the stopped pair with periods of silence queued for playback. */
+static int restart(struct audio_stream *stream, unsigned int periods)
+{
+	struct recovery *r = stream->recovery;
+	snd_pcm_sframes_t written;
+	unsigned int i;
+	int err;
+
+	if (stream->io_mode == IO_MMAP && periods + 1 > r->ring_periods) {
+		err = resize_ring(stream, periods + 1);
+		if (err < 0)
+			return err;
+	}
+
+	// rw playback starts itself once the silence is queued
+	if (stream->io_mode == IO_RW) {
+		err = set_start_threshold(stream, periods * stream->frame_size);
+		if (err < 0) {
+			fprintf(stderr, "cannot set start threshold (%s)\n", snd_strerror(err));
+			return err;
+		}
+	}
+
+	if ((err = snd_pcm_prepare(playback_handle)) < 0 ||
+	    (err = snd_pcm_prepare(capture_handle)) < 0) {
+		fprintf(stderr, "cannot prepare audio interface for use (%s)\n",
+				snd_strerror(err));
+		return err;
+	}
+
+	r->periods = periods;
+
+	if (stream->io_mode == IO_MMAP) {
+		stream->latency_periods = periods;
+		return mmap_start(stream);
+	}
+
+	snd_pcm_format_set_silence(stream->format, stream->buffer,
+				   stream->frame_size * stream->channels);
+	for (i = 0; i < periods; i++) {
+		written = snd_pcm_writei(playback_handle, stream->buffer, stream->frame_size);
+		if (written < 0) {
+			fprintf(stderr, "cannot prime playback (%s)\n", snd_strerror(written));
+			return written;
+		}
+	}
+
+	err = snd_pcm_start(capture_handle);
+	if (err < 0) {
+		fprintf(stderr, "cannot start capture (%s)\n", snd_strerror(err));
+		return err;
+	}
+
+	return 0;
+}
+
+int xrun_recover(struct audio_stream *stream, int err)
+{
+	struct recovery *r = stream->recovery;
+	unsigned long long now = telemetry_clock();
+	unsigned int periods = r->periods;
+	int cause = err;
+
+	if (err != -EPIPE && err != -ESTRPIPE)
+		return err;
+
+	telemetry_xrun(stream->telemetry);
+	r->xruns++;
+
+	if (err == -ESTRPIPE) {
+		pcm_resume(capture_handle);
+		pcm_resume(playback_handle);
+	}
+
+	// stop both so they restart on the same period boundary
+	snd_pcm_drop(playback_handle);
+	snd_pcm_drop(capture_handle);
+
+	if (r->last_xrun_ns && now - r->last_xrun_ns < RECOVERY_BURST_MS * 1000000ULL)
+		r->burst++;
+	else
+		r->burst = 1;
+	r->last_xrun_ns = now;
+	r->stable_periods = 0;
+
+	if (r->burst >= RECOVERY_BURST_XRUNS && periods < r->max_periods) {
+		periods++;
+		r->burst = 0;
+	}
+
+	err = restart(stream, periods);
+	if (err < 0)
+		return err;
+
+	fprintf(stderr, "%s %u recovered, playback latency %u periods\n",
+			cause == -ESTRPIPE ? "suspend" : "xrun", r->xruns, r->periods);
+	return 0;
+}
+
+int recovery_period(struct audio_stream *stream)
+{
+	struct recovery *r = stream->recovery;
+
+	if (r->periods <= r->min_periods)
+		return 0;
+
+	if (++r->stable_periods < r->lower_after)
+		return 0;
+
+	r->stable_periods = 0;
+	r->periods--;
+	if (stream->io_mode == IO_MMAP)
+		stream->latency_periods = r->periods;
+
+	fprintf(stderr, "no xruns for %d s, playback latency %u periods\n",
+			RECOVERY_STABLE_MS / 1000, r->periods);
+	return 1;
+}
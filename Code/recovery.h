@@ -0,0 +1,56 @@
+#ifndef RECOVERY_H
+#define RECOVERY_H
+
+#include <alsa/asoundlib.h>
+
+struct audio_stream;
+
+/* Xrun recovery and adaptive playback latency.
+ *
+ * An overrun on capture or an underrun on playback (-EPIPE), or a system
+ * suspend (-ESTRPIPE), no longer ends the program.  Both handles are
+ * stopped and prepared, playback is primed with silence and the pair is
+ * started again, so capture and playback come back in step.
+ *
+ * The silence primed on restart is the playback latency in periods.  Two
+ * xruns less than RECOVERY_BURST_MS apart add a period, up to what the
+ * playback ring can hold (mmap mode grows the ring when it has to).
+ * After RECOVERY_STABLE_MS without an xrun one period is taken back by
+ * not playing one captured period, down to the latency asked for at
+ * start.
+ */
+
+#define RECOVERY_BURST_MS	10000	// xruns closer than this raise the latency
+#define RECOVERY_BURST_XRUNS	2	// ... once this many have been seen
+#define RECOVERY_STABLE_MS	60000	// clean time before lowering it again
+#define RECOVERY_MAX_PERIODS	8
+
+struct recovery {
+	unsigned int periods;		// playback latency now
+	unsigned int min_periods;	// the latency asked for at start
+	unsigned int max_periods;
+	unsigned int ring_periods;	// playback ring size in periods
+
+	unsigned int xruns;		// recovered so far
+	unsigned int burst;		// xruns in the current burst
+	unsigned long long last_xrun_ns;
+	unsigned long stable_periods;	// periods since the last xrun
+	unsigned long lower_after;	// RECOVERY_STABLE_MS in periods
+
+	snd_pcm_hw_params_t *hw_params;	// for resizing the playback ring
+};
+
+// after open_and_init(), reads the negotiated playback ring
+int recovery_init(struct recovery *r, struct audio_stream *stream);
+
+/* audio thread: bring both handles back after err.  Returns 0 when the
+ * stream runs again, err when it was not an xrun or the restart failed.
+ */
+int xrun_recover(struct audio_stream *stream, int err);
+
+/* audio thread, once per period: returns 1 when the output of this
+ * period should be dropped to lower the latency by one period.
+ */
+int recovery_period(struct audio_stream *stream);
+
+#endif
@@ -0,0 +1,98 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "rt_alloc_guard.h"
+
+#ifdef RT_ALLOC_DEBUG
+
+/* glibc entry points behind malloc() and friends.  Defining malloc() in
+ * the executable interposes it for the whole process, including libstk
+ * and libstdc++'s operator new, and we forward to these.
+ */
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+}
+
+static __thread int rt_section;
+
+static void rt_alloc_abort(const char *what)
+{
+	// no stdio here, it may allocate
+	static const char msg[] = "rt_alloc_guard: audio thread called ";
+
+	rt_section = 0;
+	write(STDERR_FILENO, msg, sizeof(msg) - 1);
+	write(STDERR_FILENO, what, strlen(what));
+	write(STDERR_FILENO, "()\n", 3);
+	abort();
+}
+
+void rt_alloc_guard_enter(void)
+{
+	rt_section = 1;
+}
+
+void rt_alloc_guard_leave(void)
+{
+	rt_section = 0;
+}
+
+extern "C" void *malloc(size_t size)
+{
+	if (rt_section)
+		rt_alloc_abort("malloc");
+	return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t nmemb, size_t size)
+{
+	if (rt_section)
+		rt_alloc_abort("calloc");
+	return __libc_calloc(nmemb, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+	if (rt_section)
+		rt_alloc_abort("realloc");
+	return __libc_realloc(ptr, size);
+}
+
+extern "C" void *memalign(size_t alignment, size_t size)
+{
+	if (rt_section)
+		rt_alloc_abort("memalign");
+	return __libc_memalign(alignment, size);
+}
+
+// C11 code and C++17 aligned operator new allocate through aligned_alloc()
+extern "C" void *aligned_alloc(size_t alignment, size_t size)
+{
+	if (rt_section)
+		rt_alloc_abort("aligned_alloc");
+	return __libc_memalign(alignment, size);
+}
+
+// StkFrames storage is allocated with posix_memalign()
+extern "C" int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+	if (rt_section)
+		rt_alloc_abort("posix_memalign");
+	*memptr = __libc_memalign(alignment, size);
+	return *memptr ? 0 : ENOMEM;
+}
+
+extern "C" void free(void *ptr)
+{
+	if (rt_section && ptr)
+		rt_alloc_abort("free");
+	__libc_free(ptr);
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef RT_ALLOC_GUARD_H
+#define RT_ALLOC_GUARD_H
+
+/* Debug check that the realtime path does not touch the heap.
+ *
+ * Build with "make RT_ALLOC_DEBUG=1" and any malloc/calloc/realloc/
+ * memalign/aligned_alloc/posix_memalign/free made by a thread between
+ * rt_alloc_guard_enter() and rt_alloc_guard_leave() prints the offending
+ * call and aborts, so a core dump points at the allocation.  In normal
+ * builds both calls compile to nothing.
+ */
+
+#ifdef RT_ALLOC_DEBUG
+
+void rt_alloc_guard_enter(void);
+void rt_alloc_guard_leave(void);
+
+#else
+
+static inline void rt_alloc_guard_enter(void) {}
+static inline void rt_alloc_guard_leave(void) {}
+
+#endif
+
+#endif
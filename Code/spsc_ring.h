@@ -0,0 +1,57 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+
+/* Wait-free single-producer/single-consumer ring.
+ *
+ * One thread may push() and one other thread may pop(); neither ever
+ * blocks, allocates or takes a lock, so either side can be the audio
+ * thread.  N must be a power of two.  head and tail sit on their own
+ * cache lines so the two sides do not bounce a line on every call.
+ */
+template <typename T, unsigned int N>
+class spsc_ring {
+	static_assert(N && !(N & (N - 1)), "spsc_ring size must be a power of two");
+
+public:
+	spsc_ring() : head(0), tail(0) {}
+
+	// producer side, false when full
+	bool push(const T &item)
+	{
+		unsigned int h = head.load(std::memory_order_relaxed);
+
+		if (h - tail.load(std::memory_order_acquire) == N)
+			return false;
+		slots[h & (N - 1)] = item;
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer side, false when empty
+	bool pop(T &item)
+	{
+		unsigned int t = tail.load(std::memory_order_relaxed);
+
+		if (head.load(std::memory_order_acquire) == t)
+			return false;
+		item = slots[t & (N - 1)];
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer side
+	bool empty() const
+	{
+		return head.load(std::memory_order_acquire) ==
+		       tail.load(std::memory_order_relaxed);
+	}
+
+private:
+	alignas(64) std::atomic<unsigned int> head;	// written by producer
+	alignas(64) std::atomic<unsigned int> tail;	// written by consumer
+	alignas(64) T slots[N];
+};
+
+#endif
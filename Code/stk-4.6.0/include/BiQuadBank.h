@@ -0,0 +1,203 @@
+#ifndef STK_BIQUADBANK_H
+#define STK_BIQUADBANK_H
+
+#include "Filter.h"
+#include "Simd.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class BiQuadBank
+    \brief STK bank of parallel biquad filters.
+
+    This class holds the parallel resonators of a modal or PhISEM
+    model, N two-pole, two-zero filters that share one input and whose
+    outputs are summed, and can hold the same N filters for several
+    voices at once.  Each filter computes the same direct form I
+    difference equation as BiQuad, with its own gain applied to the
+    input, so a BiQuad setting carries over unchanged.
+
+    The coefficients and state are stored as arrays across filters
+    rather than one object per filter, so a vector of filters steps
+    through a sample at a time (see biquadBank() in Simd.h).  With one
+    voice the vectors run across the N filters of that voice, a frame
+    at a time.  With several voices they run across voices, filter j
+    of every voice in one row, so each voice keeps its own input and
+    its own output and no vector is ever summed across lanes; the
+    StkFrames tick function then runs each row over a block of frames
+    before the next one, which is where the bank is fastest.
+
+    Filter j of voice v is number j + v * N in the functions that set
+    one filter.
+*/
+/***************************************************/
+
+class BiQuadBank : public Filter
+{
+public:
+
+  //! Default constructor creates \e filters pass-through filters for each of \e voices voices.
+  BiQuadBank( unsigned int filters = 1, unsigned int voices = 1 );
+
+  //! Class destructor.
+  ~BiQuadBank();
+
+  //! Set the number of filters per voice and the number of voices.
+  /*!
+    Every filter is reset to a pass-through filter with unity gain
+    and the internal state is cleared.
+  */
+  void resize( unsigned int filters, unsigned int voices = 1 );
+
+  //! Return the number of filters per voice.
+  unsigned int getFilters( void ) const { return filters_; };
+
+  //! Return the number of voices.
+  unsigned int getVoices( void ) const { return voices_; };
+
+  //! Set all the coefficients of filter \e k.
+  void setCoefficients( unsigned int k, StkFloat b0, StkFloat b1, StkFloat b2, StkFloat a1, StkFloat a2, bool clearState = false );
+
+  //! Set the gain applied to the input of filter \e k.
+  void setFilterGain( unsigned int k, StkFloat gain ) { coefficient( k, 0 ) = gain; };
+
+  //! Return the input gain of filter \e k.
+  StkFloat getFilterGain( unsigned int k ) const { return coefficients_[offset( k, 0 )]; };
+
+  //! Set the poles of filter \e k for a resonance at \e frequency with the given \e radius, as BiQuad::setResonance().
+  void setResonance( unsigned int k, StkFloat frequency, StkFloat radius, bool normalize = false );
+
+  //! Set the zeros of filter \e k for a notch at \e frequency with the given \e radius, as BiQuad::setNotch().
+  void setNotch( unsigned int k, StkFloat frequency, StkFloat radius );
+
+  //! Set the zeros of filter \e k to +1 and -1, as BiQuad::setEqualGainZeroes().
+  void setEqualGainZeroes( unsigned int k );
+
+  //! Clears the state of every filter.
+  void clear( void );
+
+  //! Return the last output of voice \e voice, the sum of its filters.
+  StkFloat lastOut( unsigned int voice = 0 ) const { return lastFrame_[voice]; };
+
+  //! Input one sample to every filter of every voice and return the output of voice 0.
+  /*!
+    The output of every voice is in lastFrame().
+  */
+  StkFloat tick( StkFloat input );
+
+  //! Take channels \c channel onwards of the StkFrames object as the inputs of each voice and replace them with the voice outputs.
+  /*!
+    The StkFrames argument reference is returned.  The StkFrames
+    argument must have at least \c channel plus the number of voices
+    channels.  However, range checking is only performed if
+    _STK_DEBUG_ is defined during compilation, in which case an
+    out-of-range value will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
+
+protected:
+
+  // Frames run through each row before the next, see tick( StkFrames& ).
+  static const unsigned int BLOCK_FRAMES = 64;
+
+  // Index of value j (gain, b0, b1, b2, a1, a2) of filter k in coefficients_.
+  unsigned int offset( unsigned int k, unsigned int j ) const;
+  StkFloat& coefficient( unsigned int k, unsigned int j ) { return coefficients_[offset( k, j )]; };
+
+  unsigned int filters_;
+  unsigned int voices_;
+  unsigned int rows_;    // 1 with one voice, else filters_
+  unsigned int stride_;  // filters_ with one voice, else voices_, rounded up to SIMD_LANES
+  std::vector<StkFloat> coefficients_;  // per row: gain, b0, b1, b2, a1, a2 of each lane
+  std::vector<StkFloat> state_;         // per row: x[n-1], x[n-2], y[n-1], y[n-2] of each lane
+  std::vector<StkFloat> lanes_;         // BLOCK_FRAMES x stride_ inputs, one frame with one voice
+  std::vector<StkFloat> block_;         // BLOCK_FRAMES x stride_ outputs, one frame with one voice
+};
+
+inline unsigned int BiQuadBank :: offset( unsigned int k, unsigned int j ) const
+{
+#if defined(_STK_DEBUG_)
+  if ( k >= filters_ * voices_ ) {
+    oStream_ << "BiQuadBank: filter index " << k << " is out of range!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  if ( voices_ == 1 ) return j * stride_ + k;
+  return ( 6 * ( k % filters_ ) + j ) * stride_ + k / filters_;
+}
+
+inline StkFloat BiQuadBank :: tick( StkFloat input )
+{
+  unsigned int i;
+  StkFloat x = gain_ * input;
+
+  // Padding lanes have zero gain, so whole vectors can run over them.
+  if ( voices_ == 1 ) {
+    lastFrame_[0] = biquadBankSum( &coefficients_[0], &state_[0], stride_, x, stride_ );
+    return lastFrame_[0];
+  }
+
+  for ( i=0; i<stride_; i++ ) {
+    lanes_[i] = x;
+    block_[i] = 0.0;
+  }
+  for ( i=0; i<rows_; i++ )
+    biquadBank( &coefficients_[6 * i * stride_], &state_[4 * i * stride_], stride_, &lanes_[0], 0,
+                &block_[0], 0, stride_, 1 );
+
+  for ( i=0; i<voices_; i++ )
+    lastFrame_[i] = block_[i];
+  return lastFrame_[0];
+}
+
+inline StkFrames& BiQuadBank :: tick( StkFrames& frames, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel + voices_ > frames.channels() ) {
+    oStream_ << "BiQuadBank::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *samples = &frames[channel];
+  unsigned int i, j, hop = frames.channels();
+
+  // One voice has too few lanes to hide the recursion, so it gains
+  // nothing from running a block at a time.
+  if ( voices_ == 1 ) {
+    for ( i=0; i<frames.frames(); i++, samples += hop )
+      *samples = tick( *samples );
+    return frames;
+  }
+
+  for ( unsigned int start=0; start<frames.frames(); start+=BLOCK_FRAMES, samples += BLOCK_FRAMES * hop ) {
+    unsigned int n = frames.frames() - start;
+    if ( n > BLOCK_FRAMES ) n = BLOCK_FRAMES;
+
+    for ( i=0; i<n; i++ ) {
+      for ( j=0; j<voices_; j++ )
+        lanes_[i * stride_ + j] = gain_ * samples[i * hop + j];
+      for ( j=0; j<stride_; j++ )
+        block_[i * stride_ + j] = 0.0;
+    }
+
+    for ( j=0; j<rows_; j++ )
+      biquadBank( &coefficients_[6 * j * stride_], &state_[4 * j * stride_], stride_, &lanes_[0], stride_,
+                  &block_[0], stride_, stride_, n );
+
+    for ( i=0; i<n; i++ )
+      for ( j=0; j<voices_; j++ )
+        samples[i * hop + j] = block_[i * stride_ + j];
+  }
+
+  if ( frames.frames() > 0 ) {
+    for ( j=0; j<voices_; j++ )
+      lastFrame_[j] = frames( frames.frames() - 1, channel + j );
+  }
+  return frames;
+}
+
+} // stk namespace
+
+#endif
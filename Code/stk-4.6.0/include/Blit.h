@@ -94,8 +94,8 @@ class Blit: public Generator
 
   unsigned int nHarmonics_;
   unsigned int m_;
-  StkFloat rate_;
-  StkFloat phase_;
+  double rate_;
+  double phase_;
   StkFloat p_;
 
 };
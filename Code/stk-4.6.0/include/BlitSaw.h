@@ -80,8 +80,8 @@ class BlitSaw: public Generator
 
   unsigned int nHarmonics_;
   unsigned int m_;
-  StkFloat rate_;
-  StkFloat phase_;
+  double rate_;
+  double phase_;
   StkFloat p_;
   StkFloat C2_;
   StkFloat a_;
@@ -103,8 +103,8 @@ class BlitSquare: public Generator
 
   unsigned int nHarmonics_;
   unsigned int m_;
-  StkFloat rate_;
-  StkFloat phase_;
+  double rate_;
+  double phase_;
   StkFloat p_;
   StkFloat a_;
   StkFloat lastBlitOutput_;
@@ -0,0 +1,227 @@
+#ifndef STK_CONVOLUTIONFIR_H
+#define STK_CONVOLUTIONFIR_H
+
+#include "Effect.h"
+#include "Simd.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class ConvolutionFir
+    \brief STK partitioned FFT convolution effect class.
+
+    This class convolves its input with an arbitrarily long impulse
+    response (a long FIR filter or a measured room response) using
+    uniformly partitioned overlap-save convolution.
+
+    The impulse response is split into partitions of \e blockSize
+    samples.  Each partition is transformed once when the response is
+    set.  Every block of input is transformed once and kept in a
+    frequency-domain delay line, and the output block is one inverse
+    transform of the sum of the partition products.  The cost per
+    sample therefore grows with the logarithm of the block size and
+    linearly only in the number of partitions, instead of with the
+    full response length as in the direct form Fir class.
+
+    The output is never delayed.  Whole blocks passed to
+    tick(StkFrames&) are convolved with one transform each.  Samples
+    of a partial block, from the single-sample tick or from frames
+    that don't fill a block, are convolved with the first partition
+    directly, and the other partitions, which only see earlier blocks,
+    are applied with one transform when the block starts.  Calls of
+    any size can therefore be mixed and give the same output, up to
+    rounding, as whole blocks.  A partial block costs about
+    \e blockSize multiply-adds per sample more.
+
+    The effect mix defaults to 1.0 (convolved signal only).
+*/
+/***************************************************/
+
+class ConvolutionFir : public Effect
+{
+ public:
+  //! Class constructor, taking the processing block size.  The default response is a unit impulse.
+  ConvolutionFir( unsigned int blockSize = RT_BUFFER_SIZE );
+
+  //! Overloaded constructor which takes the impulse response.
+  /*!
+    An StkError can be thrown if the coefficient vector size is
+    zero.
+  */
+  ConvolutionFir( std::vector<StkFloat> &coefficients, unsigned int blockSize = RT_BUFFER_SIZE );
+
+  //! Class destructor.
+  ~ConvolutionFir( void );
+
+  //! Reset and clear all internal state.
+  void clear( void );
+
+  //! Set the processing block (partition) size in samples.
+  /*!
+    This should equal the size of the blocks passed to
+    tick(StkFrames&), which are then convolved with one transform
+    each.  The internal
+    state is cleared.  An StkError can be thrown if the argument is
+    zero.
+  */
+  void setBlockSize( unsigned int blockSize );
+
+  //! Return the processing block size in samples.
+  unsigned int getBlockSize( void ) const { return blockSize_; };
+
+  //! Set the impulse response from a vector of coefficients.
+  /*!
+    An StkError can be thrown if the coefficient vector size is
+    zero.  The internal state of the filter is not cleared unless the
+    \e clearState flag is \c true.
+  */
+  void setCoefficients( std::vector<StkFloat> &coefficients, bool clearState = false );
+
+  //! Load the impulse response from the first channel of a soundfile.
+  /*!
+    Any format supported by FileRead can be used.  Raw files are
+    read as mono 16-bit data.  The file sample rate is not converted.
+    An StkError is thrown if the file cannot be read.
+  */
+  void openFile( std::string fileName, bool typeRaw = false );
+
+  //! Return the impulse response length in samples.
+  unsigned long getLength( void ) const { return length_; };
+
+  //! Return the last computed output value.
+  StkFloat lastOut( void ) const { return lastFrame_[0]; };
+
+  //! Input one sample to the effect and return one output.
+  StkFloat tick( StkFloat input );
+
+  //! Take a channel of the StkFrames object as inputs to the effect and replace with corresponding outputs.
+  /*!
+    The StkFrames argument reference is returned.  The \c channel
+    argument must be less than the number of channels in the
+    StkFrames argument (the first channel is specified by 0).
+    However, range checking is only performed if _STK_DEBUG_ is
+    defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
+
+  //! Take a channel of the \c iFrames object as inputs to the effect and write outputs to the \c oFrames object.
+  /*!
+    The \c iFrames object reference is returned.  Each channel
+    argument must be less than the number of channels in the
+    corresponding StkFrames argument (the first channel is specified
+    by 0).  However, range checking is only performed if _STK_DEBUG_
+    is defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
+
+ protected:
+
+  // Size the transform and delay line for the block size and response length.
+  void allocate( void );
+
+  // Transform the stored impulse response into partition spectra.
+  void transformResponse( void );
+
+  // Prepare a block for partial processing: load the previous block
+  // for the first partition and convolve the later partitions.
+  void startBlock( void );
+
+  // Add the block of input in history_ to the window and the delay line.
+  void transformBlock( void );
+
+  // Convolve the partitions from \e first on and leave the result in outBlock_.
+  void convolve( unsigned int first );
+
+  // In-place radix-2 complex FFT of size fftSize_.
+  void fft( StkFloat *real, StkFloat *imag, bool inverse );
+
+  unsigned int blockSize_;
+  unsigned int fftSize_;
+  unsigned int bins_;          // fftSize_ / 2 + 1, the non-redundant half
+  unsigned int partitions_;
+  unsigned int fdlIndex_;      // newest spectrum in the delay line
+  unsigned int fill_;          // samples in the pending partial block
+  unsigned long length_;
+
+  std::vector<StkFloat> response_;
+  std::vector<StkFloat> window_;   // last fftSize_ input samples
+  std::vector<StkFloat> real_;
+  std::vector<StkFloat> imag_;
+  std::vector<StkFloat> responseReal_;
+  std::vector<StkFloat> responseImag_;
+  std::vector<StkFloat> fdlReal_;
+  std::vector<StkFloat> fdlImag_;
+  std::vector<StkFloat> cosTable_;
+  std::vector<StkFloat> sinTable_;
+  std::vector<unsigned int> bitReverse_;
+  std::vector<StkFloat> history_;  // previous block, then the current one
+  std::vector<StkFloat> reversed_; // first partition, time-reversed
+  std::vector<StkFloat> outBlock_;
+};
+
+inline StkFloat ConvolutionFir :: tick( StkFloat input )
+{
+  if ( fill_ == 0 ) this->startBlock();
+
+  history_[blockSize_+fill_] = input;
+  StkFloat output = outBlock_[fill_] + dotProduct( &reversed_[0], &history_[fill_+1], blockSize_ );
+  if ( ++fill_ == blockSize_ ) {
+    this->transformBlock();
+    fill_ = 0;
+  }
+
+  lastFrame_[0] = effectMix_ * ( output - input ) + input;
+  return lastFrame_[0];
+}
+
+inline StkFrames& ConvolutionFir :: tick( StkFrames& frames, unsigned int channel )
+{
+  return tick( frames, frames, channel, channel );
+}
+
+inline StkFrames& ConvolutionFir :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
+{
+#if defined(_STK_DEBUG_)
+  if ( iChannel >= iFrames.channels() || oChannel >= oFrames.channels() ) {
+    oStream_ << "ConvolutionFir::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *iSamples = &iFrames[iChannel];
+  StkFloat *oSamples = &oFrames[oChannel];
+  unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
+  unsigned int nFrames = iFrames.frames();
+
+  unsigned int i = 0;
+  while ( i < nFrames ) {
+    if ( fill_ != 0 || nFrames - i < blockSize_ ) {
+      *oSamples = tick( *iSamples );
+      iSamples += iHop;
+      oSamples += oHop;
+      i++;
+      continue;
+    }
+
+    // A whole block: read it all before writing, for in-place use.
+    StkFloat *in = &history_[blockSize_];
+    for ( unsigned int j=0; j<blockSize_; j++, iSamples += iHop )
+      in[j] = *iSamples;
+
+    this->transformBlock();
+    this->convolve( 0 );
+
+    for ( unsigned int j=0; j<blockSize_; j++, oSamples += oHop )
+      *oSamples = effectMix_ * ( outBlock_[j] - in[j] ) + in[j];
+    i += blockSize_;
+  }
+
+  if ( nFrames > 0 ) lastFrame_[0] = *(oSamples-oHop);
+  return iFrames;
+}
+
+} // stk namespace
+
+#endif
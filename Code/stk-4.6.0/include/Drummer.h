@@ -43,8 +43,8 @@ class Drummer : public Instrmnt
   /*!
     Use general MIDI drum instrument numbers, converted to
     frequency values as if MIDI note numbers, to select a particular
-    instrument.  An StkError will be thrown if the rawwave path is
-    incorrectly set.
+    instrument.  The drum waves are read by the constructor, so this
+    function neither reads a file nor allocates memory.
   */
   void noteOn( StkFloat instrument, StkFloat amplitude );
 
@@ -66,6 +66,7 @@ class Drummer : public Instrmnt
 
  protected:
 
+  const WaveCache::Wave *sounds_[DRUM_NUMWAVES];
   FileWvIn waves_[DRUM_POLYPHONY];
   OnePole  filters_[DRUM_POLYPHONY];
   std::vector<int> soundOrder_;
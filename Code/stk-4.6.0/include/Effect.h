@@ -36,6 +36,21 @@ class Effect : public Stk
   //! Set the mixture of input and "effected" levels in the output (0.0 = input only, 1.0 = effect only). 
   virtual void setEffectMix( StkFloat mix );
 
+  //! Take a channel of the StkFrames object as inputs to the effect and replace with corresponding outputs.
+  /*!
+    Effects with more than one output channel write them to \c
+    channel onwards.  The StkFrames argument reference is returned.
+  */
+  virtual StkFrames& tick( StkFrames& frames, unsigned int channel = 0 ) = 0;
+
+  //! Process the first \e n frames of \e frames in place, the same values as \e n calls of tick().
+  /*!
+    The input is channel 0 and the outputs start at channel 0.  The
+    view must have at least \e n frames.  The default calls tick(
+    StkFrames& ) on the first \e n frames.
+  */
+  virtual void process( StkFramesView frames, unsigned int n ) { frames.resize( n, frames.channels() ); this->tick( frames ); };
+
  protected:
 
   // Returns true if argument value is prime.
@@ -97,12 +97,18 @@ class FM : public Instrmnt
 
  protected:
 
+  // Set every operator to its ratio of the base frequency raised by the
+  // vibrato offset, unless they are already there, as they are on every
+  // sample without vibrato.
+  void setOperatorFrequencies( StkFloat vibrato );
+
   std::vector<ADSR *> adsr_; 
   std::vector<FileLoop *> waves_;
   SineWave vibrato_;
   TwoZero  twozero_;
   unsigned int nOperators_;
   StkFloat baseFrequency_;
+  StkFloat operatorFrequency_; // raised base frequency the operators were last set for, 0 if none
   std::vector<StkFloat> ratios_;
   std::vector<StkFloat> gains_;
   StkFloat modDepth_;
@@ -114,6 +120,16 @@ class FM : public Instrmnt
 
 };
 
+inline void FM :: setOperatorFrequencies( StkFloat vibrato )
+{
+  StkFloat frequency = baseFrequency_ * ( 1.0 + vibrato );
+  if ( frequency == operatorFrequency_ ) return;
+
+  operatorFrequency_ = frequency;
+  for ( unsigned int i=0; i<nOperators_; i++ )
+    waves_[i]->setFrequency( frequency * ratios_[i] );
+}
+
 } // stk namespace
 
 #endif
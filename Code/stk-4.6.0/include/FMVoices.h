@@ -80,15 +80,10 @@ class FMVoices : public FM
 
 inline StkFloat FMVoices :: tick( unsigned int )
 {
-  StkFloat temp, temp2;
+  StkFloat temp;
 
   temp = gains_[3] * adsr_[3]->tick() * waves_[3]->tick();
-  temp2 = vibrato_.tick() * modDepth_ * 0.1;
-
-  waves_[0]->setFrequency(baseFrequency_ * (1.0 + temp2) * ratios_[0]);
-  waves_[1]->setFrequency(baseFrequency_ * (1.0 + temp2) * ratios_[1]);
-  waves_[2]->setFrequency(baseFrequency_ * (1.0 + temp2) * ratios_[2]);
-  waves_[3]->setFrequency(baseFrequency_ * (1.0 + temp2) * ratios_[3]);
+  this->setOperatorFrequencies( vibrato_.tick() * modDepth_ * 0.1 );
 
   waves_[0]->addPhaseOffset(temp * mods_[0]);
   waves_[1]->addPhaseOffset(temp * mods_[1]);
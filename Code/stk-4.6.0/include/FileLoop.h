@@ -19,6 +19,9 @@ namespace stk {
     the overloaded one that takes an StkFrames object for
     multi-channel and/or multi-frame data.
 
+    As with FileWvIn, the openShared() functions loop file data held
+    by the WaveCache instead of a private copy.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2017.
 */
 /***************************************************/
@@ -50,6 +53,22 @@ class FileLoop : protected FileWvIn
   */
   void openFile( std::string fileName, bool raw = false, bool doNormalize = true, bool doInt2FloatScaling = true );
 
+  //! Open the specified file through the WaveCache and loop the cached data.
+  /*!
+    The file is read into the cache if no other object holds it,
+    and its whole content is loaded regardless of the chunkThreshold
+    limit.  The arguments and errors are as for openFile().
+  */
+  void openShared( std::string fileName, bool raw = false, bool doNormalize = true, bool doInt2FloatScaling = true )
+  { FileWvIn::openShared( fileName, raw, doNormalize, doInt2FloatScaling ); };
+
+  //! Loop a wave already held in the WaveCache, as returned by WaveCache::acquire().
+  /*!
+    This function reads no file and allocates no memory.  The object
+    keeps its own reference to the wave until the file is closed.
+  */
+  void openShared( const WaveCache::Wave *wave ) { FileWvIn::openShared( wave ); };
+
   //! Close a file if one is open.
   void closeFile( void ) { FileWvIn::closeFile(); };
 
@@ -69,12 +88,12 @@ class FileLoop : protected FileWvIn
   //! Normalize data to a maximum of \e +-peak.
   /*!
     This function has no effect when data is incrementally loaded
-    from disk.
+    from disk.  Shared data is first copied, as it is never modified.
   */
   void normalize( StkFloat peak ) { FileWvIn::normalize( peak ); };
 
   //! Return the file size in sample frames.
-  unsigned long getSize( void ) const { return data_.frames(); };
+  unsigned long getSize( void ) const { return wave_->frames(); };
 
   //! Return the input file sample rate in Hz (not the data read rate).
   /*!
@@ -82,7 +101,7 @@ class FileLoop : protected FileWvIn
     their headers.  STK RAW files have a sample rate of 22050 Hz
     by definition.  MAT-files are assumed to have a rate of 44100 Hz.
   */
-  StkFloat getFileRate( void ) const { return data_.dataRate(); };
+  StkFloat getFileRate( void ) const { return wave_->dataRate(); };
 
   //! Set the data read rate in samples.  The rate can be negative.
   /*!
@@ -17,6 +17,15 @@ namespace stk {
     does not store its own copy of the file data,
     rather the data is read directly from disk.
 
+    Where the platform allows it, an open file is
+    mapped read-only into memory (see
+    setMemoryMapping()) and read() decodes the
+    samples straight from the mapping, so that even
+    a very large file opens immediately and the
+    operating system reads only the parts of it
+    that are used.  The samples are converted with
+    the vectorized decode kernels of Simd.h.
+
     FileRead currently supports uncompressed WAV,
     AIFF/AIFC, SND (AU), MAT-file (Matlab), and
     STK RAW file formats.  Signed integer (8-,
@@ -105,6 +114,32 @@ public:
    */
   void read( StkFrames& buffer, unsigned long startFrame = 0, bool doNormalize = true );
 
+  //! Enable or disable memory mapping of the files opened afterwards (default = true).
+  /*!
+    When enabled, open() maps a file read-only into memory if the
+    platform allows it, and read() decodes its samples from the
+    mapping rather than through stdio.  A file that can't be mapped,
+    or whose header gives more data than the file holds, is read
+    through stdio.  A mapped file must not be truncated while it is
+    open.
+  */
+  static void setMemoryMapping( bool enable ) { memoryMapping_ = enable; };
+
+  //! Returns \e true if the open file is memory-mapped.
+  bool isMapped( void ) const { return map_ != 0; };
+
+  //! Return a pointer to the first sample of the mapped file data, or NULL if the file is not mapped.
+  /*!
+    The samples are interleaved and stored as in the file, in the
+    format returned by format() and in the byte order given by
+    isByteSwapped(), except that 8-bit WAV samples are unsigned.  The
+    pointer is valid until the file is closed.
+  */
+  const unsigned char *mappedData( void ) const { return map_ ? map_ + dataOffset_ : 0; };
+
+  //! Returns \e true if the byte order of the file data differs from that of the host.
+  bool isByteSwapped( void ) const { return byteswap_; };
+
 protected:
 
   // Get STK RAW file information.
@@ -126,6 +161,12 @@ protected:
   // Helper function for MAT-file parsing.
   bool findNextMatArray( SINT32 *chunkSize, SINT32 *rows, SINT32 *columns, SINT32 *nametype );
 
+  // Map the open file into memory, if possible.
+  void mapFile( void );
+
+  // Convert n samples of the file data at in to StkFloat values.
+  void decode( StkFloat *out, const unsigned char *in, unsigned long n, bool doNormalize ) const;
+
   FILE *fd_;
   bool byteswap_;
   bool wavFile_;
@@ -134,6 +175,11 @@ protected:
   unsigned int channels_;
   StkFormat dataType_;
   StkFloat fileRate_;
+  const unsigned char *map_;
+  size_t mapSize_;
+  void *mapHandle_;
+
+  static bool memoryMapping_;
 };
 
 } // stk namespace
@@ -3,6 +3,7 @@
 
 #include "WvIn.h"
 #include "FileRead.h"
+#include "WaveCache.h"
 
 namespace stk {
 
@@ -39,6 +40,10 @@ namespace stk {
     signed integers, the input values will be scaled by 1 / 32768.0. This
     scaling will not happen for floating-point file data formats.
 
+    The openShared() functions play file data held by the WaveCache
+    instead of a private copy, so that many objects playing the same
+    file use one copy of its data.  Shared data is never chunked.
+
     When the file end is reached, subsequent calls to the tick()
     functions return zeros and isFinished() returns \e true.
 
@@ -80,6 +85,22 @@ public:
   */
   virtual void openFile( std::string fileName, bool raw = false, bool doNormalize = true, bool doInt2FloatScaling = true );
 
+  //! Open the specified file through the WaveCache and play the cached data.
+  /*!
+    The file is read into the cache if no other object holds it,
+    and its whole content is loaded regardless of the chunkThreshold
+    limit.  The arguments and errors are as for openFile().
+  */
+  void openShared( std::string fileName, bool raw = false, bool doNormalize = true, bool doInt2FloatScaling = true );
+
+  //! Play a wave already held in the WaveCache, as returned by WaveCache::acquire().
+  /*!
+    This function reads no file and allocates no memory, so it can
+    be called in a note-on.  The object keeps its own reference to the
+    wave until the file is closed.
+  */
+  void openShared( const WaveCache::Wave *wave );
+
   //! Close a file if one is open.
   virtual void closeFile( void );
 
@@ -96,7 +117,7 @@ public:
   //! Normalize data to a maximum of \e +-peak.
   /*!
     This function has no effect when data is incrementally loaded
-    from disk.
+    from disk.  Shared data is first copied, as it is never modified.
   */
   virtual void normalize( StkFloat peak );
 
@@ -109,7 +130,7 @@ public:
     their headers.  STK RAW files have a sample rate of 22050 Hz
     by definition.  MAT-files are assumed to have a rate of 44100 Hz.
   */
-  virtual StkFloat getFileRate( void ) const { return data_.dataRate(); };
+  virtual StkFloat getFileRate( void ) const { return wave_->dataRate(); };
 
   //! Query whether a file is open.
   bool isOpen( void ) { return file_.isOpen(); };
@@ -177,12 +198,14 @@ protected:
   void sampleRateChanged( StkFloat newRate, StkFloat oldRate );
 
   FileRead file_;
+  const WaveCache::Wave *shared_;  // the cached wave played, or NULL
+  const StkFrames *wave_;          // the data played, data_ or the cached wave
   bool finished_;
   bool interpolate_;
   bool int2floatscaling_;
   bool chunking_;
-  StkFloat time_;
-  StkFloat rate_;
+  double time_;
+  double rate_;
   unsigned long fileSize_;
   unsigned long chunkThreshold_;
   unsigned long chunkSize_;
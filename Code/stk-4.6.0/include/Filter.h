@@ -66,6 +66,13 @@ public:
   */
   virtual StkFrames& tick( StkFrames& frames, unsigned int channel = 0 ) = 0;
 
+  //! Filter channel 0 of the first \e n frames of \e frames in place, the same values as \e n calls of tick().
+  /*!
+    The view must have at least \e n frames.  The default calls
+    tick( StkFrames& ) on the first \e n frames.
+  */
+  virtual void process( StkFramesView frames, unsigned int n ) { frames.resize( n, frames.channels() ); this->tick( frames ); };
+
 protected:
 
   StkFloat gain_;
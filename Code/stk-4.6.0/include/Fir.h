@@ -2,6 +2,7 @@
 #define STK_FIR_H
 
 #include "Filter.h"
+#include "Simd.h"
 
 namespace stk {
 
@@ -23,6 +24,11 @@ namespace stk {
     This structure results in one extra multiply per computed sample,
     but allows easy control of the overall filter gain.
 
+    The input history is kept twice in a circular buffer of twice the
+    filter length, so the last N inputs are always contiguous in
+    memory.  Each output is a single dot product (vectorized where the
+    platform allows, see Simd.h) and no history is shifted per sample.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2017.
 */
 /***************************************************/
@@ -81,19 +87,27 @@ public:
 
 protected:
 
+  // Store one input in the circular history and return the output.
+  StkFloat computeSample( StkFloat input );
+
+  // Newest input lives at inputs_[index_] and inputs_[index_ + order].
+  unsigned int index_;
+
 };
 
-inline StkFloat Fir :: tick( StkFloat input )
+inline StkFloat Fir :: computeSample( StkFloat input )
 {
-  lastFrame_[0] = 0.0;
-  inputs_[0] = gain_ * input;
+  unsigned int order = (unsigned int) b_.size();
 
-  for ( unsigned int i=(unsigned int)(b_.size())-1; i>0; i-- ) {
-    lastFrame_[0] += b_[i] * inputs_[i];
-    inputs_[i] = inputs_[i-1];
-  }
-  lastFrame_[0] += b_[0] * inputs_[0];
+  index_ = ( index_ == 0 ) ? order - 1 : index_ - 1;
+  inputs_[index_] = inputs_[index_ + order] = gain_ * input;
 
+  return dotProduct( &b_[0], &inputs_[index_], order );
+}
+
+inline StkFloat Fir :: tick( StkFloat input )
+{
+  lastFrame_[0] = computeSample( input );
   return lastFrame_[0];
 }
 
@@ -107,17 +121,9 @@ inline StkFrames& Fir :: tick( StkFrames& frames, unsigned int channel )
 #endif
 
   StkFloat *samples = &frames[channel];
-  unsigned int i, hop = frames.channels();
-  for ( unsigned int j=0; j<frames.frames(); j++, samples += hop ) {
-    inputs_[0] = gain_ * *samples;
-    *samples = 0.0;
-
-    for ( i=(unsigned int)b_.size()-1; i>0; i-- ) {
-      *samples += b_[i] * inputs_[i];
-      inputs_[i] = inputs_[i-1];
-    }
-    *samples += b_[0] * inputs_[0];
-  }
+  unsigned int hop = frames.channels();
+  for ( unsigned int j=0; j<frames.frames(); j++, samples += hop )
+    *samples = computeSample( *samples );
 
   lastFrame_[0] = *(samples-hop);
   return frames;
@@ -134,17 +140,9 @@ inline StkFrames& Fir :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned
 
   StkFloat *iSamples = &iFrames[iChannel];
   StkFloat *oSamples = &oFrames[oChannel];
-  unsigned int i, iHop = iFrames.channels(), oHop = oFrames.channels();
-  for ( unsigned int j=0; j<iFrames.frames(); j++, iSamples += iHop, oSamples += oHop ) {
-    inputs_[0] = gain_ * *iSamples;
-    *oSamples = 0.0;
-
-    for ( i=(unsigned int)b_.size()-1; i>0; i-- ) {
-      *oSamples += b_[i] * inputs_[i];
-      inputs_[i] = inputs_[i-1];
-    }
-    *oSamples += b_[0] * inputs_[0];
-  }
+  unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
+  for ( unsigned int j=0; j<iFrames.frames(); j++, iSamples += iHop, oSamples += oHop )
+    *oSamples = computeSample( *iSamples );
 
   lastFrame_[0] = *(oSamples-oHop);
   return iFrames;
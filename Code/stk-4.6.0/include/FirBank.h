@@ -0,0 +1,194 @@
+#ifndef STK_FIRBANK_H
+#define STK_FIRBANK_H
+
+#include "Filter.h"
+#include "Simd.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class FirBank
+    \brief STK bank of finite impulse response filters on one input.
+
+    A set of K filters run on the same input signal, for an analyzer,
+    a crossfade between two filters or the first stages of parallel
+    effect chains, each need the same delay line.  This class keeps a
+    single input history and computes all K outputs in one pass over
+    it, so the history is written once per sample and read once per
+    sample for the whole bank.
+
+    The coefficients are stored interleaved, row j holding tap j of
+    every filter, so each history sample is loaded once and multiplied
+    into a vector of filters at a time (see bankProduct() in Simd.h).
+    The rows are padded to a whole number of vectors.
+    Shorter filters are padded with zeros at the end to the longest
+    length N, so each output is the same, sample for sample, as that
+    of the filter run on its own.  When every padded filter is
+    symmetric, as when linear-phase filters all have the same length,
+    the two history samples that share a row are added first and the
+    bank runs on N/2 rows, as in SymmetricFir.
+
+    One sample of input gives a frame of K outputs, filter k in
+    channel k: see lastFrame() and lastOut().
+*/
+/***************************************************/
+
+class FirBank : public Filter
+{
+public:
+  //! Default constructor creates a bank of one zero-order pass-through "filter".
+  FirBank( void );
+
+  //! Overloaded constructor which takes the coefficients of each filter.
+  /*!
+    An StkError can be thrown if there are no filters or a
+    coefficient vector size is zero.
+  */
+  FirBank( const std::vector< std::vector<StkFloat> > &filters );
+
+  //! Class destructor.
+  ~FirBank( void );
+
+  //! Set the coefficients of each filter, which sets the number of filters.
+  /*!
+    An StkError can be thrown if there are no filters or a
+    coefficient vector size is zero.  The internal state of the bank
+    is not cleared unless the \e clearState flag is \c true or the
+    padded length changes.
+  */
+  void setCoefficients( const std::vector< std::vector<StkFloat> > &filters, bool clearState = false );
+
+  //! Return the number of filters.
+  unsigned int getFilters( void ) const { return filters_; };
+
+  //! Return the padded length shared by every filter.
+  unsigned int getLength( void ) const { return order_; };
+
+  //! Clears the input history.
+  void clear( void );
+
+  //! Return the last output of filter \e k.
+  StkFloat lastOut( unsigned int k = 0 ) const { return lastFrame_[k]; };
+
+  //! Input one sample to the bank and return the output of the first filter.
+  /*!
+    The outputs of every filter are in lastFrame().
+  */
+  StkFloat tick( StkFloat input );
+
+  //! Take a channel of the StkFrames object as input to the bank and write filter k's output to channel \e channel + k.
+  /*!
+    The StkFrames argument reference is returned.  The StkFrames
+    argument must have at least \e channel + K channels.  However,
+    range checking is only performed if _STK_DEBUG_ is defined during
+    compilation, in which case an out-of-range value will trigger an
+    StkError exception.
+  */
+  StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
+
+  //! Take a channel of the \c iFrames object as input to the bank and write filter k's output to channel k of the \c oFrames object.
+  /*!
+    The \c iFrames object reference is returned.  The \c iChannel
+    argument must be less than the number of channels in \c iFrames
+    and \c oFrames must have K channels and at least as many frames.
+    However, range checking is only performed if _STK_DEBUG_ is
+    defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0 );
+
+protected:
+
+  void computeFrame( StkFloat input, StkFloat *output );
+
+  unsigned int filters_;              // K
+  unsigned int stride_;               // K rounded up to SIMD_LANES
+  unsigned int order_;                // N, the padded length
+  unsigned int rows_;                 // rows of coefficients_ in use
+  bool folded_;
+  std::vector<StkFloat> coefficients_;  // rows_ x stride_, interleaved
+  std::vector<StkFloat> sums_;        // the history, folded when folded_
+  std::vector<StkFloat> frame_;       // stride_ outputs
+
+  // History kept twice, newest input at inputs_[index_] and inputs_[index_ + N];
+  // reversed_ is the same in the opposite time order.
+  unsigned int index_;
+  StkFrames reversed_;
+  unsigned int rIndex_;
+};
+
+inline void FirBank :: computeFrame( StkFloat input, StkFloat *output )
+{
+  StkFloat x = gain_ * input;
+
+  index_ = ( index_ == 0 ) ? order_ - 1 : index_ - 1;
+  inputs_[index_] = inputs_[index_ + order_] = x;
+  const StkFloat *newest = &inputs_[index_];
+
+  if ( folded_ ) {
+    rIndex_ = ( rIndex_ == order_ - 1 ) ? 0 : rIndex_ + 1;
+    reversed_[rIndex_] = reversed_[rIndex_ + order_] = x;
+
+    // x[n-j] pairs with x[n-(N-1-j)]
+    const StkFloat *oldest = &reversed_[rIndex_ + 1];
+    unsigned int half = order_ / 2;
+    for ( unsigned int j=0; j<half; j++ )
+      sums_[j] = newest[j] + oldest[j];
+    if ( order_ & 1 ) sums_[half] = newest[half];
+    newest = &sums_[0];
+  }
+
+  bankProduct( &coefficients_[0], newest, rows_, stride_, &frame_[0] );
+  for ( unsigned int k=0; k<filters_; k++ )
+    output[k] = frame_[k];
+}
+
+inline StkFloat FirBank :: tick( StkFloat input )
+{
+  computeFrame( input, &lastFrame_[0] );
+  return lastFrame_[0];
+}
+
+inline StkFrames& FirBank :: tick( StkFrames& frames, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel + filters_ > frames.channels() ) {
+    oStream_ << "FirBank::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *samples = &frames[channel];
+  unsigned int hop = frames.channels();
+  for ( unsigned int j=0; j<frames.frames(); j++, samples += hop )
+    computeFrame( *samples, samples );
+
+  for ( unsigned int k=0; k<filters_; k++ )
+    lastFrame_[k] = *(samples - hop + k);
+  return frames;
+}
+
+inline StkFrames& FirBank :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel )
+{
+#if defined(_STK_DEBUG_)
+  if ( iChannel >= iFrames.channels() || oFrames.channels() != filters_ ||
+       oFrames.frames() < iFrames.frames() ) {
+    oStream_ << "FirBank::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *iSamples = &iFrames[iChannel];
+  StkFloat *oSamples = &oFrames[0];
+  unsigned int iHop = iFrames.channels();
+  for ( unsigned int j=0; j<iFrames.frames(); j++, iSamples += iHop, oSamples += filters_ )
+    computeFrame( *iSamples, oSamples );
+
+  for ( unsigned int k=0; k<filters_; k++ )
+    lastFrame_[k] = *(oSamples - filters_ + k);
+  return iFrames;
+}
+
+} // stk namespace
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef STK_FIRDESIGN_H
+#define STK_FIRDESIGN_H
+
+#include "Stk.h"
+#include <vector>
+
+namespace stk {
+
+/***************************************************/
+/*! \class FirDesign
+    \brief STK linear-phase FIR filter design class.
+
+    This class computes coefficients for the Fir class at run time,
+    for any band edges and sample rate, so filters need not be
+    designed offline for one fixed rate.
+
+    Two methods are provided.  windowedSinc() truncates the ideal
+    response with a Kaiser window whose shape and length follow from
+    the stopband attenuation and transition width, raised until the
+    designed response meets that attenuation.  equiripple() uses
+    the Parks-McClellan (Remez exchange) algorithm, which spreads the
+    error evenly over each band and meets the same specification with
+    fewer taps; its length is raised until the ripple and attenuation
+    asked for are met.
+
+    Band edges are passband edges in Hz.  The stopband begins
+    \e transition Hz beyond each of them.  Lowpass and highpass
+    filters use only \e f1, bandpass and bandstop filters pass or stop
+    \e f1 to \e f2.  All designs have an odd length and symmetric
+    coefficients.
+
+    halfBand() designs the lowpass filter of a decimate or
+    interpolate by 2 stage: its response is symmetric about a quarter
+    of the rate and every second coefficient but the centre one is
+    zero, which MultirateFir skips.  An StkError is thrown if a band does not fit
+    between 0 Hz and the Nyquist frequency.
+*/
+/***************************************************/
+
+class FirDesign : public Stk
+{
+ public:
+  //! Filter response types.
+  enum Type {
+    LOWPASS,
+    HIGHPASS,
+    BANDPASS,
+    BANDSTOP
+  };
+
+  //! Revision of the design methods, raised whenever a change alters the coefficients they return.
+  static const unsigned int REVISION = 3;
+
+  //! Kaiser windowed-sinc design for \e attenuation dB of stopband rejection.
+  static std::vector<StkFloat> windowedSinc( Type type, StkFloat f1, StkFloat f2,
+                                             StkFloat transition, StkFloat attenuation,
+                                             StkFloat rate = Stk::sampleRate() );
+
+  //! Parks-McClellan design for \e ripple dB (peak to peak) in the passband and \e attenuation dB in the stopband.
+  static std::vector<StkFloat> equiripple( Type type, StkFloat f1, StkFloat f2,
+                                           StkFloat transition, StkFloat attenuation,
+                                           StkFloat ripple, StkFloat rate = Stk::sampleRate() );
+
+  //! Kaiser windowed half-band lowpass, \e transition Hz wide and centred on a quarter of \e rate.
+  static std::vector<StkFloat> halfBand( StkFloat transition, StkFloat attenuation,
+                                         StkFloat rate = Stk::sampleRate() );
+
+ protected:
+
+  struct Band {
+    StkFloat lower;   // normalized frequency, 0 to 0.5
+    StkFloat upper;
+    StkFloat desired;
+    StkFloat weight;
+  };
+
+  static void checkEdges( Type type, StkFloat f1, StkFloat f2, StkFloat transition, StkFloat rate );
+  static std::vector<Band> bands( Type type, StkFloat f1, StkFloat f2, StkFloat transition,
+                                  StkFloat rate, StkFloat passWeight, StkFloat stopWeight );
+  static StkFloat largestError( const std::vector<StkFloat> &coefficients, const std::vector<Band> &bands );
+  static StkFloat remez( std::vector<StkFloat> &coefficients, unsigned int length,
+                         const std::vector<Band> &bands );
+};
+
+} // stk namespace
+
+#endif
@@ -40,6 +40,14 @@ class Generator : public Stk
   */
   virtual StkFrames& tick( StkFrames& frames, unsigned int channel = 0 ) = 0;
 
+  //! Compute \e n sample frames into the start of \e frames, the same values as \e n calls of tick().
+  /*!
+    The output channels start at channel 0 of the view, which must
+    have at least \e n frames.  The default calls tick( StkFrames& )
+    on the first \e n frames.
+  */
+  virtual void process( StkFramesView frames, unsigned int n ) { frames.resize( n, frames.channels() ); this->tick( frames ); };
+
   protected:
 
   StkFrames lastFrame_;
@@ -71,11 +71,7 @@ inline StkFloat HevyMetl :: tick( unsigned int )
 {
   StkFloat temp;
 
-  temp = vibrato_.tick() * modDepth_ * 0.2;    
-  waves_[0]->setFrequency(baseFrequency_ * (1.0 + temp) * ratios_[0]);
-  waves_[1]->setFrequency(baseFrequency_ * (1.0 + temp) * ratios_[1]);
-  waves_[2]->setFrequency(baseFrequency_ * (1.0 + temp) * ratios_[2]);
-  waves_[3]->setFrequency(baseFrequency_ * (1.0 + temp) * ratios_[3]);
+  this->setOperatorFrequencies( vibrato_.tick() * modDepth_ * 0.2 );
     
   temp = gains_[2] * adsr_[2]->tick() * waves_[2]->tick();
   waves_[1]->addPhaseOffset( temp );
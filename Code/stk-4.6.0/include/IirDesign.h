@@ -0,0 +1,45 @@
+#ifndef STK_IIRDESIGN_H
+#define STK_IIRDESIGN_H
+
+#include "FirDesign.h"
+#include "Sos.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class IirDesign
+    \brief STK Chebyshev IIR filter design class.
+
+    This class computes the sections of a Sos filter at run time from
+    the same band specification as FirDesign: passband edges in Hz,
+    the stopband beginning \e transition Hz beyond each of them,
+    \e ripple dB of passband ripple and \e attenuation dB of stopband
+    rejection.
+
+    chebyshev() designs a Chebyshev type I filter of the lowest order
+    that meets the specification.  The analog prototype is moved to
+    the band edges and mapped to the z-plane with the bilinear
+    transform, prewarped so the passband edges fall exactly where
+    asked.  The poles are computed directly, never the polynomial
+    coefficients, so high orders stay accurate.  An IIR filter meets a
+    steep specification with a small fraction of the multiplies of a
+    linear-phase FIR, at the cost of a phase response that is not
+    linear.
+
+    An StkError is thrown if a band does not fit between 0 Hz and
+    the Nyquist frequency or the order would exceed 32.
+*/
+/***************************************************/
+
+class IirDesign : public FirDesign
+{
+ public:
+  //! Chebyshev type I design for \e ripple dB (peak to peak) in the passband and \e attenuation dB in the stopband.
+  static std::vector<Sos::Section> chebyshev( Type type, StkFloat f1, StkFloat f2,
+                                              StkFloat transition, StkFloat attenuation,
+                                              StkFloat ripple, StkFloat rate = Stk::sampleRate() );
+};
+
+} // stk namespace
+
+#endif
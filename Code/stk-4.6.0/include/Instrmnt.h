@@ -12,6 +12,13 @@ namespace stk {
   This class provides a common interface for
   all STK instruments.
 
+  Instruments can be run a sample at a time with
+  tick() or a block at a time with process(), which
+  produces the same samples without a virtual call
+  per sample.  Subclasses override process() where
+  some work can be decided once per block, such as
+  skipping an attack wave that has finished.
+
   by Perry R. Cook and Gary P. Scavone, 1995--2017.
 */
 /***************************************************/
@@ -73,6 +80,15 @@ class Instrmnt : public Stk
   */
   virtual StkFrames& tick( StkFrames& frames, unsigned int channel = 0 ) = 0;
 
+  //! Compute \e n sample frames into the start of \e frames, the same values as \e n calls of tick().
+  /*!
+    The output channels start at channel 0 of the view, which must
+    have at least \e n frames.  The default calls tick( StkFrames& )
+    on the first \e n frames.  Control changes take effect at block
+    boundaries.
+  */
+  virtual void process( StkFramesView frames, unsigned int n );
+
  protected:
 
   StkFrames lastFrame_;
@@ -97,6 +113,12 @@ inline StkFloat Instrmnt :: lastOut( unsigned int channel )
   return lastFrame_[channel];
 }
 
+inline void Instrmnt :: process( StkFramesView frames, unsigned int n )
+{
+  frames.resize( n, frames.channels() );
+  this->tick( frames );
+}
+
 inline void Instrmnt :: controlChange( int number, StkFloat value )
 {
   oStream_ << "Instrmnt::controlChange: virtual function call!";
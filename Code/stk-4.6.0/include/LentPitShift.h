@@ -90,9 +90,9 @@ class LentPitShift : public Effect
 
   StkFloat threshold_; // Threshold of detection for the pitch tracker
   unsigned long lastPeriod_;    // Result of the last pitch tracking loop
-  StkFloat* dt;        // Array containing the euclidian distance coefficients
-  StkFloat* cumDt;     // Array containing the cumulative sum of the coefficients in dt
-  StkFloat* dpt;       // Array containing the pitch tracking function coefficients
+  double* dt;          // Array containing the euclidian distance coefficients
+  double* cumDt;       // Array containing the cumulative sum of the coefficients in dt
+  double* dpt;         // Array containing the pitch tracking function coefficients
 
   // Pitch shifter variables
   StkFloat env[2];     // Coefficients for the linear interpolation when modifying the output samples
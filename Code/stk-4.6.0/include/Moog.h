@@ -66,6 +66,9 @@ class Moog : public Sampler
   */
   StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
 
+  //! Compute \e n sample frames into the start of \e frames, the same values as \e n calls of tick().
+  void process( StkFramesView frames, unsigned int n );
+
  protected:
 
   FormSwep filters_[2];
@@ -0,0 +1,242 @@
+#ifndef STK_MULTIRATEFIR_H
+#define STK_MULTIRATEFIR_H
+
+#include "SymmetricFir.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class MultirateFir
+    \brief STK multirate finite impulse response filter class.
+
+    A filter whose passband and transition band sit in the lowest
+    part of the spectrum does not need the full sample rate.  This
+    class decimates its input by 2 in each of a number of stages,
+    runs a SymmetricFir at the reduced rate and interpolates the
+    result back up by 2 in as many stages.  The core filter is
+    designed for the reduced rate, so it is shorter by the same factor
+    and runs once every 2^stages samples.  A 500 Hz lowpass with a
+    200 Hz transition and 60 dB of attenuation, 473 taps at 44.1 kHz,
+    becomes four stages around a 31 tap core and runs about six times
+    faster.
+
+    Each stage is a polyphase half-band filter (see
+    FirDesign::halfBand()).  Half its coefficients are zero, so the
+    decimator computes one output per two inputs from the nonzero
+    ones only, and one phase of the interpolator is a plain delay.
+    The StkFrames tick functions run each stage over a whole chunk of
+    samples before the next one.
+    A stage passes everything up to the highest band edge of the
+    filter (passband plus transition) and stops what would alias onto
+    it.  The first stages, where the edge is a small fraction of the
+    rate, get by with a few taps; the edge may reach 7/32 of the rate
+    of the last one, and stagesFor() returns how many stages that
+    allows.  With zero stages the class is a SymmetricFir.
+
+    Use setStages() before setCoefficients(), whose coefficients are
+    those of the core filter at the rate divided by 2^stages.
+*/
+/***************************************************/
+
+class MultirateFir : public Filter
+{
+public:
+  //! Default constructor creates a zero-order pass-through "filter" with no stages.
+  MultirateFir( void );
+
+  //! Class destructor.
+  ~MultirateFir( void );
+
+  //! Return the number of stages for a filter with nothing above \e edge Hz to keep.
+  static unsigned int stagesFor( StkFloat edge, StkFloat rate = Stk::sampleRate() );
+
+  //! Set the number of decimation and interpolation stages for a filter with nothing above \e edge Hz to keep.
+  /*!
+    The stages stop aliases and images by \e attenuation dB.  The
+    internal state of the filter is cleared.  An StkError is thrown
+    if \e edge is too high for that many stages.
+  */
+  void setStages( unsigned int stages, StkFloat edge, StkFloat attenuation = 60.0,
+                  StkFloat rate = Stk::sampleRate() );
+
+  //! Return the number of decimation stages.
+  unsigned int getStages( void ) const { return stages_; };
+
+  //! Set the core filter coefficients, for the rate divided by 2^stages.
+  /*!
+    An StkError can be thrown if the coefficient vector size is
+    zero.  The internal state of the filter is not cleared unless the
+    \e clearState flag is \c true.
+  */
+  void setCoefficients( std::vector<StkFloat> &coefficients, bool clearState = false );
+
+  //! Use the minimum-phase version of the core filter, see SymmetricFir.
+  void setMinimumPhase( bool state ) { core_.setMinimumPhase( state ); };
+
+  //! Return the length of the impulse response, in samples at the full rate.
+  unsigned long getLength( void ) const;
+
+  //! Clears the input and output history of every stage.
+  void clear( void );
+
+  //! Return the last computed output value.
+  StkFloat lastOut( void ) const { return lastFrame_[0]; };
+
+  //! Input one sample to the filter and return one output.
+  StkFloat tick( StkFloat input );
+
+  //! Take a channel of the StkFrames object as inputs to the filter and replace with corresponding outputs.
+  /*!
+    The StkFrames argument reference is returned.  The \c channel
+    argument must be less than the number of channels in the
+    StkFrames argument (the first channel is specified by 0).
+    However, range checking is only performed if _STK_DEBUG_ is
+    defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
+
+  //! Take a channel of the \c iFrames object as inputs to the filter and write outputs to the \c oFrames object.
+  /*!
+    The \c iFrames object reference is returned.  Each channel
+    argument must be less than the number of channels in the
+    corresponding StkFrames argument (the first channel is specified
+    by 0).  However, range checking is only performed if _STK_DEBUG_
+    is defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
+
+protected:
+
+  // History kept twice, so the newest n samples are contiguous, newest first.
+  struct Ring {
+    std::vector<StkFloat> data;
+    unsigned int index;
+
+    void resize( unsigned int n ) { data.assign( 2 * n, 0.0 ); index = 0; };
+    void push( StkFloat x ) {
+      unsigned int n = data.size() / 2;
+      index = ( index == 0 ) ? n - 1 : index - 1;
+      data[index] = data[index + n] = x;
+    };
+    const StkFloat *newest( void ) const { return &data[index]; };
+  };
+
+  /* One decimator and its interpolator.  Even input times of the
+     decimator meet the nonzero half of the half-band, odd ones only its
+     centre; even output times of the interpolator are that half again,
+     odd ones a delayed input.
+  */
+  struct Stage {
+    std::vector<StkFloat> taps;       // h[0], h[2], ..., h[2M] of the half-band
+    unsigned int center;              // M, odd
+    Ring even;                        // decimator inputs at even times
+    Ring odd;                         // and at odd times
+    Ring inputs;                      // interpolator inputs
+    bool oddIn;
+    bool oddOut;
+    std::vector<StkFloat> block;      // a chunk of input at this stage's rate
+  };
+
+  // The half-band kernels are short: a plain loop beats the SIMD set-up and reduction.
+  static StkFloat halfBandSum( const StkFloat *taps, const StkFloat *x, unsigned int n ) {
+    StkFloat sum = 0.0;
+    for ( unsigned int i=0; i<n; i++ ) sum += taps[i] * x[i];
+    return sum;
+  };
+
+  StkFloat computeSample( StkFloat input );
+  void computeBlock( const StkFloat *input, unsigned int iHop, StkFloat *output, unsigned int oHop, unsigned int n );
+  static unsigned int decimate( Stage &d, const StkFloat *in, unsigned int n, StkFloat *out );
+  static void interpolate( Stage &u, const StkFloat *in, unsigned int n, StkFloat *out );
+
+  unsigned int stages_;
+  std::vector<Stage> stage_;
+  std::vector<StkFloat> coreBlock_;
+  SymmetricFir core_;
+  unsigned int coreLength_;
+  StkFloat coreOut_;
+};
+
+inline StkFloat MultirateFir :: computeSample( StkFloat input )
+{
+  StkFloat value = gain_ * input;
+  unsigned int s;
+
+  // Down: a stage passes a sample on for every second one it takes.
+  for ( s=0; s<stages_; s++ ) {
+    Stage &d = stage_[s];
+    if ( d.oddIn ) {
+      d.odd.push( value );
+      d.oddIn = false;
+      break;
+    }
+    d.even.push( value );
+    d.oddIn = true;
+    value = halfBandSum( &d.taps[0], d.even.newest(), d.center + 1 )
+      + 0.5 * d.odd.newest()[( d.center - 1 ) / 2];
+  }
+  if ( s == stages_ ) coreOut_ = core_.tick( value );
+
+  // Up: stages due for their even phase take a new input from the one below.
+  for ( s=0; s<stages_ && !stage_[s].oddOut; s++ ) ;
+  StkFloat out = coreOut_;
+  if ( s < stages_ ) {
+    stage_[s].oddOut = false;
+    out = stage_[s].inputs.newest()[( stage_[s].center - 1 ) / 2];
+  }
+  while ( s-- > 0 ) {
+    Stage &u = stage_[s];
+    u.inputs.push( out );
+    u.oddOut = true;
+    out = 2.0 * halfBandSum( &u.taps[0], u.inputs.newest(), u.center + 1 );
+  }
+
+  return out;
+}
+
+inline StkFloat MultirateFir :: tick( StkFloat input )
+{
+  lastFrame_[0] = computeSample( input );
+  return lastFrame_[0];
+}
+
+inline StkFrames& MultirateFir :: tick( StkFrames& frames, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel >= frames.channels() ) {
+    oStream_ << "MultirateFir::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *samples = &frames[channel];
+  unsigned int hop = frames.channels();
+  computeBlock( samples, hop, samples, hop, frames.frames() );
+
+  lastFrame_[0] = samples[hop * ( frames.frames() - 1 )];
+  return frames;
+}
+
+inline StkFrames& MultirateFir :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
+{
+#if defined(_STK_DEBUG_)
+  if ( iChannel >= iFrames.channels() || oChannel >= oFrames.channels() ) {
+    oStream_ << "MultirateFir::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *iSamples = &iFrames[iChannel];
+  StkFloat *oSamples = &oFrames[oChannel];
+  unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
+  computeBlock( iSamples, iHop, oSamples, oHop, iFrames.frames() );
+
+  lastFrame_[0] = oSamples[oHop * ( iFrames.frames() - 1 )];
+  return iFrames;
+}
+
+} // stk namespace
+
+#endif
@@ -72,11 +72,7 @@ inline StkFloat PercFlut :: tick( unsigned int )
 {
   StkFloat temp;
 
-  temp = vibrato_.tick() * modDepth_ * 0.2;    
-  waves_[0]->setFrequency(baseFrequency_ * (1.0 + temp) * ratios_[0]);
-  waves_[1]->setFrequency(baseFrequency_ * (1.0 + temp) * ratios_[1]);
-  waves_[2]->setFrequency(baseFrequency_ * (1.0 + temp) * ratios_[2]);
-  waves_[3]->setFrequency(baseFrequency_ * (1.0 + temp) * ratios_[3]);
+  this->setOperatorFrequencies( vibrato_.tick() * modDepth_ * 0.2 );
     
   waves_[3]->addPhaseOffset( twozero_.lastOut() );
   temp = gains_[3] * adsr_[3]->tick() * waves_[3]->tick();
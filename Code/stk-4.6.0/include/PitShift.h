@@ -62,9 +62,9 @@ class PitShift : public Effect
  protected:
 
   DelayL delayLine_[2];
-  StkFloat delay_[2];
+  double delay_[2];
   StkFloat env_[2];
-  StkFloat rate_;
+  double rate_;
   unsigned long delayLength_;
   unsigned long halfLength_;
 
@@ -0,0 +1,78 @@
+#ifndef STK_REALTIME_H
+#define STK_REALTIME_H
+
+#include "Stk.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class Realtime
+    \brief STK realtime thread setup class.
+
+    This class gathers the calls an audio thread needs before it
+    enters its processing loop: SCHED_FIFO priority, pinning to one
+    CPU, locking the process memory with mlockall() and prefaulting
+    the thread's stack so that the first periods do not take page
+    faults.
+
+    Every function falls back gracefully.  When the process lacks the
+    privilege (e.g. no CAP_SYS_NICE or RLIMIT_RTPRIO, or too small an
+    RLIMIT_MEMLOCK) a warning is printed and false is returned, and
+    the thread keeps running as it was.  Affinity is only supported
+    under Linux, priority and memory locking on all pthread systems.
+
+    The functions act on the calling thread.  Thread::start() can
+    apply them to a new thread before its routine runs.
+*/
+/***************************************************/
+
+class Realtime : public Stk
+{
+ public:
+  //! Run the calling thread under SCHED_FIFO at \e priority (1--99).
+  static bool setPriority( int priority );
+
+  //! Pin the calling thread to \e cpu.
+  /*!
+    Threads and processes started by the calling thread afterwards
+    inherit its affinity.
+  */
+  static bool setAffinity( int cpu );
+
+  //! Keep the calling thread, and anything it starts afterwards, off \e cpu.
+  /*!
+    Used by housekeeping threads to leave a CPU to the audio thread.
+    Nothing is changed when \e cpu is the only CPU allowed.
+  */
+  static bool avoidCpu( int cpu );
+
+  //! Lock all current and future pages of the process into memory.
+  static bool lockMemory( void );
+
+  //! Touch \e bytes of the calling thread's stack so its pages are resident.
+  static void prefaultStack( size_t bytes = 65536 );
+
+  //! Set up the calling thread as an audio thread.
+  /*!
+    Applies setPriority() when \e priority is greater than zero and
+    setAffinity() when \e cpu is zero or more, then prefaults the
+    stack.  Returns false if any requested step failed.
+  */
+  static bool setupThread( int priority, int cpu = -1, size_t stackBytes = 65536 );
+
+  //! Return the last online CPU, or -1 on a single-CPU system.
+  /*!
+    A sensible default for setAffinity() that leaves CPU 0, which
+    takes most interrupts and housekeeping, to the rest of the system.
+  */
+  static int defaultCpu( void );
+
+ protected:
+
+  // Print the warning in oStream_ and clear it.
+  static void warn( void );
+};
+
+} // stk namespace
+
+#endif
@@ -0,0 +1,357 @@
+#ifndef STK_SAMPLECONVERT_H
+#define STK_SAMPLECONVERT_H
+
+#include "Simd.h"
+#include <stdint.h>
+#include <cstring>
+#include <cmath>
+
+namespace stk {
+
+/***************************************************/
+/*! \file SampleConvert.h
+    \brief STK sample format conversion kernels.
+
+    Conversions between StkFloat buffers (float or double) and the
+    linear formats used by sound devices and files: signed 16-bit,
+    packed little-endian 24-bit (three bytes per sample), signed
+    32-bit and 32-bit float.  The 16-bit, 32-bit and float formats
+    are in host byte order.
+
+    Every function converts \e n consecutive samples, so an
+    interleaved multi-channel buffer is converted by passing
+    frames * channels.  Integer samples map to floating-point by
+    division by 2^(bits-1), so full scale is [-1.0, 1.0).  Conversions
+    to integer formats round to nearest and saturate at the format
+    limits instead of wrapping around, and can add triangular (TPDF)
+    dither of +/-1 LSB from a SampleDither object.  Conversions to
+    32-bit float are not clipped.
+
+    The 16-bit, 32-bit and float kernels use SSE2 on x86 and NEON on
+    AArch64 (single precision only), with the scalar code elsewhere or
+    when _STK_NO_SIMD_ is defined.  The 24-bit kernels are scalar.
+*/
+/***************************************************/
+
+#if defined(__STK_SIMD_AVX__) || defined(__STK_SIMD_SSE2__)
+  #define __STK_CONVERT_SSE2__
+#elif defined(__STK_SIMD_NEON__) && defined(__aarch64__)
+  #define __STK_CONVERT_NEON__
+#endif
+
+//! Triangular probability density dither source.
+/*!
+  Each tick() returns the difference of two uniform random values,
+  a triangular distribution over (-1, 1) in units of one LSB.  The
+  generator is a linear congruential one, cheap enough to run per
+  sample in the audio thread.
+*/
+class SampleDither
+{
+ public:
+  //! Class constructor, taking an optional seed.
+  SampleDither( uint32_t seed = 1 ) : state_( seed ) {};
+
+  //! Return the next dither value in (-1, 1).
+  float tick( void ) { float a = uniform(); return a - uniform(); };
+
+ private:
+  float uniform( void )
+  {
+    state_ = state_ * 1664525u + 1013904223u;
+    return ( state_ >> 8 ) * ( 1.0f / 16777216.0f );
+  };
+
+  uint32_t state_;
+};
+
+// Scale, dither, clamp to [lo, hi] and round one sample.  NaN becomes
+// lo, as in the SSE2 kernels.  Those only clamp the top of the range:
+// the SSE2 conversions return INT_MIN for anything below the int32
+// range (and for NaN), and the 16-bit pack saturates.
+template <typename T>
+inline long quantizeSample( T x, T scale, T lo, T hi, SampleDither *dither )
+{
+  x *= scale;
+  if ( dither ) x += dither->tick();
+  if ( !( x >= lo ) ) x = lo;
+  else if ( x > hi ) x = hi;
+  return std::lrint( x );
+}
+
+// The largest value below 2^31 that float can hold.
+const float INT32_FLOAT_MAX = 2147483520.0f;
+
+//
+// Signed 16-bit
+//
+
+//! Convert \e n signed 16-bit samples to float in [-1.0, 1.0).
+inline void convertFromInt16( const int16_t *in, float *out, size_t n )
+{
+  const float scale = 1.0f / 32768.0f;
+  size_t i = 0;
+#if defined(__STK_CONVERT_SSE2__)
+  const __m128 vscale = _mm_set1_ps( scale );
+  for ( ; i+8<=n; i+=8 ) {
+    __m128i v = _mm_loadu_si128( (const __m128i *) ( in+i ) );
+    __m128i lo = _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 );
+    __m128i hi = _mm_srai_epi32( _mm_unpackhi_epi16( v, v ), 16 );
+    _mm_storeu_ps( out+i, _mm_mul_ps( _mm_cvtepi32_ps( lo ), vscale ) );
+    _mm_storeu_ps( out+i+4, _mm_mul_ps( _mm_cvtepi32_ps( hi ), vscale ) );
+  }
+#elif defined(__STK_CONVERT_NEON__)
+  for ( ; i+8<=n; i+=8 ) {
+    int16x8_t v = vld1q_s16( in+i );
+    vst1q_f32( out+i, vmulq_n_f32( vcvtq_f32_s32( vmovl_s16( vget_low_s16( v ) ) ), scale ) );
+    vst1q_f32( out+i+4, vmulq_n_f32( vcvtq_f32_s32( vmovl_s16( vget_high_s16( v ) ) ), scale ) );
+  }
+#endif
+  for ( ; i<n; i++ )
+    out[i] = in[i] * scale;
+}
+
+//! Convert \e n signed 16-bit samples to double in [-1.0, 1.0).
+inline void convertFromInt16( const int16_t *in, double *out, size_t n )
+{
+  const double scale = 1.0 / 32768.0;
+  size_t i = 0;
+#if defined(__STK_CONVERT_SSE2__)
+  const __m128d vscale = _mm_set1_pd( scale );
+  for ( ; i+4<=n; i+=4 ) {
+    __m128i v = _mm_loadl_epi64( (const __m128i *) ( in+i ) );
+    v = _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 );
+    _mm_storeu_pd( out+i, _mm_mul_pd( _mm_cvtepi32_pd( v ), vscale ) );
+    _mm_storeu_pd( out+i+2, _mm_mul_pd( _mm_cvtepi32_pd( _mm_shuffle_epi32( v, _MM_SHUFFLE( 1, 0, 3, 2 ) ) ), vscale ) );
+  }
+#endif
+  for ( ; i<n; i++ )
+    out[i] = in[i] * scale;
+}
+
+//! Convert \e n float samples to signed 16-bit with saturation and optional dither.
+inline void convertToInt16( const float *in, int16_t *out, size_t n, SampleDither *dither = 0 )
+{
+  size_t i = 0;
+#if defined(__STK_CONVERT_SSE2__)
+  const __m128 vscale = _mm_set1_ps( 32768.0f );
+  const __m128 vhi = _mm_set1_ps( 32767.0f );
+  float d[8] = { 0.0f };
+  for ( ; i+8<=n; i+=8 ) {
+    if ( dither )
+      for ( int k=0; k<8; k++ ) d[k] = dither->tick();
+    __m128 a = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( in+i ), vscale ), _mm_loadu_ps( d ) );
+    __m128 b = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( in+i+4 ), vscale ), _mm_loadu_ps( d+4 ) );
+    a = _mm_min_ps( vhi, a );
+    b = _mm_min_ps( vhi, b );
+    _mm_storeu_si128( (__m128i *) ( out+i ), _mm_packs_epi32( _mm_cvtps_epi32( a ), _mm_cvtps_epi32( b ) ) );
+  }
+#elif defined(__STK_CONVERT_NEON__)
+  float d[8] = { 0.0f };
+  for ( ; i+8<=n; i+=8 ) {
+    if ( dither )
+      for ( int k=0; k<8; k++ ) d[k] = dither->tick();
+    float32x4_t a = vaddq_f32( vmulq_n_f32( vld1q_f32( in+i ), 32768.0f ), vld1q_f32( d ) );
+    float32x4_t b = vaddq_f32( vmulq_n_f32( vld1q_f32( in+i+4 ), 32768.0f ), vld1q_f32( d+4 ) );
+    // vcvtnq rounds to nearest and vqmovn narrows with saturation.
+    vst1q_s16( out+i, vcombine_s16( vqmovn_s32( vcvtnq_s32_f32( a ) ), vqmovn_s32( vcvtnq_s32_f32( b ) ) ) );
+  }
+#endif
+  for ( ; i<n; i++ )
+    out[i] = (int16_t) quantizeSample( in[i], 32768.0f, -32768.0f, 32767.0f, dither );
+}
+
+//! Convert \e n double samples to signed 16-bit with saturation and optional dither.
+inline void convertToInt16( const double *in, int16_t *out, size_t n, SampleDither *dither = 0 )
+{
+  size_t i = 0;
+#if defined(__STK_CONVERT_SSE2__)
+  const __m128d vscale = _mm_set1_pd( 32768.0 );
+  const __m128d vhi = _mm_set1_pd( 32767.0 );
+  double d[8] = { 0.0 };
+  for ( ; i+8<=n; i+=8 ) {
+    if ( dither )
+      for ( int k=0; k<8; k++ ) d[k] = dither->tick();
+    __m128i q[4];
+    for ( int k=0; k<4; k++ ) {
+      __m128d x = _mm_add_pd( _mm_mul_pd( _mm_loadu_pd( in+i+2*k ), vscale ), _mm_loadu_pd( d+2*k ) );
+      q[k] = _mm_cvtpd_epi32( _mm_min_pd( vhi, x ) );
+    }
+    __m128i a = _mm_unpacklo_epi64( q[0], q[1] );
+    __m128i b = _mm_unpacklo_epi64( q[2], q[3] );
+    _mm_storeu_si128( (__m128i *) ( out+i ), _mm_packs_epi32( a, b ) );
+  }
+#endif
+  for ( ; i<n; i++ )
+    out[i] = (int16_t) quantizeSample( in[i], 32768.0, -32768.0, 32767.0, dither );
+}
+
+//
+// Packed little-endian 24-bit
+//
+
+//! Convert \e n packed little-endian 24-bit samples to floating-point in [-1.0, 1.0).
+template <typename T>
+inline void convertFromInt24( const unsigned char *in, T *out, size_t n )
+{
+  const T scale = (T) ( 1.0 / 8388608.0 );
+  for ( size_t i=0; i<n; i++, in+=3 ) {
+    // Shift into the top of an int32 so the sign extends.
+    int32_t x = (int32_t) ( ( (uint32_t) in[0] << 8 ) | ( (uint32_t) in[1] << 16 ) | ( (uint32_t) in[2] << 24 ) );
+    out[i] = ( x >> 8 ) * scale;
+  }
+}
+
+//! Convert \e n floating-point samples to packed little-endian 24-bit with saturation and optional dither.
+template <typename T>
+inline void convertToInt24( const T *in, unsigned char *out, size_t n, SampleDither *dither = 0 )
+{
+  for ( size_t i=0; i<n; i++, out+=3 ) {
+    long x = quantizeSample( in[i], (T) 8388608.0, (T) -8388608.0, (T) 8388607.0, dither );
+    out[0] = (unsigned char) ( x & 0xff );
+    out[1] = (unsigned char) ( ( x >> 8 ) & 0xff );
+    out[2] = (unsigned char) ( ( x >> 16 ) & 0xff );
+  }
+}
+
+//
+// Signed 32-bit
+//
+
+//! Convert \e n signed 32-bit samples to float in [-1.0, 1.0].
+inline void convertFromInt32( const int32_t *in, float *out, size_t n )
+{
+  const float scale = 1.0f / 2147483648.0f;
+  size_t i = 0;
+#if defined(__STK_CONVERT_SSE2__)
+  const __m128 vscale = _mm_set1_ps( scale );
+  for ( ; i+4<=n; i+=4 )
+    _mm_storeu_ps( out+i, _mm_mul_ps( _mm_cvtepi32_ps( _mm_loadu_si128( (const __m128i *) ( in+i ) ) ), vscale ) );
+#elif defined(__STK_CONVERT_NEON__)
+  for ( ; i+4<=n; i+=4 )
+    vst1q_f32( out+i, vmulq_n_f32( vcvtq_f32_s32( vld1q_s32( in+i ) ), scale ) );
+#endif
+  for ( ; i<n; i++ )
+    out[i] = in[i] * scale;
+}
+
+//! Convert \e n signed 32-bit samples to double in [-1.0, 1.0).
+inline void convertFromInt32( const int32_t *in, double *out, size_t n )
+{
+  const double scale = 1.0 / 2147483648.0;
+  size_t i = 0;
+#if defined(__STK_CONVERT_SSE2__)
+  const __m128d vscale = _mm_set1_pd( scale );
+  for ( ; i+4<=n; i+=4 ) {
+    __m128i v = _mm_loadu_si128( (const __m128i *) ( in+i ) );
+    _mm_storeu_pd( out+i, _mm_mul_pd( _mm_cvtepi32_pd( v ), vscale ) );
+    _mm_storeu_pd( out+i+2, _mm_mul_pd( _mm_cvtepi32_pd( _mm_shuffle_epi32( v, _MM_SHUFFLE( 1, 0, 3, 2 ) ) ), vscale ) );
+  }
+#endif
+  for ( ; i<n; i++ )
+    out[i] = in[i] * scale;
+}
+
+//! Convert \e n float samples to signed 32-bit with saturation and optional dither.
+/*!
+  Single precision cannot represent 2^31 - 1, so positive full scale
+  saturates at 2^31 - 128.
+*/
+inline void convertToInt32( const float *in, int32_t *out, size_t n, SampleDither *dither = 0 )
+{
+  size_t i = 0;
+#if defined(__STK_CONVERT_SSE2__)
+  const __m128 vscale = _mm_set1_ps( 2147483648.0f );
+  const __m128 vhi = _mm_set1_ps( INT32_FLOAT_MAX );
+  float d[4] = { 0.0f };
+  for ( ; i+4<=n; i+=4 ) {
+    if ( dither )
+      for ( int k=0; k<4; k++ ) d[k] = dither->tick();
+    __m128 x = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( in+i ), vscale ), _mm_loadu_ps( d ) );
+    x = _mm_min_ps( vhi, x );
+    _mm_storeu_si128( (__m128i *) ( out+i ), _mm_cvtps_epi32( x ) );
+  }
+#elif defined(__STK_CONVERT_NEON__)
+  float d[4] = { 0.0f };
+  for ( ; i+4<=n; i+=4 ) {
+    if ( dither )
+      for ( int k=0; k<4; k++ ) d[k] = dither->tick();
+    float32x4_t x = vaddq_f32( vmulq_n_f32( vld1q_f32( in+i ), 2147483648.0f ), vld1q_f32( d ) );
+    vst1q_s32( out+i, vcvtnq_s32_f32( x ) );
+  }
+#endif
+  for ( ; i<n; i++ )
+    out[i] = (int32_t) quantizeSample( in[i], 2147483648.0f, -2147483648.0f, INT32_FLOAT_MAX, dither );
+}
+
+//! Convert \e n double samples to signed 32-bit with saturation and optional dither.
+inline void convertToInt32( const double *in, int32_t *out, size_t n, SampleDither *dither = 0 )
+{
+  size_t i = 0;
+#if defined(__STK_CONVERT_SSE2__)
+  const __m128d vscale = _mm_set1_pd( 2147483648.0 );
+  const __m128d vhi = _mm_set1_pd( 2147483647.0 );
+  double d[4] = { 0.0 };
+  for ( ; i+4<=n; i+=4 ) {
+    if ( dither )
+      for ( int k=0; k<4; k++ ) d[k] = dither->tick();
+    __m128d a = _mm_add_pd( _mm_mul_pd( _mm_loadu_pd( in+i ), vscale ), _mm_loadu_pd( d ) );
+    __m128d b = _mm_add_pd( _mm_mul_pd( _mm_loadu_pd( in+i+2 ), vscale ), _mm_loadu_pd( d+2 ) );
+    a = _mm_min_pd( vhi, a );
+    b = _mm_min_pd( vhi, b );
+    _mm_storeu_si128( (__m128i *) ( out+i ), _mm_unpacklo_epi64( _mm_cvtpd_epi32( a ), _mm_cvtpd_epi32( b ) ) );
+  }
+#endif
+  for ( ; i<n; i++ )
+    out[i] = (int32_t) quantizeSample( in[i], 2147483648.0, -2147483648.0, 2147483647.0, dither );
+}
+
+//
+// 32-bit float
+//
+
+//! Copy \e n 32-bit float samples.
+inline void convertFromFloat32( const float *in, float *out, size_t n )
+{
+  if ( in != out ) memmove( out, in, n * sizeof( float ) );
+}
+
+//! Convert \e n 32-bit float samples to double.
+inline void convertFromFloat32( const float *in, double *out, size_t n )
+{
+  size_t i = 0;
+#if defined(__STK_CONVERT_SSE2__)
+  for ( ; i+4<=n; i+=4 ) {
+    __m128 v = _mm_loadu_ps( in+i );
+    _mm_storeu_pd( out+i, _mm_cvtps_pd( v ) );
+    _mm_storeu_pd( out+i+2, _mm_cvtps_pd( _mm_movehl_ps( v, v ) ) );
+  }
+#endif
+  for ( ; i<n; i++ )
+    out[i] = in[i];
+}
+
+//! Copy \e n 32-bit float samples.
+inline void convertToFloat32( const float *in, float *out, size_t n )
+{
+  if ( in != out ) memmove( out, in, n * sizeof( float ) );
+}
+
+//! Convert \e n double samples to 32-bit float.
+inline void convertToFloat32( const double *in, float *out, size_t n )
+{
+  size_t i = 0;
+#if defined(__STK_CONVERT_SSE2__)
+  for ( ; i+4<=n; i+=4 ) {
+    __m128 a = _mm_cvtpd_ps( _mm_loadu_pd( in+i ) );
+    __m128 b = _mm_cvtpd_ps( _mm_loadu_pd( in+i+2 ) );
+    _mm_storeu_ps( out+i, _mm_movelh_ps( a, b ) );
+  }
+#endif
+  for ( ; i<n; i++ )
+    out[i] = (float) in[i];
+}
+
+} // stk namespace
+
+#endif
@@ -2,6 +2,7 @@
 #define STK_SHAKERS_H
 
 #include "Instrmnt.h"
+#include "BiQuadBank.h"
 #include <cmath>
 #include <stdlib.h>
 
@@ -112,8 +113,6 @@ class Shakers : public Instrmnt
  protected:
 
   void setType( int type );
-  void setResonance( BiQuad &filter, StkFloat frequency, StkFloat radius );
-  StkFloat tickResonance( BiQuad &filter, StkFloat input );
   void setEqualization( StkFloat b0, StkFloat b1, StkFloat b2 );
   StkFloat tickEqualize( StkFloat input );
   int randomInt( int max );
@@ -139,7 +138,8 @@ class Shakers : public Instrmnt
   StkFloat baseRatchetDelta_;
   int lastRatchetValue_;
 
-  std::vector< BiQuad > filters_;
+  BiQuadBank filters_;
+  std::vector< StkFloat > baseGains_;  // Angklung tubes, gated per event
   std::vector< StkFloat > baseFrequencies_;
   std::vector< StkFloat > baseRadii_;
   std::vector< bool > doVaryFrequency_;
@@ -147,21 +147,6 @@ class Shakers : public Instrmnt
   StkFloat varyFactor_;
 };
 
-inline void Shakers :: setResonance( BiQuad &filter, StkFloat frequency, StkFloat radius )
-{
-  filter.a[1] = -2.0 * radius * cos( TWO_PI * frequency / Stk::sampleRate());
-  filter.a[2] = radius * radius;
-}
-
-inline StkFloat Shakers :: tickResonance( BiQuad &filter, StkFloat input )
-{
-  filter.outputs[0] = input * filter.gain * currentGain_;
-  filter.outputs[0] -= filter.a[1] * filter.outputs[1] + filter.a[2] * filter.outputs[2];
-  filter.outputs[2] = filter.outputs[1];
-  filter.outputs[1] = filter.outputs[0];
-  return filter.outputs[0];
-}
-
 inline void Shakers :: setEqualization( StkFloat b0, StkFloat b1, StkFloat b2 )
 {
   equalizer_.b[0] = b0;
@@ -201,35 +186,35 @@ inline void Shakers :: waterDrop( void )
   if ( randomInt( 32767 ) < nObjects_) {
     sndLevel_ = shakeEnergy_;   
     unsigned int j = randomInt( 3 );
-    if ( j == 0 && filters_[0].gain == 0.0 ) { // don't change unless fully decayed
+    if ( j == 0 && filters_.getFilterGain( 0 ) == 0.0 ) { // don't change unless fully decayed
       tempFrequencies_[0] = baseFrequencies_[1] * (0.75 + (0.25 * noise()));
-      filters_[0].gain = fabs( noise() );
+      filters_.setFilterGain( 0, fabs( noise() ) );
     }
-    else if (j == 1 && filters_[1].gain == 0.0) {
+    else if (j == 1 && filters_.getFilterGain( 1 ) == 0.0) {
       tempFrequencies_[1] = baseFrequencies_[1] * (1.0 + (0.25 * noise()));
-      filters_[1].gain = fabs( noise() );
+      filters_.setFilterGain( 1, fabs( noise() ) );
     }
-    else if ( filters_[2].gain == 0.0 ) {
+    else if ( filters_.getFilterGain( 2 ) == 0.0 ) {
       tempFrequencies_[2] = baseFrequencies_[1] * (1.25 + (0.25 * noise()));
-      filters_[2].gain = fabs( noise() );
+      filters_.setFilterGain( 2, fabs( noise() ) );
     }
   }
 
   // Sweep center frequencies.
   for ( unsigned int i=0; i<3; i++ ) { // WATER_RESONANCES = 3
-    filters_[i].gain *= baseRadii_[i];
-    if ( filters_[i].gain > 0.001 ) {
+    StkFloat gain = filters_.getFilterGain( i ) * baseRadii_[i];
+    if ( gain > 0.001 ) {
       tempFrequencies_[i] *= WATER_FREQ_SWEEP;
-      filters_[i].a[1] = -2.0 * baseRadii_[i] * cos( TWO_PI * tempFrequencies_[i] / Stk::sampleRate() );
+      filters_.setResonance( i, tempFrequencies_[i], baseRadii_[i] );
     }
     else
-      filters_[i].gain = 0.0;
+      gain = 0.0;
+    filters_.setFilterGain( i, gain );
   }
 }
 
 inline StkFloat Shakers :: tick( unsigned int )
 {
-  unsigned int iTube = 0;
   StkFloat input = 0.0;
   if ( shakerType_ == 19 || shakerType_ == 20 ) {
     if ( ratchetCount_ <= 0 ) return lastFrame_[0] = 0.0;
@@ -265,10 +250,15 @@ inline StkFloat Shakers :: tick( unsigned int )
         for ( unsigned int i=0; i<nResonances_; i++ ) {
           if ( doVaryFrequency_[i] ) {
             StkFloat tempRand = baseFrequencies_[i] * ( 1.0 + ( varyFactor_ * noise() ) );
-            filters_[i].a[1] = -2.0 * baseRadii_[i] * cos( TWO_PI * tempRand / Stk::sampleRate() );
+            filters_.setResonance( i, tempRand, baseRadii_[i] );
           }
         }
-        if ( shakerType_ == 22 ) iTube = randomInt( 7 ); // ANGKLUNG_RESONANCES
+        if ( shakerType_ == 22 ) {
+          // Only the struck tube hears this event.
+          unsigned int iTube = randomInt( 7 ); // ANGKLUNG_RESONANCES
+          for ( unsigned int i=0; i<nResonances_; i++ )
+            filters_.setFilterGain( i, ( i == iTube ) ? baseGains_[i] : 0.0 );
+        }
       }
     }
   }
@@ -277,19 +267,7 @@ inline StkFloat Shakers :: tick( unsigned int )
   sndLevel_ *= soundDecay_;
 
   // Do resonance filtering
-  lastFrame_[0] = 0.0;
-  if ( shakerType_ == 22 ) {
-    for ( unsigned int i=0; i<nResonances_; i++ ) {
-      if ( i == iTube )
-        lastFrame_[0] += tickResonance( filters_[i], input );
-      else
-        lastFrame_[0] += tickResonance( filters_[i], 0.0 );
-    }
-  }
-  else {
-    for ( unsigned int i=0; i<nResonances_; i++ )
-      lastFrame_[0] += tickResonance( filters_[i], input );
-  }
+  lastFrame_[0] = filters_.tick( input * currentGain_ );
 
   // Do final FIR filtering (lowpass or highpass)
   lastFrame_[0] = tickEqualize( lastFrame_[0] );
@@ -0,0 +1,1295 @@
+#ifndef STK_SIMD_H
+#define STK_SIMD_H
+
+#include "Stk.h"
+#include <cstring>
+
+#if defined(__AVX__)
+  #include <immintrin.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+#endif
+
+namespace stk {
+
+/***************************************************/
+/*! \file Simd.h
+    \brief STK vector arithmetic kernels.
+
+    Inner loops shared by the block processing paths of the filter
+    classes.  The instruction set is chosen at compile time: AVX if
+    the compiler targets it (e.g. -mavx), otherwise SSE2 on x86 and
+    NEON on ARM (double precision lanes only on AArch64).  Every kernel
+    has a scalar fallback.
+
+    The vector versions sum in a different order than the scalar
+    loops, so their results can differ from the scalar ones in the
+    last bits.  Defining _STK_NO_SIMD_ forces the scalar code.
+
+    The decode kernels, which convert audio file samples to StkFloat
+    values for FileRead, have SSE2 code (also used by AVX builds) and
+    give exactly the same values as their scalar loops.
+*/
+/***************************************************/
+
+#if !defined(_STK_NO_SIMD_)
+  #if defined(__AVX__)
+    #define __STK_SIMD_AVX__
+  #elif defined(__SSE2__)
+    #define __STK_SIMD_SSE2__
+  #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define __STK_SIMD_NEON__
+  #endif
+#endif
+
+//! Number of StkFloat values in a vector register, 1 for the scalar code.
+#if defined(__STK_SIMD_AVX__)
+const unsigned int SIMD_LANES = 32 / sizeof( StkFloat );
+#elif defined(__STK_SIMD_SSE2__) || ( defined(__STK_SIMD_NEON__) && ( defined(__aarch64__) || defined(__STK_FLOAT32__) ) )
+const unsigned int SIMD_LANES = 16 / sizeof( StkFloat );
+#else
+const unsigned int SIMD_LANES = 1;
+#endif
+
+//! Return the sum of a[i] * b[i] for i = 0 ... n-1.
+/*!
+  The scalar fallback accumulates from the last element down to the
+  first, the same order as the original Fir tick loop.
+*/
+inline double dotProduct( const double *a, const double *b, unsigned int n )
+{
+  unsigned int i = 0;
+  double sum = 0.0;
+
+#if defined(__STK_SIMD_AVX__)
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  for ( ; i+8<=n; i+=8 ) {
+    acc0 = _mm256_add_pd( acc0, _mm256_mul_pd( _mm256_loadu_pd( a+i ), _mm256_loadu_pd( b+i ) ) );
+    acc1 = _mm256_add_pd( acc1, _mm256_mul_pd( _mm256_loadu_pd( a+i+4 ), _mm256_loadu_pd( b+i+4 ) ) );
+  }
+  acc0 = _mm256_add_pd( acc0, acc1 );
+  __m128d half = _mm_add_pd( _mm256_castpd256_pd128( acc0 ), _mm256_extractf128_pd( acc0, 1 ) );
+  sum = _mm_cvtsd_f64( _mm_add_sd( half, _mm_unpackhi_pd( half, half ) ) );
+#elif defined(__STK_SIMD_SSE2__)
+  __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+  for ( ; i+4<=n; i+=4 ) {
+    acc0 = _mm_add_pd( acc0, _mm_mul_pd( _mm_loadu_pd( a+i ), _mm_loadu_pd( b+i ) ) );
+    acc1 = _mm_add_pd( acc1, _mm_mul_pd( _mm_loadu_pd( a+i+2 ), _mm_loadu_pd( b+i+2 ) ) );
+  }
+  acc0 = _mm_add_pd( acc0, acc1 );
+  sum = _mm_cvtsd_f64( _mm_add_sd( acc0, _mm_unpackhi_pd( acc0, acc0 ) ) );
+#elif defined(__STK_SIMD_NEON__) && defined(__aarch64__)
+  float64x2_t acc0 = vdupq_n_f64( 0.0 ), acc1 = vdupq_n_f64( 0.0 );
+  for ( ; i+4<=n; i+=4 ) {
+    acc0 = vfmaq_f64( acc0, vld1q_f64( a+i ), vld1q_f64( b+i ) );
+    acc1 = vfmaq_f64( acc1, vld1q_f64( a+i+2 ), vld1q_f64( b+i+2 ) );
+  }
+  sum = vaddvq_f64( vaddq_f64( acc0, acc1 ) );
+#endif
+
+  if ( i == 0 ) {
+    for ( unsigned int j=n; j>0; j-- )
+      sum += a[j-1] * b[j-1];
+  }
+  else {
+    for ( ; i<n; i++ )
+      sum += a[i] * b[i];
+  }
+
+  return sum;
+}
+
+//! Return the sum of a[i] * b[i] for i = 0 ... n-1.
+/*!
+  The scalar fallback accumulates from the last element down to the
+  first, the same order as the original Fir tick loop.
+*/
+inline float dotProduct( const float *a, const float *b, unsigned int n )
+{
+  unsigned int i = 0;
+  float sum = 0.0f;
+
+#if defined(__STK_SIMD_AVX__)
+  __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+  for ( ; i+16<=n; i+=16 ) {
+    acc0 = _mm256_add_ps( acc0, _mm256_mul_ps( _mm256_loadu_ps( a+i ), _mm256_loadu_ps( b+i ) ) );
+    acc1 = _mm256_add_ps( acc1, _mm256_mul_ps( _mm256_loadu_ps( a+i+8 ), _mm256_loadu_ps( b+i+8 ) ) );
+  }
+  acc0 = _mm256_add_ps( acc0, acc1 );
+  __m128 quad = _mm_add_ps( _mm256_castps256_ps128( acc0 ), _mm256_extractf128_ps( acc0, 1 ) );
+  quad = _mm_add_ps( quad, _mm_movehl_ps( quad, quad ) );
+  sum = _mm_cvtss_f32( _mm_add_ss( quad, _mm_shuffle_ps( quad, quad, 1 ) ) );
+#elif defined(__STK_SIMD_SSE2__)
+  __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+  for ( ; i+8<=n; i+=8 ) {
+    acc0 = _mm_add_ps( acc0, _mm_mul_ps( _mm_loadu_ps( a+i ), _mm_loadu_ps( b+i ) ) );
+    acc1 = _mm_add_ps( acc1, _mm_mul_ps( _mm_loadu_ps( a+i+4 ), _mm_loadu_ps( b+i+4 ) ) );
+  }
+  acc0 = _mm_add_ps( acc0, acc1 );
+  acc0 = _mm_add_ps( acc0, _mm_movehl_ps( acc0, acc0 ) );
+  sum = _mm_cvtss_f32( _mm_add_ss( acc0, _mm_shuffle_ps( acc0, acc0, 1 ) ) );
+#elif defined(__STK_SIMD_NEON__)
+  float32x4_t acc0 = vdupq_n_f32( 0.0f ), acc1 = vdupq_n_f32( 0.0f );
+  for ( ; i+8<=n; i+=8 ) {
+    acc0 = vmlaq_f32( acc0, vld1q_f32( a+i ), vld1q_f32( b+i ) );
+    acc1 = vmlaq_f32( acc1, vld1q_f32( a+i+4 ), vld1q_f32( b+i+4 ) );
+  }
+  acc0 = vaddq_f32( acc0, acc1 );
+  float32x2_t pair = vadd_f32( vget_low_f32( acc0 ), vget_high_f32( acc0 ) );
+  sum = vget_lane_f32( vpadd_f32( pair, pair ), 0 );
+#endif
+
+  if ( i == 0 ) {
+    for ( unsigned int j=n; j>0; j-- )
+      sum += a[j-1] * b[j-1];
+  }
+  else {
+    for ( ; i<n; i++ )
+      sum += a[i] * b[i];
+  }
+
+  return sum;
+}
+
+//! Return the sum of a[i] * ( b[i] + c[i] ) for i = 0 ... n-1.
+/*!
+  The folded kernel of a linear-phase filter: b and c are the two
+  halves of the input history, paired so that samples sharing a
+  coefficient line up, and each pair costs one multiply.
+*/
+inline double foldedDotProduct( const double *a, const double *b, const double *c, unsigned int n )
+{
+  unsigned int i = 0;
+  double sum = 0.0;
+
+#if defined(__STK_SIMD_AVX__)
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  for ( ; i+8<=n; i+=8 ) {
+    acc0 = _mm256_add_pd( acc0, _mm256_mul_pd( _mm256_loadu_pd( a+i ),
+                                               _mm256_add_pd( _mm256_loadu_pd( b+i ), _mm256_loadu_pd( c+i ) ) ) );
+    acc1 = _mm256_add_pd( acc1, _mm256_mul_pd( _mm256_loadu_pd( a+i+4 ),
+                                               _mm256_add_pd( _mm256_loadu_pd( b+i+4 ), _mm256_loadu_pd( c+i+4 ) ) ) );
+  }
+  acc0 = _mm256_add_pd( acc0, acc1 );
+  __m128d half = _mm_add_pd( _mm256_castpd256_pd128( acc0 ), _mm256_extractf128_pd( acc0, 1 ) );
+  sum = _mm_cvtsd_f64( _mm_add_sd( half, _mm_unpackhi_pd( half, half ) ) );
+#elif defined(__STK_SIMD_SSE2__)
+  __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+  for ( ; i+4<=n; i+=4 ) {
+    acc0 = _mm_add_pd( acc0, _mm_mul_pd( _mm_loadu_pd( a+i ),
+                                         _mm_add_pd( _mm_loadu_pd( b+i ), _mm_loadu_pd( c+i ) ) ) );
+    acc1 = _mm_add_pd( acc1, _mm_mul_pd( _mm_loadu_pd( a+i+2 ),
+                                         _mm_add_pd( _mm_loadu_pd( b+i+2 ), _mm_loadu_pd( c+i+2 ) ) ) );
+  }
+  acc0 = _mm_add_pd( acc0, acc1 );
+  sum = _mm_cvtsd_f64( _mm_add_sd( acc0, _mm_unpackhi_pd( acc0, acc0 ) ) );
+#elif defined(__STK_SIMD_NEON__) && defined(__aarch64__)
+  float64x2_t acc0 = vdupq_n_f64( 0.0 ), acc1 = vdupq_n_f64( 0.0 );
+  for ( ; i+4<=n; i+=4 ) {
+    acc0 = vfmaq_f64( acc0, vld1q_f64( a+i ), vaddq_f64( vld1q_f64( b+i ), vld1q_f64( c+i ) ) );
+    acc1 = vfmaq_f64( acc1, vld1q_f64( a+i+2 ), vaddq_f64( vld1q_f64( b+i+2 ), vld1q_f64( c+i+2 ) ) );
+  }
+  sum = vaddvq_f64( vaddq_f64( acc0, acc1 ) );
+#endif
+
+  for ( ; i<n; i++ )
+    sum += a[i] * ( b[i] + c[i] );
+
+  return sum;
+}
+
+//! Return the sum of a[i] * ( b[i] + c[i] ) for i = 0 ... n-1.
+inline float foldedDotProduct( const float *a, const float *b, const float *c, unsigned int n )
+{
+  unsigned int i = 0;
+  float sum = 0.0f;
+
+#if defined(__STK_SIMD_AVX__)
+  __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+  for ( ; i+16<=n; i+=16 ) {
+    acc0 = _mm256_add_ps( acc0, _mm256_mul_ps( _mm256_loadu_ps( a+i ),
+                                               _mm256_add_ps( _mm256_loadu_ps( b+i ), _mm256_loadu_ps( c+i ) ) ) );
+    acc1 = _mm256_add_ps( acc1, _mm256_mul_ps( _mm256_loadu_ps( a+i+8 ),
+                                               _mm256_add_ps( _mm256_loadu_ps( b+i+8 ), _mm256_loadu_ps( c+i+8 ) ) ) );
+  }
+  acc0 = _mm256_add_ps( acc0, acc1 );
+  __m128 quad = _mm_add_ps( _mm256_castps256_ps128( acc0 ), _mm256_extractf128_ps( acc0, 1 ) );
+  quad = _mm_add_ps( quad, _mm_movehl_ps( quad, quad ) );
+  sum = _mm_cvtss_f32( _mm_add_ss( quad, _mm_shuffle_ps( quad, quad, 1 ) ) );
+#elif defined(__STK_SIMD_SSE2__)
+  __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+  for ( ; i+8<=n; i+=8 ) {
+    acc0 = _mm_add_ps( acc0, _mm_mul_ps( _mm_loadu_ps( a+i ),
+                                         _mm_add_ps( _mm_loadu_ps( b+i ), _mm_loadu_ps( c+i ) ) ) );
+    acc1 = _mm_add_ps( acc1, _mm_mul_ps( _mm_loadu_ps( a+i+4 ),
+                                         _mm_add_ps( _mm_loadu_ps( b+i+4 ), _mm_loadu_ps( c+i+4 ) ) ) );
+  }
+  acc0 = _mm_add_ps( acc0, acc1 );
+  acc0 = _mm_add_ps( acc0, _mm_movehl_ps( acc0, acc0 ) );
+  sum = _mm_cvtss_f32( _mm_add_ss( acc0, _mm_shuffle_ps( acc0, acc0, 1 ) ) );
+#elif defined(__STK_SIMD_NEON__)
+  float32x4_t acc0 = vdupq_n_f32( 0.0f ), acc1 = vdupq_n_f32( 0.0f );
+  for ( ; i+8<=n; i+=8 ) {
+    acc0 = vmlaq_f32( acc0, vld1q_f32( a+i ), vaddq_f32( vld1q_f32( b+i ), vld1q_f32( c+i ) ) );
+    acc1 = vmlaq_f32( acc1, vld1q_f32( a+i+4 ), vaddq_f32( vld1q_f32( b+i+4 ), vld1q_f32( c+i+4 ) ) );
+  }
+  acc0 = vaddq_f32( acc0, acc1 );
+  float32x2_t pair = vadd_f32( vget_low_f32( acc0 ), vget_high_f32( acc0 ) );
+  sum = vget_lane_f32( vpadd_f32( pair, pair ), 0 );
+#endif
+
+  for ( ; i<n; i++ )
+    sum += a[i] * ( b[i] + c[i] );
+
+  return sum;
+}
+
+//! Set out[k] to the sum of a[j * width + k] * x[j] for j = 0 ... rows-1, for k = 0 ... width-1.
+/*!
+  The kernel of a filter bank whose coefficients are interleaved, row
+  j holding tap j of every filter: each input sample is broadcast and
+  multiplied into a vector of filters at once.  Rows are spread over
+  four accumulators to hide the add latency.
+*/
+inline void bankProduct( const double *a, const double *x, unsigned int rows, unsigned int width, double *out )
+{
+  unsigned int j, k = 0;
+
+#if defined(__STK_SIMD_AVX__)
+  for ( ; k+8<=width; k+=8 ) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd(), acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    for ( j=0; j+2<=rows; j+=2 ) {
+      const double *row = a + j*width + k;
+      acc0 = _mm256_add_pd( acc0, _mm256_mul_pd( _mm256_loadu_pd( row ), _mm256_set1_pd( x[j] ) ) );
+      acc1 = _mm256_add_pd( acc1, _mm256_mul_pd( _mm256_loadu_pd( row+4 ), _mm256_set1_pd( x[j] ) ) );
+      acc2 = _mm256_add_pd( acc2, _mm256_mul_pd( _mm256_loadu_pd( row+width ), _mm256_set1_pd( x[j+1] ) ) );
+      acc3 = _mm256_add_pd( acc3, _mm256_mul_pd( _mm256_loadu_pd( row+width+4 ), _mm256_set1_pd( x[j+1] ) ) );
+    }
+    if ( j < rows ) {
+      acc0 = _mm256_add_pd( acc0, _mm256_mul_pd( _mm256_loadu_pd( a + j*width + k ), _mm256_set1_pd( x[j] ) ) );
+      acc1 = _mm256_add_pd( acc1, _mm256_mul_pd( _mm256_loadu_pd( a + j*width + k+4 ), _mm256_set1_pd( x[j] ) ) );
+    }
+    _mm256_storeu_pd( out+k, _mm256_add_pd( acc0, acc2 ) );
+    _mm256_storeu_pd( out+k+4, _mm256_add_pd( acc1, acc3 ) );
+  }
+  for ( ; k+4<=width; k+=4 ) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd(), acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    for ( j=0; j+4<=rows; j+=4 ) {
+      acc0 = _mm256_add_pd( acc0, _mm256_mul_pd( _mm256_loadu_pd( a + j*width + k ), _mm256_set1_pd( x[j] ) ) );
+      acc1 = _mm256_add_pd( acc1, _mm256_mul_pd( _mm256_loadu_pd( a + (j+1)*width + k ), _mm256_set1_pd( x[j+1] ) ) );
+      acc2 = _mm256_add_pd( acc2, _mm256_mul_pd( _mm256_loadu_pd( a + (j+2)*width + k ), _mm256_set1_pd( x[j+2] ) ) );
+      acc3 = _mm256_add_pd( acc3, _mm256_mul_pd( _mm256_loadu_pd( a + (j+3)*width + k ), _mm256_set1_pd( x[j+3] ) ) );
+    }
+    for ( ; j<rows; j++ )
+      acc0 = _mm256_add_pd( acc0, _mm256_mul_pd( _mm256_loadu_pd( a + j*width + k ), _mm256_set1_pd( x[j] ) ) );
+    _mm256_storeu_pd( out+k, _mm256_add_pd( _mm256_add_pd( acc0, acc1 ), _mm256_add_pd( acc2, acc3 ) ) );
+  }
+#elif defined(__STK_SIMD_SSE2__)
+  for ( ; k+4<=width; k+=4 ) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+    for ( j=0; j+2<=rows; j+=2 ) {
+      const double *row = a + j*width + k;
+      acc0 = _mm_add_pd( acc0, _mm_mul_pd( _mm_loadu_pd( row ), _mm_set1_pd( x[j] ) ) );
+      acc1 = _mm_add_pd( acc1, _mm_mul_pd( _mm_loadu_pd( row+2 ), _mm_set1_pd( x[j] ) ) );
+      acc2 = _mm_add_pd( acc2, _mm_mul_pd( _mm_loadu_pd( row+width ), _mm_set1_pd( x[j+1] ) ) );
+      acc3 = _mm_add_pd( acc3, _mm_mul_pd( _mm_loadu_pd( row+width+2 ), _mm_set1_pd( x[j+1] ) ) );
+    }
+    if ( j < rows ) {
+      acc0 = _mm_add_pd( acc0, _mm_mul_pd( _mm_loadu_pd( a + j*width + k ), _mm_set1_pd( x[j] ) ) );
+      acc1 = _mm_add_pd( acc1, _mm_mul_pd( _mm_loadu_pd( a + j*width + k+2 ), _mm_set1_pd( x[j] ) ) );
+    }
+    _mm_storeu_pd( out+k, _mm_add_pd( acc0, acc2 ) );
+    _mm_storeu_pd( out+k+2, _mm_add_pd( acc1, acc3 ) );
+  }
+  for ( ; k+2<=width; k+=2 ) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+    for ( j=0; j+4<=rows; j+=4 ) {
+      acc0 = _mm_add_pd( acc0, _mm_mul_pd( _mm_loadu_pd( a + j*width + k ), _mm_set1_pd( x[j] ) ) );
+      acc1 = _mm_add_pd( acc1, _mm_mul_pd( _mm_loadu_pd( a + (j+1)*width + k ), _mm_set1_pd( x[j+1] ) ) );
+      acc2 = _mm_add_pd( acc2, _mm_mul_pd( _mm_loadu_pd( a + (j+2)*width + k ), _mm_set1_pd( x[j+2] ) ) );
+      acc3 = _mm_add_pd( acc3, _mm_mul_pd( _mm_loadu_pd( a + (j+3)*width + k ), _mm_set1_pd( x[j+3] ) ) );
+    }
+    for ( ; j<rows; j++ )
+      acc0 = _mm_add_pd( acc0, _mm_mul_pd( _mm_loadu_pd( a + j*width + k ), _mm_set1_pd( x[j] ) ) );
+    _mm_storeu_pd( out+k, _mm_add_pd( _mm_add_pd( acc0, acc1 ), _mm_add_pd( acc2, acc3 ) ) );
+  }
+#elif defined(__STK_SIMD_NEON__) && defined(__aarch64__)
+  for ( ; k+4<=width; k+=4 ) {
+    float64x2_t acc0 = vdupq_n_f64( 0.0 ), acc1 = vdupq_n_f64( 0.0 ), acc2 = vdupq_n_f64( 0.0 ), acc3 = vdupq_n_f64( 0.0 );
+    for ( j=0; j+2<=rows; j+=2 ) {
+      const double *row = a + j*width + k;
+      acc0 = vfmaq_n_f64( acc0, vld1q_f64( row ), x[j] );
+      acc1 = vfmaq_n_f64( acc1, vld1q_f64( row+2 ), x[j] );
+      acc2 = vfmaq_n_f64( acc2, vld1q_f64( row+width ), x[j+1] );
+      acc3 = vfmaq_n_f64( acc3, vld1q_f64( row+width+2 ), x[j+1] );
+    }
+    if ( j < rows ) {
+      acc0 = vfmaq_n_f64( acc0, vld1q_f64( a + j*width + k ), x[j] );
+      acc1 = vfmaq_n_f64( acc1, vld1q_f64( a + j*width + k+2 ), x[j] );
+    }
+    vst1q_f64( out+k, vaddq_f64( acc0, acc2 ) );
+    vst1q_f64( out+k+2, vaddq_f64( acc1, acc3 ) );
+  }
+  for ( ; k+2<=width; k+=2 ) {
+    float64x2_t acc0 = vdupq_n_f64( 0.0 ), acc1 = vdupq_n_f64( 0.0 ), acc2 = vdupq_n_f64( 0.0 ), acc3 = vdupq_n_f64( 0.0 );
+    for ( j=0; j+4<=rows; j+=4 ) {
+      acc0 = vfmaq_n_f64( acc0, vld1q_f64( a + j*width + k ), x[j] );
+      acc1 = vfmaq_n_f64( acc1, vld1q_f64( a + (j+1)*width + k ), x[j+1] );
+      acc2 = vfmaq_n_f64( acc2, vld1q_f64( a + (j+2)*width + k ), x[j+2] );
+      acc3 = vfmaq_n_f64( acc3, vld1q_f64( a + (j+3)*width + k ), x[j+3] );
+    }
+    for ( ; j<rows; j++ )
+      acc0 = vfmaq_n_f64( acc0, vld1q_f64( a + j*width + k ), x[j] );
+    vst1q_f64( out+k, vaddq_f64( vaddq_f64( acc0, acc1 ), vaddq_f64( acc2, acc3 ) ) );
+  }
+#endif
+
+  for ( ; k<width; k++ ) {
+    double sum = 0.0;
+    for ( j=0; j<rows; j++ )
+      sum += a[j*width + k] * x[j];
+    out[k] = sum;
+  }
+}
+
+//! Set out[k] to the sum of a[j * width + k] * x[j] for j = 0 ... rows-1, for k = 0 ... width-1.
+inline void bankProduct( const float *a, const float *x, unsigned int rows, unsigned int width, float *out )
+{
+  unsigned int j, k = 0;
+
+#if defined(__STK_SIMD_AVX__)
+  for ( ; k+16<=width; k+=16 ) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    for ( j=0; j+2<=rows; j+=2 ) {
+      const float *row = a + j*width + k;
+      acc0 = _mm256_add_ps( acc0, _mm256_mul_ps( _mm256_loadu_ps( row ), _mm256_set1_ps( x[j] ) ) );
+      acc1 = _mm256_add_ps( acc1, _mm256_mul_ps( _mm256_loadu_ps( row+8 ), _mm256_set1_ps( x[j] ) ) );
+      acc2 = _mm256_add_ps( acc2, _mm256_mul_ps( _mm256_loadu_ps( row+width ), _mm256_set1_ps( x[j+1] ) ) );
+      acc3 = _mm256_add_ps( acc3, _mm256_mul_ps( _mm256_loadu_ps( row+width+8 ), _mm256_set1_ps( x[j+1] ) ) );
+    }
+    if ( j < rows ) {
+      acc0 = _mm256_add_ps( acc0, _mm256_mul_ps( _mm256_loadu_ps( a + j*width + k ), _mm256_set1_ps( x[j] ) ) );
+      acc1 = _mm256_add_ps( acc1, _mm256_mul_ps( _mm256_loadu_ps( a + j*width + k+8 ), _mm256_set1_ps( x[j] ) ) );
+    }
+    _mm256_storeu_ps( out+k, _mm256_add_ps( acc0, acc2 ) );
+    _mm256_storeu_ps( out+k+8, _mm256_add_ps( acc1, acc3 ) );
+  }
+  for ( ; k+8<=width; k+=8 ) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    for ( j=0; j+4<=rows; j+=4 ) {
+      acc0 = _mm256_add_ps( acc0, _mm256_mul_ps( _mm256_loadu_ps( a + j*width + k ), _mm256_set1_ps( x[j] ) ) );
+      acc1 = _mm256_add_ps( acc1, _mm256_mul_ps( _mm256_loadu_ps( a + (j+1)*width + k ), _mm256_set1_ps( x[j+1] ) ) );
+      acc2 = _mm256_add_ps( acc2, _mm256_mul_ps( _mm256_loadu_ps( a + (j+2)*width + k ), _mm256_set1_ps( x[j+2] ) ) );
+      acc3 = _mm256_add_ps( acc3, _mm256_mul_ps( _mm256_loadu_ps( a + (j+3)*width + k ), _mm256_set1_ps( x[j+3] ) ) );
+    }
+    for ( ; j<rows; j++ )
+      acc0 = _mm256_add_ps( acc0, _mm256_mul_ps( _mm256_loadu_ps( a + j*width + k ), _mm256_set1_ps( x[j] ) ) );
+    _mm256_storeu_ps( out+k, _mm256_add_ps( _mm256_add_ps( acc0, acc1 ), _mm256_add_ps( acc2, acc3 ) ) );
+  }
+#elif defined(__STK_SIMD_SSE2__)
+  for ( ; k+8<=width; k+=8 ) {
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    for ( j=0; j+2<=rows; j+=2 ) {
+      const float *row = a + j*width + k;
+      acc0 = _mm_add_ps( acc0, _mm_mul_ps( _mm_loadu_ps( row ), _mm_set1_ps( x[j] ) ) );
+      acc1 = _mm_add_ps( acc1, _mm_mul_ps( _mm_loadu_ps( row+4 ), _mm_set1_ps( x[j] ) ) );
+      acc2 = _mm_add_ps( acc2, _mm_mul_ps( _mm_loadu_ps( row+width ), _mm_set1_ps( x[j+1] ) ) );
+      acc3 = _mm_add_ps( acc3, _mm_mul_ps( _mm_loadu_ps( row+width+4 ), _mm_set1_ps( x[j+1] ) ) );
+    }
+    if ( j < rows ) {
+      acc0 = _mm_add_ps( acc0, _mm_mul_ps( _mm_loadu_ps( a + j*width + k ), _mm_set1_ps( x[j] ) ) );
+      acc1 = _mm_add_ps( acc1, _mm_mul_ps( _mm_loadu_ps( a + j*width + k+4 ), _mm_set1_ps( x[j] ) ) );
+    }
+    _mm_storeu_ps( out+k, _mm_add_ps( acc0, acc2 ) );
+    _mm_storeu_ps( out+k+4, _mm_add_ps( acc1, acc3 ) );
+  }
+  for ( ; k+4<=width; k+=4 ) {
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    for ( j=0; j+4<=rows; j+=4 ) {
+      acc0 = _mm_add_ps( acc0, _mm_mul_ps( _mm_loadu_ps( a + j*width + k ), _mm_set1_ps( x[j] ) ) );
+      acc1 = _mm_add_ps( acc1, _mm_mul_ps( _mm_loadu_ps( a + (j+1)*width + k ), _mm_set1_ps( x[j+1] ) ) );
+      acc2 = _mm_add_ps( acc2, _mm_mul_ps( _mm_loadu_ps( a + (j+2)*width + k ), _mm_set1_ps( x[j+2] ) ) );
+      acc3 = _mm_add_ps( acc3, _mm_mul_ps( _mm_loadu_ps( a + (j+3)*width + k ), _mm_set1_ps( x[j+3] ) ) );
+    }
+    for ( ; j<rows; j++ )
+      acc0 = _mm_add_ps( acc0, _mm_mul_ps( _mm_loadu_ps( a + j*width + k ), _mm_set1_ps( x[j] ) ) );
+    _mm_storeu_ps( out+k, _mm_add_ps( _mm_add_ps( acc0, acc1 ), _mm_add_ps( acc2, acc3 ) ) );
+  }
+#elif defined(__STK_SIMD_NEON__)
+  for ( ; k+8<=width; k+=8 ) {
+    float32x4_t acc0 = vdupq_n_f32( 0.0f ), acc1 = vdupq_n_f32( 0.0f ), acc2 = vdupq_n_f32( 0.0f ), acc3 = vdupq_n_f32( 0.0f );
+    for ( j=0; j+2<=rows; j+=2 ) {
+      const float *row = a + j*width + k;
+      acc0 = vmlaq_n_f32( acc0, vld1q_f32( row ), x[j] );
+      acc1 = vmlaq_n_f32( acc1, vld1q_f32( row+4 ), x[j] );
+      acc2 = vmlaq_n_f32( acc2, vld1q_f32( row+width ), x[j+1] );
+      acc3 = vmlaq_n_f32( acc3, vld1q_f32( row+width+4 ), x[j+1] );
+    }
+    if ( j < rows ) {
+      acc0 = vmlaq_n_f32( acc0, vld1q_f32( a + j*width + k ), x[j] );
+      acc1 = vmlaq_n_f32( acc1, vld1q_f32( a + j*width + k+4 ), x[j] );
+    }
+    vst1q_f32( out+k, vaddq_f32( acc0, acc2 ) );
+    vst1q_f32( out+k+4, vaddq_f32( acc1, acc3 ) );
+  }
+  for ( ; k+4<=width; k+=4 ) {
+    float32x4_t acc0 = vdupq_n_f32( 0.0f ), acc1 = vdupq_n_f32( 0.0f ), acc2 = vdupq_n_f32( 0.0f ), acc3 = vdupq_n_f32( 0.0f );
+    for ( j=0; j+4<=rows; j+=4 ) {
+      acc0 = vmlaq_n_f32( acc0, vld1q_f32( a + j*width + k ), x[j] );
+      acc1 = vmlaq_n_f32( acc1, vld1q_f32( a + (j+1)*width + k ), x[j+1] );
+      acc2 = vmlaq_n_f32( acc2, vld1q_f32( a + (j+2)*width + k ), x[j+2] );
+      acc3 = vmlaq_n_f32( acc3, vld1q_f32( a + (j+3)*width + k ), x[j+3] );
+    }
+    for ( ; j<rows; j++ )
+      acc0 = vmlaq_n_f32( acc0, vld1q_f32( a + j*width + k ), x[j] );
+    vst1q_f32( out+k, vaddq_f32( vaddq_f32( acc0, acc1 ), vaddq_f32( acc2, acc3 ) ) );
+  }
+#endif
+
+  for ( ; k<width; k++ ) {
+    float sum = 0.0f;
+    for ( j=0; j<rows; j++ )
+      sum += a[j*width + k] * x[j];
+    out[k] = sum;
+  }
+}
+
+//! Run a transposed direct form II biquad in place over n frames of \e width channels.
+/*!
+  c holds b0, b1, b2, a1 and a2, shared by every channel; s1 and s2
+  hold the two state values of each channel.  Channel k of frame i is
+  x[i * hop + k].  The recursion runs along time, so the vectors are
+  across channels, a vector of them at a time.
+*/
+inline void biquadBlock( const double *c, double *s1, double *s2, double *x, unsigned int hop, unsigned int width, unsigned int n )
+{
+  unsigned int i, k = 0;
+
+#if defined(__STK_SIMD_AVX__)
+  __m256d b0 = _mm256_set1_pd( c[0] ), b1 = _mm256_set1_pd( c[1] ), b2 = _mm256_set1_pd( c[2] ), a1 = _mm256_set1_pd( c[3] ), a2 = _mm256_set1_pd( c[4] );
+  for ( ; k+4<=width; k+=4 ) {
+    __m256d v1 = _mm256_loadu_pd( s1+k ), v2 = _mm256_loadu_pd( s2+k );
+    for ( i=0; i<n; i++ ) {
+      __m256d in = _mm256_loadu_pd( x + i*hop + k );
+      __m256d out = _mm256_add_pd( _mm256_mul_pd( b0, in ), v1 );
+      v1 = _mm256_add_pd( _mm256_sub_pd( _mm256_mul_pd( b1, in ), _mm256_mul_pd( a1, out ) ), v2 );
+      v2 = _mm256_sub_pd( _mm256_mul_pd( b2, in ), _mm256_mul_pd( a2, out ) );
+      _mm256_storeu_pd( x + i*hop + k, out );
+    }
+    _mm256_storeu_pd( s1+k, v1 );
+    _mm256_storeu_pd( s2+k, v2 );
+  }
+#elif defined(__STK_SIMD_SSE2__)
+  __m128d b0 = _mm_set1_pd( c[0] ), b1 = _mm_set1_pd( c[1] ), b2 = _mm_set1_pd( c[2] ), a1 = _mm_set1_pd( c[3] ), a2 = _mm_set1_pd( c[4] );
+  for ( ; k+2<=width; k+=2 ) {
+    __m128d v1 = _mm_loadu_pd( s1+k ), v2 = _mm_loadu_pd( s2+k );
+    for ( i=0; i<n; i++ ) {
+      __m128d in = _mm_loadu_pd( x + i*hop + k );
+      __m128d out = _mm_add_pd( _mm_mul_pd( b0, in ), v1 );
+      v1 = _mm_add_pd( _mm_sub_pd( _mm_mul_pd( b1, in ), _mm_mul_pd( a1, out ) ), v2 );
+      v2 = _mm_sub_pd( _mm_mul_pd( b2, in ), _mm_mul_pd( a2, out ) );
+      _mm_storeu_pd( x + i*hop + k, out );
+    }
+    _mm_storeu_pd( s1+k, v1 );
+    _mm_storeu_pd( s2+k, v2 );
+  }
+#elif defined(__STK_SIMD_NEON__) && defined(__aarch64__)
+  float64x2_t b0 = vdupq_n_f64( c[0] ), b1 = vdupq_n_f64( c[1] ), b2 = vdupq_n_f64( c[2] ), a1 = vdupq_n_f64( c[3] ), a2 = vdupq_n_f64( c[4] );
+  for ( ; k+2<=width; k+=2 ) {
+    float64x2_t v1 = vld1q_f64( s1+k ), v2 = vld1q_f64( s2+k );
+    for ( i=0; i<n; i++ ) {
+      float64x2_t in = vld1q_f64( x + i*hop + k );
+      float64x2_t out = vaddq_f64( vmulq_f64( b0, in ), v1 );
+      v1 = vaddq_f64( vsubq_f64( vmulq_f64( b1, in ), vmulq_f64( a1, out ) ), v2 );
+      v2 = vsubq_f64( vmulq_f64( b2, in ), vmulq_f64( a2, out ) );
+      vst1q_f64( x + i*hop + k, out );
+    }
+    vst1q_f64( s1+k, v1 );
+    vst1q_f64( s2+k, v2 );
+  }
+#endif
+
+  for ( ; k<width; k++ ) {
+    double v1 = s1[k], v2 = s2[k];
+    for ( i=0; i<n; i++ ) {
+      double in = x[i*hop + k];
+      double out = c[0] * in + v1;
+      v1 = c[1] * in - c[3] * out + v2;
+      v2 = c[2] * in - c[4] * out;
+      x[i*hop + k] = out;
+    }
+    s1[k] = v1;
+    s2[k] = v2;
+  }
+}
+
+//! Run a transposed direct form II biquad in place over n frames of \e width channels.
+inline void biquadBlock( const float *c, float *s1, float *s2, float *x, unsigned int hop, unsigned int width, unsigned int n )
+{
+  unsigned int i, k = 0;
+
+#if defined(__STK_SIMD_AVX__)
+  __m256 b0 = _mm256_set1_ps( c[0] ), b1 = _mm256_set1_ps( c[1] ), b2 = _mm256_set1_ps( c[2] ), a1 = _mm256_set1_ps( c[3] ), a2 = _mm256_set1_ps( c[4] );
+  for ( ; k+8<=width; k+=8 ) {
+    __m256 v1 = _mm256_loadu_ps( s1+k ), v2 = _mm256_loadu_ps( s2+k );
+    for ( i=0; i<n; i++ ) {
+      __m256 in = _mm256_loadu_ps( x + i*hop + k );
+      __m256 out = _mm256_add_ps( _mm256_mul_ps( b0, in ), v1 );
+      v1 = _mm256_add_ps( _mm256_sub_ps( _mm256_mul_ps( b1, in ), _mm256_mul_ps( a1, out ) ), v2 );
+      v2 = _mm256_sub_ps( _mm256_mul_ps( b2, in ), _mm256_mul_ps( a2, out ) );
+      _mm256_storeu_ps( x + i*hop + k, out );
+    }
+    _mm256_storeu_ps( s1+k, v1 );
+    _mm256_storeu_ps( s2+k, v2 );
+  }
+#elif defined(__STK_SIMD_SSE2__)
+  __m128 b0 = _mm_set1_ps( c[0] ), b1 = _mm_set1_ps( c[1] ), b2 = _mm_set1_ps( c[2] ), a1 = _mm_set1_ps( c[3] ), a2 = _mm_set1_ps( c[4] );
+  for ( ; k+4<=width; k+=4 ) {
+    __m128 v1 = _mm_loadu_ps( s1+k ), v2 = _mm_loadu_ps( s2+k );
+    for ( i=0; i<n; i++ ) {
+      __m128 in = _mm_loadu_ps( x + i*hop + k );
+      __m128 out = _mm_add_ps( _mm_mul_ps( b0, in ), v1 );
+      v1 = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( b1, in ), _mm_mul_ps( a1, out ) ), v2 );
+      v2 = _mm_sub_ps( _mm_mul_ps( b2, in ), _mm_mul_ps( a2, out ) );
+      _mm_storeu_ps( x + i*hop + k, out );
+    }
+    _mm_storeu_ps( s1+k, v1 );
+    _mm_storeu_ps( s2+k, v2 );
+  }
+#elif defined(__STK_SIMD_NEON__)
+  float32x4_t b0 = vdupq_n_f32( c[0] ), b1 = vdupq_n_f32( c[1] ), b2 = vdupq_n_f32( c[2] ), a1 = vdupq_n_f32( c[3] ), a2 = vdupq_n_f32( c[4] );
+  for ( ; k+4<=width; k+=4 ) {
+    float32x4_t v1 = vld1q_f32( s1+k ), v2 = vld1q_f32( s2+k );
+    for ( i=0; i<n; i++ ) {
+      float32x4_t in = vld1q_f32( x + i*hop + k );
+      float32x4_t out = vaddq_f32( vmulq_f32( b0, in ), v1 );
+      v1 = vaddq_f32( vsubq_f32( vmulq_f32( b1, in ), vmulq_f32( a1, out ) ), v2 );
+      v2 = vsubq_f32( vmulq_f32( b2, in ), vmulq_f32( a2, out ) );
+      vst1q_f32( x + i*hop + k, out );
+    }
+    vst1q_f32( s1+k, v1 );
+    vst1q_f32( s2+k, v2 );
+  }
+#endif
+
+  for ( ; k<width; k++ ) {
+    float v1 = s1[k], v2 = s2[k];
+    for ( i=0; i<n; i++ ) {
+      float in = x[i*hop + k];
+      float out = c[0] * in + v1;
+      v1 = c[1] * in - c[3] * out + v2;
+      v2 = c[2] * in - c[4] * out;
+      x[i*hop + k] = out;
+    }
+    s1[k] = v1;
+    s2[k] = v2;
+  }
+}
+
+//! Run \e width independent direct form I biquads over n frames, adding each output into out.
+/*!
+  Biquad k has its own gain and coefficients, c[j * stride + k] for
+  gain, b0, b1, b2, a1 and a2 in that order, and its own state,
+  s[j * stride + k] for the last two inputs and the last two outputs.
+  The inputs are kept after the gain, as in BiQuad.  Its input at
+  frame i is x[i * hop + k] and its output is added to
+  out[i * oHop + k].  The vectors are across biquads, so every lane
+  has its own recursion.
+*/
+inline void biquadBank( const double *c, double *s, unsigned int stride, const double *x, unsigned int hop,
+                        double *out, unsigned int oHop, unsigned int width, unsigned int n )
+{
+  unsigned int i, k = 0;
+
+#if defined(__STK_SIMD_AVX__)
+  // Two vectors at a time, so one recursion runs while the other waits.
+  for ( ; k+8<=width; k+=8 ) {
+    __m256d g = _mm256_loadu_pd( c+k ), b0 = _mm256_loadu_pd( c+stride+k ), b1 = _mm256_loadu_pd( c+2*stride+k ), b2 = _mm256_loadu_pd( c+3*stride+k );
+    __m256d a1 = _mm256_loadu_pd( c+4*stride+k ), a2 = _mm256_loadu_pd( c+5*stride+k );
+    __m256d x1 = _mm256_loadu_pd( s+k ), x2 = _mm256_loadu_pd( s+stride+k ), y1 = _mm256_loadu_pd( s+2*stride+k ), y2 = _mm256_loadu_pd( s+3*stride+k );
+    __m256d gB = _mm256_loadu_pd( c+k+4 ), b0B = _mm256_loadu_pd( c+stride+k+4 ), b1B = _mm256_loadu_pd( c+2*stride+k+4 ), b2B = _mm256_loadu_pd( c+3*stride+k+4 );
+    __m256d a1B = _mm256_loadu_pd( c+4*stride+k+4 ), a2B = _mm256_loadu_pd( c+5*stride+k+4 );
+    __m256d x1B = _mm256_loadu_pd( s+k+4 ), x2B = _mm256_loadu_pd( s+stride+k+4 ), y1B = _mm256_loadu_pd( s+2*stride+k+4 ), y2B = _mm256_loadu_pd( s+3*stride+k+4 );
+    for ( i=0; i<n; i++ ) {
+      __m256d in = _mm256_mul_pd( g, _mm256_loadu_pd( x + i*hop + k ) );
+      __m256d y = _mm256_sub_pd( _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd( b0, in ), _mm256_mul_pd( b1, x1 ) ), _mm256_sub_pd( _mm256_mul_pd( b2, x2 ), _mm256_mul_pd( a2, y2 ) ) ), _mm256_mul_pd( a1, y1 ) );
+      _mm256_storeu_pd( out + i*oHop + k, _mm256_add_pd( _mm256_loadu_pd( out + i*oHop + k ), y ) );
+      __m256d inB = _mm256_mul_pd( gB, _mm256_loadu_pd( x + i*hop + k + 4 ) );
+      __m256d yB = _mm256_sub_pd( _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd( b0B, inB ), _mm256_mul_pd( b1B, x1B ) ), _mm256_sub_pd( _mm256_mul_pd( b2B, x2B ), _mm256_mul_pd( a2B, y2B ) ) ), _mm256_mul_pd( a1B, y1B ) );
+      _mm256_storeu_pd( out + i*oHop + k + 4, _mm256_add_pd( _mm256_loadu_pd( out + i*oHop + k + 4 ), yB ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+      x2B = x1B; x1B = inB;
+      y2B = y1B; y1B = yB;
+    }
+    _mm256_storeu_pd( s+k, x1 ); _mm256_storeu_pd( s+stride+k, x2 );
+    _mm256_storeu_pd( s+2*stride+k, y1 ); _mm256_storeu_pd( s+3*stride+k, y2 );
+    _mm256_storeu_pd( s+k+4, x1B ); _mm256_storeu_pd( s+stride+k+4, x2B );
+    _mm256_storeu_pd( s+2*stride+k+4, y1B ); _mm256_storeu_pd( s+3*stride+k+4, y2B );
+  }
+  for ( ; k+4<=width; k+=4 ) {
+    __m256d g = _mm256_loadu_pd( c+k ), b0 = _mm256_loadu_pd( c+stride+k ), b1 = _mm256_loadu_pd( c+2*stride+k ), b2 = _mm256_loadu_pd( c+3*stride+k );
+    __m256d a1 = _mm256_loadu_pd( c+4*stride+k ), a2 = _mm256_loadu_pd( c+5*stride+k );
+    __m256d x1 = _mm256_loadu_pd( s+k ), x2 = _mm256_loadu_pd( s+stride+k ), y1 = _mm256_loadu_pd( s+2*stride+k ), y2 = _mm256_loadu_pd( s+3*stride+k );
+    for ( i=0; i<n; i++ ) {
+      __m256d in = _mm256_mul_pd( g, _mm256_loadu_pd( x + i*hop + k ) );
+      __m256d y = _mm256_sub_pd( _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd( b0, in ), _mm256_mul_pd( b1, x1 ) ), _mm256_sub_pd( _mm256_mul_pd( b2, x2 ), _mm256_mul_pd( a2, y2 ) ) ), _mm256_mul_pd( a1, y1 ) );
+      _mm256_storeu_pd( out + i*oHop + k, _mm256_add_pd( _mm256_loadu_pd( out + i*oHop + k ), y ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+    }
+    _mm256_storeu_pd( s+k, x1 ); _mm256_storeu_pd( s+stride+k, x2 );
+    _mm256_storeu_pd( s+2*stride+k, y1 ); _mm256_storeu_pd( s+3*stride+k, y2 );
+  }
+#elif defined(__STK_SIMD_SSE2__)
+  // Two vectors at a time, so one recursion runs while the other waits.
+  for ( ; k+4<=width; k+=4 ) {
+    __m128d g = _mm_loadu_pd( c+k ), b0 = _mm_loadu_pd( c+stride+k ), b1 = _mm_loadu_pd( c+2*stride+k ), b2 = _mm_loadu_pd( c+3*stride+k );
+    __m128d a1 = _mm_loadu_pd( c+4*stride+k ), a2 = _mm_loadu_pd( c+5*stride+k );
+    __m128d x1 = _mm_loadu_pd( s+k ), x2 = _mm_loadu_pd( s+stride+k ), y1 = _mm_loadu_pd( s+2*stride+k ), y2 = _mm_loadu_pd( s+3*stride+k );
+    __m128d gB = _mm_loadu_pd( c+k+2 ), b0B = _mm_loadu_pd( c+stride+k+2 ), b1B = _mm_loadu_pd( c+2*stride+k+2 ), b2B = _mm_loadu_pd( c+3*stride+k+2 );
+    __m128d a1B = _mm_loadu_pd( c+4*stride+k+2 ), a2B = _mm_loadu_pd( c+5*stride+k+2 );
+    __m128d x1B = _mm_loadu_pd( s+k+2 ), x2B = _mm_loadu_pd( s+stride+k+2 ), y1B = _mm_loadu_pd( s+2*stride+k+2 ), y2B = _mm_loadu_pd( s+3*stride+k+2 );
+    for ( i=0; i<n; i++ ) {
+      __m128d in = _mm_mul_pd( g, _mm_loadu_pd( x + i*hop + k ) );
+      __m128d y = _mm_sub_pd( _mm_add_pd( _mm_add_pd( _mm_mul_pd( b0, in ), _mm_mul_pd( b1, x1 ) ), _mm_sub_pd( _mm_mul_pd( b2, x2 ), _mm_mul_pd( a2, y2 ) ) ), _mm_mul_pd( a1, y1 ) );
+      _mm_storeu_pd( out + i*oHop + k, _mm_add_pd( _mm_loadu_pd( out + i*oHop + k ), y ) );
+      __m128d inB = _mm_mul_pd( gB, _mm_loadu_pd( x + i*hop + k + 2 ) );
+      __m128d yB = _mm_sub_pd( _mm_add_pd( _mm_add_pd( _mm_mul_pd( b0B, inB ), _mm_mul_pd( b1B, x1B ) ), _mm_sub_pd( _mm_mul_pd( b2B, x2B ), _mm_mul_pd( a2B, y2B ) ) ), _mm_mul_pd( a1B, y1B ) );
+      _mm_storeu_pd( out + i*oHop + k + 2, _mm_add_pd( _mm_loadu_pd( out + i*oHop + k + 2 ), yB ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+      x2B = x1B; x1B = inB;
+      y2B = y1B; y1B = yB;
+    }
+    _mm_storeu_pd( s+k, x1 ); _mm_storeu_pd( s+stride+k, x2 );
+    _mm_storeu_pd( s+2*stride+k, y1 ); _mm_storeu_pd( s+3*stride+k, y2 );
+    _mm_storeu_pd( s+k+2, x1B ); _mm_storeu_pd( s+stride+k+2, x2B );
+    _mm_storeu_pd( s+2*stride+k+2, y1B ); _mm_storeu_pd( s+3*stride+k+2, y2B );
+  }
+  for ( ; k+2<=width; k+=2 ) {
+    __m128d g = _mm_loadu_pd( c+k ), b0 = _mm_loadu_pd( c+stride+k ), b1 = _mm_loadu_pd( c+2*stride+k ), b2 = _mm_loadu_pd( c+3*stride+k );
+    __m128d a1 = _mm_loadu_pd( c+4*stride+k ), a2 = _mm_loadu_pd( c+5*stride+k );
+    __m128d x1 = _mm_loadu_pd( s+k ), x2 = _mm_loadu_pd( s+stride+k ), y1 = _mm_loadu_pd( s+2*stride+k ), y2 = _mm_loadu_pd( s+3*stride+k );
+    for ( i=0; i<n; i++ ) {
+      __m128d in = _mm_mul_pd( g, _mm_loadu_pd( x + i*hop + k ) );
+      __m128d y = _mm_sub_pd( _mm_add_pd( _mm_add_pd( _mm_mul_pd( b0, in ), _mm_mul_pd( b1, x1 ) ), _mm_sub_pd( _mm_mul_pd( b2, x2 ), _mm_mul_pd( a2, y2 ) ) ), _mm_mul_pd( a1, y1 ) );
+      _mm_storeu_pd( out + i*oHop + k, _mm_add_pd( _mm_loadu_pd( out + i*oHop + k ), y ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+    }
+    _mm_storeu_pd( s+k, x1 ); _mm_storeu_pd( s+stride+k, x2 );
+    _mm_storeu_pd( s+2*stride+k, y1 ); _mm_storeu_pd( s+3*stride+k, y2 );
+  }
+#elif defined(__STK_SIMD_NEON__) && defined(__aarch64__)
+  // Two vectors at a time, so one recursion runs while the other waits.
+  for ( ; k+4<=width; k+=4 ) {
+    float64x2_t g = vld1q_f64( c+k ), b0 = vld1q_f64( c+stride+k ), b1 = vld1q_f64( c+2*stride+k ), b2 = vld1q_f64( c+3*stride+k );
+    float64x2_t a1 = vld1q_f64( c+4*stride+k ), a2 = vld1q_f64( c+5*stride+k );
+    float64x2_t x1 = vld1q_f64( s+k ), x2 = vld1q_f64( s+stride+k ), y1 = vld1q_f64( s+2*stride+k ), y2 = vld1q_f64( s+3*stride+k );
+    float64x2_t gB = vld1q_f64( c+k+2 ), b0B = vld1q_f64( c+stride+k+2 ), b1B = vld1q_f64( c+2*stride+k+2 ), b2B = vld1q_f64( c+3*stride+k+2 );
+    float64x2_t a1B = vld1q_f64( c+4*stride+k+2 ), a2B = vld1q_f64( c+5*stride+k+2 );
+    float64x2_t x1B = vld1q_f64( s+k+2 ), x2B = vld1q_f64( s+stride+k+2 ), y1B = vld1q_f64( s+2*stride+k+2 ), y2B = vld1q_f64( s+3*stride+k+2 );
+    for ( i=0; i<n; i++ ) {
+      float64x2_t in = vmulq_f64( g, vld1q_f64( x + i*hop + k ) );
+      float64x2_t y = vsubq_f64( vaddq_f64( vaddq_f64( vmulq_f64( b0, in ), vmulq_f64( b1, x1 ) ), vsubq_f64( vmulq_f64( b2, x2 ), vmulq_f64( a2, y2 ) ) ), vmulq_f64( a1, y1 ) );
+      vst1q_f64( out + i*oHop + k, vaddq_f64( vld1q_f64( out + i*oHop + k ), y ) );
+      float64x2_t inB = vmulq_f64( gB, vld1q_f64( x + i*hop + k + 2 ) );
+      float64x2_t yB = vsubq_f64( vaddq_f64( vaddq_f64( vmulq_f64( b0B, inB ), vmulq_f64( b1B, x1B ) ), vsubq_f64( vmulq_f64( b2B, x2B ), vmulq_f64( a2B, y2B ) ) ), vmulq_f64( a1B, y1B ) );
+      vst1q_f64( out + i*oHop + k + 2, vaddq_f64( vld1q_f64( out + i*oHop + k + 2 ), yB ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+      x2B = x1B; x1B = inB;
+      y2B = y1B; y1B = yB;
+    }
+    vst1q_f64( s+k, x1 ); vst1q_f64( s+stride+k, x2 );
+    vst1q_f64( s+2*stride+k, y1 ); vst1q_f64( s+3*stride+k, y2 );
+    vst1q_f64( s+k+2, x1B ); vst1q_f64( s+stride+k+2, x2B );
+    vst1q_f64( s+2*stride+k+2, y1B ); vst1q_f64( s+3*stride+k+2, y2B );
+  }
+  for ( ; k+2<=width; k+=2 ) {
+    float64x2_t g = vld1q_f64( c+k ), b0 = vld1q_f64( c+stride+k ), b1 = vld1q_f64( c+2*stride+k ), b2 = vld1q_f64( c+3*stride+k );
+    float64x2_t a1 = vld1q_f64( c+4*stride+k ), a2 = vld1q_f64( c+5*stride+k );
+    float64x2_t x1 = vld1q_f64( s+k ), x2 = vld1q_f64( s+stride+k ), y1 = vld1q_f64( s+2*stride+k ), y2 = vld1q_f64( s+3*stride+k );
+    for ( i=0; i<n; i++ ) {
+      float64x2_t in = vmulq_f64( g, vld1q_f64( x + i*hop + k ) );
+      float64x2_t y = vsubq_f64( vaddq_f64( vaddq_f64( vmulq_f64( b0, in ), vmulq_f64( b1, x1 ) ), vsubq_f64( vmulq_f64( b2, x2 ), vmulq_f64( a2, y2 ) ) ), vmulq_f64( a1, y1 ) );
+      vst1q_f64( out + i*oHop + k, vaddq_f64( vld1q_f64( out + i*oHop + k ), y ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+    }
+    vst1q_f64( s+k, x1 ); vst1q_f64( s+stride+k, x2 );
+    vst1q_f64( s+2*stride+k, y1 ); vst1q_f64( s+3*stride+k, y2 );
+  }
+#endif
+
+  for ( ; k<width; k++ ) {
+    double g = c[k], b0 = c[stride+k], b1 = c[2*stride+k], b2 = c[3*stride+k], a1 = c[4*stride+k], a2 = c[5*stride+k];
+    double x1 = s[k], x2 = s[stride+k], y1 = s[2*stride+k], y2 = s[3*stride+k];
+    for ( i=0; i<n; i++ ) {
+      double in = g * x[i*hop + k];
+      double y = b0 * in + b1 * x1 + ( b2 * x2 - a2 * y2 ) - a1 * y1;
+      out[i*oHop + k] += y;
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+    }
+    s[k] = x1; s[stride+k] = x2;
+    s[2*stride+k] = y1; s[3*stride+k] = y2;
+  }
+}
+
+//! Run \e width independent direct form I biquads over n frames, adding each output into out.
+inline void biquadBank( const float *c, float *s, unsigned int stride, const float *x, unsigned int hop,
+                        float *out, unsigned int oHop, unsigned int width, unsigned int n )
+{
+  unsigned int i, k = 0;
+
+#if defined(__STK_SIMD_AVX__)
+  // Two vectors at a time, so one recursion runs while the other waits.
+  for ( ; k+16<=width; k+=16 ) {
+    __m256 g = _mm256_loadu_ps( c+k ), b0 = _mm256_loadu_ps( c+stride+k ), b1 = _mm256_loadu_ps( c+2*stride+k ), b2 = _mm256_loadu_ps( c+3*stride+k );
+    __m256 a1 = _mm256_loadu_ps( c+4*stride+k ), a2 = _mm256_loadu_ps( c+5*stride+k );
+    __m256 x1 = _mm256_loadu_ps( s+k ), x2 = _mm256_loadu_ps( s+stride+k ), y1 = _mm256_loadu_ps( s+2*stride+k ), y2 = _mm256_loadu_ps( s+3*stride+k );
+    __m256 gB = _mm256_loadu_ps( c+k+8 ), b0B = _mm256_loadu_ps( c+stride+k+8 ), b1B = _mm256_loadu_ps( c+2*stride+k+8 ), b2B = _mm256_loadu_ps( c+3*stride+k+8 );
+    __m256 a1B = _mm256_loadu_ps( c+4*stride+k+8 ), a2B = _mm256_loadu_ps( c+5*stride+k+8 );
+    __m256 x1B = _mm256_loadu_ps( s+k+8 ), x2B = _mm256_loadu_ps( s+stride+k+8 ), y1B = _mm256_loadu_ps( s+2*stride+k+8 ), y2B = _mm256_loadu_ps( s+3*stride+k+8 );
+    for ( i=0; i<n; i++ ) {
+      __m256 in = _mm256_mul_ps( g, _mm256_loadu_ps( x + i*hop + k ) );
+      __m256 y = _mm256_sub_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( b0, in ), _mm256_mul_ps( b1, x1 ) ), _mm256_sub_ps( _mm256_mul_ps( b2, x2 ), _mm256_mul_ps( a2, y2 ) ) ), _mm256_mul_ps( a1, y1 ) );
+      _mm256_storeu_ps( out + i*oHop + k, _mm256_add_ps( _mm256_loadu_ps( out + i*oHop + k ), y ) );
+      __m256 inB = _mm256_mul_ps( gB, _mm256_loadu_ps( x + i*hop + k + 8 ) );
+      __m256 yB = _mm256_sub_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( b0B, inB ), _mm256_mul_ps( b1B, x1B ) ), _mm256_sub_ps( _mm256_mul_ps( b2B, x2B ), _mm256_mul_ps( a2B, y2B ) ) ), _mm256_mul_ps( a1B, y1B ) );
+      _mm256_storeu_ps( out + i*oHop + k + 8, _mm256_add_ps( _mm256_loadu_ps( out + i*oHop + k + 8 ), yB ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+      x2B = x1B; x1B = inB;
+      y2B = y1B; y1B = yB;
+    }
+    _mm256_storeu_ps( s+k, x1 ); _mm256_storeu_ps( s+stride+k, x2 );
+    _mm256_storeu_ps( s+2*stride+k, y1 ); _mm256_storeu_ps( s+3*stride+k, y2 );
+    _mm256_storeu_ps( s+k+8, x1B ); _mm256_storeu_ps( s+stride+k+8, x2B );
+    _mm256_storeu_ps( s+2*stride+k+8, y1B ); _mm256_storeu_ps( s+3*stride+k+8, y2B );
+  }
+  for ( ; k+8<=width; k+=8 ) {
+    __m256 g = _mm256_loadu_ps( c+k ), b0 = _mm256_loadu_ps( c+stride+k ), b1 = _mm256_loadu_ps( c+2*stride+k ), b2 = _mm256_loadu_ps( c+3*stride+k );
+    __m256 a1 = _mm256_loadu_ps( c+4*stride+k ), a2 = _mm256_loadu_ps( c+5*stride+k );
+    __m256 x1 = _mm256_loadu_ps( s+k ), x2 = _mm256_loadu_ps( s+stride+k ), y1 = _mm256_loadu_ps( s+2*stride+k ), y2 = _mm256_loadu_ps( s+3*stride+k );
+    for ( i=0; i<n; i++ ) {
+      __m256 in = _mm256_mul_ps( g, _mm256_loadu_ps( x + i*hop + k ) );
+      __m256 y = _mm256_sub_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( b0, in ), _mm256_mul_ps( b1, x1 ) ), _mm256_sub_ps( _mm256_mul_ps( b2, x2 ), _mm256_mul_ps( a2, y2 ) ) ), _mm256_mul_ps( a1, y1 ) );
+      _mm256_storeu_ps( out + i*oHop + k, _mm256_add_ps( _mm256_loadu_ps( out + i*oHop + k ), y ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+    }
+    _mm256_storeu_ps( s+k, x1 ); _mm256_storeu_ps( s+stride+k, x2 );
+    _mm256_storeu_ps( s+2*stride+k, y1 ); _mm256_storeu_ps( s+3*stride+k, y2 );
+  }
+#elif defined(__STK_SIMD_SSE2__)
+  // Two vectors at a time, so one recursion runs while the other waits.
+  for ( ; k+8<=width; k+=8 ) {
+    __m128 g = _mm_loadu_ps( c+k ), b0 = _mm_loadu_ps( c+stride+k ), b1 = _mm_loadu_ps( c+2*stride+k ), b2 = _mm_loadu_ps( c+3*stride+k );
+    __m128 a1 = _mm_loadu_ps( c+4*stride+k ), a2 = _mm_loadu_ps( c+5*stride+k );
+    __m128 x1 = _mm_loadu_ps( s+k ), x2 = _mm_loadu_ps( s+stride+k ), y1 = _mm_loadu_ps( s+2*stride+k ), y2 = _mm_loadu_ps( s+3*stride+k );
+    __m128 gB = _mm_loadu_ps( c+k+4 ), b0B = _mm_loadu_ps( c+stride+k+4 ), b1B = _mm_loadu_ps( c+2*stride+k+4 ), b2B = _mm_loadu_ps( c+3*stride+k+4 );
+    __m128 a1B = _mm_loadu_ps( c+4*stride+k+4 ), a2B = _mm_loadu_ps( c+5*stride+k+4 );
+    __m128 x1B = _mm_loadu_ps( s+k+4 ), x2B = _mm_loadu_ps( s+stride+k+4 ), y1B = _mm_loadu_ps( s+2*stride+k+4 ), y2B = _mm_loadu_ps( s+3*stride+k+4 );
+    for ( i=0; i<n; i++ ) {
+      __m128 in = _mm_mul_ps( g, _mm_loadu_ps( x + i*hop + k ) );
+      __m128 y = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( b0, in ), _mm_mul_ps( b1, x1 ) ), _mm_sub_ps( _mm_mul_ps( b2, x2 ), _mm_mul_ps( a2, y2 ) ) ), _mm_mul_ps( a1, y1 ) );
+      _mm_storeu_ps( out + i*oHop + k, _mm_add_ps( _mm_loadu_ps( out + i*oHop + k ), y ) );
+      __m128 inB = _mm_mul_ps( gB, _mm_loadu_ps( x + i*hop + k + 4 ) );
+      __m128 yB = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( b0B, inB ), _mm_mul_ps( b1B, x1B ) ), _mm_sub_ps( _mm_mul_ps( b2B, x2B ), _mm_mul_ps( a2B, y2B ) ) ), _mm_mul_ps( a1B, y1B ) );
+      _mm_storeu_ps( out + i*oHop + k + 4, _mm_add_ps( _mm_loadu_ps( out + i*oHop + k + 4 ), yB ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+      x2B = x1B; x1B = inB;
+      y2B = y1B; y1B = yB;
+    }
+    _mm_storeu_ps( s+k, x1 ); _mm_storeu_ps( s+stride+k, x2 );
+    _mm_storeu_ps( s+2*stride+k, y1 ); _mm_storeu_ps( s+3*stride+k, y2 );
+    _mm_storeu_ps( s+k+4, x1B ); _mm_storeu_ps( s+stride+k+4, x2B );
+    _mm_storeu_ps( s+2*stride+k+4, y1B ); _mm_storeu_ps( s+3*stride+k+4, y2B );
+  }
+  for ( ; k+4<=width; k+=4 ) {
+    __m128 g = _mm_loadu_ps( c+k ), b0 = _mm_loadu_ps( c+stride+k ), b1 = _mm_loadu_ps( c+2*stride+k ), b2 = _mm_loadu_ps( c+3*stride+k );
+    __m128 a1 = _mm_loadu_ps( c+4*stride+k ), a2 = _mm_loadu_ps( c+5*stride+k );
+    __m128 x1 = _mm_loadu_ps( s+k ), x2 = _mm_loadu_ps( s+stride+k ), y1 = _mm_loadu_ps( s+2*stride+k ), y2 = _mm_loadu_ps( s+3*stride+k );
+    for ( i=0; i<n; i++ ) {
+      __m128 in = _mm_mul_ps( g, _mm_loadu_ps( x + i*hop + k ) );
+      __m128 y = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( b0, in ), _mm_mul_ps( b1, x1 ) ), _mm_sub_ps( _mm_mul_ps( b2, x2 ), _mm_mul_ps( a2, y2 ) ) ), _mm_mul_ps( a1, y1 ) );
+      _mm_storeu_ps( out + i*oHop + k, _mm_add_ps( _mm_loadu_ps( out + i*oHop + k ), y ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+    }
+    _mm_storeu_ps( s+k, x1 ); _mm_storeu_ps( s+stride+k, x2 );
+    _mm_storeu_ps( s+2*stride+k, y1 ); _mm_storeu_ps( s+3*stride+k, y2 );
+  }
+#elif defined(__STK_SIMD_NEON__)
+  // Two vectors at a time, so one recursion runs while the other waits.
+  for ( ; k+8<=width; k+=8 ) {
+    float32x4_t g = vld1q_f32( c+k ), b0 = vld1q_f32( c+stride+k ), b1 = vld1q_f32( c+2*stride+k ), b2 = vld1q_f32( c+3*stride+k );
+    float32x4_t a1 = vld1q_f32( c+4*stride+k ), a2 = vld1q_f32( c+5*stride+k );
+    float32x4_t x1 = vld1q_f32( s+k ), x2 = vld1q_f32( s+stride+k ), y1 = vld1q_f32( s+2*stride+k ), y2 = vld1q_f32( s+3*stride+k );
+    float32x4_t gB = vld1q_f32( c+k+4 ), b0B = vld1q_f32( c+stride+k+4 ), b1B = vld1q_f32( c+2*stride+k+4 ), b2B = vld1q_f32( c+3*stride+k+4 );
+    float32x4_t a1B = vld1q_f32( c+4*stride+k+4 ), a2B = vld1q_f32( c+5*stride+k+4 );
+    float32x4_t x1B = vld1q_f32( s+k+4 ), x2B = vld1q_f32( s+stride+k+4 ), y1B = vld1q_f32( s+2*stride+k+4 ), y2B = vld1q_f32( s+3*stride+k+4 );
+    for ( i=0; i<n; i++ ) {
+      float32x4_t in = vmulq_f32( g, vld1q_f32( x + i*hop + k ) );
+      float32x4_t y = vsubq_f32( vaddq_f32( vaddq_f32( vmulq_f32( b0, in ), vmulq_f32( b1, x1 ) ), vsubq_f32( vmulq_f32( b2, x2 ), vmulq_f32( a2, y2 ) ) ), vmulq_f32( a1, y1 ) );
+      vst1q_f32( out + i*oHop + k, vaddq_f32( vld1q_f32( out + i*oHop + k ), y ) );
+      float32x4_t inB = vmulq_f32( gB, vld1q_f32( x + i*hop + k + 4 ) );
+      float32x4_t yB = vsubq_f32( vaddq_f32( vaddq_f32( vmulq_f32( b0B, inB ), vmulq_f32( b1B, x1B ) ), vsubq_f32( vmulq_f32( b2B, x2B ), vmulq_f32( a2B, y2B ) ) ), vmulq_f32( a1B, y1B ) );
+      vst1q_f32( out + i*oHop + k + 4, vaddq_f32( vld1q_f32( out + i*oHop + k + 4 ), yB ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+      x2B = x1B; x1B = inB;
+      y2B = y1B; y1B = yB;
+    }
+    vst1q_f32( s+k, x1 ); vst1q_f32( s+stride+k, x2 );
+    vst1q_f32( s+2*stride+k, y1 ); vst1q_f32( s+3*stride+k, y2 );
+    vst1q_f32( s+k+4, x1B ); vst1q_f32( s+stride+k+4, x2B );
+    vst1q_f32( s+2*stride+k+4, y1B ); vst1q_f32( s+3*stride+k+4, y2B );
+  }
+  for ( ; k+4<=width; k+=4 ) {
+    float32x4_t g = vld1q_f32( c+k ), b0 = vld1q_f32( c+stride+k ), b1 = vld1q_f32( c+2*stride+k ), b2 = vld1q_f32( c+3*stride+k );
+    float32x4_t a1 = vld1q_f32( c+4*stride+k ), a2 = vld1q_f32( c+5*stride+k );
+    float32x4_t x1 = vld1q_f32( s+k ), x2 = vld1q_f32( s+stride+k ), y1 = vld1q_f32( s+2*stride+k ), y2 = vld1q_f32( s+3*stride+k );
+    for ( i=0; i<n; i++ ) {
+      float32x4_t in = vmulq_f32( g, vld1q_f32( x + i*hop + k ) );
+      float32x4_t y = vsubq_f32( vaddq_f32( vaddq_f32( vmulq_f32( b0, in ), vmulq_f32( b1, x1 ) ), vsubq_f32( vmulq_f32( b2, x2 ), vmulq_f32( a2, y2 ) ) ), vmulq_f32( a1, y1 ) );
+      vst1q_f32( out + i*oHop + k, vaddq_f32( vld1q_f32( out + i*oHop + k ), y ) );
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+    }
+    vst1q_f32( s+k, x1 ); vst1q_f32( s+stride+k, x2 );
+    vst1q_f32( s+2*stride+k, y1 ); vst1q_f32( s+3*stride+k, y2 );
+  }
+#endif
+
+  for ( ; k<width; k++ ) {
+    float g = c[k], b0 = c[stride+k], b1 = c[2*stride+k], b2 = c[3*stride+k], a1 = c[4*stride+k], a2 = c[5*stride+k];
+    float x1 = s[k], x2 = s[stride+k], y1 = s[2*stride+k], y2 = s[3*stride+k];
+    for ( i=0; i<n; i++ ) {
+      float in = g * x[i*hop + k];
+      float y = b0 * in + b1 * x1 + ( b2 * x2 - a2 * y2 ) - a1 * y1;
+      out[i*oHop + k] += y;
+      x2 = x1; x1 = in;
+      y2 = y1; y1 = y;
+    }
+    s[k] = x1; s[stride+k] = x2;
+    s[2*stride+k] = y1; s[3*stride+k] = y2;
+  }
+}
+
+//! Run one frame of \e width biquads laid out as for biquadBank(), all with the input x, and return the sum of their outputs.
+inline double biquadBankSum( const double *c, double *s, unsigned int stride, double x, unsigned int width )
+{
+  unsigned int k = 0;
+  double sum = 0.0;
+
+#if defined(__STK_SIMD_AVX__)
+  __m256d xv = _mm256_set1_pd( x ), acc = _mm256_setzero_pd();
+  for ( ; k+4<=width; k+=4 ) {
+    __m256d g = _mm256_loadu_pd( c+k ), in = _mm256_mul_pd( g, xv );
+    __m256d x1 = _mm256_loadu_pd( s+k ), x2 = _mm256_loadu_pd( s+stride+k ), y1 = _mm256_loadu_pd( s+2*stride+k ), y2 = _mm256_loadu_pd( s+3*stride+k );
+    __m256d y = _mm256_sub_pd( _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd( _mm256_loadu_pd( c+stride+k ), in ), _mm256_mul_pd( _mm256_loadu_pd( c+2*stride+k ), x1 ) ),
+                            _mm256_sub_pd( _mm256_mul_pd( _mm256_loadu_pd( c+3*stride+k ), x2 ), _mm256_mul_pd( _mm256_loadu_pd( c+5*stride+k ), y2 ) ) ),
+                 _mm256_mul_pd( _mm256_loadu_pd( c+4*stride+k ), y1 ) );
+    _mm256_storeu_pd( s+k, in ); _mm256_storeu_pd( s+stride+k, x1 );
+    _mm256_storeu_pd( s+2*stride+k, y ); _mm256_storeu_pd( s+3*stride+k, y1 );
+    acc = _mm256_add_pd( acc, y );
+  }
+  __m128d half = _mm_add_pd( _mm256_castpd256_pd128( acc ), _mm256_extractf128_pd( acc, 1 ) );
+  sum = _mm_cvtsd_f64( _mm_add_sd( half, _mm_unpackhi_pd( half, half ) ) );
+#elif defined(__STK_SIMD_SSE2__)
+  __m128d xv = _mm_set1_pd( x ), acc = _mm_setzero_pd();
+  for ( ; k+2<=width; k+=2 ) {
+    __m128d g = _mm_loadu_pd( c+k ), in = _mm_mul_pd( g, xv );
+    __m128d x1 = _mm_loadu_pd( s+k ), x2 = _mm_loadu_pd( s+stride+k ), y1 = _mm_loadu_pd( s+2*stride+k ), y2 = _mm_loadu_pd( s+3*stride+k );
+    __m128d y = _mm_sub_pd( _mm_add_pd( _mm_add_pd( _mm_mul_pd( _mm_loadu_pd( c+stride+k ), in ), _mm_mul_pd( _mm_loadu_pd( c+2*stride+k ), x1 ) ),
+                            _mm_sub_pd( _mm_mul_pd( _mm_loadu_pd( c+3*stride+k ), x2 ), _mm_mul_pd( _mm_loadu_pd( c+5*stride+k ), y2 ) ) ),
+                 _mm_mul_pd( _mm_loadu_pd( c+4*stride+k ), y1 ) );
+    _mm_storeu_pd( s+k, in ); _mm_storeu_pd( s+stride+k, x1 );
+    _mm_storeu_pd( s+2*stride+k, y ); _mm_storeu_pd( s+3*stride+k, y1 );
+    acc = _mm_add_pd( acc, y );
+  }
+  sum = _mm_cvtsd_f64( _mm_add_sd( acc, _mm_unpackhi_pd( acc, acc ) ) );
+#elif defined(__STK_SIMD_NEON__) && defined(__aarch64__)
+  float64x2_t xv = vdupq_n_f64( x ), acc = vdupq_n_f64( 0.0 );
+  for ( ; k+2<=width; k+=2 ) {
+    float64x2_t g = vld1q_f64( c+k ), in = vmulq_f64( g, xv );
+    float64x2_t x1 = vld1q_f64( s+k ), x2 = vld1q_f64( s+stride+k ), y1 = vld1q_f64( s+2*stride+k ), y2 = vld1q_f64( s+3*stride+k );
+    float64x2_t y = vsubq_f64( vaddq_f64( vaddq_f64( vmulq_f64( vld1q_f64( c+stride+k ), in ), vmulq_f64( vld1q_f64( c+2*stride+k ), x1 ) ),
+                            vsubq_f64( vmulq_f64( vld1q_f64( c+3*stride+k ), x2 ), vmulq_f64( vld1q_f64( c+5*stride+k ), y2 ) ) ),
+                 vmulq_f64( vld1q_f64( c+4*stride+k ), y1 ) );
+    vst1q_f64( s+k, in ); vst1q_f64( s+stride+k, x1 );
+    vst1q_f64( s+2*stride+k, y ); vst1q_f64( s+3*stride+k, y1 );
+    acc = vaddq_f64( acc, y );
+  }
+  sum = vaddvq_f64( acc );
+#endif
+
+  for ( ; k<width; k++ ) {
+    double in = c[k] * x;
+    double y = c[stride+k] * in + c[2*stride+k] * s[k] + ( c[3*stride+k] * s[stride+k] - c[5*stride+k] * s[3*stride+k] ) - c[4*stride+k] * s[2*stride+k];
+    s[stride+k] = s[k]; s[k] = in;
+    s[3*stride+k] = s[2*stride+k]; s[2*stride+k] = y;
+    sum += y;
+  }
+
+  return sum;
+}
+
+//! Run one frame of \e width biquads laid out as for biquadBank(), all with the input x, and return the sum of their outputs.
+inline float biquadBankSum( const float *c, float *s, unsigned int stride, float x, unsigned int width )
+{
+  unsigned int k = 0;
+  float sum = 0.0f;
+
+#if defined(__STK_SIMD_AVX__)
+  __m256 xv = _mm256_set1_ps( x ), acc = _mm256_setzero_ps();
+  for ( ; k+8<=width; k+=8 ) {
+    __m256 g = _mm256_loadu_ps( c+k ), in = _mm256_mul_ps( g, xv );
+    __m256 x1 = _mm256_loadu_ps( s+k ), x2 = _mm256_loadu_ps( s+stride+k ), y1 = _mm256_loadu_ps( s+2*stride+k ), y2 = _mm256_loadu_ps( s+3*stride+k );
+    __m256 y = _mm256_sub_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( c+stride+k ), in ), _mm256_mul_ps( _mm256_loadu_ps( c+2*stride+k ), x1 ) ),
+                            _mm256_sub_ps( _mm256_mul_ps( _mm256_loadu_ps( c+3*stride+k ), x2 ), _mm256_mul_ps( _mm256_loadu_ps( c+5*stride+k ), y2 ) ) ),
+                 _mm256_mul_ps( _mm256_loadu_ps( c+4*stride+k ), y1 ) );
+    _mm256_storeu_ps( s+k, in ); _mm256_storeu_ps( s+stride+k, x1 );
+    _mm256_storeu_ps( s+2*stride+k, y ); _mm256_storeu_ps( s+3*stride+k, y1 );
+    acc = _mm256_add_ps( acc, y );
+  }
+  __m128 quad = _mm_add_ps( _mm256_castps256_ps128( acc ), _mm256_extractf128_ps( acc, 1 ) );
+  quad = _mm_add_ps( quad, _mm_movehl_ps( quad, quad ) );
+  sum = _mm_cvtss_f32( _mm_add_ss( quad, _mm_shuffle_ps( quad, quad, 1 ) ) );
+#elif defined(__STK_SIMD_SSE2__)
+  __m128 xv = _mm_set1_ps( x ), acc = _mm_setzero_ps();
+  for ( ; k+4<=width; k+=4 ) {
+    __m128 g = _mm_loadu_ps( c+k ), in = _mm_mul_ps( g, xv );
+    __m128 x1 = _mm_loadu_ps( s+k ), x2 = _mm_loadu_ps( s+stride+k ), y1 = _mm_loadu_ps( s+2*stride+k ), y2 = _mm_loadu_ps( s+3*stride+k );
+    __m128 y = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( c+stride+k ), in ), _mm_mul_ps( _mm_loadu_ps( c+2*stride+k ), x1 ) ),
+                            _mm_sub_ps( _mm_mul_ps( _mm_loadu_ps( c+3*stride+k ), x2 ), _mm_mul_ps( _mm_loadu_ps( c+5*stride+k ), y2 ) ) ),
+                 _mm_mul_ps( _mm_loadu_ps( c+4*stride+k ), y1 ) );
+    _mm_storeu_ps( s+k, in ); _mm_storeu_ps( s+stride+k, x1 );
+    _mm_storeu_ps( s+2*stride+k, y ); _mm_storeu_ps( s+3*stride+k, y1 );
+    acc = _mm_add_ps( acc, y );
+  }
+  acc = _mm_add_ps( acc, _mm_movehl_ps( acc, acc ) );
+  sum = _mm_cvtss_f32( _mm_add_ss( acc, _mm_shuffle_ps( acc, acc, 1 ) ) );
+#elif defined(__STK_SIMD_NEON__)
+  float32x4_t xv = vdupq_n_f32( x ), acc = vdupq_n_f32( 0.0f );
+  for ( ; k+4<=width; k+=4 ) {
+    float32x4_t g = vld1q_f32( c+k ), in = vmulq_f32( g, xv );
+    float32x4_t x1 = vld1q_f32( s+k ), x2 = vld1q_f32( s+stride+k ), y1 = vld1q_f32( s+2*stride+k ), y2 = vld1q_f32( s+3*stride+k );
+    float32x4_t y = vsubq_f32( vaddq_f32( vaddq_f32( vmulq_f32( vld1q_f32( c+stride+k ), in ), vmulq_f32( vld1q_f32( c+2*stride+k ), x1 ) ),
+                            vsubq_f32( vmulq_f32( vld1q_f32( c+3*stride+k ), x2 ), vmulq_f32( vld1q_f32( c+5*stride+k ), y2 ) ) ),
+                 vmulq_f32( vld1q_f32( c+4*stride+k ), y1 ) );
+    vst1q_f32( s+k, in ); vst1q_f32( s+stride+k, x1 );
+    vst1q_f32( s+2*stride+k, y ); vst1q_f32( s+3*stride+k, y1 );
+    acc = vaddq_f32( acc, y );
+  }
+  float32x2_t pair = vadd_f32( vget_low_f32( acc ), vget_high_f32( acc ) );
+  sum = vget_lane_f32( vpadd_f32( pair, pair ), 0 );
+#endif
+
+  for ( ; k<width; k++ ) {
+    float in = c[k] * x;
+    float y = c[stride+k] * in + c[2*stride+k] * s[k] + ( c[3*stride+k] * s[stride+k] - c[5*stride+k] * s[3*stride+k] ) - c[4*stride+k] * s[2*stride+k];
+    s[stride+k] = s[k]; s[k] = in;
+    s[3*stride+k] = s[2*stride+k]; s[2*stride+k] = y;
+    sum += y;
+  }
+
+  return sum;
+}
+
+//! Add x[i] to sum[i] for i = 0 ... n-1.
+/*!
+  Each element gets one addition, so unlike the other kernels the
+  vector and scalar versions give identical results.
+*/
+inline void accumulate( double *sum, const double *x, unsigned int n )
+{
+  unsigned int i = 0;
+
+#if defined(__STK_SIMD_AVX__)
+  for ( ; i+8<=n; i+=8 ) {
+    _mm256_storeu_pd( sum+i, _mm256_add_pd( _mm256_loadu_pd( sum+i ), _mm256_loadu_pd( x+i ) ) );
+    _mm256_storeu_pd( sum+i+4, _mm256_add_pd( _mm256_loadu_pd( sum+i+4 ), _mm256_loadu_pd( x+i+4 ) ) );
+  }
+#elif defined(__STK_SIMD_SSE2__)
+  for ( ; i+4<=n; i+=4 ) {
+    _mm_storeu_pd( sum+i, _mm_add_pd( _mm_loadu_pd( sum+i ), _mm_loadu_pd( x+i ) ) );
+    _mm_storeu_pd( sum+i+2, _mm_add_pd( _mm_loadu_pd( sum+i+2 ), _mm_loadu_pd( x+i+2 ) ) );
+  }
+#elif defined(__STK_SIMD_NEON__) && defined(__aarch64__)
+  for ( ; i+4<=n; i+=4 ) {
+    vst1q_f64( sum+i, vaddq_f64( vld1q_f64( sum+i ), vld1q_f64( x+i ) ) );
+    vst1q_f64( sum+i+2, vaddq_f64( vld1q_f64( sum+i+2 ), vld1q_f64( x+i+2 ) ) );
+  }
+#endif
+
+  for ( ; i<n; i++ )
+    sum[i] += x[i];
+}
+
+//! Add x[i] to sum[i] for i = 0 ... n-1.
+inline void accumulate( float *sum, const float *x, unsigned int n )
+{
+  unsigned int i = 0;
+
+#if defined(__STK_SIMD_AVX__)
+  for ( ; i+16<=n; i+=16 ) {
+    _mm256_storeu_ps( sum+i, _mm256_add_ps( _mm256_loadu_ps( sum+i ), _mm256_loadu_ps( x+i ) ) );
+    _mm256_storeu_ps( sum+i+8, _mm256_add_ps( _mm256_loadu_ps( sum+i+8 ), _mm256_loadu_ps( x+i+8 ) ) );
+  }
+#elif defined(__STK_SIMD_SSE2__)
+  for ( ; i+8<=n; i+=8 ) {
+    _mm_storeu_ps( sum+i, _mm_add_ps( _mm_loadu_ps( sum+i ), _mm_loadu_ps( x+i ) ) );
+    _mm_storeu_ps( sum+i+4, _mm_add_ps( _mm_loadu_ps( sum+i+4 ), _mm_loadu_ps( x+i+4 ) ) );
+  }
+#elif defined(__STK_SIMD_NEON__)
+  for ( ; i+8<=n; i+=8 ) {
+    vst1q_f32( sum+i, vaddq_f32( vld1q_f32( sum+i ), vld1q_f32( x+i ) ) );
+    vst1q_f32( sum+i+4, vaddq_f32( vld1q_f32( sum+i+4 ), vld1q_f32( x+i+4 ) ) );
+  }
+#endif
+
+  for ( ; i<n; i++ )
+    sum[i] += x[i];
+}
+
+// The decode kernels read n samples from memory that need not be
+// aligned.  \e swap is true if the byte order of the samples differs
+// from the host's.  Integers are converted and then multiplied by
+// \e gain, floating-point values are copied.
+
+#if defined(__STK_SIMD_AVX__) || defined(__STK_SIMD_SSE2__)
+
+// Store the four 32-bit integers in x, times gain.
+inline void storeScaled( double *out, __m128i x, double gain )
+{
+#if defined(__STK_SIMD_AVX__)
+  _mm256_storeu_pd( out, _mm256_mul_pd( _mm256_cvtepi32_pd( x ), _mm256_set1_pd( gain ) ) );
+#else
+  __m128d g = _mm_set1_pd( gain );
+  _mm_storeu_pd( out, _mm_mul_pd( _mm_cvtepi32_pd( x ), g ) );
+  _mm_storeu_pd( out+2, _mm_mul_pd( _mm_cvtepi32_pd( _mm_unpackhi_epi64( x, x ) ), g ) );
+#endif
+}
+
+inline void storeScaled( float *out, __m128i x, float gain )
+{
+  _mm_storeu_ps( out, _mm_mul_ps( _mm_cvtepi32_ps( x ), _mm_set1_ps( gain ) ) );
+}
+
+// Reverse the bytes of each 16, 32 or 64-bit lane of x.
+inline __m128i swapBytes16( __m128i x )
+{
+  return _mm_or_si128( _mm_slli_epi16( x, 8 ), _mm_srli_epi16( x, 8 ) );
+}
+
+inline __m128i swapBytes32( __m128i x )
+{
+  return swapBytes16( _mm_shufflehi_epi16( _mm_shufflelo_epi16( x, 0xB1 ), 0xB1 ) );
+}
+
+inline __m128i swapBytes64( __m128i x )
+{
+  return swapBytes16( _mm_shufflehi_epi16( _mm_shufflelo_epi16( x, 0x1B ), 0x1B ) );
+}
+
+#endif
+
+// Return the 16, 32 or 64-bit value at in, in host byte order.
+inline UINT16 loadBits16( const unsigned char *in, bool swap )
+{
+  UINT16 v;
+  memcpy( &v, in, 2 );
+  return swap ? (UINT16) ( ( v << 8 ) | ( v >> 8 ) ) : v;
+}
+
+inline UINT32 loadBits32( const unsigned char *in, bool swap )
+{
+  UINT32 v;
+  memcpy( &v, in, 4 );
+  if ( swap )
+    v = ( v << 24 ) | ( ( v << 8 ) & 0x00ff0000 ) | ( ( v >> 8 ) & 0x0000ff00 ) | ( v >> 24 );
+  return v;
+}
+
+inline unsigned long long loadBits64( const unsigned char *in, bool swap )
+{
+  unsigned long long v;
+  memcpy( &v, in, 8 );
+  if ( swap ) {
+    UINT32 hi = (UINT32) ( v >> 32 ), lo = (UINT32) v;
+    v = ( (unsigned long long) loadBits32( (const unsigned char *) &lo, true ) << 32 ) |
+      loadBits32( (const unsigned char *) &hi, true );
+  }
+  return v;
+}
+
+//! Convert n 8-bit integers to StkFloat values times gain.
+/*!
+  The integers are unsigned with an offset of 128, as in WAV files,
+  if \e isUnsigned is true, and signed otherwise.
+*/
+inline void decodeInt8( StkFloat *out, const unsigned char *in, unsigned long n, bool isUnsigned, StkFloat gain )
+{
+  unsigned long i = 0;
+
+#if defined(__STK_SIMD_AVX__) || defined(__STK_SIMD_SSE2__)
+  // Flipping the top bit of an offset byte gives the signed value.
+  const __m128i bias = _mm_set1_epi8( isUnsigned ? (char) 0x80 : 0 );
+  for ( ; i+16<=n; i+=16 ) {
+    __m128i x = _mm_xor_si128( _mm_loadu_si128( (const __m128i *) ( in+i ) ), bias );
+    __m128i lo = _mm_unpacklo_epi8( x, x ), hi = _mm_unpackhi_epi8( x, x );
+    storeScaled( out+i, _mm_srai_epi32( _mm_unpacklo_epi16( lo, lo ), 24 ), gain );
+    storeScaled( out+i+4, _mm_srai_epi32( _mm_unpackhi_epi16( lo, lo ), 24 ), gain );
+    storeScaled( out+i+8, _mm_srai_epi32( _mm_unpacklo_epi16( hi, hi ), 24 ), gain );
+    storeScaled( out+i+12, _mm_srai_epi32( _mm_unpackhi_epi16( hi, hi ), 24 ), gain );
+  }
+#endif
+
+  for ( ; i<n; i++ )
+    out[i] = ( isUnsigned ? in[i] - 128 : (signed char) in[i] ) * gain;
+}
+
+//! Convert n 16-bit signed integers to StkFloat values times gain.
+inline void decodeInt16( StkFloat *out, const unsigned char *in, unsigned long n, bool swap, StkFloat gain )
+{
+  unsigned long i = 0;
+
+#if defined(__STK_SIMD_AVX__) || defined(__STK_SIMD_SSE2__)
+  for ( ; i+8<=n; i+=8 ) {
+    __m128i x = _mm_loadu_si128( (const __m128i *) ( in+2*i ) );
+    if ( swap ) x = swapBytes16( x );
+    storeScaled( out+i, _mm_srai_epi32( _mm_unpacklo_epi16( x, x ), 16 ), gain );
+    storeScaled( out+i+4, _mm_srai_epi32( _mm_unpackhi_epi16( x, x ), 16 ), gain );
+  }
+#endif
+
+  for ( ; i<n; i++ )
+    out[i] = (SINT16) loadBits16( in+2*i, swap ) * gain;
+}
+
+//! Convert n 24-bit signed integers to StkFloat values times gain.
+/*!
+  Each integer is converted shifted left by 8 bits, as the top three
+  bytes of a 32-bit integer, so a gain of 1.0 / 256.0 gives the
+  integer values.
+*/
+inline void decodeInt24( StkFloat *out, const unsigned char *in, unsigned long n, bool swap, StkFloat gain )
+{
+  unsigned long i = 0;
+
+#if defined(__STK_SIMD_AVX__) || defined(__STK_SIMD_SSE2__)
+  // Move each group of three bytes to the low bytes of its own lane.
+  // A 16-byte load holds five samples, so stop while six remain.
+  const __m128i m0 = _mm_set_epi32( 0, 0, 0, 0x00ffffff ), m1 = _mm_slli_si128( m0, 4 );
+  const __m128i m2 = _mm_slli_si128( m0, 8 ), m3 = _mm_slli_si128( m0, 12 );
+  for ( ; i+6<=n; i+=4 ) {
+    __m128i x = _mm_loadu_si128( (const __m128i *) ( in+3*i ) );
+    __m128i y = _mm_or_si128( _mm_or_si128( _mm_and_si128( x, m0 ), _mm_and_si128( _mm_slli_si128( x, 1 ), m1 ) ),
+                              _mm_or_si128( _mm_and_si128( _mm_slli_si128( x, 2 ), m2 ),
+                                            _mm_and_si128( _mm_slli_si128( x, 3 ), m3 ) ) );
+    y = swap ? swapBytes32( y ) : _mm_slli_epi32( y, 8 );
+    storeScaled( out+i, y, gain );
+  }
+#endif
+
+  // The samples are little-endian if they are in host order on a
+  // little-endian host or swapped on a big-endian one.
+#if defined(__LITTLE_ENDIAN__)
+  bool littleEndian = !swap;
+#else
+  bool littleEndian = swap;
+#endif
+  for ( ; i<n; i++ ) {
+    const unsigned char *p = in + 3*i;
+    UINT32 v = littleEndian ? ( (UINT32) p[2] << 24 ) | ( p[1] << 16 ) | ( p[0] << 8 )
+      : ( (UINT32) p[0] << 24 ) | ( p[1] << 16 ) | ( p[2] << 8 );
+    out[i] = (SINT32) v * gain;
+  }
+}
+
+//! Convert n 32-bit signed integers to StkFloat values times gain.
+inline void decodeInt32( StkFloat *out, const unsigned char *in, unsigned long n, bool swap, StkFloat gain )
+{
+  unsigned long i = 0;
+
+#if defined(__STK_SIMD_AVX__) || defined(__STK_SIMD_SSE2__)
+  for ( ; i+4<=n; i+=4 ) {
+    __m128i x = _mm_loadu_si128( (const __m128i *) ( in+4*i ) );
+    storeScaled( out+i, swap ? swapBytes32( x ) : x, gain );
+  }
+#endif
+
+  for ( ; i<n; i++ )
+    out[i] = (SINT32) loadBits32( in+4*i, swap ) * gain;
+}
+
+//! Convert n 32-bit floating-point values to StkFloat values.
+inline void decodeFloat32( StkFloat *out, const unsigned char *in, unsigned long n, bool swap )
+{
+  unsigned long i = 0;
+
+#if defined(__STK_SIMD_AVX__) || defined(__STK_SIMD_SSE2__)
+  for ( ; i+4<=n; i+=4 ) {
+    __m128i x = _mm_loadu_si128( (const __m128i *) ( in+4*i ) );
+    if ( swap ) x = swapBytes32( x );
+#if defined(__STK_FLOAT32__)
+    _mm_storeu_ps( out+i, _mm_castsi128_ps( x ) );
+#elif defined(__STK_SIMD_AVX__)
+    _mm256_storeu_pd( out+i, _mm256_cvtps_pd( _mm_castsi128_ps( x ) ) );
+#else
+    _mm_storeu_pd( out+i, _mm_cvtps_pd( _mm_castsi128_ps( x ) ) );
+    _mm_storeu_pd( out+i+2, _mm_cvtps_pd( _mm_castsi128_ps( _mm_unpackhi_epi64( x, x ) ) ) );
+#endif
+  }
+#endif
+
+  for ( ; i<n; i++ ) {
+    UINT32 v = loadBits32( in+4*i, swap );
+    FLOAT32 f;
+    memcpy( &f, &v, 4 );
+    out[i] = f;
+  }
+}
+
+//! Convert n 64-bit floating-point values to StkFloat values.
+inline void decodeFloat64( StkFloat *out, const unsigned char *in, unsigned long n, bool swap )
+{
+  unsigned long i = 0;
+
+#if defined(__STK_SIMD_AVX__) || defined(__STK_SIMD_SSE2__)
+  for ( ; i+4<=n; i+=4 ) {
+    __m128i x0 = _mm_loadu_si128( (const __m128i *) ( in+8*i ) );
+    __m128i x1 = _mm_loadu_si128( (const __m128i *) ( in+8*i+16 ) );
+    if ( swap ) {
+      x0 = swapBytes64( x0 );
+      x1 = swapBytes64( x1 );
+    }
+#if defined(__STK_FLOAT32__)
+    _mm_storeu_ps( out+i, _mm_movelh_ps( _mm_cvtpd_ps( _mm_castsi128_pd( x0 ) ),
+                                         _mm_cvtpd_ps( _mm_castsi128_pd( x1 ) ) ) );
+#else
+    _mm_storeu_pd( out+i, _mm_castsi128_pd( x0 ) );
+    _mm_storeu_pd( out+i+2, _mm_castsi128_pd( x1 ) );
+#endif
+  }
+#endif
+
+  for ( ; i<n; i++ ) {
+    unsigned long long v = loadBits64( in+8*i, swap );
+    FLOAT64 f;
+    memcpy( &f, &v, 8 );
+    out[i] = (StkFloat) f;
+  }
+}
+
+} // stk namespace
+
+#endif
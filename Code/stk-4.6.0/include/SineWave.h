@@ -88,8 +88,8 @@ protected:
   void sampleRateChanged( StkFloat newRate, StkFloat oldRate );
 
   static StkFrames table_;
-  StkFloat time_;
-  StkFloat rate_;
+  double time_;
+  double rate_;
   StkFloat phaseOffset_;
   unsigned int iIndex_;
   StkFloat alpha_;
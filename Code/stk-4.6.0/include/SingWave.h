@@ -31,7 +31,8 @@ class SingWave : public Generator
     is unknown, or a read error occurs.  If the soundfile has no
     header, the second argument should be \e true and the file data
     will be assumed to consist of 16-bit signed integers in big-endian
-    byte order at a sample rate of 22050 Hz.
+    byte order at a sample rate of 22050 Hz.  The file data is shared
+    through the WaveCache with every other object that plays it.
   */
   SingWave( std::string fileName, bool raw = false );
 
@@ -75,8 +75,8 @@ class Sitar : public Instrmnt
 
   StkFloat loopGain_;
   StkFloat amGain_;
-  StkFloat delay_;
-  StkFloat targetDelay_;
+  double delay_;
+  double targetDelay_;
 
 };
 
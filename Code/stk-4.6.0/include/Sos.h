@@ -0,0 +1,213 @@
+#ifndef STK_SOS_H
+#define STK_SOS_H
+
+#include "Filter.h"
+#include "Simd.h"
+#include <complex>
+
+namespace stk {
+
+/***************************************************/
+/*! \class Sos
+    \brief STK cascade of second-order sections IIR filter class.
+
+    This class implements an IIR filter as a series of biquads, each
+    in transposed direct form II:
+
+    y[n] = b0*x[n] + s1[n-1]
+    s1[n] = b1*x[n] - a1*y[n] + s2[n-1]
+    s2[n] = b2*x[n] - a2*y[n]
+
+    A high-order filter in the single difference equation of the Iir
+    class needs its coefficients to many more digits than a sample
+    has, and small errors move its poles a long way; a cascade of
+    second-order sections keeps every pole pair in two well-scaled
+    coefficients and stays stable at any order.
+
+    The sections can be given directly (see IirDesign), from their
+    poles and zeros with fromRoots(), or from the b and a coefficients
+    of an Iir filter with setCoefficients(), which finds the roots of
+    both polynomials.  Poles are paired with their nearest zeros and
+    the sections run from the least to the most resonant.
+
+    The filter can run on several channels at once with the same
+    coefficients, for example the two sides of a stereo signal.  The
+    StkFrames tick functions run each section over the whole block
+    before the next one, a vector of channels at a time (see Simd.h).
+*/
+/***************************************************/
+
+class Sos : public Filter
+{
+public:
+  //! One biquad, with a0 equal to 1.
+  struct Section {
+    StkFloat b0, b1, b2;
+    StkFloat a1, a2;
+  };
+
+  //! Default constructor creates a pass-through "filter" with no sections on one channel.
+  Sos( void );
+
+  //! Overloaded constructor which takes the sections and the number of channels.
+  Sos( const std::vector<Section> &sections, unsigned int channels = 1 );
+
+  //! Overloaded constructor which takes Iir filter coefficients, see setCoefficients().
+  Sos( std::vector<StkFloat> &bCoefficients, std::vector<StkFloat> &aCoefficients );
+
+  //! Class destructor.
+  ~Sos( void );
+
+  //! Set the sections.
+  /*!
+    The internal state of the filter is not cleared unless the \e
+    clearState flag is \c true or the number of sections changes.
+  */
+  void setSections( const std::vector<Section> &sections, bool clearState = false );
+
+  //! Return the sections in use.
+  const std::vector<Section>& getSections( void ) const { return sections_; };
+
+  //! Set the sections from the coefficients of the Iir difference equation.
+  /*!
+    An StkError can be thrown if either of the coefficient vector
+    sizes is zero, or if the a[0] coefficient is equal to zero.  The
+    roots are only as accurate as the polynomials allow: repeated
+    roots of a high-order filter are better designed as sections in
+    the first place.  The internal state of the filter is not cleared
+    unless the \e clearState flag is \c true or the number of sections
+    changes.
+  */
+  void setCoefficients( std::vector<StkFloat> &bCoefficients, std::vector<StkFloat> &aCoefficients, bool clearState = false );
+
+  //! Return the sections of \e gain times the product of (1 - zero/z) over the product of (1 - pole/z).
+  /*!
+    Complex zeros and poles must come with their conjugates.
+  */
+  static std::vector<Section> fromRoots( const std::vector< std::complex<StkFloat> > &zeros,
+                                         const std::vector< std::complex<StkFloat> > &poles,
+                                         StkFloat gain );
+
+  //! Set the number of channels that run through the filter.  The internal state is cleared.
+  void setChannels( unsigned int channels );
+
+  //! Return the number of samples the impulse response takes to decay by \e attenuation dB.
+  /*!
+    The estimate follows the pole closest to the unit circle.
+  */
+  unsigned long getDecayLength( StkFloat attenuation = 60.0 ) const;
+
+  //! Clears the state of every section and channel.
+  void clear( void );
+
+  //! Return the last computed output value of channel 0.
+  StkFloat lastOut( void ) const { return lastFrame_[0]; };
+
+  //! Input one sample to channel 0 and return one output.
+  StkFloat tick( StkFloat input );
+
+  //! Take the channels \c channel onwards of the StkFrames object as inputs to the filter and replace with corresponding outputs.
+  /*!
+    The StkFrames argument reference is returned.  The StkFrames
+    argument must have at least \c channel plus the number of filter
+    channels.  However, range checking is only performed if
+    _STK_DEBUG_ is defined during compilation, in which case an
+    out-of-range value will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
+
+  //! Take the channels \c iChannel onwards of the \c iFrames object as inputs to the filter and write outputs to the channels \c oChannel onwards of the \c oFrames object.
+  /*!
+    The \c iFrames object reference is returned.  Each StkFrames
+    argument must have at least the channel argument plus the number
+    of filter channels.  However, range checking is only performed if
+    _STK_DEBUG_ is defined during compilation, in which case an
+    out-of-range value will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
+
+protected:
+
+  void computeBlock( StkFloat *samples, unsigned int hop, unsigned int n );
+
+  std::vector<Section> sections_;
+  std::vector<StkFloat> coefficients_;  // b0, b1, b2, a1, a2 of each section, for biquadBlock()
+  unsigned int channels_;
+
+  // Per section: s1 of every channel, then s2 of every channel.
+  std::vector<StkFloat> state_;
+};
+
+inline StkFloat Sos :: tick( StkFloat input )
+{
+  StkFloat x = gain_ * input;
+
+  for ( unsigned int i=0; i<sections_.size(); i++ ) {
+    const Section &s = sections_[i];
+    StkFloat *state = &state_[2 * i * channels_];
+    StkFloat y = s.b0 * x + state[0];
+    state[0] = s.b1 * x - s.a1 * y + state[channels_];
+    state[channels_] = s.b2 * x - s.a2 * y;
+    x = y;
+  }
+
+  lastFrame_[0] = x;
+  return lastFrame_[0];
+}
+
+inline void Sos :: computeBlock( StkFloat *samples, unsigned int hop, unsigned int n )
+{
+  unsigned int i;
+
+  if ( n == 0 ) return;
+  if ( gain_ != 1.0 ) {
+    for ( i=0; i<n; i++ )
+      for ( unsigned int k=0; k<channels_; k++ )
+        samples[i * hop + k] *= gain_;
+  }
+
+  for ( i=0; i<sections_.size(); i++ ) {
+    StkFloat *state = &state_[2 * i * channels_];
+    biquadBlock( &coefficients_[5 * i], state, state + channels_, samples, hop, channels_, n );
+  }
+
+  for ( unsigned int k=0; k<channels_; k++ )
+    lastFrame_[k] = samples[( n - 1 ) * hop + k];
+}
+
+inline StkFrames& Sos :: tick( StkFrames& frames, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel + channels_ > frames.channels() ) {
+    oStream_ << "Sos::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  computeBlock( &frames[channel], frames.channels(), frames.frames() );
+  return frames;
+}
+
+inline StkFrames& Sos :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
+{
+#if defined(_STK_DEBUG_)
+  if ( iChannel + channels_ > iFrames.channels() || oChannel + channels_ > oFrames.channels() ) {
+    oStream_ << "Sos::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *iSamples = &iFrames[iChannel];
+  StkFloat *oSamples = &oFrames[oChannel];
+  unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
+  for ( unsigned int i=0; i<iFrames.frames(); i++ )
+    for ( unsigned int k=0; k<channels_; k++ )
+      oSamples[i * oHop + k] = iSamples[i * iHop + k];
+
+  computeBlock( oSamples, oHop, iFrames.frames() );
+  return iFrames;
+}
+
+} // stk namespace
+
+#endif
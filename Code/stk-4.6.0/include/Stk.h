@@ -71,10 +71,18 @@ namespace stk {
 //#define _STK_DEBUG_
 
 // Most data in STK is passed and calculated with the
-// following user-definable floating-point type.  You
-// can change this to "float" if you prefer or perhaps
-// a "long double" in the future.
+// following user-definable floating-point type.  It is
+// "double" by default.  Defining __STK_FLOAT32__ (or
+// configuring with --enable-float) selects "float",
+// which halves the memory used by buffers, delay lines
+// and tables and doubles the SIMD width.  A program must
+// be compiled with the same setting as the library it
+// links against.
+#if defined(__STK_FLOAT32__)
+typedef float StkFloat;
+#else
 typedef double StkFloat;
+#endif
 
 //! STK error handling class.
 /*!
@@ -244,6 +252,62 @@ protected:
 };
 
 
+/***************************************************/
+/*! \class StkArena
+    \brief A preallocated memory pool for StkFrames data.
+
+    An StkArena allocates one block of memory when it is created and
+    hands out aligned pieces of it to StkFrames objects constructed
+    with it.  Nothing is returned to the arena when such an object is
+    destroyed or grows; all of the memory is released together by
+    reset() or when the arena is destroyed.  This keeps the buffers of
+    a processing graph close together and lets a program size them up
+    front, so that no audio-thread code touches the heap.
+
+    The arena must outlive every StkFrames object that uses it.
+*/
+/***************************************************/
+
+class StkArena
+{
+public:
+
+  //! Allocate an arena of \c bytes bytes.
+  /*!
+    An StkError is thrown if the memory cannot be allocated.
+  */
+  StkArena( size_t bytes );
+
+  //! The destructor releases all of the arena memory.
+  ~StkArena();
+
+  //! Return \c bytes bytes of memory aligned to STK_ALIGNMENT, or NULL if the arena is exhausted.
+  void *allocate( size_t bytes );
+
+  //! Mark all of the arena memory free again.
+  /*!
+    StkFrames objects using the arena must not be used after this.
+  */
+  void reset( void ) { used_ = 0; };
+
+  //! Return the arena size in bytes.
+  size_t capacity( void ) const { return capacity_; };
+
+  //! Return the number of bytes handed out since construction or the last reset().
+  size_t used( void ) const { return used_; };
+
+private:
+
+  // Arenas are not copyable.
+  StkArena( const StkArena& );
+  StkArena& operator= ( const StkArena& );
+
+  char *data_;
+  size_t capacity_;
+  size_t used_;
+};
+
+
 /***************************************************/
 /*! \class StkFrames
     \brief An STK class to handle vectorized audio data.
@@ -265,6 +329,10 @@ protected:
     Note that this class can also be used as a table with interpolating
     lookup.
 
+    The data is aligned to STK_ALIGNMENT bytes.  It normally comes
+    from the heap, but can be taken from an StkArena instead.  The
+    StkFramesView subclass wraps memory owned by the caller.
+
     Possible future improvements in this class could include functions
     to convert to and return other data types.
 
@@ -282,13 +350,22 @@ public:
   //! Overloaded constructor that initializes the frame data to the specified size with \c value.
   StkFrames( const StkFloat& value, unsigned int nFrames, unsigned int nChannels );
 
+  //! Overloaded constructor that takes its zero-initialized storage from \c arena.
+  /*!
+    Later growth by resize() is also taken from the arena.  An
+    StkError is thrown if the arena is exhausted.
+  */
+  StkFrames( StkArena& arena, unsigned int nFrames, unsigned int nChannels );
+
   //! The destructor.
   ~StkFrames();
 
   // A copy constructor.
   StkFrames( const StkFrames& f );
 
-  // Assignment operator that returns a reference to self.
+  // Assignment operator that returns a reference to self.  An
+  // StkFramesView keeps its memory and copies the values into it, so
+  // the dimensions must match.
   StkFrames& operator= ( const StkFrames& f );
 
   //! Subscript operator that returns a reference to element \c n of self.
@@ -370,7 +447,9 @@ public:
     channels.  No element assignment is performed.  No memory
     deallocation occurs if the new size is smaller than the previous
     size.  Further, no new memory is allocated when the new size is
-    smaller or equal to a previously allocated size.
+    smaller or equal to a previously allocated size.  An StkFramesView
+    cannot grow beyond the memory it wraps and an StkError is thrown
+    if that is attempted.
   */
   void resize( size_t nFrames, unsigned int nChannels = 1 );
 
@@ -420,7 +499,7 @@ public:
    */
   StkFloat dataRate( void ) const { return dataRate_; };
 
-private:
+protected:
 
   StkFloat *data_;
   StkFloat dataRate_;
@@ -428,9 +507,54 @@ private:
   unsigned int nChannels_;
   size_t size_;
   size_t bufferSize_;
+  StkArena *arena_;  // storage source, or NULL for the heap
+  bool owner_;       // false when data_ belongs to someone else
 
 };
 
+
+/***************************************************/
+/*! \class StkFramesView
+    \brief An StkFrames object that wraps memory it does not own.
+
+    A view presents caller-owned interleaved StkFloat samples as an
+    StkFrames object, so any tick(StkFrames&) function can process
+    them in place without a copy.  Constructing, copying and
+    destroying a view never allocates or frees memory.
+
+    A view can be resized smaller than the memory it wraps, but not
+    larger.  Copying a view gives a second view of the same memory,
+    while assigning to a view copies sample values into its memory.
+*/
+/***************************************************/
+
+class StkFramesView : public StkFrames
+{
+public:
+
+  //! Wrap \c nFrames frames of \c nChannels interleaved channels starting at \c data.
+  StkFramesView( StkFloat *data, unsigned int nFrames, unsigned int nChannels = 1 );
+
+  //! Wrap \c nFrames frames of \c frames starting at frame \c offset.
+  /*!
+    The view is valid until \c frames is resized or destroyed.  No
+    range checking is performed unless _STK_DEBUG_ is defined.
+  */
+  StkFramesView( StkFrames& frames, unsigned int offset, unsigned int nFrames );
+
+  //! A copy constructor that wraps the same memory as \c v.
+  StkFramesView( const StkFramesView& v );
+
+  //! Copy the values of \c f into the wrapped memory.
+  StkFramesView& operator= ( const StkFrames& f ) { StkFrames::operator=( f ); return *this; };
+
+  //! Copy the values of \c v into the wrapped memory.
+  StkFramesView& operator= ( const StkFramesView& v ) { StkFrames::operator=( v ); return *this; };
+
+  //! Wrap different memory.
+  void wrap( StkFloat *data, unsigned int nFrames, unsigned int nChannels = 1 );
+};
+
 inline bool StkFrames :: empty() const
 {
   if ( size_ > 0 ) return false;
@@ -551,6 +675,10 @@ typedef double FLOAT64;
 // The default sampling rate.
 const StkFloat SRATE = 44100.0;
 
+// The byte alignment of StkFrames and StkArena storage, one cache
+// line and enough for any SIMD load on the supported targets.
+const size_t STK_ALIGNMENT = 64;
+
 // The default real-time audio input and output buffer size.  If
 // clicks are occuring in the input and/or output sound stream, a
 // larger buffer size may help.  Larger buffer sizes, however, produce
@@ -0,0 +1,185 @@
+#ifndef STK_SYMMETRICFIR_H
+#define STK_SYMMETRICFIR_H
+
+#include "Fir.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class SymmetricFir
+    \brief STK linear-phase finite impulse response filter class.
+
+    This class is a Fir that looks at the coefficients it is given.
+    When they are symmetric (b[i] == b[N-1-i]) or antisymmetric
+    (b[i] == -b[N-1-i]), as with any linear-phase design, the two
+    input samples that share a coefficient are added (or subtracted)
+    before the multiply, so each output costs about N/2 multiplies
+    instead of N.  Other coefficient vectors run the plain Fir
+    computation.
+
+    For this, a second copy of the input history is kept in the
+    opposite time order, so the folded sum is a single vectorizable
+    loop over two contiguous arrays (see Simd.h).
+
+    A linear-phase filter delays every frequency by (N-1)/2 samples.
+    setMinimumPhase() replaces the coefficients with the minimum-phase
+    filter of the same length and magnitude response, found with the
+    real cepstrum, which moves most of the energy to the first taps
+    and cuts the delay to a few samples at the cost of a nonlinear
+    phase.  This is meant for live monitoring, where latency matters
+    more than waveform shape.  A minimum-phase filter is not symmetric
+    and runs at the plain Fir cost.
+*/
+/***************************************************/
+
+class SymmetricFir : public Fir
+{
+public:
+  //! Coefficient symmetry found by setCoefficients().
+  enum Symmetry {
+    NONE,
+    SYMMETRIC,
+    ANTISYMMETRIC
+  };
+
+  //! Default constructor creates a zero-order pass-through "filter".
+  SymmetricFir( void );
+
+  //! Overloaded constructor which takes filter coefficients.
+  /*!
+    An StkError can be thrown if the coefficient vector size is
+    zero.
+  */
+  SymmetricFir( std::vector<StkFloat> &coefficients, bool minimumPhase = false );
+
+  //! Class destructor.
+  ~SymmetricFir( void );
+
+  //! Clears the input history.
+  void clear( void );
+
+  //! Set filter coefficients and detect their symmetry.
+  /*!
+    An StkError can be thrown if the coefficient vector size is
+    zero.  The internal state of the filter is not cleared unless the
+    \e clearState flag is \c true.  With minimum phase selected, the
+    coefficients are converted before use.
+  */
+  void setCoefficients( std::vector<StkFloat> &coefficients, bool clearState = false );
+
+  //! Use the minimum-phase version of the coefficients, or go back to the original ones.
+  void setMinimumPhase( bool state );
+
+  //! Return the symmetry of the coefficients in use.
+  Symmetry getSymmetry( void ) const { return symmetry_; };
+
+  //! Return the minimum-phase filter with the magnitude response of \e coefficients.
+  static std::vector<StkFloat> minimumPhase( const std::vector<StkFloat> &coefficients );
+
+  //! Input one sample to the filter and return one output.
+  StkFloat tick( StkFloat input );
+
+  //! Take a channel of the StkFrames object as inputs to the filter and replace with corresponding outputs.
+  /*!
+    The StkFrames argument reference is returned.  The \c channel
+    argument must be less than the number of channels in the
+    StkFrames argument (the first channel is specified by 0).
+    However, range checking is only performed if _STK_DEBUG_ is
+    defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
+
+  //! Take a channel of the \c iFrames object as inputs to the filter and write outputs to the \c oFrames object.
+  /*!
+    The \c iFrames object reference is returned.  Each channel
+    argument must be less than the number of channels in the
+    corresponding StkFrames argument (the first channel is specified
+    by 0).  However, range checking is only performed if _STK_DEBUG_
+    is defined during compilation, in which case an out-of-range value
+    will trigger an StkError exception.
+  */
+  StkFrames& tick( StkFrames& iFrames, StkFrames &oFrames, unsigned int iChannel = 0, unsigned int oChannel = 0 );
+
+protected:
+
+  StkFloat computeSample( StkFloat input );
+  void fold( void );
+
+  Symmetry symmetry_;
+  bool minimumPhase_;
+  std::vector<StkFloat> prototype_;   // coefficients as given
+  std::vector<StkFloat> folded_;      // b_[0] ... b_[N/2 - 1]
+  StkFloat middle_;                   // b_[N/2] of an odd length, else 0
+  StkFloat sign_;                     // -1 for antisymmetric
+
+  // Time reversed history, newest input at reversed_[rIndex_] and reversed_[rIndex_ + N].
+  StkFrames reversed_;
+  unsigned int rIndex_;
+};
+
+inline StkFloat SymmetricFir :: computeSample( StkFloat input )
+{
+  if ( symmetry_ == NONE ) return Fir::computeSample( input );
+
+  unsigned int order = (unsigned int) b_.size();
+  StkFloat x = gain_ * input;
+
+  index_ = ( index_ == 0 ) ? order - 1 : index_ - 1;
+  inputs_[index_] = inputs_[index_ + order] = x;
+  rIndex_ = ( rIndex_ == order - 1 ) ? 0 : rIndex_ + 1;
+  reversed_[rIndex_] = reversed_[rIndex_ + order] = sign_ * x;
+
+  // x[n-k] pairs with x[n-(N-1-k)]
+  const StkFloat *newest = &inputs_[index_];
+  const StkFloat *oldest = &reversed_[rIndex_ + 1];
+  unsigned int half = order / 2;
+  return foldedDotProduct( &folded_[0], newest, oldest, half ) + middle_ * newest[half];
+}
+
+inline StkFloat SymmetricFir :: tick( StkFloat input )
+{
+  lastFrame_[0] = computeSample( input );
+  return lastFrame_[0];
+}
+
+inline StkFrames& SymmetricFir :: tick( StkFrames& frames, unsigned int channel )
+{
+#if defined(_STK_DEBUG_)
+  if ( channel >= frames.channels() ) {
+    oStream_ << "SymmetricFir::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *samples = &frames[channel];
+  unsigned int hop = frames.channels();
+  for ( unsigned int j=0; j<frames.frames(); j++, samples += hop )
+    *samples = computeSample( *samples );
+
+  lastFrame_[0] = *(samples-hop);
+  return frames;
+}
+
+inline StkFrames& SymmetricFir :: tick( StkFrames& iFrames, StkFrames& oFrames, unsigned int iChannel, unsigned int oChannel )
+{
+#if defined(_STK_DEBUG_)
+  if ( iChannel >= iFrames.channels() || oChannel >= oFrames.channels() ) {
+    oStream_ << "SymmetricFir::tick(): channel and StkFrames arguments are incompatible!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+#endif
+
+  StkFloat *iSamples = &iFrames[iChannel];
+  StkFloat *oSamples = &oFrames[oChannel];
+  unsigned int iHop = iFrames.channels(), oHop = oFrames.channels();
+  for ( unsigned int j=0; j<iFrames.frames(); j++, iSamples += iHop, oSamples += oHop )
+    *oSamples = computeSample( *iSamples );
+
+  lastFrame_[0] = *(oSamples-oHop);
+  return iFrames;
+}
+
+} // stk namespace
+
+#endif
@@ -63,6 +63,16 @@ class Thread : public Stk
   */
   bool start( THREAD_FUNCTION routine, void * ptr = NULL );
 
+  //! Begin execution of the thread \e routine as a realtime thread.
+  /*!
+    Before \e routine runs, the new thread calls
+    Realtime::setupThread() with \e priority (SCHED_FIFO, 1--99) and
+    \e cpu (-1 leaves the affinity alone).  If the system refuses the
+    priority or affinity a warning is printed and the routine still
+    runs, at normal priority.  The return value is as for start().
+  */
+  bool start( THREAD_FUNCTION routine, void * ptr, int priority, int cpu = -1 );
+
   //! Signal cancellation of a thread routine, returning \e true on success.
   /*!
     This function only signals thread cancellation.  It does not
@@ -89,7 +99,13 @@ class Thread : public Stk
 
  protected:
 
+  static THREAD_RETURN THREAD_TYPE realtimeStart( void *ptr );
+
   THREAD_HANDLE thread_;
+  THREAD_FUNCTION routine_;
+  void *ptr_;
+  int priority_;
+  int cpu_;
 
 };
 
@@ -4,6 +4,13 @@
 #include "Instrmnt.h"
 #include <vector>
 
+#if defined(__STK_REALTIME__)
+
+#include "Mutex.h"
+#include "Thread.h"
+
+#endif // __STK_REALTIME__
+
 namespace stk {
 
 /***************************************************/
@@ -27,6 +34,26 @@ namespace stk {
     Alternately, control changes can be sent to all voices in a given
     group.
 
+    Voices are allocated in constant time.  Each group keeps a list of
+    its free voices and a list of its sounding voices in the order
+    they were started, and the sounding voices are indexed by note
+    number and every voice by its tag, so noteOn(), noteOff() and the
+    functions that take a tag do not search the voices.  When all the
+    voices of a group are sounding, noteOn() interrupts the one chosen
+    by the stealing policy (see setStealPolicy()).  The voice manager
+    takes no locks: its functions must be called from the thread that
+    calls tick(), between ticks.
+
+    The StkFrames tick() function renders each voice a block at a
+    time with Instrmnt::process() and adds the voices with vector
+    instructions.  After setThreads(), the sounding voices are split
+    between the calling thread and a pool of worker threads, each of
+    which mixes its own share.  On one thread the samples are the same
+    as those of the single-sample tick().  With more threads the
+    shares are added in a different order, which can change the last
+    bits, and instruments that use Noise share the rand() state, so
+    their noise depends on the thread timing.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2017.
 */
 /***************************************************/
@@ -34,9 +61,19 @@ namespace stk {
 class Voicer : public Stk
 {
  public:
+  //! The voice that noteOn() interrupts when all the voices of a group are sounding.
+  enum StealPolicy {
+    STEAL_OLDEST,    /*!< The voice started longest ago (the default). */
+    STEAL_QUIETEST,  /*!< The voice with the lowest recent output level. */
+    STEAL_SAME_NOTE  /*!< A voice playing the same note number, else the oldest. */
+  };
+
   //! Class constructor taking an optional note decay time (in seconds).
   Voicer( StkFloat decayTime = 0.2 );
 
+  //! Class destructor, which stops any worker threads.
+  ~Voicer( void );
+
   //! Add an instrument with an optional group number to the voice manager.
   /*!
     A set of instruments can be grouped by group number and
@@ -54,9 +91,9 @@ class Voicer : public Stk
 
   //! Initiate a noteOn event with the given note number and amplitude and return a unique note tag.
   /*!
-    Send the noteOn message to the first available unused voice.
-    If all voices are sounding, the oldest voice is interrupted and
-    sent the noteOn message.  If the optional group argument is
+    Send the noteOn message to an unused voice.  If all voices are
+    sounding, the voice chosen by the stealing policy is interrupted
+    and sent the noteOn message.  If the optional group argument is
     non-zero, only voices in that group are used.  If no voices are
     found for a specified non-zero group value, the function returns
     -1.  The amplitude value should be in the range 0.0 - 128.0.
@@ -102,6 +139,34 @@ class Voicer : public Stk
   //! Send a noteOff message to all existing voices.
   void silence( void );
 
+  //! Set the policy that chooses the voice noteOn() interrupts when all the voices of a group are sounding.
+  /*!
+    The oldest and same-note policies take constant time.  The
+    quietest policy compares the levels of all the voices in the
+    group, which are only followed while it is in use.  A subclass can
+    implement another policy by overriding stealVoice().
+  */
+  void setStealPolicy( StealPolicy policy ) { stealPolicy_ = policy; };
+
+  //! Return the current voice stealing policy.
+  StealPolicy getStealPolicy( void ) const { return stealPolicy_; };
+
+  //! Render the voices on \e nThreads threads, the calling thread included.
+  /*!
+    The StkFrames tick() function then splits the sounding voices
+    between the calling thread and \e nThreads - 1 worker threads.  If
+    \e priority is greater than zero, the workers are started as
+    realtime threads with that priority (see Thread::start()).  Worker
+    threads need STK to be compiled with realtime support; without it
+    a warning is issued and all voices are rendered on the calling
+    thread.  The single-sample tick() always renders on the calling
+    thread.
+  */
+  void setThreads( unsigned int nThreads, int priority = 0 );
+
+  //! Return the number of threads that render the voices.
+  unsigned int getThreads( void ) const { return threads_; };
+
   //! Return the current number of output channels.
   unsigned int channelsOut( void ) const { return lastFrame_.channels(); };
 
@@ -132,17 +197,23 @@ class Voicer : public Stk
 
   //! Fill the StkFrames argument with computed frames and return the same reference.
   /*!
-    The number of channels in the StkFrames argument must equal
-    the number of channels in the file data.  However, this is only
-    checked if _STK_DEBUG_ is defined during compilation, in which
-    case an incompatibility will trigger an StkError exception.  If no
-    file data is loaded, the function does nothing (a warning will be
-    issued if _STK_DEBUG_ is defined during compilation).
+    The frames are written to channelsOut() channels starting at \c
+    channel, which must leave enough channels in the StkFrames
+    argument.  However, this is only checked if _STK_DEBUG_ is defined
+    during compilation, in which case an incompatibility will trigger
+    an StkError exception.  The voices are rendered up to 256 frames
+    at a time, on the threads set with setThreads().
   */
   StkFrames& tick( StkFrames& frames, unsigned int channel = 0 );
 
  protected:
 
+  // Frames rendered per pass of the StkFrames tick() function.
+  static const unsigned int BLOCK_FRAMES = 256;
+
+  // Fewest sounding voices given to each thread.
+  static const unsigned int THREAD_VOICES = 4;
+
   struct Voice {
     Instrmnt *instrument;
     long tag;
@@ -150,16 +221,85 @@ class Voicer : public Stk
     StkFloat frequency;
     int sounding;
     int group;
+    StkFloat level;           // decaying peak output, for STEAL_QUIETEST
+    unsigned int slot;        // index of the group in groups_
+    int prev, next;           // free or sounding list of the group
+    int notePrev, noteNext;   // noteIndex_ chain, sounding voices only
+    int tagPrev, tagNext;     // tagIndex_ chain, voices that have a tag
 
     // Default constructor.
     Voice()
-      :instrument(0), tag(0), noteNumber(-1.0), frequency(0.0), sounding(0), group(0) {}
+      :instrument(0), tag(0), noteNumber(-1.0), frequency(0.0), sounding(0), group(0), level(0.0),
+       slot(0), prev(-1), next(-1), notePrev(-1), noteNext(-1), tagPrev(-1), tagNext(-1) {}
   };
 
+  struct Group {
+    int group;
+    int free;             // first free voice, singly linked by next
+    int oldest, newest;   // sounding voices in noteOn() order
+  };
+
+  //! Return the voice of \e group that noteOn() should interrupt to play \e noteNumber, or -1 for none.
+  /*!
+    Called when all the voices of the group are sounding.  The
+    returned voice must be a sounding voice of the group.
+  */
+  virtual int stealVoice( int group, StkFloat noteNumber );
+
+  int findGroup( int group ) const;
+  int findTag( long tag ) const;
+  unsigned int noteBucket( StkFloat noteNumber, int group ) const;
+  unsigned int tagBucket( long tag ) const { return (unsigned long) tag & ( tagIndex_.size() - 1 ); };
+  void linkSounding( int voice );
+  void unlinkSounding( int voice );
+  void linkNote( int voice );
+  void unlinkNote( int voice );
+  void linkTag( int voice );
+  void unlinkTag( int voice );
+  void releaseVoice( int voice, StkFloat amplitude );
+  void freeVoice( int voice );
+  void rebuildIndex( void );
+  void resizeBuffers( void );
+  void followLevel( Voice& voice, StkFloat sample );
+
+  // Mix nFrames frames of all sounding voices into the start of mix_.
+  void render( unsigned int nFrames );
+
+  // Mix active_[first] to active_[last-1] into share number \e thread of mix_.
+  void renderVoices( unsigned int first, unsigned int last, unsigned int nFrames, unsigned int thread );
+
   std::vector<Voice> voices_;
+  std::vector<Group> groups_;
+  std::vector<int> noteIndex_;  // chain heads, a power of two in size
+  std::vector<int> tagIndex_;
+  std::vector<unsigned int> active_;  // voices rendered by render()
+  StkFrames mix_;               // BLOCK_FRAMES frames per thread
+  StkFrames voiceFrames_;       // BLOCK_FRAMES frames per thread
   long tags_;
   int muteTime_;
+  StkFloat levelDecay_;
+  StealPolicy stealPolicy_;
+  unsigned int threads_;
   StkFrames lastFrame_;
+
+#if defined(__STK_REALTIME__)
+
+  struct Worker {
+    Voicer *voicer;
+    unsigned int thread;
+    unsigned int first, last, nFrames;
+    bool busy;                  // a share is waiting or being rendered
+    bool quit;
+    Mutex mutex;
+    Thread handle;
+  };
+
+  static THREAD_RETURN THREAD_TYPE workerThread( void *ptr );
+  void stopWorkers( void );
+
+  std::vector<Worker *> workers_;
+
+#endif // __STK_REALTIME__
 };
 
 inline StkFloat Voicer :: lastOut( unsigned int channel )
@@ -175,6 +315,20 @@ inline StkFloat Voicer :: lastOut( unsigned int channel )
 }
 
 
+inline unsigned int Voicer :: noteBucket( StkFloat noteNumber, int group ) const
+{
+  // Note numbers are mostly whole, or whole fractions of a semitone.
+  long key = (long) ( noteNumber * 64.0 ) + 1031 * group;
+  return (unsigned long) key & ( noteIndex_.size() - 1 );
+}
+
+inline void Voicer :: followLevel( Voice& voice, StkFloat sample )
+{
+  if ( sample < 0.0 ) sample = -sample;
+  voice.level *= levelDecay_;
+  if ( sample > voice.level ) voice.level = sample;
+}
+
 inline StkFloat Voicer :: tick( unsigned int channel )
 {
   unsigned int j;
@@ -183,11 +337,11 @@ inline StkFloat Voicer :: tick( unsigned int channel )
     if ( voices_[i].sounding != 0 ) {
       voices_[i].instrument->tick();
       for ( j=0; j<voices_[i].instrument->channelsOut(); j++ ) lastFrame_[j] += voices_[i].instrument->lastOut( j );
+      if ( stealPolicy_ == STEAL_QUIETEST )
+        followLevel( voices_[i], voices_[i].instrument->lastOut() );
+      if ( voices_[i].sounding < 0 && ++voices_[i].sounding == 0 )
+        freeVoice( i );
     }
-    if ( voices_[i].sounding < 0 )
-      voices_[i].sounding++;
-    if ( voices_[i].sounding == 0 )
-      voices_[i].noteNumber = -1;
   }
 
   return lastFrame_[channel];
@@ -204,11 +358,16 @@ inline StkFrames& Voicer :: tick( StkFrames& frames, unsigned int channel )
 #endif
 
   StkFloat *samples = &frames[channel];
-  unsigned int j, hop = frames.channels() - nChannels;
-  for ( unsigned int i=0; i<frames.frames(); i++, samples += hop ) {
-    tick();
-    for ( j=0; j<nChannels; j++ )
-      *samples++ = lastFrame_[j];
+  unsigned int i, j, n, hop = frames.channels() - nChannels;
+  for ( unsigned int start=0; start<frames.frames(); start+=n ) {
+    n = frames.frames() - start;
+    if ( n > BLOCK_FRAMES ) n = BLOCK_FRAMES;
+    render( n );
+
+    StkFloat *mix = &mix_[0];
+    for ( i=0; i<n; i++, samples += hop )
+      for ( j=0; j<nChannels; j++ )
+        *samples++ = *mix++;
   }
 
   return frames;
@@ -0,0 +1,80 @@
+#ifndef STK_WAVECACHE_H
+#define STK_WAVECACHE_H
+
+#include "Stk.h"
+
+namespace stk {
+
+/***************************************************/
+/*! \class WaveCache
+    \brief STK process-wide cache of audio file data.
+
+    This class holds the decoded data of audio files, such as the
+    rawwaves used by the instruments, so that any number of FileWvIn
+    and FileLoop objects can play a file from a single copy in memory.
+    A file is read when it is first acquired and its data is freed
+    when the last reference to it is released.
+
+    FileWvIn::openShared() and FileLoop::openShared() acquire a file
+    by name and play the cached data without copying it.  An
+    instrument can also acquire its waves when it is constructed and
+    pass them to openShared() later, which then neither reads a file
+    nor allocates memory.
+
+    A file is cached separately for each combination of the raw,
+    normalize and integer scaling flags it is read with.  The data of
+    a file of N frames holds N + 1 frames, the last a copy of the
+    first, so that the same data can be looped or played once.  The
+    cached data is read-only.
+
+    In a realtime build the cache is guarded by a mutex, so objects
+    on different threads can share it.  The mutex is not held while a
+    file is read.
+*/
+/***************************************************/
+
+class WaveCache : public Stk
+{
+ public:
+
+  //! The data of one cached file.
+  class Wave
+  {
+  public:
+    //! Return the file data, followed by a copy of its first frame.
+    const StkFrames& data( void ) const { return data_; };
+
+    //! Return the file size in sample frames.
+    unsigned long fileSize( void ) const { return fileSize_; };
+
+  private:
+    friend class WaveCache;
+    StkFrames data_;
+    unsigned long fileSize_;
+    mutable unsigned int references_;
+    std::string key_;
+  };
+
+  //! Return the data of a file and add a reference to it, reading the file if it is not cached.
+  /*!
+    The \e raw, \e doNormalize and \e doInt2FloatScaling flags have
+    the same meaning as for FileWvIn::openFile().  An StkError will be
+    thrown if the file is not found, its format is unknown, or a read
+    error occurs.  Each call must be matched by a call to release().
+  */
+  static const Wave *acquire( std::string fileName, bool raw = false, bool doNormalize = true,
+                              bool doInt2FloatScaling = true );
+
+  //! Add a reference to a wave that is already held.
+  static void retain( const Wave *wave );
+
+  //! Remove a reference to a wave, which is freed with its last reference.
+  static void release( const Wave *wave );
+
+  //! Return the number of waves in the cache.
+  static unsigned int size( void );
+};
+
+} // stk namespace
+
+#endif
@@ -107,6 +107,10 @@ SOURCE=..\..\src\BiQuad.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\BiQuadBank.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\BlowBotl.cpp
 # End Source File
 # Begin Source File
@@ -375,6 +379,10 @@ SOURCE=..\..\src\FileLoop.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\WaveCache.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\Whistle.cpp
 # End Source File
 # Begin Source File
@@ -407,6 +415,10 @@ SOURCE=..\..\include\BiQuad.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\BiQuadBank.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\BlowBotl.h
 # End Source File
 # Begin Source File
@@ -703,6 +715,10 @@ SOURCE=..\..\include\FileLoop.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\WaveCache.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\Whistle.h
 # End Source File
 # Begin Source File
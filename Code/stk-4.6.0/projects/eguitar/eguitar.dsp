@@ -288,6 +288,14 @@ SOURCE=..\..\include\Thread.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\WaveCache.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\include\WaveCache.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\WvIn.h
 # End Source File
 # Begin Source File
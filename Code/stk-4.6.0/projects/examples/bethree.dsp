@@ -141,6 +141,10 @@ SOURCE=..\..\src\TwoZero.cpp
 
 SOURCE=..\..\src\FileLoop.cpp
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\src\WaveCache.cpp
+# End Source File
 # End Group
 # Begin Group "Header Files"
 
@@ -207,6 +211,10 @@ SOURCE=..\..\include\FileLoop.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\WaveCache.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\WvIn.h
 # End Source File
 # Begin Source File
@@ -166,6 +166,10 @@ SOURCE=..\..\src\TwoZero.cpp
 
 SOURCE=..\..\src\FileLoop.cpp
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\src\WaveCache.cpp
+# End Source File
 # End Group
 # Begin Group "Header Files"
 
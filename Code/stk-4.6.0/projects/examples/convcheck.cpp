@@ -0,0 +1,103 @@
+/******************************************/
+/*
+  Check for the ConvolutionFir call shapes.
+
+  Convolves noise with a 3000-tap response
+  in 64-frame periods, as MySynth does, and
+  again with each period split 40 + 24 (as
+  when the mmap ring wraps), with a mix of
+  whole and split periods, a sample at a
+  time, and in 100 and 128-frame calls.
+  Prints the largest difference of each
+  from the whole-period render and from a
+  direct convolution, and fails if any is
+  above the rounding tolerance: 1e-10 in a
+  double build and 1e-4 in a float build.
+
+  usage: convcheck
+*/
+/******************************************/
+
+#include "ConvolutionFir.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace stk;
+
+const unsigned int PERIOD = 64;
+const unsigned int TAPS = 3000;
+const unsigned int FRAMES = 200 * PERIOD;
+
+// Run input through a new convolver in calls of the given sizes, repeated.
+static void render( std::vector<StkFloat> &response, const StkFrames &input, StkFrames &output,
+                    const unsigned int *sizes, unsigned int nSizes )
+{
+  ConvolutionFir conv( response, PERIOD );
+  unsigned int i = 0, s = 0;
+  while ( i < FRAMES ) {
+    unsigned int n = sizes[s++ % nSizes];
+    if ( n > FRAMES - i ) n = FRAMES - i;
+    if ( n == 1 ) {
+      output[i] = conv.tick( input[i] );
+    }
+    else {
+      StkFrames block( n, 1 );
+      for ( unsigned int j=0; j<n; j++ ) block[j] = input[i+j];
+      conv.tick( block );
+      for ( unsigned int j=0; j<n; j++ ) output[i+j] = block[j];
+    }
+    i += n;
+  }
+}
+
+static StkFloat maxDifference( const StkFrames &a, const StkFrames &b )
+{
+  StkFloat diff = 0.0;
+  for ( unsigned int i=0; i<FRAMES; i++ )
+    if ( std::fabs( a[i] - b[i] ) > diff ) diff = std::fabs( a[i] - b[i] );
+  return diff;
+}
+
+int main( void )
+{
+  const StkFloat tolerance = ( sizeof( StkFloat ) == 4 ) ? 1e-4 : 1e-10;
+
+  srand( 1 );
+  std::vector<StkFloat> response( TAPS );
+  for ( unsigned int i=0; i<TAPS; i++ )
+    response[i] = ( 2.0 * rand() / RAND_MAX - 1.0 ) * exp( -4.0 * i / TAPS ) * 0.05;
+
+  StkFrames input( FRAMES, 1 ), direct( FRAMES, 1 ), whole( FRAMES, 1 ), output( FRAMES, 1 );
+  for ( unsigned int i=0; i<FRAMES; i++ )
+    input[i] = 2.0 * rand() / RAND_MAX - 1.0;
+
+  for ( unsigned int i=0; i<FRAMES; i++ ) {
+    double sum = 0.0;
+    for ( unsigned int k=0; k<TAPS && k<=i; k++ )
+      sum += (double) response[k] * input[i-k];
+    direct[i] = (StkFloat) sum;
+  }
+
+  const unsigned int periods[] = { PERIOD };
+  render( response, input, whole, periods, 1 );
+  StkFloat diff = maxDifference( whole, direct );
+  printf( "%-20s %11s %11s\n", "calls", "vs periods", "vs direct" );
+  printf( "%-20s %11s %11.3g\n", "64", "", diff );
+  bool failed = diff > tolerance;
+
+  const char *names[] = { "40 + 24", "64, 40 + 24", "1", "100", "128" };
+  const unsigned int split[] = { 40, 24 }, mixed[] = { 64, 40, 24 }, single[] = { 1 };
+  const unsigned int odd[] = { 100 }, pairs[] = { 2 * PERIOD };
+  const unsigned int *sizes[] = { split, mixed, single, odd, pairs };
+  const unsigned int nSizes[] = { 2, 3, 1, 1, 1 };
+  for ( unsigned int t=0; t<5; t++ ) {
+    render( response, input, output, sizes[t], nSizes[t] );
+    StkFloat periodDiff = maxDifference( output, whole ), directDiff = maxDifference( output, direct );
+    printf( "%-20s %11.3g %11.3g\n", names[t], periodDiff, directDiff );
+    if ( periodDiff > tolerance || directDiff > tolerance ) failed = true;
+  }
+
+  printf( "%s: tolerance %g\n", failed ? "FAILED" : "ok", tolerance );
+  return failed ? 1 : 0;
+}
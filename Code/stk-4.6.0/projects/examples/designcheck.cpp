@@ -0,0 +1,82 @@
+/******************************************/
+/*
+  Check for the FirDesign stopbands.
+
+  Designs lowpass, highpass, bandpass and
+  bandstop filters with windowedSinc() and
+  equiripple(), evaluates each response on
+  a fine grid over its stopbands, and
+  prints the attenuation reached and the
+  attenuation asked for.  Fails if any
+  design falls short.
+
+  usage: designcheck
+*/
+/******************************************/
+
+#include "FirDesign.h"
+#include <cmath>
+#include <cstdio>
+
+using namespace stk;
+
+const StkFloat RATE = 44100.0;
+const unsigned int GRID = 50000;
+
+struct Spec {
+  FirDesign::Type type;
+  StkFloat f1;
+  StkFloat f2;
+  StkFloat transition;
+  StkFloat attenuation;
+};
+
+const Spec specs[] = {
+  { FirDesign::LOWPASS, 4000, 0, 1000, 40 }, { FirDesign::HIGHPASS, 4000, 0, 500, 80 },
+  { FirDesign::BANDPASS, 2000, 4000, 1000, 40 }, { FirDesign::BANDPASS, 300, 3400, 200, 60 },
+  { FirDesign::BANDPASS, 1000, 1500, 300, 80 }, { FirDesign::BANDSTOP, 2000, 6000, 1000, 40 },
+  { FirDesign::BANDSTOP, 500, 2500, 400, 70 } };
+
+const char *typeNames[] = { "lowpass", "highpass", "bandpass", "bandstop" };
+
+static bool inStopband( const Spec &spec, StkFloat f )
+{
+  switch ( spec.type ) {
+  case FirDesign::LOWPASS: return f >= spec.f1 + spec.transition;
+  case FirDesign::HIGHPASS: return f <= spec.f1 - spec.transition;
+  case FirDesign::BANDPASS: return f <= spec.f1 - spec.transition || f >= spec.f2 + spec.transition;
+  default: return f >= spec.f1 + spec.transition && f <= spec.f2 - spec.transition;
+  }
+}
+
+// The attenuation in dB at the loudest point of the stopbands.
+static double attenuation( const Spec &spec, const std::vector<StkFloat> &h )
+{
+  double largest = 0.0;
+  for ( unsigned int i=0; i<=GRID; i++ ) {
+    double f = 0.5 * RATE * i / GRID;
+    if ( !inStopband( spec, f ) ) continue;
+    double a = 0.0;
+    for ( unsigned int n=0; n<h.size(); n++ )
+      a += h[n] * cos( TWO_PI * f / RATE * ( (int) n - (int) h.size() / 2 ) );
+    if ( std::fabs( a ) > largest ) largest = std::fabs( a );
+  }
+  return -20.0 * log10( largest );
+}
+
+int main( void )
+{
+  bool failed = false;
+  printf( "%-9s %6s %6s %6s %7s %13s %13s\n", "", "f1", "f2", "trans", "asked", "windowedSinc", "equiripple" );
+  for ( unsigned int i=0; i<sizeof( specs ) / sizeof( specs[0] ); i++ ) {
+    const Spec &s = specs[i];
+    double sinc = attenuation( s, FirDesign::windowedSinc( s.type, s.f1, s.f2, s.transition, s.attenuation, RATE ) );
+    double remez = attenuation( s, FirDesign::equiripple( s.type, s.f1, s.f2, s.transition, s.attenuation, 0.1, RATE ) );
+    bool passed = sinc >= s.attenuation && remez >= s.attenuation;
+    printf( "%-9s %6g %6g %6g %7g %13.2f %13.2f  %s\n", typeNames[s.type], s.f1, s.f2, s.transition,
+            s.attenuation, sinc, remez, passed ? "ok" : "FAILED" );
+    if ( !passed ) failed = true;
+  }
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+/******************************************/
+/*
+  Benchmark for the Fir block tick.
+
+  Times Fir::tick(StkFrames&) against the
+  original shift-register loop for 31, 81,
+  255 and 1023 taps and prints ns/sample and
+  the largest difference between the two
+  outputs.
+
+  usage: firbench [seconds]
+*/
+/******************************************/
+
+#include "Fir.h"
+#include "Noise.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace stk;
+
+// The Fir::tick(StkFrames&) loop as it was before the circular history.
+static void shiftTick( std::vector<StkFloat> &b, std::vector<StkFloat> &inputs, StkFrames &frames )
+{
+  StkFloat *samples = &frames[0];
+  unsigned int i;
+  for ( unsigned int j=0; j<frames.frames(); j++, samples++ ) {
+    inputs[0] = *samples;
+    *samples = 0.0;
+
+    for ( i=(unsigned int)b.size()-1; i>0; i-- ) {
+      *samples += b[i] * inputs[i];
+      inputs[i] = inputs[i-1];
+    }
+    *samples += b[0] * inputs[0];
+  }
+}
+
+static double nsPerSample( std::chrono::steady_clock::duration elapsed, unsigned long samples )
+{
+  return std::chrono::duration<double, std::nano>( elapsed ).count() / samples;
+}
+
+int main( int argc, char *argv[] )
+{
+  const unsigned int taps[] = { 31, 81, 255, 1023 };
+  const unsigned int blockSize = 1024;
+  double seconds = ( argc > 1 ) ? atof( argv[1] ) : 2.0;
+  unsigned long blocks = (unsigned long) ( seconds * Stk::sampleRate() / blockSize ) + 1;
+
+  Noise noise( 1234 );
+  StkFrames input( blockSize, 1 ), reference( blockSize, 1 ), output( blockSize, 1 );
+
+  printf( "%6s %14s %14s %8s %12s\n", "taps", "shift ns/smp", "fir ns/smp", "speedup", "max |diff|" );
+
+  for ( unsigned int t=0; t<sizeof(taps)/sizeof(taps[0]); t++ ) {
+    // A windowed-sinc lowpass, so the outputs stay in a sane range.
+    std::vector<StkFloat> b( taps[t] );
+    for ( unsigned int i=0; i<taps[t]; i++ ) {
+      StkFloat x = i - 0.5 * ( taps[t] - 1 );
+      StkFloat sinc = ( x == 0.0 ) ? 0.25 : sin( 0.25 * PI * x ) / ( PI * x );
+      b[i] = sinc * ( 0.54 - 0.46 * cos( TWO_PI * i / ( taps[t] - 1 ) ) );
+    }
+
+    Fir fir( b );
+    std::vector<StkFloat> history( taps[t], 0.0 );
+    std::chrono::steady_clock::duration shiftTime( 0 ), firTime( 0 );
+    StkFloat maxDiff = 0.0;
+
+    for ( unsigned long n=0; n<blocks; n++ ) {
+      noise.tick( input );
+      reference = input;
+      output = input;
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      shiftTick( b, history, reference );
+      std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+      fir.tick( output );
+      std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+      shiftTime += middle - start;
+      firTime += end - middle;
+
+      for ( unsigned int i=0; i<blockSize; i++ )
+        if ( std::fabs( output[i] - reference[i] ) > maxDiff )
+          maxDiff = std::fabs( output[i] - reference[i] );
+    }
+
+    double shiftNs = nsPerSample( shiftTime, blocks * blockSize );
+    double firNs = nsPerSample( firTime, blocks * blockSize );
+    printf( "%6u %14.2f %14.2f %7.2fx %12.3g\n", taps[t], shiftNs, firNs, shiftNs / firNs, maxDiff );
+  }
+
+  return 0;
+}
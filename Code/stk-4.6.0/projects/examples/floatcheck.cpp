@@ -0,0 +1,282 @@
+/******************************************/
+/*
+  Accuracy check for the float StkFloat build.
+
+  Renders a note on every instrument and a
+  test signal through every effect.  Run in
+  a double build with -w, it writes the
+  renders to a file; run in a float build
+  (configure --enable-float) with that file,
+  it prints the largest and the RMS error of
+  each render relative to the double one, in
+  dB, and fails if either is above the limit
+  for that instrument or effect.
+
+  Each limit is the error measured when
+  this check was written, rounded up by
+  about 5 dB, so a change that loses
+  precision in the float build fails it.
+  rand() is seeded before every render, so
+  both builds draw the same noise.
+
+  Whistle bounces a pea around its can,
+  and the bounces are chaotic: a change of
+  one part in 10^12 in double precision
+  gives a different pea path after about
+  0.2 seconds.  Only its first 0.1 seconds
+  are compared.
+
+  usage: floatcheck -w file  (double build)
+         floatcheck file     (float build)
+*/
+/******************************************/
+
+#include "Clarinet.h"
+#include "BlowHole.h"
+#include "Saxofony.h"
+#include "Flute.h"
+#include "Brass.h"
+#include "BlowBotl.h"
+#include "Bowed.h"
+#include "Plucked.h"
+#include "StifKarp.h"
+#include "Sitar.h"
+#include "Mandolin.h"
+#include "Rhodey.h"
+#include "Wurley.h"
+#include "TubeBell.h"
+#include "HevyMetl.h"
+#include "PercFlut.h"
+#include "BeeThree.h"
+#include "FMVoices.h"
+#include "VoicForm.h"
+#include "Moog.h"
+#include "Simple.h"
+#include "Drummer.h"
+#include "BandedWG.h"
+#include "Shakers.h"
+#include "ModalBar.h"
+#include "Mesh2D.h"
+#include "Resonate.h"
+#include "Whistle.h"
+#include "Echo.h"
+#include "Chorus.h"
+#include "PitShift.h"
+#include "LentPitShift.h"
+#include "JCRev.h"
+#include "NRev.h"
+#include "PRCRev.h"
+#include "FreeVerb.h"
+#include "ConvolutionFir.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace stk;
+
+const unsigned long FRAMES = 44100;
+const unsigned int BLOCK_SIZE = 256;
+
+// The largest and RMS errors allowed, in dB relative to the peak and
+// RMS of the double render, over its first frames (all when 0).
+struct Render {
+  const char *name;
+  double maxLimit;
+  double rmsLimit;
+  unsigned long frames;
+};
+
+const Render instruments[] = {
+  { "Clarinet", -40, -60 }, { "BlowHole", -55, -65 }, { "Saxofony", -40, -55 },
+  { "Flute", -40, -55 }, { "Brass", -70, -80 }, { "BlowBotl", -50, -50 },
+  { "Bowed", -50, -55 }, { "Plucked", -65, -65 }, { "StifKarp", -65, -55 },
+  { "Sitar", -55, -50 }, { "Mandolin", -65, -60 }, { "Rhodey", -55, -55 },
+  // Wurley's fixed 510 Hz operator is phase modulated by its own output
+  // through a differentiating TwoZero.  While its wave is not silent the
+  // loop amplifies a rounding error by about 10^6 (a gain change of one
+  // part in 10^7 moves a double render by -40 dB), so float errors show
+  // as short bursts.  They do not build up: the error dies away in each
+  // silent part of the wave.
+  { "Wurley", -15, -40 }, { "TubeBell", -60, -65 }, { "HevyMetl", -65, -75 },
+  { "PercFlut", -75, -80 }, { "BeeThree", -80, -85 }, { "FMVoices", -85, -100 },
+  { "VoicForm", -65, -70 }, { "Moog", -55, -55 }, { "Simple", -50, -65 },
+  { "Drummer", -120, -130 }, { "BandedWG", -55, -45 }, { "Shakers", -100, -95 },
+  { "ModalBar", -75, -60 }, { "Mesh2D", -120, -115 }, { "Resonate", -95, -105 },
+  { "Whistle", -70, -70, 4410 } };
+
+const Render effects[] = {
+  { "Echo", -85, -85 }, { "Chorus", -70, -75 }, { "PitShift", -60, -70 },
+  { "LentPitShift", -65, -75 }, { "JCRev", -85, -85 }, { "NRev", -80, -85 },
+  { "PRCRev", -85, -85 }, { "FreeVerb", -115, -115 }, { "ConvolutionFir", -85, -85 } };
+
+const unsigned int nInstruments = sizeof( instruments ) / sizeof( instruments[0] );
+const unsigned int nEffects = sizeof( effects ) / sizeof( effects[0] );
+
+static Instrmnt *makeInstrument( unsigned int i )
+{
+  switch ( i ) {
+  case 0: return new Clarinet( 10.0 );
+  case 1: return new BlowHole( 10.0 );
+  case 2: return new Saxofony( 10.0 );
+  case 3: return new Flute( 10.0 );
+  case 4: return new Brass( 10.0 );
+  case 5: return new BlowBotl();
+  case 6: return new Bowed( 10.0 );
+  case 7: return new Plucked( 10.0 );
+  case 8: return new StifKarp( 10.0 );
+  case 9: return new Sitar( 10.0 );
+  case 10: return new Mandolin( 10.0 );
+  case 11: return new Rhodey();
+  case 12: return new Wurley();
+  case 13: return new TubeBell();
+  case 14: return new HevyMetl();
+  case 15: return new PercFlut();
+  case 16: return new BeeThree();
+  case 17: return new FMVoices();
+  case 18: return new VoicForm();
+  case 19: return new Moog();
+  case 20: return new Simple();
+  case 21: return new Drummer();
+  case 22: return new BandedWG();
+  case 23: return new Shakers();
+  case 24: return new ModalBar();
+  case 25: return new Mesh2D( 10, 10 );
+  case 26: return new Resonate();
+  default: return new Whistle();
+  }
+}
+
+static Effect *makeEffect( unsigned int i )
+{
+  switch ( i ) {
+  case 0: {
+    Echo *echo = new Echo( 10000 );
+    echo->setDelay( 7919 );
+    return echo;
+  }
+  case 1: return new Chorus();
+  case 2: {
+    PitShift *shift = new PitShift();
+    shift->setShift( 1.2 );
+    return shift;
+  }
+  case 3: return new LentPitShift( 1.2 );
+  case 4: return new JCRev();
+  case 5: return new NRev();
+  case 6: return new PRCRev();
+  case 7: return new FreeVerb();
+  default: {
+    // A decaying noise response, the same in both builds.
+    std::vector<StkFloat> response( 4000 );
+    srand( 4321 );
+    for ( unsigned int j=0; j<response.size(); j++ )
+      response[j] = ( 2.0 * rand() / RAND_MAX - 1.0 ) * exp( -5.0 * j / response.size() ) * 0.05;
+    return new ConvolutionFir( response, BLOCK_SIZE );
+  }
+  }
+}
+
+// Render a note on an instrument, released three quarters of the way through.
+static void render( Instrmnt *inst, std::vector<double> &output )
+{
+  srand( 1234 );
+  inst->noteOn( 220.0, 0.8 );
+  for ( unsigned long i=0; i<FRAMES; i++ ) {
+    if ( i == FRAMES / 4 * 3 ) inst->noteOff( 0.5 );
+    output.push_back( inst->tick() );
+  }
+}
+
+// Run a burst of noise and a sine sweep through an effect, keeping every output channel.
+static void render( Effect *effect, std::vector<double> &output )
+{
+  srand( 1234 );
+  StkFrames block( BLOCK_SIZE, effect->channelsOut() );
+  double phase = 0.0;
+  for ( unsigned long i=0; i<FRAMES; i+=BLOCK_SIZE ) {
+    for ( unsigned int j=0; j<BLOCK_SIZE; j++ ) {
+      double t = (double) ( i + j ) / FRAMES;
+      phase += TWO_PI * ( 200.0 + 2000.0 * t ) / 44100.0;
+      double noise = ( t < 0.1 ) ? 2.0 * rand() / RAND_MAX - 1.0 : 0.0;
+      block( j, 0 ) = (StkFloat) ( 0.5 * noise + 0.3 * sin( phase ) * ( t < 0.5 ) );
+    }
+    effect->tick( block );
+    for ( unsigned int k=0; k<block.size(); k++ )
+      output.push_back( block[k] );
+  }
+}
+
+// Compare a render with the reference and print its errors in dB.
+static bool compare( const Render &item, const std::vector<double> &output, const std::vector<double> &reference )
+{
+  double peak = 0.0, power = 0.0, maxError = 0.0, errorPower = 0.0;
+  size_t size = ( item.frames > 0 ) ? item.frames : output.size();
+  for ( size_t i=0; i<size; i++ ) {
+    double error = std::fabs( output[i] - reference[i] );
+    if ( std::fabs( reference[i] ) > peak ) peak = std::fabs( reference[i] );
+    if ( error > maxError ) maxError = error;
+    power += reference[i] * reference[i];
+    errorPower += error * error;
+  }
+
+  // An exact match reports -999 dB.
+  double maxDb = ( maxError > 0.0 ) ? 20.0 * log10( maxError / peak ) : -999.0;
+  double rmsDb = ( errorPower > 0.0 ) ? 10.0 * log10( errorPower / power ) : -999.0;
+  bool passed = maxDb <= item.maxLimit && rmsDb <= item.rmsLimit;
+  printf( "%-15s %8.1f %8.1f %8.0f %8.0f  %s\n", item.name, maxDb, rmsDb, item.maxLimit, item.rmsLimit,
+          passed ? "ok" : "FAILED" );
+  return passed;
+}
+
+int main( int argc, char *argv[] )
+{
+  bool write = ( argc == 3 && !strcmp( argv[1], "-w" ) );
+  if ( argc != 2 && !write ) {
+    printf( "usage: floatcheck -w file  (double build)\n       floatcheck file     (float build)\n" );
+    return 1;
+  }
+
+  FILE *file = fopen( argv[argc-1], write ? "wb" : "rb" );
+  if ( !file ) {
+    printf( "floatcheck: cannot open %s\n", argv[argc-1] );
+    return 1;
+  }
+
+  Stk::showWarnings( false );
+  Stk::setRawwavePath( RAWWAVE_PATH );
+  if ( !write )
+    printf( "%-15s %8s %8s %8s %8s\n%-15s %8s %8s %8s %8s\n", "", "max", "rms", "max", "rms",
+            "", "error", "error", "limit", "limit" );
+
+  bool passed = true;
+  for ( unsigned int i=0; i<nInstruments+nEffects; i++ ) {
+    std::vector<double> output;
+    if ( i < nInstruments ) {
+      Instrmnt *inst = makeInstrument( i );
+      render( inst, output );
+      delete inst;
+    }
+    else {
+      Effect *effect = makeEffect( i - nInstruments );
+      render( effect, output );
+      delete effect;
+    }
+
+    if ( write ) {
+      fwrite( &output[0], sizeof( double ), output.size(), file );
+      continue;
+    }
+
+    std::vector<double> reference( output.size() );
+    if ( fread( &reference[0], sizeof( double ), reference.size(), file ) != reference.size() ) {
+      printf( "floatcheck: %s is not a reference file for these renders\n", argv[1] );
+      fclose( file );
+      return 1;
+    }
+    passed &= compare( ( i < nInstruments ) ? instruments[i] : effects[i-nInstruments], output, reference );
+  }
+
+  fclose( file );
+  return passed ? 0 : 1;
+}
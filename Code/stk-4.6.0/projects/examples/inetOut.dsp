@@ -103,6 +103,10 @@ SOURCE=..\..\src\InetWvOut.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\Mutex.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\Socket.cpp
 # End Source File
 # Begin Source File
@@ -117,6 +121,10 @@ SOURCE=..\..\src\TcpClient.cpp
 
 SOURCE=..\..\src\UdpSocket.cpp
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\src\WaveCache.cpp
+# End Source File
 # End Group
 # Begin Group "Header Files"
 
@@ -143,6 +151,10 @@ SOURCE=..\..\include\TcpClient.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\WaveCache.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\WvOut.h
 # End Source File
 # End Group
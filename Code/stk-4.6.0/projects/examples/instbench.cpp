@@ -0,0 +1,173 @@
+/******************************************/
+/*
+  Benchmark for the Instrmnt block process.
+
+  Renders a note on each instrument a sample
+  at a time with tick(), the way Voicer runs
+  its voices, and then a block at a time with
+  process() for 64, 256 and 1024-frame
+  blocks, and prints ns/sample, the speedup
+  over tick() and the largest difference
+  between the two outputs.  Each time is the
+  best of five runs.
+
+  usage: instbench [seconds]
+*/
+/******************************************/
+
+#include "Clarinet.h"
+#include "BlowHole.h"
+#include "Saxofony.h"
+#include "Flute.h"
+#include "Brass.h"
+#include "BlowBotl.h"
+#include "Bowed.h"
+#include "Plucked.h"
+#include "StifKarp.h"
+#include "Sitar.h"
+#include "Mandolin.h"
+#include "Rhodey.h"
+#include "Wurley.h"
+#include "TubeBell.h"
+#include "HevyMetl.h"
+#include "PercFlut.h"
+#include "BeeThree.h"
+#include "FMVoices.h"
+#include "VoicForm.h"
+#include "Moog.h"
+#include "Simple.h"
+#include "Drummer.h"
+#include "BandedWG.h"
+#include "Shakers.h"
+#include "ModalBar.h"
+#include "Mesh2D.h"
+#include "Resonate.h"
+#include "Whistle.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace stk;
+
+const char *names[] = { "Clarinet", "BlowHole", "Saxofony", "Flute", "Brass", "BlowBotl",
+                        "Bowed", "Plucked", "StifKarp", "Sitar", "Mandolin", "Rhodey",
+                        "Wurley", "TubeBell", "HevyMetl", "PercFlut", "BeeThree", "FMVoices",
+                        "VoicForm", "Moog", "Simple", "Drummer", "BandedWG", "Shakers",
+                        "ModalBar", "Mesh2D", "Resonate", "Whistle" };
+
+static Instrmnt *makeInstrument( unsigned int i )
+{
+  switch ( i ) {
+  case 0: return new Clarinet( 10.0 );
+  case 1: return new BlowHole( 10.0 );
+  case 2: return new Saxofony( 10.0 );
+  case 3: return new Flute( 10.0 );
+  case 4: return new Brass( 10.0 );
+  case 5: return new BlowBotl();
+  case 6: return new Bowed( 10.0 );
+  case 7: return new Plucked( 10.0 );
+  case 8: return new StifKarp( 10.0 );
+  case 9: return new Sitar( 10.0 );
+  case 10: return new Mandolin( 10.0 );
+  case 11: return new Rhodey();
+  case 12: return new Wurley();
+  case 13: return new TubeBell();
+  case 14: return new HevyMetl();
+  case 15: return new PercFlut();
+  case 16: return new BeeThree();
+  case 17: return new FMVoices();
+  case 18: return new VoicForm();
+  case 19: return new Moog();
+  case 20: return new Simple();
+  case 21: return new Drummer();
+  case 22: return new BandedWG();
+  case 23: return new Shakers();
+  case 24: return new ModalBar();
+  case 25: return new Mesh2D( 10, 10 );
+  case 26: return new Resonate();
+  default: return new Whistle();
+  }
+}
+
+// Start a note, stop it at frame noteOff and time blockSize frames at
+// a time, or a sample at a time with tick() if blockSize is 0.
+static std::chrono::steady_clock::duration render( Instrmnt *inst, unsigned int blockSize,
+                                                   unsigned long noteOff, StkFrames &output )
+{
+  srand( 1234 );
+  inst->noteOn( 220.0, 0.8 );
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  if ( blockSize == 0 ) {
+    for ( unsigned long i=0; i<output.frames(); i++ ) {
+      if ( i == noteOff ) inst->noteOff( 0.5 );
+      output[i] = inst->tick();
+    }
+  }
+  else {
+    for ( unsigned long i=0; i<output.frames(); i+=blockSize ) {
+      if ( i == noteOff ) inst->noteOff( 0.5 );
+      inst->process( StkFramesView( output, i, blockSize ), blockSize );
+    }
+  }
+  return std::chrono::steady_clock::now() - start;
+}
+
+static double nsPerSample( std::chrono::steady_clock::duration elapsed, unsigned long samples )
+{
+  return std::chrono::duration<double, std::nano>( elapsed ).count() / samples;
+}
+
+int main( int argc, char *argv[] )
+{
+  const unsigned int blockSizes[] = { 0, 64, 256, 1024 };
+  const unsigned int repeats = 5;
+  double seconds = ( argc > 1 ) ? atof( argv[1] ) : 2.0;
+
+  // A whole number of the largest block, with the note off on a block boundary.
+  unsigned long nFrames = ( (unsigned long) ( seconds * Stk::sampleRate() ) / 1024 + 1 ) * 1024;
+  unsigned long noteOff = nFrames / 4 * 3 / 1024 * 1024;
+
+  Stk::showWarnings( false );
+  Stk::setRawwavePath( RAWWAVE_PATH );
+  StkFrames reference( nFrames, 1 ), output( nFrames, 1 );
+
+  printf( "%-9s %10s", "", "tick" );
+  for ( unsigned int b=1; b<4; b++ )
+    printf( " %9s%-5u", "process ", blockSizes[b] );
+  printf( " %11s\n", "" );
+  printf( "%-9s %10s", "", "ns/smp" );
+  for ( unsigned int b=1; b<4; b++ )
+    printf( " %7s %6s", "ns/smp", "speed" );
+  printf( " %11s\n", "max |diff|" );
+
+  for ( unsigned int i=0; i<sizeof(names)/sizeof(names[0]); i++ ) {
+    double ns[4];
+    StkFloat maxDiff = 0.0;
+    for ( unsigned int r=0; r<repeats; r++ ) {
+      // A Noise seeds rand() from the clock when it is constructed and
+      // some instruments tick it then, so construct the four together.
+      Instrmnt *inst[4];
+      for ( unsigned int b=0; b<4; b++ ) inst[b] = makeInstrument( i );
+
+      for ( unsigned int b=0; b<4; b++ ) {
+        double t = nsPerSample( render( inst[b], blockSizes[b], noteOff, b ? output : reference ), nFrames );
+        if ( r == 0 || t < ns[b] ) ns[b] = t;
+        if ( b == 0 ) continue;
+        for ( unsigned long j=0; j<nFrames; j++ )
+          if ( std::fabs( output[j] - reference[j] ) > maxDiff )
+            maxDiff = std::fabs( output[j] - reference[j] );
+      }
+
+      for ( unsigned int b=0; b<4; b++ ) delete inst[b];
+    }
+
+    printf( "%-9s %10.1f", names[i], ns[0] );
+    for ( unsigned int b=1; b<4; b++ )
+      printf( " %7.1f %5.2fx", ns[b], ns[0] / ns[b] );
+    printf( " %11.3g\n", maxDiff );
+  }
+
+  return 0;
+}
@@ -95,6 +95,10 @@ SOURCE=..\..\src\FileWvIn.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\Mutex.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\play.cpp
 # End Source File
 # Begin Source File
@@ -105,6 +109,10 @@ SOURCE=..\..\src\RtAudio.cpp
 
 SOURCE=..\..\src\Stk.cpp
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\src\WaveCache.cpp
+# End Source File
 # End Group
 # Begin Group "Header Files"
 
@@ -102,6 +102,10 @@ SOURCE=..\..\src\FileWvOut.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\Mutex.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\sineosc.cpp
 # End Source File
 # Begin Source File
@@ -112,6 +116,10 @@ SOURCE=..\..\src\Stk.cpp
 
 SOURCE=..\..\src\FileLoop.cpp
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\src\WaveCache.cpp
+# End Source File
 # End Group
 # Begin Group "Header Files"
 
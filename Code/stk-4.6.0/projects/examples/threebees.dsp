@@ -169,6 +169,10 @@ SOURCE=..\..\src\Voicer.cpp
 
 SOURCE=..\..\src\FileLoop.cpp
 # End Source File
+# Begin Source File
+
+SOURCE=..\..\src\WaveCache.cpp
+# End Source File
 # End Group
 # Begin Group "Header Files"
 
@@ -0,0 +1,139 @@
+/******************************************/
+/*
+  Benchmark for the Voicer block rendering.
+
+  Plays a note on every voice of a Voicer
+  of 64, 128 and 256 Rhodey voices, and
+  releases them three quarters of the way
+  through.  The voices are rendered with
+  the single-sample tick() and then with
+  the StkFrames tick() on 1, 2, 4 ... up to
+  the given number of threads, and the
+  program prints ns/frame, the speedup over
+  tick() and the largest difference from
+  its output.  It also times a noteOn and
+  noteOff pair with every voice sounding.
+
+  usage: voicebench [threads] [seconds]
+*/
+/******************************************/
+
+#include "Voicer.h"
+#include "Rhodey.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace stk;
+
+const unsigned int BLOCK_SIZE = 256;
+
+// Fill output with nVoices voices rendered on nThreads threads, or a
+// sample at a time with tick() if nThreads is 0, and return ns/frame.
+static double render( unsigned int nVoices, unsigned int nThreads, StkFrames &output )
+{
+  Voicer voicer;
+  std::vector<Instrmnt *> voices( nVoices );
+  for ( unsigned int i=0; i<nVoices; i++ ) {
+    voices[i] = new Rhodey();
+    voicer.addInstrument( voices[i] );
+  }
+  if ( nThreads > 1 ) voicer.setThreads( nThreads );
+
+  for ( unsigned int i=0; i<nVoices; i++ )
+    voicer.noteOn( 36.0 + i % 48, 64.0 );
+
+  unsigned long noteOff = output.frames() / 4 * 3;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  if ( nThreads == 0 ) {
+    for ( unsigned long i=0; i<output.frames(); i++ ) {
+      if ( i == noteOff )
+        for ( unsigned int j=0; j<48; j++ ) voicer.noteOff( (StkFloat) ( 36.0 + j ), 64.0 );
+      output[i] = voicer.tick();
+    }
+  }
+  else {
+    for ( unsigned long i=0; i<output.frames(); i+=BLOCK_SIZE ) {
+      if ( i == noteOff )
+        for ( unsigned int j=0; j<48; j++ ) voicer.noteOff( (StkFloat) ( 36.0 + j ), 64.0 );
+      StkFramesView block( output, i, BLOCK_SIZE );
+      voicer.tick( block );
+    }
+  }
+  double ns = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count();
+
+  for ( unsigned int i=0; i<nVoices; i++ ) {
+    voicer.removeInstrument( voices[i] );
+    delete voices[i];
+  }
+  return ns / output.frames();
+}
+
+// Time a noteOn and noteOff by tag with every voice sounding.
+static double allocate( unsigned int nVoices )
+{
+  const unsigned int pairs = 100000;
+  Voicer voicer;
+  std::vector<Instrmnt *> voices( nVoices );
+  for ( unsigned int i=0; i<nVoices; i++ ) {
+    voices[i] = new Rhodey();
+    voicer.addInstrument( voices[i] );
+    voicer.noteOn( 36.0 + i % 48, 64.0 );
+  }
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for ( unsigned int i=0; i<pairs; i++ ) {
+    long tag = voicer.noteOn( 36.0 + i % 48, 64.0 );
+    voicer.noteOff( tag, 64.0 );
+  }
+  double ns = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count();
+
+  for ( unsigned int i=0; i<nVoices; i++ ) {
+    voicer.removeInstrument( voices[i] );
+    delete voices[i];
+  }
+  return ns / pairs;
+}
+
+int main( int argc, char *argv[] )
+{
+  const unsigned int nVoices[] = { 64, 128, 256 };
+  unsigned int maxThreads = ( argc > 1 ) ? atoi( argv[1] ) : 4;
+  double seconds = ( argc > 2 ) ? atof( argv[2] ) : 2.0;
+  if ( maxThreads == 0 ) maxThreads = 1;
+
+  // A whole number of blocks, with the noteOffs on a block boundary.
+  unsigned long nFrames = ( (unsigned long) ( seconds * Stk::sampleRate() ) / ( 4 * BLOCK_SIZE ) + 1 ) * 4 * BLOCK_SIZE;
+
+  Stk::showWarnings( false );
+  Stk::setRawwavePath( RAWWAVE_PATH );
+  StkFrames reference( nFrames, 1 ), output( nFrames, 1 );
+
+  printf( "%-7s %8s %8s", "voices", "on/off", "tick" );
+  for ( unsigned int t=1; t<=maxThreads; t*=2 )
+    printf( "  %5u thread%s", t, ( t == 1 ) ? " " : "s" );
+  printf( "\n%-7s %8s %8s", "", "ns", "ns/frm" );
+  for ( unsigned int t=1; t<=maxThreads; t*=2 )
+    printf( "  %6s %6s", "ns/frm", "speed" );
+  printf( " %11s %11s\n", "|diff| 1", "|diff| >1" );
+
+  for ( unsigned int v=0; v<sizeof(nVoices)/sizeof(nVoices[0]); v++ ) {
+    double tickTime = render( nVoices[v], 0, reference );
+    printf( "%-7u %8.1f %8.1f", nVoices[v], allocate( nVoices[v] ), tickTime );
+
+    // One thread adds the voices in the same order as tick(), more
+    // threads add their shares in a different order.
+    StkFloat maxDiff[2] = { 0.0, 0.0 };
+    for ( unsigned int t=1; t<=maxThreads; t*=2 ) {
+      double ns = render( nVoices[v], t, output );
+      printf( "  %6.1f %5.2fx", ns, tickTime / ns );
+      for ( unsigned long j=0; j<nFrames; j++ )
+        if ( std::fabs( output[j] - reference[j] ) > maxDiff[t > 1] )
+          maxDiff[t > 1] = std::fabs( output[j] - reference[j] );
+    }
+    printf( " %11.3g %11.3g\n", maxDiff[0], maxDiff[1] );
+  }
+
+  return 0;
+}
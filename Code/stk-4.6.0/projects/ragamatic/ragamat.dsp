@@ -304,6 +304,14 @@ SOURCE=..\..\include\FileLoop.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\WaveCache.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=..\..\include\WaveCache.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\WvIn.h
 # End Source File
 # Begin Source File
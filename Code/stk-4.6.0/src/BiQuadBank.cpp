@@ -0,0 +1,141 @@
+/***************************************************/
+/*! \class BiQuadBank
+    \brief STK bank of parallel biquad filters.
+
+    This class holds the parallel resonators of a modal or PhISEM
+    model, N two-pole, two-zero filters that share one input and whose
+    outputs are summed, and can hold the same N filters for several
+    voices at once.  Each filter computes the same direct form I
+    difference equation as BiQuad, with its own gain applied to the
+    input, so a BiQuad setting carries over unchanged.
+
+    The coefficients and state are stored as arrays across filters
+    rather than one object per filter, so a vector of filters steps
+    through a sample at a time (see biquadBank() in Simd.h).  With one
+    voice the vectors run across the N filters of that voice, a frame
+    at a time.  With several voices they run across voices, filter j
+    of every voice in one row, so each voice keeps its own input and
+    its own output and no vector is ever summed across lanes; the
+    StkFrames tick function then runs each row over a block of frames
+    before the next one, which is where the bank is fastest.
+
+    Filter j of voice v is number j + v * N in the functions that set
+    one filter.
+*/
+/***************************************************/
+
+#include "BiQuadBank.h"
+#include <cmath>
+
+namespace stk {
+
+BiQuadBank :: BiQuadBank( unsigned int filters, unsigned int voices ) : Filter()
+{
+  this->resize( filters, voices );
+}
+
+BiQuadBank :: ~BiQuadBank()
+{
+}
+
+void BiQuadBank :: resize( unsigned int filters, unsigned int voices )
+{
+  if ( filters == 0 || voices == 0 ) {
+    oStream_ << "BiQuadBank::resize: the number of filters and voices must be > 0!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  filters_ = filters;
+  voices_ = voices;
+  rows_ = ( voices_ == 1 ) ? 1 : filters_;
+  unsigned int width = ( voices_ == 1 ) ? filters_ : voices_;
+  stride_ = ( width + SIMD_LANES - 1 ) / SIMD_LANES * SIMD_LANES;
+
+  // Padding lanes keep a zero gain, so their output stays zero.
+  coefficients_.assign( 6 * rows_ * stride_, 0.0 );
+  for ( unsigned int k=0; k<filters_ * voices_; k++ ) {
+    coefficient( k, 0 ) = 1.0;
+    coefficient( k, 1 ) = 1.0;
+  }
+
+  state_.resize( 4 * rows_ * stride_ );
+
+  // Only several voices run a block at a time.
+  unsigned int blockSize = ( voices_ == 1 ) ? stride_ : BLOCK_FRAMES * stride_;
+  lanes_.assign( blockSize, 0.0 );
+  block_.resize( blockSize );
+  channelsIn_ = voices_;
+  lastFrame_.resize( 1, voices_, 0.0 );
+  this->clear();
+}
+
+void BiQuadBank :: setCoefficients( unsigned int k, StkFloat b0, StkFloat b1, StkFloat b2, StkFloat a1, StkFloat a2, bool clearState )
+{
+  coefficient( k, 1 ) = b0;
+  coefficient( k, 2 ) = b1;
+  coefficient( k, 3 ) = b2;
+  coefficient( k, 4 ) = a1;
+  coefficient( k, 5 ) = a2;
+
+  if ( clearState ) this->clear();
+}
+
+void BiQuadBank :: setResonance( unsigned int k, StkFloat frequency, StkFloat radius, bool normalize )
+{
+#if defined(_STK_DEBUG_)
+  if ( frequency < 0.0 || frequency > 0.5 * Stk::sampleRate() ) {
+    oStream_ << "BiQuadBank::setResonance: frequency argument (" << frequency << ") is out of range!";
+    handleError( StkError::WARNING ); return;
+  }
+  if ( radius < 0.0 || radius >= 1.0 ) {
+    oStream_ << "BiQuadBank::setResonance: radius argument (" << radius << ") is out of range!";
+    handleError( StkError::WARNING ); return;
+  }
+#endif
+
+  coefficient( k, 5 ) = radius * radius;
+  coefficient( k, 4 ) = -2.0 * radius * cos( TWO_PI * frequency / Stk::sampleRate() );
+
+  if ( normalize ) {
+    // Use zeros at +- 1 and normalize the filter peak gain.
+    coefficient( k, 1 ) = 0.5 - 0.5 * radius * radius;
+    coefficient( k, 2 ) = 0.0;
+    coefficient( k, 3 ) = -coefficient( k, 1 );
+  }
+}
+
+void BiQuadBank :: setNotch( unsigned int k, StkFloat frequency, StkFloat radius )
+{
+#if defined(_STK_DEBUG_)
+  if ( frequency < 0.0 || frequency > 0.5 * Stk::sampleRate() ) {
+    oStream_ << "BiQuadBank::setNotch: frequency argument (" << frequency << ") is out of range!";
+    handleError( StkError::WARNING ); return;
+  }
+  if ( radius < 0.0 ) {
+    oStream_ << "BiQuadBank::setNotch: radius argument (" << radius << ") is negative!";
+    handleError( StkError::WARNING ); return;
+  }
+#endif
+
+  // This method does not attempt to normalize the filter gain.
+  coefficient( k, 3 ) = radius * radius;
+  coefficient( k, 2 ) = (StkFloat) -2.0 * radius * cos( TWO_PI * (double) frequency / Stk::sampleRate() );
+}
+
+void BiQuadBank :: setEqualGainZeroes( unsigned int k )
+{
+  coefficient( k, 1 ) = 1.0;
+  coefficient( k, 2 ) = 0.0;
+  coefficient( k, 3 ) = -1.0;
+}
+
+void BiQuadBank :: clear( void )
+{
+  unsigned int i;
+  for ( i=0; i<state_.size(); i++ )
+    state_[i] = 0.0;
+  for ( i=0; i<lastFrame_.size(); i++ )
+    lastFrame_[i] = 0.0;
+}
+
+} // stk namespace
@@ -0,0 +1,288 @@
+/***************************************************/
+/*! \class ConvolutionFir
+    \brief STK partitioned FFT convolution effect class.
+
+    This class convolves its input with an arbitrarily long impulse
+    response (a long FIR filter or a measured room response) using
+    uniformly partitioned overlap-save convolution.
+
+    The impulse response is split into partitions of \e blockSize
+    samples.  Each partition is transformed once when the response is
+    set.  Every block of input is transformed once and kept in a
+    frequency-domain delay line, and the output block is one inverse
+    transform of the sum of the partition products.  The cost per
+    sample therefore grows with the logarithm of the block size and
+    linearly only in the number of partitions, instead of with the
+    full response length as in the direct form Fir class.
+
+    The output is never delayed.  Whole blocks passed to
+    tick(StkFrames&) are convolved with one transform each.  Samples
+    of a partial block, from the single-sample tick or from frames
+    that don't fill a block, are convolved with the first partition
+    directly, and the other partitions, which only see earlier blocks,
+    are applied with one transform when the block starts.  Calls of
+    any size can therefore be mixed and give the same output, up to
+    rounding, as whole blocks.  A partial block costs about
+    \e blockSize multiply-adds per sample more.
+
+    The effect mix defaults to 1.0 (convolved signal only).
+*/
+/***************************************************/
+
+#include "ConvolutionFir.h"
+#include "FileRead.h"
+#include <algorithm>
+#include <cmath>
+
+namespace stk {
+
+ConvolutionFir :: ConvolutionFir( unsigned int blockSize ) : Effect()
+{
+  effectMix_ = 1.0;
+  blockSize_ = blockSize;
+  response_.push_back( 1.0 );
+  this->allocate();
+}
+
+ConvolutionFir :: ConvolutionFir( std::vector<StkFloat> &coefficients, unsigned int blockSize ) : Effect()
+{
+  if ( coefficients.size() == 0 ) {
+    oStream_ << "ConvolutionFir: coefficient vector must have size > 0!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  effectMix_ = 1.0;
+  blockSize_ = blockSize;
+  response_ = coefficients;
+  this->allocate();
+}
+
+ConvolutionFir :: ~ConvolutionFir( void )
+{
+}
+
+void ConvolutionFir :: clear( void )
+{
+  std::fill( window_.begin(), window_.end(), 0.0 );
+  std::fill( fdlReal_.begin(), fdlReal_.end(), 0.0 );
+  std::fill( fdlImag_.begin(), fdlImag_.end(), 0.0 );
+  std::fill( history_.begin(), history_.end(), 0.0 );
+  std::fill( outBlock_.begin(), outBlock_.end(), 0.0 );
+  fill_ = 0;
+  lastFrame_[0] = 0.0;
+}
+
+void ConvolutionFir :: setBlockSize( unsigned int blockSize )
+{
+  if ( blockSize == 0 ) {
+    oStream_ << "ConvolutionFir::setBlockSize: block size must be > 0!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  blockSize_ = blockSize;
+  this->allocate();
+}
+
+void ConvolutionFir :: setCoefficients( std::vector<StkFloat> &coefficients, bool clearState )
+{
+  if ( coefficients.size() == 0 ) {
+    oStream_ << "ConvolutionFir::setCoefficients: coefficient vector must have size > 0!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  unsigned int partitions = ( coefficients.size() + blockSize_ - 1 ) / blockSize_;
+  response_ = coefficients;
+  if ( partitions != partitions_ ) {
+    this->allocate();
+    return;
+  }
+
+  this->transformResponse();
+  if ( clearState ) this->clear();
+}
+
+void ConvolutionFir :: openFile( std::string fileName, bool typeRaw )
+{
+  FileRead file( fileName, typeRaw );
+  StkFrames data( file.fileSize(), file.channels() );
+  file.read( data );
+
+  std::vector<StkFloat> coefficients( data.frames() );
+  for ( unsigned int i=0; i<data.frames(); i++ )
+    coefficients[i] = data( i, 0 );
+
+  this->setCoefficients( coefficients, true );
+}
+
+void ConvolutionFir :: allocate( void )
+{
+  // Overlap-save needs room for one block of input plus one partition.
+  fftSize_ = 2;
+  while ( fftSize_ < 2 * blockSize_ ) fftSize_ <<= 1;
+  bins_ = fftSize_ / 2 + 1;
+  partitions_ = ( response_.size() + blockSize_ - 1 ) / blockSize_;
+
+  window_.assign( fftSize_, 0.0 );
+  real_.assign( fftSize_, 0.0 );
+  imag_.assign( fftSize_, 0.0 );
+  responseReal_.assign( partitions_ * bins_, 0.0 );
+  responseImag_.assign( partitions_ * bins_, 0.0 );
+  fdlReal_.assign( partitions_ * bins_, 0.0 );
+  fdlImag_.assign( partitions_ * bins_, 0.0 );
+  history_.assign( 2 * blockSize_, 0.0 );
+  reversed_.assign( blockSize_, 0.0 );
+  outBlock_.assign( blockSize_, 0.0 );
+
+  cosTable_.resize( fftSize_ / 2 );
+  sinTable_.resize( fftSize_ / 2 );
+  for ( unsigned int i=0; i<fftSize_/2; i++ ) {
+    cosTable_[i] = cos( TWO_PI * i / fftSize_ );
+    sinTable_[i] = sin( TWO_PI * i / fftSize_ );
+  }
+
+  unsigned int bits = 0;
+  while ( ( 1u << bits ) < fftSize_ ) bits++;
+  bitReverse_.resize( fftSize_ );
+  for ( unsigned int i=0; i<fftSize_; i++ ) {
+    unsigned int r = 0;
+    for ( unsigned int b=0; b<bits; b++ )
+      if ( i & ( 1u << b ) ) r |= 1u << ( bits - 1 - b );
+    bitReverse_[i] = r;
+  }
+
+  fdlIndex_ = 0;
+  fill_ = 0;
+  this->transformResponse();
+  this->clear();
+}
+
+void ConvolutionFir :: transformResponse( void )
+{
+  length_ = response_.size();
+
+  for ( unsigned int p=0; p<partitions_; p++ ) {
+    std::fill( real_.begin(), real_.end(), 0.0 );
+    std::fill( imag_.begin(), imag_.end(), 0.0 );
+    for ( unsigned int i=0; i<blockSize_ && p*blockSize_+i<length_; i++ )
+      real_[i] = response_[p*blockSize_+i];
+
+    this->fft( &real_[0], &imag_[0], false );
+
+    for ( unsigned int k=0; k<bins_; k++ ) {
+      responseReal_[p*bins_+k] = real_[k];
+      responseImag_[p*bins_+k] = imag_[k];
+    }
+  }
+
+  for ( unsigned int i=0; i<blockSize_; i++ )
+    reversed_[blockSize_-1-i] = ( i < length_ ) ? response_[i] : 0.0;
+
+  // A partial block in progress continues with the new response.
+  if ( fill_ > 0 ) this->convolve( 1 );
+}
+
+void ConvolutionFir :: startBlock( void )
+{
+  for ( unsigned int k=0; k<blockSize_; k++ )
+    history_[k] = window_[fftSize_-blockSize_+k];
+
+  this->convolve( 1 );
+}
+
+void ConvolutionFir :: transformBlock( void )
+{
+  unsigned int k;
+
+  // Slide the input window by one block.
+  for ( k=0; k<fftSize_-blockSize_; k++ )
+    window_[k] = window_[k+blockSize_];
+  for ( k=0; k<blockSize_; k++ )
+    window_[fftSize_-blockSize_+k] = history_[blockSize_+k];
+
+  for ( k=0; k<fftSize_; k++ ) {
+    real_[k] = window_[k];
+    imag_[k] = 0.0;
+  }
+  this->fft( &real_[0], &imag_[0], false );
+
+  // The newest spectrum goes to the front of the delay line.
+  fdlIndex_ = ( fdlIndex_ == 0 ) ? partitions_ - 1 : fdlIndex_ - 1;
+  StkFloat *xr = &fdlReal_[fdlIndex_*bins_];
+  StkFloat *xi = &fdlImag_[fdlIndex_*bins_];
+  for ( k=0; k<bins_; k++ ) {
+    xr[k] = real_[k];
+    xi[k] = imag_[k];
+  }
+}
+
+void ConvolutionFir :: convolve( unsigned int first )
+{
+  unsigned int k, p;
+
+  if ( first >= partitions_ ) {
+    std::fill( outBlock_.begin(), outBlock_.end(), 0.0 );
+    return;
+  }
+
+  // Sum the partition products over the non-redundant half spectrum.
+  // Partition \e first pairs with the newest spectrum in the delay line.
+  for ( k=0; k<bins_; k++ ) real_[k] = imag_[k] = 0.0;
+  unsigned int slot = fdlIndex_;
+  for ( p=first; p<partitions_; p++ ) {
+    const StkFloat *hr = &responseReal_[p*bins_];
+    const StkFloat *hi = &responseImag_[p*bins_];
+    const StkFloat *xr = &fdlReal_[slot*bins_];
+    const StkFloat *xi = &fdlImag_[slot*bins_];
+    for ( k=0; k<bins_; k++ ) {
+      real_[k] += xr[k] * hr[k] - xi[k] * hi[k];
+      imag_[k] += xr[k] * hi[k] + xi[k] * hr[k];
+    }
+    if ( ++slot == partitions_ ) slot = 0;
+  }
+
+  // Rebuild the conjugate-symmetric upper half and transform back.
+  for ( k=bins_; k<fftSize_; k++ ) {
+    real_[k] = real_[fftSize_-k];
+    imag_[k] = -imag_[fftSize_-k];
+  }
+  this->fft( &real_[0], &imag_[0], true );
+
+  // The last block of the circular result is free of wrap-around.
+  StkFloat scale = 1.0 / fftSize_;
+  for ( k=0; k<blockSize_; k++ )
+    outBlock_[k] = real_[fftSize_-blockSize_+k] * scale;
+}
+
+void ConvolutionFir :: fft( StkFloat *real, StkFloat *imag, bool inverse )
+{
+  unsigned int i, j, k;
+
+  for ( i=0; i<fftSize_; i++ ) {
+    j = bitReverse_[i];
+    if ( j > i ) {
+      StkFloat t = real[i]; real[i] = real[j]; real[j] = t;
+      t = imag[i]; imag[i] = imag[j]; imag[j] = t;
+    }
+  }
+
+  StkFloat sign = inverse ? 1.0 : -1.0;
+  for ( unsigned int size=2; size<=fftSize_; size<<=1 ) {
+    unsigned int half = size >> 1;
+    unsigned int step = fftSize_ / size;
+    for ( i=0; i<fftSize_; i+=size ) {
+      for ( j=0, k=0; j<half; j++, k+=step ) {
+        StkFloat wr = cosTable_[k];
+        StkFloat wi = sign * sinTable_[k];
+        unsigned int a = i + j, b = i + j + half;
+        StkFloat tr = real[b] * wr - imag[b] * wi;
+        StkFloat ti = real[b] * wi + imag[b] * wr;
+        real[b] = real[a] - tr;
+        imag[b] = imag[a] - ti;
+        real[a] += tr;
+        imag[a] += ti;
+      }
+    }
+  }
+}
+
+} // stk namespace
@@ -61,10 +61,17 @@ Drummer :: Drummer( void ) : Instrmnt()
   nSounding_ = 0;
   soundOrder_ = std::vector<int> (DRUM_POLYPHONY, -1);
   soundNumber_ = std::vector<int> (DRUM_POLYPHONY, -1);
+
+  // Load the drum waves now, shared with any other Drummer, so that
+  // a noteOn() does no file input.
+  for ( int i=0; i<DRUM_NUMWAVES; i++ )
+    sounds_[i] = WaveCache::acquire( Stk::rawwavePath() + waveNames[i], true );
 }
 
 Drummer :: ~Drummer( void )
 {
+  for ( int i=0; i<DRUM_NUMWAVES; i++ )
+    WaveCache::release( sounds_[i] );
 }
 
 void Drummer :: noteOn( StkFloat instrument, StkFloat amplitude )
@@ -113,8 +120,7 @@ void Drummer :: noteOn( StkFloat instrument, StkFloat amplitude )
     soundNumber_[iWave] = noteNumber;
     //std::cout << "iWave = " << iWave << ", nSounding = " << nSounding_ << ", soundOrder[] = " << soundOrder_[iWave] << std::endl;
 
-    // Concatenate the STK rawwave path to the rawwave file
-    waves_[iWave].openFile( (Stk::rawwavePath() + waveNames[ genMIDIMap[ noteNumber ] ]).c_str(), true );
+    waves_[iWave].openShared( sounds_[ genMIDIMap[ noteNumber ] ] );
     if ( Stk::sampleRate() != 22050.0 )
       waves_[iWave].setRate( 22050.0 / Stk::sampleRate() );
     filters_[iWave].setPole( 0.999 - (amplitude * 0.6) );
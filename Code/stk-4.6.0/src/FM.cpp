@@ -54,6 +54,7 @@ FM :: FM( unsigned int operators )
   control1_ = 1.0;
   control2_ = 1.0;
   baseFrequency_ = 440.0;
+  operatorFrequency_ = 0.0;
 
   int i;
   StkFloat temp = 1.0;
@@ -85,8 +86,11 @@ FM :: ~FM( void )
 
 void FM :: loadWaves( const char **filenames )
 {
-  for (unsigned int i=0; i<nOperators_; i++ )
-    waves_[i] = new FileLoop( filenames[i], true );
+  for (unsigned int i=0; i<nOperators_; i++ ) {
+    waves_[i] = new FileLoop();
+    waves_[i]->openShared( filenames[i], true );
+  }
+  operatorFrequency_ = 0.0;
 }
 
 void FM :: setFrequency( StkFloat frequency )
@@ -99,6 +103,7 @@ void FM :: setFrequency( StkFloat frequency )
 #endif
 
   baseFrequency_ = frequency;
+  operatorFrequency_ = 0.0;
   for ( unsigned int i=0; i<nOperators_; i++ )
     waves_[i]->setFrequency( baseFrequency_ * ratios_[i] );
 }
@@ -111,6 +116,7 @@ void FM :: setRatio( unsigned int waveIndex, StkFloat ratio )
   }
 
   ratios_[waveIndex] = ratio;
+  operatorFrequency_ = 0.0;
   if (ratio > 0.0) 
     waves_[waveIndex]->setFrequency( baseFrequency_ * ratio );
   else
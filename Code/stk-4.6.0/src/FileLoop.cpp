@@ -12,6 +12,9 @@
     the overloaded one that takes an StkFrames object for
     multi-channel and/or multi-frame data.
 
+    As with FileWvIn, the openShared() functions loop file data held
+    by the WaveCache instead of a private copy.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2017.
 */
 /***************************************************/
@@ -186,11 +189,11 @@ StkFloat FileLoop :: tick( unsigned int channel )
 
   if ( interpolate_ ) {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_.interpolate( tyme, i );
+      lastFrame_[i] = wave_->interpolate( tyme, i );
   }
   else {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_( (size_t) tyme, i );
+      lastFrame_[i] = (*wave_)( (size_t) tyme, i );
   }
 
   // Increment time, which can be negative.
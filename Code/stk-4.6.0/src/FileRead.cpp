@@ -10,6 +10,15 @@
     does not store its own copy of the file data,
     rather the data is read directly from disk.
 
+    Where the platform allows it, an open file is
+    mapped read-only into memory (see
+    setMemoryMapping()) and read() decodes the
+    samples straight from the mapping, so that even
+    a very large file opens immediately and the
+    operating system reads only the parts of it
+    that are used.  The samples are converted with
+    the vectorized decode kernels of Simd.h.
+
     FileRead currently supports uncompressed WAV,
     AIFF/AIFC, SND (AU), MAT-file (Matlab), and
     STK RAW file formats.  Signed integer (8-,
@@ -32,34 +41,70 @@
 /***************************************************/
 
 #include "FileRead.h"
+#include "Simd.h"
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <cstring>
 #include <cmath>
 #include <cstdio>
 
+// Memory mapping doesn't depend on an audio API, so the platform is
+// also detected when none of the __OS_*__ macros of Stk.h is defined.
+#if defined(__OS_WINDOWS__) || defined(_WIN32)
+  #define __STK_MMAP_WINDOWS__
+  #include <windows.h>
+  #include <io.h>
+#elif defined(__OS_LINUX__) || defined(__OS_MACOSX__) || defined(__OS_IRIX__) || defined(__unix__) || defined(__APPLE__)
+  #define __STK_MMAP_POSIX__
+  #include <sys/mman.h>
+#endif
+
 namespace stk {
 
+bool FileRead :: memoryMapping_ = true;
+
+// Return the size in bytes of one sample of the given format.
+static unsigned int sampleBytes( Stk::StkFormat format )
+{
+  if ( format == Stk::STK_SINT8 ) return 1;
+  else if ( format == Stk::STK_SINT16 ) return 2;
+  else if ( format == Stk::STK_SINT24 ) return 3;
+  else if ( format == Stk::STK_FLOAT64 ) return 8;
+  return 4;
+}
+
 FileRead :: FileRead()
-  : fd_(0), fileSize_(0), channels_(0), dataType_(0), fileRate_(0.0)
+  : fd_(0), fileSize_(0), channels_(0), dataType_(0), fileRate_(0.0),
+    map_(0), mapSize_(0), mapHandle_(0)
 {
 }
 
 FileRead :: FileRead( std::string fileName, bool typeRaw, unsigned int nChannels,
                       StkFormat format, StkFloat rate )
-  : fd_(0)
+  : fd_(0), map_(0), mapSize_(0), mapHandle_(0)
 {
   open( fileName, typeRaw, nChannels, format, rate );
 }
 
 FileRead :: ~FileRead()
 {
-  if ( fd_ )
-    fclose( fd_ );
+  this->close();
 }
 
 void FileRead :: close( void )
 {
+  if ( map_ ) {
+#if defined(__STK_MMAP_WINDOWS__)
+    UnmapViewOfFile( map_ );
+    CloseHandle( (HANDLE) mapHandle_ );
+#elif defined(__STK_MMAP_POSIX__)
+    munmap( (void *) map_, mapSize_ );
+#endif
+  }
+  map_ = 0;
+  mapSize_ = 0;
+  mapHandle_ = 0;
+
   if ( fd_ ) fclose( fd_ );
   fd_ = 0;
   wavFile_ = false;
@@ -126,6 +171,8 @@ void FileRead :: open( std::string fileName, bool typeRaw, unsigned int nChannel
     handleError( StkError::FILE_ERROR );
   }
 
+  if ( memoryMapping_ ) mapFile();
+
   return;
 
  error:
@@ -133,6 +180,41 @@ void FileRead :: open( std::string fileName, bool typeRaw, unsigned int nChannel
   handleError( StkError::FILE_ERROR );
 }
 
+void FileRead :: mapFile( void )
+{
+  // Only map the file if it holds all of the data given by its header.
+  unsigned long long dataEnd = dataOffset_ + (unsigned long long) fileSize_ * channels_ * sampleBytes( dataType_ );
+
+#if defined(__STK_MMAP_WINDOWS__)
+  HANDLE file = (HANDLE) _get_osfhandle( _fileno( fd_ ) );
+  LARGE_INTEGER length;
+  if ( file == INVALID_HANDLE_VALUE || !GetFileSizeEx( file, &length ) ) return;
+  if ( (unsigned long long) length.QuadPart < dataEnd || (unsigned long long) length.QuadPart > (size_t) -1 ) return;
+
+  HANDLE mapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+  if ( mapping == NULL ) return;
+  void *view = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+  if ( view == NULL ) {
+    CloseHandle( mapping );
+    return;
+  }
+
+  map_ = (const unsigned char *) view;
+  mapSize_ = (size_t) length.QuadPart;
+  mapHandle_ = mapping;
+#elif defined(__STK_MMAP_POSIX__)
+  struct stat filestat;
+  if ( fstat( fileno( fd_ ), &filestat ) == -1 ) return;
+  if ( (unsigned long long) filestat.st_size < dataEnd || (unsigned long long) filestat.st_size > (size_t) -1 ) return;
+
+  void *view = mmap( 0, (size_t) filestat.st_size, PROT_READ, MAP_SHARED, fileno( fd_ ), 0 );
+  if ( view == MAP_FAILED ) return;
+
+  map_ = (const unsigned char *) view;
+  mapSize_ = (size_t) filestat.st_size;
+#endif
+}
+
 bool FileRead :: getRawInfo( const char *fileName, unsigned int nChannels, StkFormat format, StkFloat rate )
 {
   // Use the system call "stat" to determine the file length.
@@ -758,136 +840,23 @@ void FileRead :: read( StkFrames& buffer, unsigned long startFrame, bool doNorma
   if ( startFrame + nFrames > fileSize_ )
     nFrames = fileSize_ - startFrame;
 
-  long i, nSamples = (long) ( nFrames * channels_ );
+  unsigned long nSamples = nFrames * channels_;
   unsigned long offset = startFrame * channels_;
+  unsigned int bytes = sampleBytes( dataType_ );
 
-  // Read samples into StkFrames data buffer.
-  if ( dataType_ == STK_SINT16 ) {
-    SINT16 *buf = (SINT16 *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+(offset*2), SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples * 2, 1, fd_ ) != 1 ) goto error;
-    if ( byteswap_ ) {
-      SINT16 *ptr = buf;
-      for ( i=nSamples-1; i>=0; i-- )
-        swap16( (unsigned char *) ptr++ );
-    }
-    if ( doNormalize ) {
-      StkFloat gain = 1.0 / 32768.0;
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i] * gain;
-    }
-    else {
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i];
-    }
-  }
-  else if ( dataType_ == STK_SINT32 ) {
-    SINT32 *buf = (SINT32 *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+(offset*4 ), SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples * 4, 1, fd_ ) != 1 ) goto error;
-    if ( byteswap_ ) {
-      SINT32 *ptr = buf;
-      for ( i=nSamples-1; i>=0; i-- )
-        swap32( (unsigned char *) ptr++ );
-    }
-    if ( doNormalize ) {
-      StkFloat gain = 1.0 / 2147483648.0;
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i] * gain;
-    }
-    else {
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i];
-    }
-  }
-  else if ( dataType_ == STK_FLOAT32 ) {
-    FLOAT32 *buf = (FLOAT32 *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+(offset*4), SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples * 4, 1, fd_ ) != 1 ) goto error;
-    if ( byteswap_ ) {
-      FLOAT32 *ptr = buf;
-      for ( i=nSamples-1; i>=0; i-- )
-        swap32( (unsigned char *) ptr++ );
-    }
-    for ( i=nSamples-1; i>=0; i-- )
-      buffer[i] = buf[i];
+  if ( map_ ) {
+    decode( &buffer[0], map_ + dataOffset_ + offset * bytes, nSamples, doNormalize );
   }
-  else if ( dataType_ == STK_FLOAT64 ) {
-    FLOAT64 *buf = (FLOAT64 *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+(offset*8), SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples * 8, 1, fd_ ) != 1 ) goto error;
-    if ( byteswap_ ) {
-      FLOAT64 *ptr = buf;
-      for ( i=nSamples-1; i>=0; i-- )
-        swap64( (unsigned char *) ptr++ );
-    }
-    for ( i=nSamples-1; i>=0; i-- )
-      buffer[i] = buf[i];
-  }
-  else if ( dataType_ == STK_SINT8 && wavFile_ ) { // 8-bit WAV data is unsigned!
-    unsigned char *buf = (unsigned char *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+offset, SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples, 1, fd_) != 1 ) goto error;
-    if ( doNormalize ) {
-      StkFloat gain = 1.0 / 128.0;
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = ( buf[i] - 128 ) * gain;
-    }
-    else {
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i] - 128.0;
-    }
-  }
-  else if ( dataType_ == STK_SINT8 ) { // signed 8-bit data
-    char *buf = (char *) &buffer[0];
-    if ( fseek( fd_, dataOffset_+offset, SEEK_SET ) == -1 ) goto error;
-    if ( fread( buf, nSamples, 1, fd_ ) != 1 ) goto error;
-    if ( doNormalize ) {
-      StkFloat gain = 1.0 / 128.0;
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i] * gain;
-    }
-    else {
-      for ( i=nSamples-1; i>=0; i-- )
-        buffer[i] = buf[i];
-    }
-  }
-  else if ( dataType_ == STK_SINT24 ) {
-    // 24-bit values are harder to import efficiently since there is
-    // no native 24-bit type.  The following routine works but is much
-    // less efficient than that used for the other data types.
-    SINT32 temp;
-    unsigned char *ptr = (unsigned char *) &temp;
-    StkFloat gain = 1.0 / 2147483648.0;
-    if ( fseek(fd_, dataOffset_+(offset*3), SEEK_SET ) == -1 ) goto error;
-    for ( i=0; i<nSamples; i++ ) {
-#ifdef __LITTLE_ENDIAN__
-      if ( byteswap_ ) {
-        if ( fread( ptr, 3, 1, fd_ ) != 1 ) goto error;
-        temp &= 0x00ffffff;
-        swap32( (unsigned char *) ptr );
-      }
-      else {
-        if ( fread( ptr+1, 3, 1, fd_ ) != 1 ) goto error;
-        temp &= 0xffffff00;
-      }
-#else
-      if ( byteswap_ ) {
-        if ( fread( ptr+1, 3, 1, fd_ ) != 1 ) goto error;
-        temp &= 0xffffff00;
-        swap32( (unsigned char *) ptr );
-      }
-      else {
-        if ( fread( ptr, 3, 1, fd_ ) != 1 ) goto error;
-        temp &= 0x00ffffff;
-      }
-#endif
-
-      if ( doNormalize ) {
-        buffer[i] = (StkFloat) temp * gain; // "gain" also  includes 1 / 256 factor.
-      }
-      else
-        buffer[i] = (StkFloat) temp / 256;  // right shift without affecting the sign bit
+  else {
+    // Read the samples through a local buffer that holds a whole
+    // number of them, and decode each block into the StkFrames data.
+    unsigned char data[8 * 3 * 512];
+    unsigned long blockSize = sizeof( data ) / bytes;
+    if ( fseek( fd_, dataOffset_+(offset*bytes), SEEK_SET ) == -1 ) goto error;
+    for ( unsigned long i=0; i<nSamples; i+=blockSize ) {
+      unsigned long count = ( nSamples - i < blockSize ) ? nSamples - i : blockSize;
+      if ( fread( data, count * bytes, 1, fd_ ) != 1 ) goto error;
+      decode( &buffer[i], data, count, doNormalize );
     }
   }
 
@@ -900,4 +869,20 @@ void FileRead :: read( StkFrames& buffer, unsigned long startFrame, bool doNorma
   handleError( StkError::FILE_ERROR);
 }
 
+void FileRead :: decode( StkFloat *out, const unsigned char *in, unsigned long n, bool doNormalize ) const
+{
+  if ( dataType_ == STK_SINT16 )
+    decodeInt16( out, in, n, byteswap_, doNormalize ? 1.0 / 32768.0 : 1.0 );
+  else if ( dataType_ == STK_SINT32 )
+    decodeInt32( out, in, n, byteswap_, doNormalize ? 1.0 / 2147483648.0 : 1.0 );
+  else if ( dataType_ == STK_FLOAT32 )
+    decodeFloat32( out, in, n, byteswap_ );
+  else if ( dataType_ == STK_FLOAT64 )
+    decodeFloat64( out, in, n, byteswap_ );
+  else if ( dataType_ == STK_SINT8 ) // 8-bit WAV data is unsigned!
+    decodeInt8( out, in, n, wavFile_, doNormalize ? 1.0 / 128.0 : 1.0 );
+  else if ( dataType_ == STK_SINT24 ) // the values are shifted left by 8 bits
+    decodeInt24( out, in, n, byteswap_, doNormalize ? 1.0 / 2147483648.0 : 1.0 / 256.0 );
+}
+
 } // stk namespace
@@ -21,6 +21,10 @@
     chunkThreshold (in sample frames) will be read incrementally in
     chunks of \e chunkSize each (also in sample frames).
 
+    The openShared() functions play file data held by the WaveCache
+    instead of a private copy, so that many objects playing the same
+    file use one copy of its data.  Shared data is never chunked.
+
     When the file end is reached, subsequent calls to the tick()
     functions return zeros and isFinished() returns \e true.
 
@@ -37,7 +41,7 @@
 namespace stk {
 
 FileWvIn :: FileWvIn( unsigned long chunkThreshold, unsigned long chunkSize )
-  : finished_(true), interpolate_(false), time_(0.0), rate_(0.0),
+  : shared_(0), wave_(&data_), finished_(true), interpolate_(false), time_(0.0), rate_(0.0),
     chunkThreshold_(chunkThreshold), chunkSize_(chunkSize)
 {
   Stk::addSampleRateAlert( this );
@@ -46,7 +50,7 @@ FileWvIn :: FileWvIn( unsigned long chunkThreshold, unsigned long chunkSize )
 FileWvIn :: FileWvIn( std::string fileName, bool raw, bool doNormalize,
                       unsigned long chunkThreshold, unsigned long chunkSize,
                       bool doInt2FloatScaling )
-  : finished_(true), interpolate_(false), time_(0.0), rate_(0.0),
+  : shared_(0), wave_(&data_), finished_(true), interpolate_(false), time_(0.0), rate_(0.0),
     chunkThreshold_(chunkThreshold), chunkSize_(chunkSize)
 {
   openFile( fileName, raw, doNormalize, doInt2FloatScaling );
@@ -68,6 +72,11 @@ void FileWvIn :: sampleRateChanged( StkFloat newRate, StkFloat oldRate )
 void FileWvIn :: closeFile( void )
 {
   if ( file_.isOpen() ) file_.close();
+  if ( shared_ ) {
+    WaveCache::release( shared_ );
+    shared_ = 0;
+    wave_ = &data_;
+  }
   finished_ = true;
   lastFrame_.resize( 0, 0 );
 }
@@ -114,6 +123,34 @@ void FileWvIn :: openFile( std::string fileName, bool raw, bool doNormalize, boo
   this->reset();
 }
 
+void FileWvIn :: openShared( std::string fileName, bool raw, bool doNormalize, bool doInt2FloatScaling )
+{
+  // Attempt to read the file ... an error might be thrown here.
+  const WaveCache::Wave *wave = WaveCache::acquire( fileName, raw, doNormalize, doInt2FloatScaling );
+  this->openShared( wave );
+  WaveCache::release( wave );
+}
+
+void FileWvIn :: openShared( const WaveCache::Wave *wave )
+{
+  // Take our reference first, in case the wave is already open.
+  WaveCache::retain( wave );
+  this->closeFile();
+
+  shared_ = wave;
+  wave_ = &wave->data();
+  chunking_ = false;
+
+  // Keep data_ empty but with the channel count of the wave, which
+  // channelsOut() returns.  Only a first open allocates lastFrame_.
+  data_.resize( 0, wave_->channels() );
+  lastFrame_.resize( 1, wave_->channels() );
+
+  fileSize_ = wave->fileSize();
+  this->setRate( wave_->dataRate() / Stk::sampleRate() );
+  this->reset();
+}
+
 void FileWvIn :: reset(void)
 {
   time_ = (StkFloat) 0.0;
@@ -132,6 +169,15 @@ void FileWvIn :: normalize( StkFloat peak )
   // When chunking, the "normalization" scaling is performed by FileRead.
   if ( chunking_ ) return;
 
+  // Shared data is never modified, so normalize a copy of it.
+  if ( shared_ ) {
+    data_ = *wave_;
+    data_.setDataRate( wave_->dataRate() );
+    WaveCache::release( shared_ );
+    shared_ = 0;
+    wave_ = &data_;
+  }
+
   size_t i;
   StkFloat max = 0.0;
 
@@ -217,11 +263,11 @@ StkFloat FileWvIn :: tick( unsigned int channel )
 
   if ( interpolate_ ) {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_.interpolate( tyme, i );
+      lastFrame_[i] = wave_->interpolate( tyme, i );
   }
   else {
     for ( unsigned int i=0; i<lastFrame_.size(); i++ )
-      lastFrame_[i] = data_( (size_t) tyme, i );
+      lastFrame_[i] = (*wave_)( (size_t) tyme, i );
   }
 
   // Increment time, which can be negative.
@@ -16,6 +16,11 @@
     This structure results in one extra multiply per computed sample,
     but allows easy control of the overall filter gain.
 
+    The input history is kept twice in a circular buffer of twice the
+    filter length, so the last N inputs are always contiguous in
+    memory.  Each output is a single dot product (vectorized where the
+    platform allows, see Simd.h) and no history is shifted per sample.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2017.
 */
 /***************************************************/
@@ -30,7 +35,8 @@ Fir :: Fir()
   // The default constructor should setup for pass-through.
   b_.push_back( 1.0 );
 
-  inputs_.resize( 1, 1, 0.0 );
+  inputs_.resize( 2, 1, 0.0 );
+  index_ = 0;
 }
 
 Fir :: Fir( std::vector<StkFloat> &coefficients )
@@ -44,7 +50,8 @@ Fir :: Fir( std::vector<StkFloat> &coefficients )
   gain_ = 1.0;
   b_ = coefficients;
 
-  inputs_.resize( b_.size(), 1, 0.0 );
+  inputs_.resize( 2 * b_.size(), 1, 0.0 );
+  index_ = 0;
   this->clear();
 }
 
@@ -62,7 +69,8 @@ void Fir :: setCoefficients( std::vector<StkFloat> &coefficients, bool clearStat
 
   if ( b_.size() != coefficients.size() ) {
     b_ = coefficients;
-    inputs_.resize( b_.size(), 1, 0.0 );
+    inputs_.resize( 2 * b_.size(), 1, 0.0 );
+    index_ = 0;
   }
   else {
     for ( unsigned int i=0; i<b_.size(); i++ ) b_[i] = coefficients[i];
@@ -0,0 +1,125 @@
+/***************************************************/
+/*! \class FirBank
+    \brief STK bank of finite impulse response filters on one input.
+
+    A set of K filters run on the same input signal, for an analyzer,
+    a crossfade between two filters or the first stages of parallel
+    effect chains, each need the same delay line.  This class keeps a
+    single input history and computes all K outputs in one pass over
+    it, so the history is written once per sample and read once per
+    sample for the whole bank.
+
+    The coefficients are stored interleaved, row j holding tap j of
+    every filter, so each history sample is loaded once and multiplied
+    into a vector of filters at a time (see bankProduct() in Simd.h).
+    The rows are padded to a whole number of vectors.
+    Shorter filters are padded with zeros at the end to the longest
+    length N, so each output is the same, sample for sample, as that
+    of the filter run on its own.  When every padded filter is
+    symmetric, as when linear-phase filters all have the same length,
+    the two history samples that share a row are added first and the
+    bank runs on N/2 rows, as in SymmetricFir.
+
+    One sample of input gives a frame of K outputs, filter k in
+    channel k: see lastFrame() and lastOut().
+*/
+/***************************************************/
+
+#include "FirBank.h"
+#include <algorithm>
+
+namespace stk {
+
+FirBank :: FirBank() : Filter()
+{
+  order_ = 0;
+  std::vector< std::vector<StkFloat> > filters( 1, std::vector<StkFloat>( 1, 1.0 ) );
+  this->setCoefficients( filters, true );
+}
+
+FirBank :: FirBank( const std::vector< std::vector<StkFloat> > &filters ) : Filter()
+{
+  order_ = 0;
+  this->setCoefficients( filters, true );
+}
+
+FirBank :: ~FirBank()
+{
+}
+
+void FirBank :: setCoefficients( const std::vector< std::vector<StkFloat> > &filters, bool clearState )
+{
+  unsigned int order = 0, k, j;
+
+  for ( k=0; k<filters.size(); k++ ) {
+    if ( filters[k].size() == 0 ) {
+      oStream_ << "FirBank::setCoefficients: coefficient vector of filter " << k << " must have size > 0!";
+      handleError( StkError::FUNCTION_ARGUMENT );
+    }
+    order = std::max( order, (unsigned int) filters[k].size() );
+  }
+  if ( order == 0 ) {
+    oStream_ << "FirBank::setCoefficients: there must be at least one filter!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  filters_ = filters.size();
+  stride_ = ( filters_ + SIMD_LANES - 1 ) / SIMD_LANES * SIMD_LANES;
+  lastFrame_.resize( 1, filters_, 0.0 );
+  frame_.resize( stride_ );
+
+  std::vector<StkFloat> padded( order * stride_, 0.0 );
+  StkFloat peak = 0.0;
+  for ( k=0; k<filters_; k++ ) {
+    for ( j=0; j<filters[k].size(); j++ ) {
+      padded[j * stride_ + k] = filters[k][j];
+      peak = std::max( peak, (StkFloat) fabs( filters[k][j] ) );
+    }
+  }
+
+  StkFloat tolerance = 1e-9 * peak;
+  unsigned int half = order / 2;
+  folded_ = order > 1;
+  for ( j=0; j<half && folded_; j++ )
+    for ( k=0; k<filters_; k++ )
+      if ( fabs( padded[j * stride_ + k] - padded[( order - 1 - j ) * stride_ + k] ) > tolerance ) folded_ = false;
+
+  if ( folded_ ) {
+    rows_ = half + ( order & 1 );
+    padded.resize( rows_ * stride_ );
+  }
+  else
+    rows_ = order;
+  coefficients_ = padded;
+
+  if ( order != order_ ) {
+    order_ = order;
+    inputs_.resize( 2 * order_, 1, 0.0 );
+    reversed_.resize( 2 * order_, 1, 0.0 );
+    clearState = true;
+  }
+  sums_.resize( rows_ );
+
+  if ( clearState ) this->clear();
+  else if ( folded_ ) {
+    // Rebuild the reversed history from the forward one, so no state is lost.
+    rIndex_ = order_ - 1 - index_;
+    for ( j=0; j<order_; j++ )
+      reversed_[rIndex_ + 1 + j] = inputs_[index_ + order_ - 1 - j];
+    for ( j=0; j<order_; j++ ) {
+      if ( rIndex_ + 1 + j >= order_ ) reversed_[rIndex_ + 1 + j - order_] = reversed_[rIndex_ + 1 + j];
+      else reversed_[rIndex_ + 1 + j + order_] = reversed_[rIndex_ + 1 + j];
+    }
+  }
+}
+
+void FirBank :: clear( void )
+{
+  Filter::clear();
+  for ( unsigned int i=0; i<reversed_.size(); i++ )
+    reversed_[i] = 0.0;
+  index_ = 0;
+  rIndex_ = order_ - 1;
+}
+
+} // stk namespace
@@ -0,0 +1,485 @@
+/***************************************************/
+/*! \class FirDesign
+    \brief STK linear-phase FIR filter design class.
+
+    This class computes coefficients for the Fir class at run time,
+    for any band edges and sample rate, so filters need not be
+    designed offline for one fixed rate.
+
+    Two methods are provided.  windowedSinc() truncates the ideal
+    response with a Kaiser window whose shape and length follow from
+    the stopband attenuation and transition width, raised until the
+    designed response meets that attenuation.  equiripple() uses
+    the Parks-McClellan (Remez exchange) algorithm, which spreads the
+    error evenly over each band and meets the same specification with
+    fewer taps; its length is raised until the ripple and attenuation
+    asked for are met.
+
+    Band edges are passband edges in Hz.  The stopband begins
+    \e transition Hz beyond each of them.  Lowpass and highpass
+    filters use only \e f1, bandpass and bandstop filters pass or stop
+    \e f1 to \e f2.  All designs have an odd length and symmetric
+    coefficients.
+
+    halfBand() designs the lowpass filter of a decimate or
+    interpolate by 2 stage: its response is symmetric about a quarter
+    of the rate and every second coefficient but the centre one is
+    zero, which MultirateFir skips.  An StkError is thrown if a band does not fit
+    between 0 Hz and the Nyquist frequency.
+*/
+/***************************************************/
+
+#include "FirDesign.h"
+#include <cmath>
+#include <algorithm>
+
+namespace stk {
+
+// Longest design windowedSinc() and equiripple() will try.
+const unsigned int MAX_LENGTH = 4095;
+const unsigned int GRID_DENSITY = 16;
+const unsigned int MAX_ITERATIONS = 100;
+
+// Zeroth order modified Bessel function of the first kind.
+static StkFloat besselI0( StkFloat x )
+{
+  StkFloat sum = 1.0, term = 1.0;
+  for ( unsigned int k=1; k<50; k++ ) {
+    term *= ( x / (2.0 * k) ) * ( x / (2.0 * k) );
+    sum += term;
+    if ( term < sum * 1e-12 ) break;
+  }
+  return sum;
+}
+
+// Ideal lowpass response centred on tap m, cutoff fc as a fraction of the rate.
+static void addLowpass( std::vector<StkFloat> &h, StkFloat fc, StkFloat gain )
+{
+  int m = ( h.size() - 1 ) / 2;
+  for ( int n=0; n<(int)h.size(); n++ ) {
+    int k = n - m;
+    h[n] += gain * ( k == 0 ? 2.0 * fc : sin( 2.0 * PI * fc * k ) / ( PI * k ) );
+  }
+}
+
+static inline unsigned int oddLength( StkFloat n )
+{
+  unsigned int length = (unsigned int) ceil( n );
+  if ( length < 3 ) length = 3;
+  return length | 1;
+}
+
+// Kaiser's estimates for the window shape and length, transition as a fraction of the rate.
+static StkFloat kaiserBeta( StkFloat attenuation )
+{
+  if ( attenuation > 50.0 )
+    return 0.1102 * ( attenuation - 8.7 );
+  if ( attenuation > 21.0 )
+    return 0.5842 * pow( attenuation - 21.0, 0.4 ) + 0.07886 * ( attenuation - 21.0 );
+  return 0.0;
+}
+
+static unsigned int kaiserLength( StkFloat transition, StkFloat attenuation )
+{
+  return oddLength( ( attenuation - 7.95 ) / ( 14.36 * transition ) + 1 );
+}
+
+static void applyKaiser( std::vector<StkFloat> &h, StkFloat beta )
+{
+  StkFloat norm = besselI0( beta );
+  unsigned int length = h.size();
+  for ( unsigned int n=0; n<length; n++ ) {
+    StkFloat x = 2.0 * n / ( length - 1 ) - 1.0;
+    h[n] *= besselI0( beta * sqrt( 1.0 - x * x ) ) / norm;
+  }
+}
+
+void FirDesign :: checkEdges( Type type, StkFloat f1, StkFloat f2, StkFloat transition, StkFloat rate )
+{
+  StkFloat nyquist = rate / 2.0;
+  bool valid = transition > 0.0 && f1 >= 0.0;
+
+  switch ( type ) {
+  case LOWPASS:
+    valid = valid && f1 + transition < nyquist;
+    break;
+  case HIGHPASS:
+    valid = valid && f1 - transition > 0.0 && f1 <= nyquist;
+    break;
+  case BANDPASS:
+    valid = valid && f1 - transition > 0.0 && f1 < f2 && f2 + transition < nyquist;
+    break;
+  case BANDSTOP:
+    valid = valid && f1 > 0.0 && f1 + transition < f2 - transition && f2 < nyquist;
+    break;
+  }
+
+  if ( !valid ) {
+    oStream_ << "FirDesign: band edges " << f1 << " / " << f2 << " Hz with a "
+             << transition << " Hz transition do not fit a " << rate << " Hz rate!";
+    handleError( oStream_.str(), StkError::FUNCTION_ARGUMENT );
+  }
+}
+
+// Kaiser window design with the cutoffs in the middle of the transition bands.
+static std::vector<StkFloat> kaiserSinc( FirDesign::Type type, StkFloat f1, StkFloat f2,
+                                         StkFloat transition, StkFloat attenuation )
+{
+  unsigned int length = kaiserLength( transition, attenuation );
+  std::vector<StkFloat> h( length, 0.0 );
+  unsigned int m = length / 2;
+  StkFloat half = transition / 2.0;
+
+  switch ( type ) {
+  case FirDesign::LOWPASS:
+    addLowpass( h, f1 + half, 1.0 );
+    break;
+  case FirDesign::HIGHPASS:
+    h[m] += 1.0;
+    addLowpass( h, f1 - half, -1.0 );
+    break;
+  case FirDesign::BANDPASS:
+    addLowpass( h, f2 + half, 1.0 );
+    addLowpass( h, f1 - half, -1.0 );
+    break;
+  case FirDesign::BANDSTOP:
+    h[m] += 1.0;
+    addLowpass( h, f2 - half, -1.0 );
+    addLowpass( h, f1 + half, 1.0 );
+    break;
+  }
+
+  applyKaiser( h, kaiserBeta( attenuation ) );
+  return h;
+}
+
+std::vector<StkFloat> FirDesign :: windowedSinc( Type type, StkFloat f1, StkFloat f2,
+                                                 StkFloat transition, StkFloat attenuation,
+                                                 StkFloat rate )
+{
+  checkEdges( type, f1, f2, transition, rate );
+
+  // Kaiser's estimates are for a single edge and fall a little short
+  // of them even then.  With two edges the ripples of both add in the
+  // stopbands, so design for more attenuation, which widens the window
+  // shape and lengthens the filter, until the response meets the
+  // attenuation asked for.
+  std::vector<Band> b = bands( type, f1, f2, transition, rate, 0.0, 1.0 );
+  StkFloat stopGain = pow( 10.0, -attenuation / 20.0 );
+  StkFloat design = attenuation;
+  std::vector<StkFloat> h = kaiserSinc( type, f1 / rate, f2 / rate, transition / rate, design );
+  StkFloat gain = largestError( h, b );
+
+  while ( gain > stopGain && h.size() < MAX_LENGTH ) {
+    StkFloat shortfall = 20.0 * log10( gain / stopGain );
+    design += std::max( shortfall, (StkFloat) 0.1 );
+    h = kaiserSinc( type, f1 / rate, f2 / rate, transition / rate, design );
+    gain = largestError( h, b );
+  }
+
+  if ( gain > stopGain ) {
+    oStream_ << "FirDesign::windowedSinc: specification not met within " << MAX_LENGTH << " taps.";
+    handleError( oStream_.str(), StkError::WARNING );
+    oStream_.str( std::string() );
+  }
+
+  return h;
+}
+
+std::vector<StkFloat> FirDesign :: halfBand( StkFloat transition, StkFloat attenuation, StkFloat rate )
+{
+  if ( transition <= 0.0 || transition >= rate / 2.0 ) {
+    oStream_ << "FirDesign::halfBand: a " << transition << " Hz transition does not fit a "
+             << rate << " Hz rate!";
+    handleError( oStream_.str(), StkError::FUNCTION_ARGUMENT );
+  }
+
+  // (length - 1) / 2 odd, so the outermost taps are not zeros.
+  unsigned int length = kaiserLength( transition / rate, attenuation );
+  if ( ( length / 2 ) % 2 == 0 ) length += 2;
+
+  std::vector<StkFloat> h( length, 0.0 );
+  int m = length / 2;
+  for ( int k=1; k<=m; k+=2 )
+    h[m+k] = h[m-k] = ( k % 4 == 1 ? 1.0 : -1.0 ) / ( PI * k );
+  h[m] = 0.5;
+
+  applyKaiser( h, kaiserBeta( attenuation ) );
+  return h;
+}
+
+std::vector<FirDesign::Band> FirDesign :: bands( Type type, StkFloat f1, StkFloat f2, StkFloat transition,
+                                                 StkFloat rate, StkFloat passWeight, StkFloat stopWeight )
+{
+  std::vector<Band> b;
+  Band pass = { 0.0, 0.0, 1.0, passWeight };
+  Band stop = { 0.0, 0.0, 0.0, stopWeight };
+
+  f1 /= rate;
+  f2 /= rate;
+  transition /= rate;
+
+  switch ( type ) {
+  case LOWPASS:
+    pass.upper = f1;
+    stop.lower = f1 + transition; stop.upper = 0.5;
+    b.push_back( pass ); b.push_back( stop );
+    break;
+  case HIGHPASS:
+    stop.upper = f1 - transition;
+    pass.lower = f1; pass.upper = 0.5;
+    b.push_back( stop ); b.push_back( pass );
+    break;
+  case BANDPASS:
+    stop.upper = f1 - transition;
+    b.push_back( stop );
+    pass.lower = f1; pass.upper = f2;
+    b.push_back( pass );
+    stop.lower = f2 + transition; stop.upper = 0.5;
+    b.push_back( stop );
+    break;
+  case BANDSTOP:
+    pass.upper = f1;
+    b.push_back( pass );
+    stop.lower = f1 + transition; stop.upper = f2 - transition;
+    b.push_back( stop );
+    pass.lower = f2; pass.upper = 0.5;
+    b.push_back( pass );
+    break;
+  }
+
+  return b;
+}
+
+/* Largest weighted error of an odd, symmetric filter over the bands.
+   The response is sampled GRID_DENSITY times per ripple and each
+   peak found is refined with a parabola through its neighbours, so
+   a peak between samples is not missed.
+*/
+StkFloat FirDesign :: largestError( const std::vector<StkFloat> &coefficients, const std::vector<Band> &bands )
+{
+  unsigned int m = coefficients.size() / 2;
+  double largest = 0.0;
+  for ( unsigned int i=0; i<bands.size(); i++ ) {
+    if ( bands[i].weight == 0.0 ) continue;
+    unsigned int points = 3 + (unsigned int) ( GRID_DENSITY * coefficients.size() * ( bands[i].upper - bands[i].lower ) );
+    std::vector<double> error( points );
+    for ( unsigned int k=0; k<points; k++ ) {
+      double f = bands[i].lower + k * ( bands[i].upper - bands[i].lower ) / ( points - 1 );
+      double a = coefficients[m];
+      for ( unsigned int n=1; n<=m; n++ )
+        a += 2.0 * coefficients[m+n] * cos( 2.0 * PI * f * n );
+      error[k] = bands[i].weight * fabs( bands[i].desired - a );
+    }
+
+    largest = std::max( largest, std::max( error.front(), error.back() ) );
+    for ( unsigned int k=1; k<points-1; k++ ) {
+      double curve = 2.0 * error[k] - error[k-1] - error[k+1];
+      if ( error[k] < error[k-1] || error[k] < error[k+1] || curve <= 0.0 ) continue;
+      double slope = error[k-1] - error[k+1];
+      largest = std::max( largest, error[k] + slope * slope / ( 8.0 * curve ) );
+    }
+  }
+  return largest;
+}
+
+/* Parks-McClellan design of an odd, symmetric filter of the given
+   length.  The amplitude response A(x), x = cos(2 pi f), is a
+   polynomial of degree M = (length - 1) / 2.  Each pass of the Remez
+   exchange fits A through M + 2 extremal frequencies with an error of
+   equal size and alternating sign, then moves the extremals to the
+   peaks of the new error curve, until the peaks are all of one size.
+   The largest weighted error of the filter designed is returned,
+   which is the deviation reached once the exchange has converged,
+   and larger when it has not.  It works in double even in a float
+   build, since the interpolation weights are products of M terms and
+   leave the float range for long filters.
+*/
+StkFloat FirDesign :: remez( std::vector<StkFloat> &coefficients, unsigned int length,
+                             const std::vector<Band> &bands )
+{
+  unsigned int m = ( length - 1 ) / 2;
+  unsigned int r = m + 2;
+  unsigned int i, k, g;
+
+  // Dense grid over the bands, in proportion to their widths.
+  double total = 0.0;
+  for ( i=0; i<bands.size(); i++ ) total += bands[i].upper - bands[i].lower;
+
+  std::vector<double> x, desired, weight;
+  std::vector<unsigned int> band;
+  for ( i=0; i<bands.size(); i++ ) {
+    unsigned int points = 2 + (unsigned int) ( GRID_DENSITY * r * ( bands[i].upper - bands[i].lower ) / total );
+    for ( k=0; k<points; k++ ) {
+      double f = bands[i].lower + k * ( bands[i].upper - bands[i].lower ) / ( points - 1 );
+      x.push_back( cos( 2.0 * PI * f ) );
+      desired.push_back( bands[i].desired );
+      weight.push_back( bands[i].weight );
+      band.push_back( i );
+    }
+  }
+  unsigned int grid = x.size();
+
+  std::vector<unsigned int> ext( r );
+  for ( k=0; k<r; k++ ) ext[k] = (unsigned long) k * ( grid - 1 ) / ( r - 1 );
+
+  std::vector<double> xk( r ), c( r ), b( r ), error( grid );
+  std::vector<unsigned int> found;
+  double delta = 0.0;
+
+  for ( unsigned int iteration=0; iteration<MAX_ITERATIONS; iteration++ ) {
+    for ( k=0; k<r; k++ ) xk[k] = x[ext[k]];
+
+    // Deviation for an alternating fit through all r points.
+    double num = 0.0, den = 0.0;
+    for ( k=0; k<r; k++ ) {
+      double w = 1.0;
+      for ( i=0; i<r; i++ )
+        if ( i != k ) w *= 2.0 * ( xk[k] - xk[i] );
+      w = 1.0 / w;
+      num += w * desired[ext[k]];
+      den += ( k & 1 ? -w : w ) / weight[ext[k]];
+    }
+    delta = num / den;
+
+    // Barycentric weights for interpolating through the first r - 1 points.
+    for ( k=0; k<r-1; k++ ) {
+      c[k] = desired[ext[k]] - ( k & 1 ? -delta : delta ) / weight[ext[k]];
+      double w = 1.0;
+      for ( i=0; i<r-1; i++ )
+        if ( i != k ) w *= 2.0 * ( xk[k] - xk[i] );
+      b[k] = 1.0 / w;
+    }
+
+    for ( g=0; g<grid; g++ ) {
+      double sn = 0.0, sd = 0.0, a = 0.0;
+      for ( k=0; k<r-1; k++ ) {
+        double d = x[g] - xk[k];
+        if ( d == 0.0 ) { a = c[k]; sd = 0.0; break; }
+        sn += b[k] * c[k] / d;
+        sd += b[k] / d;
+      }
+      if ( sd != 0.0 ) a = sn / sd;
+      error[g] = weight[g] * ( desired[g] - a );
+    }
+
+    // Local peaks of the error, each band on its own.
+    found.clear();
+    for ( g=0; g<grid; g++ ) {
+      bool left = g == 0 || band[g-1] != band[g];
+      bool right = g == grid - 1 || band[g+1] != band[g];
+      double e = error[g];
+      if ( e > 0.0 ) {
+        if ( ( left || e >= error[g-1] ) && ( right || e > error[g+1] ) ) found.push_back( g );
+      }
+      else if ( e < 0.0 ) {
+        if ( ( left || e <= error[g-1] ) && ( right || e < error[g+1] ) ) found.push_back( g );
+      }
+    }
+
+    // Keep the larger of neighbouring peaks of the same sign.
+    std::vector<unsigned int> alt;
+    for ( i=0; i<found.size(); i++ ) {
+      if ( !alt.empty() && ( error[alt.back()] > 0.0 ) == ( error[found[i]] > 0.0 ) ) {
+        if ( fabs( error[found[i]] ) > fabs( error[alt.back()] ) ) alt.back() = found[i];
+      }
+      else alt.push_back( found[i] );
+    }
+
+    // Too many: drop the smallest peaks, in pairs inside the set so
+    // that the signs still alternate.
+    while ( alt.size() > r ) {
+      if ( alt.size() == r + 1 ) {
+        if ( fabs( error[alt.front()] ) < fabs( error[alt.back()] ) ) alt.erase( alt.begin() );
+        else alt.pop_back();
+        continue;
+      }
+      unsigned int j = 0;
+      for ( i=1; i<alt.size(); i++ )
+        if ( fabs( error[alt[i]] ) < fabs( error[alt[j]] ) ) j = i;
+      if ( j > 0 && j < alt.size() - 1 ) {
+        if ( fabs( error[alt[j-1]] ) < fabs( error[alt[j+1]] ) ) j--;
+        alt.erase( alt.begin() + j, alt.begin() + j + 2 );
+      }
+      else alt.erase( alt.begin() + j );
+    }
+    if ( alt.size() < r ) break;
+
+    double largest = 0.0, smallest = 1e300;
+    for ( k=0; k<r; k++ ) {
+      largest = std::max( largest, fabs( error[alt[k]] ) );
+      smallest = std::min( smallest, fabs( error[alt[k]] ) );
+    }
+    bool same = std::equal( alt.begin(), alt.end(), ext.begin() );
+    ext = alt;
+    if ( same || ( largest - smallest ) <= 1e-6 * largest ) break;
+  }
+
+  // Sample A at the DFT frequencies and transform back to taps.
+  std::vector<double> a( m + 1 );
+  for ( k=0; k<=m; k++ ) {
+    double xf = cos( 2.0 * PI * k / length );
+    double sn = 0.0, sd = 0.0, value = 0.0;
+    for ( i=0; i<r-1; i++ ) {
+      double d = xf - xk[i];
+      if ( d == 0.0 ) { value = c[i]; sd = 0.0; break; }
+      sn += b[i] * c[i] / d;
+      sd += b[i] / d;
+    }
+    a[k] = sd != 0.0 ? sn / sd : value;
+  }
+
+  coefficients.assign( length, 0.0 );
+  for ( unsigned int n=0; n<length; n++ ) {
+    double sum = a[0];
+    for ( k=1; k<=m; k++ )
+      sum += 2.0 * a[k] * cos( 2.0 * PI * k * ( (int) n - (int) m ) / length );
+    coefficients[n] = sum / length;
+  }
+
+  return largestError( coefficients, bands );
+}
+
+std::vector<StkFloat> FirDesign :: equiripple( Type type, StkFloat f1, StkFloat f2,
+                                               StkFloat transition, StkFloat attenuation,
+                                               StkFloat ripple, StkFloat rate )
+{
+  checkEdges( type, f1, f2, transition, rate );
+
+  StkFloat g = pow( 10.0, ripple / 20.0 );
+  StkFloat passDev = ( g - 1.0 ) / ( g + 1.0 );
+  StkFloat stopDev = pow( 10.0, -attenuation / 20.0 );
+
+  // With these weights the specification is met when the weighted deviation is below passDev.
+  std::vector<Band> b = bands( type, f1, f2, transition, rate, 1.0, passDev / stopDev );
+
+  // Kaiser's length estimate, then the shortest length that meets the specification.
+  unsigned int length = oddLength( ( -20.0 * log10( sqrt( passDev * stopDev ) ) - 13.0 )
+                                   / ( 14.6 * transition / rate ) + 1 );
+  std::vector<StkFloat> h, best;
+  bool met = remez( h, length, b ) <= passDev;
+
+  if ( met ) {
+    best = h;
+    while ( length > 3 && remez( h, length - 2, b ) <= passDev ) {
+      length -= 2;
+      best = h;
+    }
+  }
+  else {
+    while ( !met && length + 2 <= MAX_LENGTH ) {
+      length += 2;
+      met = remez( h, length, b ) <= passDev;
+    }
+    best = h;
+    if ( !met ) {
+      oStream_ << "FirDesign::equiripple: specification not met within " << MAX_LENGTH << " taps.";
+      handleError( oStream_.str(), StkError::WARNING );
+      oStream_.str( std::string() );
+    }
+  }
+
+  return best;
+}
+
+} // stk namespace
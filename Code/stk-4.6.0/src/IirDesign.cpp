@@ -0,0 +1,151 @@
+/***************************************************/
+/*! \class IirDesign
+    \brief STK Chebyshev IIR filter design class.
+
+    This class computes the sections of a Sos filter at run time from
+    the same band specification as FirDesign: passband edges in Hz,
+    the stopband beginning \e transition Hz beyond each of them,
+    \e ripple dB of passband ripple and \e attenuation dB of stopband
+    rejection.
+
+    chebyshev() designs a Chebyshev type I filter of the lowest order
+    that meets the specification.  The analog prototype is moved to
+    the band edges and mapped to the z-plane with the bilinear
+    transform, prewarped so the passband edges fall exactly where
+    asked.  The poles are computed directly, never the polynomial
+    coefficients, so high orders stay accurate.  An IIR filter meets a
+    steep specification with a small fraction of the multiplies of a
+    linear-phase FIR, at the cost of a phase response that is not
+    linear.
+
+    An StkError is thrown if a band does not fit between 0 Hz and
+    the Nyquist frequency or the order would exceed 32.
+*/
+/***************************************************/
+
+#include "IirDesign.h"
+#include <cmath>
+#include <algorithm>
+
+namespace stk {
+
+typedef std::complex<double> Complex;
+
+// Highest prototype order chebyshev() will design.
+const unsigned int MAX_ORDER = 32;
+
+// Analog frequency of f Hz after prewarping for the bilinear transform.
+static double warp( StkFloat f, StkFloat rate )
+{
+  return 2.0 * tan( PI * f / rate );
+}
+
+// The bilinear transform, s = 2 (z - 1) / (z + 1).
+static std::complex<StkFloat> bilinear( Complex s )
+{
+  Complex z = ( 2.0 + s ) / ( 2.0 - s );
+  return std::complex<StkFloat>( z.real(), z.imag() );
+}
+
+// Magnitude of the cascade at e^(j omega).
+static double magnitude( const std::vector<Sos::Section> &sections, double omega )
+{
+  Complex z1 = std::polar( 1.0, -omega ), z2 = z1 * z1;
+  Complex h = 1.0;
+  for ( unsigned int i=0; i<sections.size(); i++ ) {
+    const Sos::Section &s = sections[i];
+    h *= ( (double) s.b0 + (double) s.b1 * z1 + (double) s.b2 * z2 ) / ( 1.0 + (double) s.a1 * z1 + (double) s.a2 * z2 );
+  }
+  return std::abs( h );
+}
+
+std::vector<Sos::Section> IirDesign :: chebyshev( Type type, StkFloat f1, StkFloat f2,
+                                                  StkFloat transition, StkFloat attenuation,
+                                                  StkFloat ripple, StkFloat rate )
+{
+  checkEdges( type, f1, f2, transition, rate );
+
+  // Prewarped passband edge, bandwidth and centre, and the stopband edge
+  // of the lowpass prototype with its passband edge at 1.
+  double edge = warp( f1, rate ), width = 0.0, centre = 0.0, stop = 0.0;
+  double omega = 0.0;  // where the response is set, in radians per sample
+  switch ( type ) {
+  case LOWPASS:
+    stop = warp( f1 + transition, rate ) / edge;
+    break;
+  case HIGHPASS:
+    stop = edge / warp( f1 - transition, rate );
+    omega = PI;
+    break;
+  case BANDPASS:
+  case BANDSTOP: {
+    double upper = warp( f2, rate );
+    width = upper - edge;
+    centre = sqrt( edge * upper );
+    double s1 = ( type == BANDPASS ) ? warp( f1 - transition, rate ) : warp( f1 + transition, rate );
+    double s2 = ( type == BANDPASS ) ? warp( f2 + transition, rate ) : warp( f2 - transition, rate );
+    double p1 = fabs( ( s1 * s1 - centre * centre ) / ( width * s1 ) );
+    double p2 = fabs( ( s2 * s2 - centre * centre ) / ( width * s2 ) );
+    if ( type == BANDPASS ) {
+      stop = std::min( p1, p2 );
+      omega = 2.0 * atan( centre / 2.0 );
+    }
+    else
+      stop = std::min( 1.0 / p1, 1.0 / p2 );
+    break;
+  }
+  }
+
+  double epsilon = sqrt( pow( 10.0, ripple / 10.0 ) - 1.0 );
+  double order = acosh( sqrt( pow( 10.0, attenuation / 10.0 ) - 1.0 ) / epsilon ) / acosh( stop );
+  if ( !( order <= MAX_ORDER ) ) {
+    oStream_ << "IirDesign::chebyshev: the specification needs an order above " << MAX_ORDER << "!";
+    handleError( oStream_.str(), StkError::FUNCTION_ARGUMENT );
+  }
+  unsigned int n = std::max( 1, (int) ceil( order - 1e-9 ) );
+
+  // Prototype poles on an ellipse, moved to the band.
+  std::vector< std::complex<StkFloat> > zeros, poles;
+  double mu = asinh( 1.0 / epsilon ) / n;
+  for ( unsigned int k=1; k<=n; k++ ) {
+    double theta = PI * ( 2 * k - 1 ) / ( 2.0 * n );
+    Complex p( -sinh( mu ) * sin( theta ), cosh( mu ) * cos( theta ) );
+    switch ( type ) {
+    case LOWPASS:
+      poles.push_back( bilinear( edge * p ) );
+      zeros.push_back( -1.0 );
+      break;
+    case HIGHPASS:
+      poles.push_back( bilinear( edge / p ) );
+      zeros.push_back( 1.0 );
+      break;
+    case BANDPASS:
+    case BANDSTOP: {
+      Complex q = ( type == BANDPASS ) ? p * width : width / p;
+      Complex root = sqrt( q * q - 4.0 * centre * centre );
+      poles.push_back( bilinear( ( q + root ) / 2.0 ) );
+      poles.push_back( bilinear( ( q - root ) / 2.0 ) );
+      if ( type == BANDPASS ) {
+        zeros.push_back( 1.0 );
+        zeros.push_back( -1.0 );
+      }
+      else {
+        zeros.push_back( bilinear( Complex( 0.0, centre ) ) );
+        zeros.push_back( bilinear( Complex( 0.0, -centre ) ) );
+      }
+      break;
+    }
+    }
+  }
+
+  // Odd orders peak at the reference frequency, even ones sit at the bottom of the ripple.
+  std::vector<Sos::Section> sections = Sos::fromRoots( zeros, poles, 1.0 );
+  double target = ( n & 1 ) ? 1.0 : 1.0 / sqrt( 1.0 + epsilon * epsilon );
+  double gain = target / magnitude( sections, omega );
+  sections[0].b0 *= gain;
+  sections[0].b1 *= gain;
+  sections[0].b2 *= gain;
+  return sections;
+}
+
+} // stk namespace
@@ -19,10 +19,10 @@ LentPitShift::LentPitShift( StkFloat periodRatio, int tMax )
 	window = new StkFloat[2*tMax_]; // Allocation of the array for the hamming window
 	threshold_ = 0.1;               // Default threshold for pitch tracking
 
-	dt = new StkFloat[tMax+1]; // Allocation of the euclidian distance coefficient array.  The first one is never used.
-	cumDt = new StkFloat[tMax+1];  // Allocation of the cumulative sum array
+	dt = new double[tMax+1];       // Allocation of the euclidian distance coefficient array.  The first one is never used.
+	cumDt = new double[tMax+1];    // Allocation of the cumulative sum array
 	cumDt[0] = 0.;                 // Initialization of the first coefficient of the cumulative sum
-	dpt = new StkFloat[tMax+1];    // Allocation of the pitch tracking function coefficient array
+	dpt = new double[tMax+1];      // Allocation of the pitch tracking function coefficient array
 	dpt[0]   = 1.;                 // Initialization of the first coefficient of dpt which is always the same
 
 	// Initialisation of the input and output delay lines
@@ -38,19 +38,20 @@ Mandolin :: Mandolin( StkFloat lowestFrequency )
     handleError( StkError::FUNCTION_ARGUMENT );
   }
 
-  // Concatenate the STK rawwave path to the rawwave files
-  soundfile_[0].openFile( (Stk::rawwavePath() + "mand1.raw").c_str(), true );
-  soundfile_[1].openFile( (Stk::rawwavePath() + "mand2.raw").c_str(), true );
-  soundfile_[2].openFile( (Stk::rawwavePath() + "mand3.raw").c_str(), true );
-  soundfile_[3].openFile( (Stk::rawwavePath() + "mand4.raw").c_str(), true );
-  soundfile_[4].openFile( (Stk::rawwavePath() + "mand5.raw").c_str(), true );
-  soundfile_[5].openFile( (Stk::rawwavePath() + "mand6.raw").c_str(), true );
-  soundfile_[6].openFile( (Stk::rawwavePath() + "mand7.raw").c_str(), true );
-  soundfile_[7].openFile( (Stk::rawwavePath() + "mand8.raw").c_str(), true );
-  soundfile_[8].openFile( (Stk::rawwavePath() + "mand9.raw").c_str(), true );
-  soundfile_[9].openFile( (Stk::rawwavePath() + "mand10.raw").c_str(), true );
-  soundfile_[10].openFile( (Stk::rawwavePath() + "mand11.raw").c_str(), true );
-  soundfile_[11].openFile( (Stk::rawwavePath() + "mand12.raw").c_str(), true );
+  // Concatenate the STK rawwave path to the rawwave files, whose data
+  // is shared with every other Mandolin.
+  soundfile_[0].openShared( Stk::rawwavePath() + "mand1.raw", true );
+  soundfile_[1].openShared( Stk::rawwavePath() + "mand2.raw", true );
+  soundfile_[2].openShared( Stk::rawwavePath() + "mand3.raw", true );
+  soundfile_[3].openShared( Stk::rawwavePath() + "mand4.raw", true );
+  soundfile_[4].openShared( Stk::rawwavePath() + "mand5.raw", true );
+  soundfile_[5].openShared( Stk::rawwavePath() + "mand6.raw", true );
+  soundfile_[6].openShared( Stk::rawwavePath() + "mand7.raw", true );
+  soundfile_[7].openShared( Stk::rawwavePath() + "mand8.raw", true );
+  soundfile_[8].openShared( Stk::rawwavePath() + "mand9.raw", true );
+  soundfile_[9].openShared( Stk::rawwavePath() + "mand10.raw", true );
+  soundfile_[10].openShared( Stk::rawwavePath() + "mand11.raw", true );
+  soundfile_[11].openShared( Stk::rawwavePath() + "mand12.raw", true );
 
   mic_ = 0;
   detuning_ = 0.995;
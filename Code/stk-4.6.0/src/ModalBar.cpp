@@ -37,8 +37,10 @@ namespace stk {
 ModalBar :: ModalBar( void )
   : Modal()
 {
-  // Concatenate the STK rawwave path to the rawwave file
-  wave_ = new FileWvIn( (Stk::rawwavePath() + "marmstk1.raw").c_str(), true );
+  // Concatenate the STK rawwave path to the rawwave file, whose data
+  // is shared with every other ModalBar.
+  wave_ = new FileWvIn();
+  wave_->openShared( Stk::rawwavePath() + "marmstk1.raw", true );
   wave_->setRate( 0.5 * 22050.0 / Stk::sampleRate() );
 
   // Set the resonances for preset 0 (marimba).
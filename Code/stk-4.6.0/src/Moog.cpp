@@ -25,10 +25,14 @@ namespace stk {
 
 Moog :: Moog( void )
 {
-  // Concatenate the STK rawwave path to the rawwave file
-  attacks_.push_back( new FileWvIn( (Stk::rawwavePath() + "mandpluk.raw").c_str(), true ) );
-  loops_.push_back ( new FileLoop( (Stk::rawwavePath() + "impuls20.raw").c_str(), true ) );
-  loops_.push_back ( new FileLoop( (Stk::rawwavePath() + "sinewave.raw").c_str(), true ) ); // vibrato
+  // Concatenate the STK rawwave path to the rawwave files, whose data
+  // is shared with every other instrument that uses them.
+  attacks_.push_back( new FileWvIn() );
+  attacks_[0]->openShared( Stk::rawwavePath() + "mandpluk.raw", true );
+  loops_.push_back ( new FileLoop() );
+  loops_[0]->openShared( Stk::rawwavePath() + "impuls20.raw", true );
+  loops_.push_back ( new FileLoop() ); // vibrato
+  loops_[1]->openShared( Stk::rawwavePath() + "sinewave.raw", true );
   loops_[1]->setFrequency( 6.122 );
 
   filters_[0].setTargets( 0.0, 0.7 );
@@ -108,4 +112,27 @@ void Moog :: controlChange( int number, StkFloat value )
 #endif
 }
 
+void Moog :: process( StkFramesView frames, unsigned int n )
+{
+  // Once the attack wave has finished it only returns zeros, so it is
+  // skipped for the whole block.
+  bool attack = !attacks_[0]->isFinished();
+
+  StkFloat temp;
+  for ( unsigned int i=0; i<n; i++ ) {
+    if ( modDepth_ != 0.0 ) {
+      temp = loops_[1]->tick() * modDepth_;
+      loops_[0]->setFrequency( baseFrequency_ * (1.0 + temp) );
+    }
+
+    temp = attackGain_ * ( attack ? attacks_[0]->tick() : 0.0 );
+    temp += loopGain_ * loops_[0]->tick();
+    temp = filter_.tick( temp );
+    temp *= adsr_.tick();
+    temp = filters_[0].tick( temp );
+    lastFrame_[0] = filters_[1].tick( temp );
+    frames( i, 0 ) = lastFrame_[0] * 6.0;
+  }
+}
+
 } // stk namespace
@@ -0,0 +1,208 @@
+/***************************************************/
+/*! \class MultirateFir
+    \brief STK multirate finite impulse response filter class.
+
+    A filter whose passband and transition band sit in the lowest
+    part of the spectrum does not need the full sample rate.  This
+    class decimates its input by 2 in each of a number of stages,
+    runs a SymmetricFir at the reduced rate and interpolates the
+    result back up by 2 in as many stages.  The core filter is
+    designed for the reduced rate, so it is shorter by the same factor
+    and runs once every 2^stages samples.  A 500 Hz lowpass with a
+    200 Hz transition and 60 dB of attenuation, 473 taps at 44.1 kHz,
+    becomes four stages around a 31 tap core and runs about six times
+    faster.
+
+    Each stage is a polyphase half-band filter (see
+    FirDesign::halfBand()).  Half its coefficients are zero, so the
+    decimator computes one output per two inputs from the nonzero
+    ones only, and one phase of the interpolator is a plain delay.
+    The StkFrames tick functions run each stage over a whole chunk of
+    samples before the next one.
+    A stage passes everything up to the highest band edge of the
+    filter (passband plus transition) and stops what would alias onto
+    it.  The first stages, where the edge is a small fraction of the
+    rate, get by with a few taps; the edge may reach 7/32 of the rate
+    of the last one, and stagesFor() returns how many stages that
+    allows.  With zero stages the class is a SymmetricFir.
+
+    Use setStages() before setCoefficients(), whose coefficients are
+    those of the core filter at the rate divided by 2^stages.
+*/
+/***************************************************/
+
+#include "MultirateFir.h"
+#include "FirDesign.h"
+#include <algorithm>
+
+namespace stk {
+
+const unsigned int MAX_STAGES = 6;
+
+// Samples per pass of computeBlock().
+const unsigned int CHUNK = 256;
+
+// Highest band edge a stage keeps, as a fraction of its input rate.
+const StkFloat HALFBAND_EDGE = 7.0 / 32.0;
+
+MultirateFir :: MultirateFir() : Filter()
+{
+  stages_ = 0;
+  coreLength_ = 1;
+  coreOut_ = 0.0;
+}
+
+MultirateFir :: ~MultirateFir()
+{
+}
+
+unsigned int MultirateFir :: stagesFor( StkFloat edge, StkFloat rate )
+{
+  unsigned int stages = 0;
+  while ( stages < MAX_STAGES && edge <= HALFBAND_EDGE * rate ) {
+    rate /= 2.0;
+    stages++;
+  }
+  return stages;
+}
+
+void MultirateFir :: setStages( unsigned int stages, StkFloat edge, StkFloat attenuation, StkFloat rate )
+{
+  if ( stages > stagesFor( edge, rate ) ) {
+    oStream_ << "MultirateFir::setStages: a " << edge << " Hz band edge does not allow "
+             << stages << " stages at a " << rate << " Hz rate!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  stages_ = stages;
+  stage_.resize( stages_ );
+  for ( unsigned int s=0; s<stages_; s++, rate /= 2.0 ) {
+    // Symmetric about a quarter of the rate: the stopband starts as far below half the rate as the edge is above 0.
+    std::vector<StkFloat> h = FirDesign::halfBand( rate / 2.0 - 2.0 * edge, attenuation, rate );
+    Stage &stage = stage_[s];
+    stage.center = h.size() / 2;
+    stage.taps.resize( stage.center + 1 );
+    for ( unsigned int i=0; i<=stage.center; i++ )
+      stage.taps[i] = h[2*i];
+    stage.block.resize( ( CHUNK >> s ) + 1 );
+  }
+  coreBlock_.resize( ( CHUNK >> stages_ ) + 1 );
+
+  this->clear();
+}
+
+void MultirateFir :: setCoefficients( std::vector<StkFloat> &coefficients, bool clearState )
+{
+  core_.setCoefficients( coefficients, clearState );
+  coreLength_ = coefficients.size();
+  if ( clearState ) this->clear();
+}
+
+unsigned long MultirateFir :: getLength( void ) const
+{
+  unsigned long factor = 1ul << stages_;
+  unsigned long length = ( coreLength_ - 1 ) * factor + 1;
+
+  // The decimator and interpolator of stage s each add 2M taps at 2^s times the full rate.
+  for ( unsigned int s=0; s<stages_; s++ )
+    length += 2 * ( 2 * stage_[s].center ) * ( 1ul << s );
+  return length;
+}
+
+// One stage over a chunk: n inputs in, the number of outputs returned.
+unsigned int MultirateFir :: decimate( Stage &d, const StkFloat *in, unsigned int n, StkFloat *out )
+{
+  unsigned int m = 0;
+
+  for ( unsigned int i=0; i<n; i++ ) {
+    if ( d.oddIn ) {
+      d.odd.push( in[i] );
+      d.oddIn = false;
+      continue;
+    }
+    d.even.push( in[i] );
+    d.oddIn = true;
+    out[m++] = halfBandSum( &d.taps[0], d.even.newest(), d.center + 1 )
+      + 0.5 * d.odd.newest()[( d.center - 1 ) / 2];
+  }
+  return m;
+}
+
+// n outputs, taking inputs from in as the even phases need them.
+void MultirateFir :: interpolate( Stage &u, const StkFloat *in, unsigned int n, StkFloat *out )
+{
+  for ( unsigned int i=0; i<n; i++ ) {
+    if ( u.oddOut ) {
+      out[i] = u.inputs.newest()[( u.center - 1 ) / 2];
+      u.oddOut = false;
+      continue;
+    }
+    u.inputs.push( *in++ );
+    u.oddOut = true;
+    out[i] = 2.0 * halfBandSum( &u.taps[0], u.inputs.newest(), u.center + 1 );
+  }
+}
+
+/* The chunk is decimated stage by stage down to the core rate, filtered
+   there and interpolated back up.  A stage takes exactly as many
+   samples as the one above made, so this matches computeSample() one
+   sample at a time.
+*/
+void MultirateFir :: computeBlock( const StkFloat *input, unsigned int iHop,
+                                   StkFloat *output, unsigned int oHop, unsigned int n )
+{
+  unsigned int length[MAX_STAGES + 1];
+  unsigned int s, i;
+
+  if ( stages_ == 0 ) {
+    for ( i=0; i<n; i++, input += iHop, output += oHop )
+      *output = core_.tick( gain_ * *input );
+    return;
+  }
+
+  while ( n > 0 ) {
+    unsigned int count = std::min( n, CHUNK );
+    StkFloat *top = &stage_[0].block[0];
+
+    for ( i=0; i<count; i++ )
+      top[i] = gain_ * input[i * iHop];
+
+    length[0] = count;
+    for ( s=0; s<stages_; s++ ) {
+      StkFloat *next = ( s + 1 < stages_ ) ? &stage_[s+1].block[0] : &coreBlock_[0];
+      length[s+1] = decimate( stage_[s], &stage_[s].block[0], length[s], next );
+    }
+
+    for ( i=0; i<length[stages_]; i++ )
+      coreOut_ = coreBlock_[i] = core_.tick( coreBlock_[i] );
+
+    for ( s=stages_; s-- > 0; ) {
+      const StkFloat *below = ( s + 1 < stages_ ) ? &stage_[s+1].block[0] : &coreBlock_[0];
+      interpolate( stage_[s], below, length[s], &stage_[s].block[0] );
+    }
+
+    for ( i=0; i<count; i++ )
+      output[i * oHop] = top[i];
+
+    input += count * iHop;
+    output += count * oHop;
+    n -= count;
+  }
+}
+
+void MultirateFir :: clear( void )
+{
+  for ( unsigned int s=0; s<stages_; s++ ) {
+    Stage &stage = stage_[s];
+    stage.even.resize( stage.center + 1 );
+    stage.odd.resize( ( stage.center + 1 ) / 2 );
+    stage.inputs.resize( stage.center + 1 );
+    stage.oddIn = false;
+    stage.oddOut = false;
+  }
+  core_.clear();
+  coreOut_ = 0.0;
+  lastFrame_[0] = 0.0;
+}
+
+} // stk namespace
@@ -0,0 +1,182 @@
+/***************************************************/
+/*! \class Realtime
+    \brief STK realtime thread setup class.
+
+    This class gathers the calls an audio thread needs before it
+    enters its processing loop: SCHED_FIFO priority, pinning to one
+    CPU, locking the process memory with mlockall() and prefaulting
+    the thread's stack so that the first periods do not take page
+    faults.
+
+    Every function falls back gracefully.  When the process lacks the
+    privilege (e.g. no CAP_SYS_NICE or RLIMIT_RTPRIO, or too small an
+    RLIMIT_MEMLOCK) a warning is printed and false is returned, and
+    the thread keeps running as it was.  Affinity is only supported
+    under Linux, priority and memory locking on all pthread systems.
+
+    The functions act on the calling thread.  Thread::start() can
+    apply them to a new thread before its routine runs.
+*/
+/***************************************************/
+
+#include "Realtime.h"
+#include <cstring>
+#include <cerrno>
+
+#if (defined(__OS_IRIX__) || defined(__OS_LINUX__) || defined(__OS_MACOSX__))
+  #include <pthread.h>
+  #include <sched.h>
+  #include <unistd.h>
+  #include <alloca.h>
+  #include <sys/mman.h>
+#elif defined(__OS_WINDOWS__)
+  #include <windows.h>
+  #include <malloc.h>
+#endif
+
+namespace stk {
+
+void Realtime :: warn( void )
+{
+  handleError( oStream_.str(), StkError::WARNING );
+  oStream_.str( std::string() );
+}
+
+bool Realtime :: setPriority( int priority )
+{
+#if (defined(__OS_IRIX__) || defined(__OS_LINUX__) || defined(__OS_MACOSX__))
+
+  struct sched_param param;
+  int min = sched_get_priority_min( SCHED_FIFO );
+  int max = sched_get_priority_max( SCHED_FIFO );
+
+  if ( priority < min ) priority = min;
+  if ( priority > max ) priority = max;
+  param.sched_priority = priority;
+
+  int err = pthread_setschedparam( pthread_self(), SCHED_FIFO, &param );
+  if ( err == 0 ) return true;
+
+  oStream_ << "Realtime::setPriority: cannot run at SCHED_FIFO priority " << priority
+           << " (" << strerror( err ) << "), staying at normal priority.";
+  warn();
+
+#elif defined(__OS_WINDOWS__)
+
+  if ( SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL ) )
+    return true;
+
+  oStream_ << "Realtime::setPriority: cannot raise the thread priority.";
+  warn();
+
+#endif
+  return false;
+}
+
+bool Realtime :: setAffinity( int cpu )
+{
+#if defined(__OS_LINUX__)
+
+  cpu_set_t set;
+
+  if ( cpu < 0 || cpu >= CPU_SETSIZE ) {
+    oStream_ << "Realtime::setAffinity: CPU " << cpu << " is out of range.";
+    warn();
+    return false;
+  }
+
+  CPU_ZERO( &set );
+  CPU_SET( cpu, &set );
+  int err = pthread_setaffinity_np( pthread_self(), sizeof(set), &set );
+  if ( err == 0 ) return true;
+
+  oStream_ << "Realtime::setAffinity: cannot pin the thread to CPU " << cpu
+           << " (" << strerror( err ) << ").";
+  warn();
+
+#else
+
+  (void) cpu;
+  oStream_ << "Realtime::setAffinity: CPU affinity is not supported on this system.";
+  warn();
+
+#endif
+  return false;
+}
+
+bool Realtime :: avoidCpu( int cpu )
+{
+#if defined(__OS_LINUX__)
+
+  cpu_set_t set;
+
+  if ( cpu < 0 || cpu >= CPU_SETSIZE ) return false;
+
+  int err = pthread_getaffinity_np( pthread_self(), sizeof(set), &set );
+  if ( err == 0 ) {
+    if ( !CPU_ISSET( cpu, &set ) ) return true;
+    // Leaving no CPU at all would fail, keep the thread where it is.
+    if ( CPU_COUNT( &set ) == 1 ) return false;
+    CPU_CLR( cpu, &set );
+    err = pthread_setaffinity_np( pthread_self(), sizeof(set), &set );
+    if ( err == 0 ) return true;
+  }
+
+  oStream_ << "Realtime::avoidCpu: cannot move the thread off CPU " << cpu
+           << " (" << strerror( err ) << ").";
+  warn();
+
+#else
+
+  (void) cpu;
+
+#endif
+  return false;
+}
+
+bool Realtime :: lockMemory( void )
+{
+#if (defined(__OS_IRIX__) || defined(__OS_LINUX__) || defined(__OS_MACOSX__))
+
+  if ( mlockall( MCL_CURRENT | MCL_FUTURE ) == 0 ) return true;
+
+  oStream_ << "Realtime::lockMemory: mlockall failed (" << strerror( errno )
+           << "), memory may be paged out.";
+  warn();
+
+#endif
+  return false;
+}
+
+void Realtime :: prefaultStack( size_t bytes )
+{
+  // Write a byte every kilobyte so every page is faulted in (and, after
+  // lockMemory(), locked) now rather than in the processing loop.
+  volatile unsigned char *stack = (volatile unsigned char *) alloca( bytes );
+  for ( size_t i = 0; i < bytes; i += 1024 )
+    stack[i] = 0;
+}
+
+bool Realtime :: setupThread( int priority, int cpu, size_t stackBytes )
+{
+  bool ok = true;
+
+  if ( priority > 0 && !setPriority( priority ) ) ok = false;
+  if ( cpu >= 0 && !setAffinity( cpu ) ) ok = false;
+  if ( stackBytes ) prefaultStack( stackBytes );
+
+  return ok;
+}
+
+int Realtime :: defaultCpu( void )
+{
+#if defined(__OS_LINUX__)
+
+  long cpus = sysconf( _SC_NPROCESSORS_ONLN );
+  if ( cpus > 1 ) return (int) cpus - 1;
+
+#endif
+  return -1;
+}
+
+} // stk namespace
@@ -37,10 +37,13 @@ namespace stk {
 Rhodey :: Rhodey( void )
   : FM()
 {
-  // Concatenate the STK rawwave path to the rawwave files
+  // Concatenate the STK rawwave path to the rawwave files, whose data
+  // is shared with every other instrument that uses them.
+  for ( unsigned int i=0; i<4; i++ )
+    waves_[i] = new FileLoop();
   for ( unsigned int i=0; i<3; i++ )
-    waves_[i] = new FileLoop( (Stk::rawwavePath() + "sinewave.raw").c_str(), true );
-  waves_[3] = new FileLoop( (Stk::rawwavePath() + "fwavblnk.raw").c_str(), true );
+    waves_[i]->openShared( Stk::rawwavePath() + "sinewave.raw", true );
+  waves_[3]->openShared( Stk::rawwavePath() + "fwavblnk.raw", true );
 
   this->setRatio(0, 1.0);
   this->setRatio(1, 0.5);
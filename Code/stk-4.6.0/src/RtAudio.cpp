@@ -41,6 +41,7 @@
 // RtAudio: Version 5.0.0
 
 #include "RtAudio.h"
+#include "SampleConvert.h"
 #include <iostream>
 #include <cstdlib>
 #include <cstring>
@@ -9802,6 +9803,54 @@ void RtApi :: setConvertInfo( StreamMode mode, unsigned int firstChannel )
   }
 }
 
+// Convert n interleaved samples between a floating-point format and a
+// 16-, 24-, 32-bit or float one with the vector kernels in
+// SampleConvert.h.  These scale by 2^(bits-1) and saturate.  Returns
+// false for the format pairs they do not cover.
+static bool convertSamples( char *outBuffer, RtAudioFormat outFormat,
+                            char *inBuffer, RtAudioFormat inFormat, size_t n )
+{
+  if ( outFormat == RTAUDIO_FLOAT64 || outFormat == RTAUDIO_FLOAT32 ) {
+    if ( outFormat == RTAUDIO_FLOAT64 ) {
+      double *out = (double *) outBuffer;
+      if ( inFormat == RTAUDIO_SINT16 ) stk::convertFromInt16( (int16_t *) inBuffer, out, n );
+      else if ( inFormat == RTAUDIO_SINT24 ) stk::convertFromInt24( (unsigned char *) inBuffer, out, n );
+      else if ( inFormat == RTAUDIO_SINT32 ) stk::convertFromInt32( (int32_t *) inBuffer, out, n );
+      else if ( inFormat == RTAUDIO_FLOAT32 ) stk::convertFromFloat32( (float *) inBuffer, out, n );
+      else return false;
+    }
+    else {
+      float *out = (float *) outBuffer;
+      if ( inFormat == RTAUDIO_SINT16 ) stk::convertFromInt16( (int16_t *) inBuffer, out, n );
+      else if ( inFormat == RTAUDIO_SINT24 ) stk::convertFromInt24( (unsigned char *) inBuffer, out, n );
+      else if ( inFormat == RTAUDIO_SINT32 ) stk::convertFromInt32( (int32_t *) inBuffer, out, n );
+      else if ( inFormat == RTAUDIO_FLOAT64 ) stk::convertToFloat32( (double *) inBuffer, out, n );
+      else return false;
+    }
+    return true;
+  }
+
+  if ( inFormat == RTAUDIO_FLOAT64 ) {
+    double *in = (double *) inBuffer;
+    if ( outFormat == RTAUDIO_SINT16 ) stk::convertToInt16( in, (int16_t *) outBuffer, n );
+    else if ( outFormat == RTAUDIO_SINT24 ) stk::convertToInt24( in, (unsigned char *) outBuffer, n );
+    else if ( outFormat == RTAUDIO_SINT32 ) stk::convertToInt32( in, (int32_t *) outBuffer, n );
+    else return false;
+    return true;
+  }
+
+  if ( inFormat == RTAUDIO_FLOAT32 ) {
+    float *in = (float *) inBuffer;
+    if ( outFormat == RTAUDIO_SINT16 ) stk::convertToInt16( in, (int16_t *) outBuffer, n );
+    else if ( outFormat == RTAUDIO_SINT24 ) stk::convertToInt24( in, (unsigned char *) outBuffer, n );
+    else if ( outFormat == RTAUDIO_SINT32 ) stk::convertToInt32( in, (int32_t *) outBuffer, n );
+    else return false;
+    return true;
+  }
+
+  return false;
+}
+
 void RtApi :: convertBuffer( char *outBuffer, char *inBuffer, ConvertInfo &info )
 {
   // This function does format conversion, input/output channel compensation, and
@@ -9813,7 +9862,16 @@ void RtApi :: convertBuffer( char *outBuffer, char *inBuffer, ConvertInfo &info
        ( stream_.nDeviceChannels[0] < stream_.nDeviceChannels[1] ) )
     memset( outBuffer, 0, stream_.bufferSize * info.outJump * formatBytes( info.outFormat ) );
 
+  // Interleaved to interleaved with matching channels is one flat run
+  // of samples, which the vector kernels handle.
   int j;
+  bool flat = ( info.inJump == info.channels && info.outJump == info.channels );
+  for ( j=0; flat && j<info.channels; j++ )
+    flat = ( info.inOffset[j] == j && info.outOffset[j] == j );
+  if ( flat && convertSamples( outBuffer, info.outFormat, inBuffer, info.inFormat,
+                               (size_t) stream_.bufferSize * info.channels ) )
+    return;
+
   if (info.outFormat == RTAUDIO_FLOAT64) {
     Float64 scale;
     Float64 *out = (Float64 *)outBuffer;
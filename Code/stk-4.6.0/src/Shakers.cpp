@@ -270,7 +270,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = CABASA_RADII[i];
       baseFrequencies_[i] = CABASA_FREQUENCIES[i];
-      filters_[i].gain = CABASA_GAINS[i];
+      filters_.setFilterGain( i, CABASA_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseDecay_ = CABASA_SYSTEM_DECAY;
@@ -289,7 +289,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = SEKERE_RADII[i];
       baseFrequencies_[i] = SEKERE_FREQUENCIES[i];
-      filters_[i].gain = SEKERE_GAINS[i];
+      filters_.setFilterGain( i, SEKERE_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseDecay_ = SEKERE_SYSTEM_DECAY;
@@ -308,7 +308,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = TAMBOURINE_RADII[i];
       baseFrequencies_[i] = TAMBOURINE_FREQUENCIES[i];
-      filters_[i].gain = TAMBOURINE_GAINS[i];
+      filters_.setFilterGain( i, TAMBOURINE_GAINS[i] );
       doVaryFrequency_[i] = true;
     }
     doVaryFrequency_[0] = false;
@@ -329,7 +329,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = SLEIGH_RADII[i];
       baseFrequencies_[i] = SLEIGH_FREQUENCIES[i];
-      filters_[i].gain = SLEIGH_GAINS[i];
+      filters_.setFilterGain( i, SLEIGH_GAINS[i] );
       doVaryFrequency_[i] = true;
     }
     baseDecay_ = SLEIGH_SYSTEM_DECAY;
@@ -349,7 +349,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = BAMBOO_RADII[i];
       baseFrequencies_[i] = BAMBOO_FREQUENCIES[i];
-      filters_[i].gain = BAMBOO_GAINS[i];
+      filters_.setFilterGain( i, BAMBOO_GAINS[i] );
       doVaryFrequency_[i] = true;
     }
     baseDecay_ = BAMBOO_SYSTEM_DECAY;
@@ -369,7 +369,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = SANDPAPER_RADII[i];
       baseFrequencies_[i] = SANDPAPER_FREQUENCIES[i];
-      filters_[i].gain = SANDPAPER_GAINS[i];
+      filters_.setFilterGain( i, SANDPAPER_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseDecay_ = SANDPAPER_SYSTEM_DECAY;
@@ -388,7 +388,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = COKECAN_RADII[i];
       baseFrequencies_[i] = COKECAN_FREQUENCIES[i];
-      filters_[i].gain = COKECAN_GAINS[i];
+      filters_.setFilterGain( i, COKECAN_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseDecay_ = COKECAN_SYSTEM_DECAY;
@@ -407,7 +407,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = STIX1_RADII[i];
       baseFrequencies_[i] = STIX1_FREQUENCIES[i];
-      filters_[i].gain = STIX1_GAINS[i];
+      filters_.setFilterGain( i, STIX1_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseDecay_ = STIX1_SYSTEM_DECAY;
@@ -426,7 +426,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = CRUNCH1_RADII[i];
       baseFrequencies_[i] = CRUNCH1_FREQUENCIES[i];
-      filters_[i].gain = CRUNCH1_GAINS[i];
+      filters_.setFilterGain( i, CRUNCH1_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseDecay_ = CRUNCH1_SYSTEM_DECAY;
@@ -445,7 +445,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = BIGROCKS_RADII[i];
       baseFrequencies_[i] = BIGROCKS_FREQUENCIES[i];
-      filters_[i].gain = BIGROCKS_GAINS[i];
+      filters_.setFilterGain( i, BIGROCKS_GAINS[i] );
       doVaryFrequency_[i] = true;
     }
     baseDecay_ = BIGROCKS_SYSTEM_DECAY;
@@ -465,7 +465,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = LITTLEROCKS_RADII[i];
       baseFrequencies_[i] = LITTLEROCKS_FREQUENCIES[i];
-      filters_[i].gain = LITTLEROCKS_GAINS[i];
+      filters_.setFilterGain( i, LITTLEROCKS_GAINS[i] );
       doVaryFrequency_[i] = true;
     }
     baseDecay_ = LITTLEROCKS_SYSTEM_DECAY;
@@ -487,7 +487,7 @@ void Shakers :: setType( int type )
     for ( int i=0; i<NEXTMUG_RESONANCES; i++ ) {
       baseRadii_[i] = NEXTMUG_RADII[i];
       baseFrequencies_[i] = NEXTMUG_FREQUENCIES[i];
-      filters_[i].gain = NEXTMUG_GAINS[i];
+      filters_.setFilterGain( i, NEXTMUG_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseDecay_ = NEXTMUG_SYSTEM_DECAY;
@@ -501,7 +501,7 @@ void Shakers :: setType( int type )
       for ( int i=0; i<COIN_RESONANCES; i++ ) {
         baseRadii_[i+NEXTMUG_RESONANCES] = PENNY_RADII[i];
         baseFrequencies_[i+NEXTMUG_RESONANCES] = PENNY_FREQUENCIES[i];
-        filters_[i+NEXTMUG_RESONANCES].gain = PENNY_GAINS[i];
+        filters_.setFilterGain( i+NEXTMUG_RESONANCES, PENNY_GAINS[i] );
         doVaryFrequency_[i+NEXTMUG_RESONANCES] = false;
       }
     }
@@ -509,7 +509,7 @@ void Shakers :: setType( int type )
       for ( int i=0; i<COIN_RESONANCES; i++ ) {
         baseRadii_[i+NEXTMUG_RESONANCES] = NICKEL_RADII[i];
         baseFrequencies_[i+NEXTMUG_RESONANCES] = NICKEL_FREQUENCIES[i];
-        filters_[i+NEXTMUG_RESONANCES].gain = NICKEL_GAINS[i];
+        filters_.setFilterGain( i+NEXTMUG_RESONANCES, NICKEL_GAINS[i] );
         doVaryFrequency_[i+NEXTMUG_RESONANCES] = false;
       }
     }
@@ -517,7 +517,7 @@ void Shakers :: setType( int type )
       for ( int i=0; i<COIN_RESONANCES; i++ ) {
         baseRadii_[i+NEXTMUG_RESONANCES] = DIME_RADII[i];
         baseFrequencies_[i+NEXTMUG_RESONANCES] = DIME_FREQUENCIES[i];
-        filters_[i+NEXTMUG_RESONANCES].gain = DIME_GAINS[i];
+        filters_.setFilterGain( i+NEXTMUG_RESONANCES, DIME_GAINS[i] );
         doVaryFrequency_[i+NEXTMUG_RESONANCES] = false;
       }
     }
@@ -525,7 +525,7 @@ void Shakers :: setType( int type )
       for ( int i=0; i<COIN_RESONANCES; i++ ) {
         baseRadii_[i+NEXTMUG_RESONANCES] = QUARTER_RADII[i];
         baseFrequencies_[i+NEXTMUG_RESONANCES] = QUARTER_FREQUENCIES[i];
-        filters_[i+NEXTMUG_RESONANCES].gain = QUARTER_GAINS[i];
+        filters_.setFilterGain( i+NEXTMUG_RESONANCES, QUARTER_GAINS[i] );
         doVaryFrequency_[i+NEXTMUG_RESONANCES] = false;
       }
     }
@@ -533,7 +533,7 @@ void Shakers :: setType( int type )
       for ( int i=0; i<COIN_RESONANCES; i++ ) {
         baseRadii_[i+NEXTMUG_RESONANCES] = FRANC_RADII[i];
         baseFrequencies_[i+NEXTMUG_RESONANCES] = FRANC_FREQUENCIES[i];
-        filters_[i+NEXTMUG_RESONANCES].gain = FRANC_GAINS[i];
+        filters_.setFilterGain( i+NEXTMUG_RESONANCES, FRANC_GAINS[i] );
         doVaryFrequency_[i+NEXTMUG_RESONANCES] = false;
       }
     }
@@ -541,7 +541,7 @@ void Shakers :: setType( int type )
       for ( int i=0; i<COIN_RESONANCES; i++ ) {
         baseRadii_[i+NEXTMUG_RESONANCES] = PESO_RADII[i];
         baseFrequencies_[i+NEXTMUG_RESONANCES] = PESO_FREQUENCIES[i];
-        filters_[i+NEXTMUG_RESONANCES].gain = PESO_GAINS[i];
+        filters_.setFilterGain( i+NEXTMUG_RESONANCES, PESO_GAINS[i] );
         doVaryFrequency_[i+NEXTMUG_RESONANCES] = false;
       }
     }
@@ -556,7 +556,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = GUIRO_RADII[i];
       baseFrequencies_[i] = GUIRO_FREQUENCIES[i];
-      filters_[i].gain = GUIRO_GAINS[i];
+      filters_.setFilterGain( i, GUIRO_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseGain_ = GUIRO_GAIN;
@@ -577,7 +577,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = WRENCH_RADII[i];
       baseFrequencies_[i] = WRENCH_FREQUENCIES[i];
-      filters_[i].gain = WRENCH_GAINS[i];
+      filters_.setFilterGain( i, WRENCH_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseGain_ = WRENCH_GAIN;
@@ -600,7 +600,7 @@ void Shakers :: setType( int type )
       baseRadii_[i] = WATER_RADII[i];
       baseFrequencies_[i] = WATER_FREQUENCIES[i];
       tempFrequencies_[i] = WATER_FREQUENCIES[i];
-      filters_[i].gain = WATER_GAINS[i];
+      filters_.setFilterGain( i, WATER_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseDecay_ = WATER_SYSTEM_DECAY;
@@ -612,6 +612,7 @@ void Shakers :: setType( int type )
   else if ( type == 22 ) { // Tuned Bamboo Chimes (Angklung)
     nResonances_ = ANGKLUNG_RESONANCES;
     filters_.resize( nResonances_ );
+    baseGains_.resize( nResonances_ );
     baseFrequencies_.resize( nResonances_ );
     baseRadii_.resize( nResonances_ );
     doVaryFrequency_.resize( nResonances_ );
@@ -619,7 +620,8 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = ANGKLUNG_RADII[i];
       baseFrequencies_[i] = ANGKLUNG_FREQUENCIES[i];
-      filters_[i].gain = ANGKLUNG_GAINS[i];
+      filters_.setFilterGain( i, ANGKLUNG_GAINS[i] );
+      baseGains_[i] = ANGKLUNG_GAINS[i];
       doVaryFrequency_[i] = false;
     }
     baseDecay_ = ANGKLUNG_SYSTEM_DECAY;
@@ -639,7 +641,7 @@ void Shakers :: setType( int type )
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       baseRadii_[i] = MARACA_RADII[i];
       baseFrequencies_[i] = MARACA_FREQUENCIES[i];
-      filters_[i].gain = MARACA_GAINS[i];
+      filters_.setFilterGain( i, MARACA_GAINS[i] );
       doVaryFrequency_[i] = false;
     }
     baseDecay_ = MARACA_SYSTEM_DECAY;
@@ -657,7 +659,7 @@ void Shakers :: setType( int type )
   currentGain_ = log( nObjects_ ) * baseGain_ / nObjects_;
 
   for ( unsigned int i=0; i<nResonances_; i++ )
-    setResonance( filters_[i], baseFrequencies_[i], baseRadii_[i] );
+    filters_.setResonance( i, baseFrequencies_[i], baseRadii_[i] );
 }
 
 const StkFloat MAX_SHAKE = 1.0;
@@ -711,7 +713,7 @@ void Shakers :: controlChange( int number, StkFloat value )
   else if ( number == __SK_ModWheel_ ) { // 1 ... resonance frequency
     for ( unsigned int i=0; i<nResonances_; i++ ) {
       StkFloat temp = baseFrequencies_[i] * pow( 4.0, normalizedValue-0.5 );
-      setResonance( filters_[i], temp, baseRadii_[i] );
+      filters_.setResonance( i, temp, baseRadii_[i] );
     }
   }
   else  if (number == __SK_ShakerInst_) { // 1071
@@ -24,8 +24,10 @@ namespace stk {
 
 Simple :: Simple( void )
 {
-  // Concatenate the STK rawwave path to the rawwave file
-  loop_ = new FileLoop( (Stk::rawwavePath() + "impuls10.raw").c_str(), true );
+  // Concatenate the STK rawwave path to the rawwave file, whose data
+  // is shared with every other Simple.
+  loop_ = new FileLoop();
+  loop_->openShared( Stk::rawwavePath() + "impuls10.raw", true );
 
   filter_.setPole( 0.5 );
   baseFrequency_ = 440.0;
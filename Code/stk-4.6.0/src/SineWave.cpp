@@ -52,8 +52,9 @@ void SineWave :: reset( void )
 
 void SineWave :: setFrequency( StkFloat frequency )
 {
-  // This is a looping frequency.
-  this->setRate( TABLE_SIZE * frequency / Stk::sampleRate() );
+  // This is a looping frequency.  The rate is computed in double
+  // precision so that a float StkFloat build does not drift in pitch.
+  rate_ = TABLE_SIZE * (double) frequency / Stk::sampleRate();
 }
 
 void SineWave :: addTime( StkFloat time )
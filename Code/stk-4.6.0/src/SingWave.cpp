@@ -20,7 +20,7 @@ namespace stk {
 SingWave :: SingWave( std::string fileName, bool raw )
 {
   // An exception could be thrown here.
-  wave_.openFile( fileName, raw );
+  wave_.openShared( fileName, raw );
 
 	rate_ = 1.0;
 	sweepRate_ = 0.001;
@@ -29,10 +29,10 @@ SingWave :: SingWave( std::string fileName, bool raw )
 	modulator_.setVibratoGain( 0.04 );
 	modulator_.setRandomGain( 0.005 );
 
+	// Start at the rate for 75 Hz without ticking, which would draw
+	// from the modulator's noise before the caller can seed rand().
 	this->setFrequency( 75.0 );
-	pitchEnvelope_.setRate( 1.0 );
-	this->tick();
-	this->tick();
+	pitchEnvelope_.setValue( rate_ );
 	pitchEnvelope_.setRate( sweepRate_ * rate_ );
 }
 
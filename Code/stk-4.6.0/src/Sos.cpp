@@ -0,0 +1,332 @@
+/***************************************************/
+/*! \class Sos
+    \brief STK cascade of second-order sections IIR filter class.
+
+    This class implements an IIR filter as a series of biquads, each
+    in transposed direct form II:
+
+    y[n] = b0*x[n] + s1[n-1]
+    s1[n] = b1*x[n] - a1*y[n] + s2[n-1]
+    s2[n] = b2*x[n] - a2*y[n]
+
+    A high-order filter in the single difference equation of the Iir
+    class needs its coefficients to many more digits than a sample
+    has, and small errors move its poles a long way; a cascade of
+    second-order sections keeps every pole pair in two well-scaled
+    coefficients and stays stable at any order.
+
+    The sections can be given directly (see IirDesign), from their
+    poles and zeros with fromRoots(), or from the b and a coefficients
+    of an Iir filter with setCoefficients(), which finds the roots of
+    both polynomials.  Poles are paired with their nearest zeros and
+    the sections run from the least to the most resonant.
+
+    The filter can run on several channels at once with the same
+    coefficients, for example the two sides of a stereo signal.  The
+    StkFrames tick functions run each section over the whole block
+    before the next one, a vector of channels at a time (see Simd.h).
+*/
+/***************************************************/
+
+#include "Sos.h"
+#include <algorithm>
+
+namespace stk {
+
+typedef std::complex<double> Complex;
+
+// Durand-Kerner iterations before giving up on convergence.
+const unsigned int MAX_ITERATIONS = 500;
+
+Sos :: Sos() : Filter()
+{
+  channels_ = 1;
+  this->setSections( std::vector<Section>(), true );
+}
+
+Sos :: Sos( const std::vector<Section> &sections, unsigned int channels ) : Filter()
+{
+  channels_ = 1;
+  this->setSections( sections, true );
+  this->setChannels( channels );
+}
+
+Sos :: Sos( std::vector<StkFloat> &bCoefficients, std::vector<StkFloat> &aCoefficients ) : Filter()
+{
+  channels_ = 1;
+  this->setSections( std::vector<Section>(), true );
+  this->setCoefficients( bCoefficients, aCoefficients, true );
+}
+
+Sos :: ~Sos()
+{
+}
+
+void Sos :: setSections( const std::vector<Section> &sections, bool clearState )
+{
+  if ( sections.size() != sections_.size() ) clearState = true;
+
+  sections_ = sections;
+  coefficients_.resize( 5 * sections_.size() );
+  for ( unsigned int i=0; i<sections_.size(); i++ ) {
+    coefficients_[5*i] = sections_[i].b0;
+    coefficients_[5*i+1] = sections_[i].b1;
+    coefficients_[5*i+2] = sections_[i].b2;
+    coefficients_[5*i+3] = sections_[i].a1;
+    coefficients_[5*i+4] = sections_[i].a2;
+  }
+
+  if ( clearState ) {
+    state_.resize( 2 * sections_.size() * channels_ );
+    this->clear();
+  }
+}
+
+void Sos :: setChannels( unsigned int channels )
+{
+  if ( channels == 0 ) {
+    oStream_ << "Sos::setChannels: the number of channels must be > 0!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  channels_ = channels;
+  channelsIn_ = channels;
+  lastFrame_.resize( 1, channels_, 0.0 );
+  state_.resize( 2 * sections_.size() * channels_ );
+  this->clear();
+}
+
+void Sos :: clear( void )
+{
+  unsigned int i;
+  for ( i=0; i<state_.size(); i++ )
+    state_[i] = 0.0;
+  for ( i=0; i<lastFrame_.size(); i++ )
+    lastFrame_[i] = 0.0;
+}
+
+unsigned long Sos :: getDecayLength( StkFloat attenuation ) const
+{
+  double radius = 0.0;
+
+  for ( unsigned int i=0; i<sections_.size(); i++ ) {
+    double a1 = sections_[i].a1, a2 = sections_[i].a2;
+    double discriminant = a1 * a1 - 4.0 * a2;
+    if ( discriminant < 0.0 )
+      radius = std::max( radius, sqrt( a2 ) );
+    else
+      radius = std::max( radius, ( fabs( a1 ) + sqrt( discriminant ) ) / 2.0 );
+  }
+
+  if ( radius <= 0.0 ) return sections_.size() * 2;
+  if ( radius >= 1.0 ) return (unsigned long) -1;
+  return (unsigned long) ceil( -attenuation / ( 20.0 * log10( radius ) ) );
+}
+
+// The roots of c[0] x^n + c[1] x^(n-1) + ... + c[n], c[0] not zero.
+static std::vector<Complex> roots( const std::vector<double> &c )
+{
+  std::vector<Complex> z;
+  unsigned int n = c.size() - 1;
+  unsigned int i, j, k;
+
+  // Roots at 0 come off first.
+  while ( n > 0 && c[n] == 0.0 ) {
+    z.push_back( 0.0 );
+    n--;
+  }
+  if ( n == 0 ) return z;
+
+  std::vector<double> monic( n + 1 );
+  double bound = 0.0;
+  for ( i=0; i<=n; i++ ) {
+    monic[i] = c[i] / c[0];
+    if ( i > 0 ) bound = std::max( bound, fabs( monic[i] ) );
+  }
+
+  // Durand-Kerner: every root estimate moves at once, starting spread on a circle.
+  std::vector<Complex> x( n );
+  Complex seed( 0.4, 0.9 );
+  for ( i=0; i<n; i++ ) x[i] = ( 1.0 + bound ) * std::pow( seed, (double) i ) / std::abs( std::pow( seed, (double) i ) );
+
+  for ( k=0; k<MAX_ITERATIONS; k++ ) {
+    double change = 0.0;
+    for ( i=0; i<n; i++ ) {
+      Complex value = 1.0, denominator = 1.0;
+      for ( j=1; j<=n; j++ ) value = value * x[i] + monic[j];
+      for ( j=0; j<n; j++ )
+        if ( j != i ) denominator *= x[i] - x[j];
+      if ( std::abs( denominator ) == 0.0 ) denominator = 1e-300;
+      Complex step = value / denominator;
+      x[i] -= step;
+      change = std::max( change, std::abs( step ) / ( 1.0 + std::abs( x[i] ) ) );
+    }
+    if ( change < 1e-15 ) break;
+  }
+
+  z.insert( z.end(), x.begin(), x.end() );
+  return z;
+}
+
+// A real root, or a complex one standing for itself and its conjugate.
+struct Root {
+  Complex z;
+  bool pair;
+};
+
+static std::vector<Root> conjugatePairs( const std::vector< std::complex<StkFloat> > &roots )
+{
+  std::vector<Root> list;
+  for ( unsigned int i=0; i<roots.size(); i++ ) {
+    Complex z( roots[i].real(), roots[i].imag() );
+    Root root;
+    if ( fabs( z.imag() ) <= 1e-9 * std::max( 1.0, std::abs( z ) ) ) {
+      root.z = z.real();
+      root.pair = false;
+      list.push_back( root );
+    }
+    else if ( z.imag() > 0.0 ) {
+      root.z = z;
+      root.pair = true;
+      list.push_back( root );
+    }
+  }
+  return list;
+}
+
+// The index of the root nearest to target, real ones only if asked; -1 for none.
+static int nearest( const std::vector<Root> &list, Complex target, bool realOnly )
+{
+  int best = -1;
+  for ( unsigned int i=0; i<list.size(); i++ ) {
+    if ( realOnly && list[i].pair ) continue;
+    if ( best < 0 || std::abs( list[i].z - target ) < std::abs( list[best].z - target ) )
+      best = i;
+  }
+  return best;
+}
+
+// Take the root at index, and a second real one near target if it is real: the c1 and c2 of 1 + c1/z + c2/z^2.
+static void takeRoots( std::vector<Root> &list, int index, Complex target, double &c1, double &c2 )
+{
+  Root root = list[index];
+  list.erase( list.begin() + index );
+
+  if ( root.pair ) {
+    c1 = -2.0 * root.z.real();
+    c2 = std::norm( root.z );
+    return;
+  }
+
+  c1 = -root.z.real();
+  c2 = 0.0;
+  int other = nearest( list, target, true );
+  if ( other >= 0 ) {
+    c1 -= list[other].z.real();
+    c2 = root.z.real() * list[other].z.real();
+    list.erase( list.begin() + other );
+  }
+}
+
+std::vector<Sos::Section> Sos :: fromRoots( const std::vector< std::complex<StkFloat> > &zeros,
+                                            const std::vector< std::complex<StkFloat> > &poles,
+                                            StkFloat gain )
+{
+  std::vector<Root> z = conjugatePairs( zeros );
+  std::vector<Root> p = conjugatePairs( poles );
+  std::vector<Section> sections;
+  double c1, c2;
+  unsigned int i;
+
+  // The pole closest to the unit circle first, with the zeros nearest to it.
+  while ( !p.empty() || !z.empty() ) {
+    Section s = { 1.0, 0.0, 0.0, 0.0, 0.0 };
+    Complex target = 0.0;
+    int index;
+
+    if ( !p.empty() ) {
+      for ( index=0, i=1; i<p.size(); i++ )
+        if ( std::abs( p[i].z ) > std::abs( p[index].z ) ) index = i;
+      target = p[index].z;
+      takeRoots( p, index, target, c1, c2 );
+      s.a1 = c1; s.a2 = c2;
+    }
+    else
+      target = z[0].z;
+
+    if ( !z.empty() ) {
+      takeRoots( z, nearest( z, target, false ), target, c1, c2 );
+      s.b1 = c1; s.b2 = c2;
+    }
+
+    sections.push_back( s );
+  }
+
+  std::reverse( sections.begin(), sections.end() );
+  if ( sections.empty() ) {
+    Section s = { 1.0, 0.0, 0.0, 0.0, 0.0 };
+    sections.push_back( s );
+  }
+  sections[0].b0 *= gain;
+  sections[0].b1 *= gain;
+  sections[0].b2 *= gain;
+  return sections;
+}
+
+void Sos :: setCoefficients( std::vector<StkFloat> &bCoefficients, std::vector<StkFloat> &aCoefficients, bool clearState )
+{
+  if ( bCoefficients.size() == 0 || aCoefficients.size() == 0 ) {
+    oStream_ << "Sos::setCoefficients: a and b coefficient vectors must both have size > 0!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  if ( aCoefficients[0] == 0.0 ) {
+    oStream_ << "Sos::setCoefficients: a[0] coefficient cannot == 0!";
+    handleError( StkError::FUNCTION_ARGUMENT );
+  }
+
+  // Leading zeros of b are a delay, put back after the sections are made.
+  unsigned int delay = 0;
+  while ( delay < bCoefficients.size() && bCoefficients[delay] == 0.0 ) delay++;
+
+  std::vector<Section> sections;
+  if ( delay == bCoefficients.size() ) {
+    Section s = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    sections.push_back( s );
+    this->setSections( sections, clearState );
+    return;
+  }
+
+  std::vector<double> b( bCoefficients.begin() + delay, bCoefficients.end() );
+  std::vector<double> a( aCoefficients.begin(), aCoefficients.end() );
+  std::vector<Complex> found;
+  std::vector< std::complex<StkFloat> > zeros, poles;
+  unsigned int i;
+
+  found = roots( b );
+  for ( i=0; i<found.size(); i++ ) zeros.push_back( std::complex<StkFloat>( found[i].real(), found[i].imag() ) );
+  found = roots( a );
+  for ( i=0; i<found.size(); i++ ) poles.push_back( std::complex<StkFloat>( found[i].real(), found[i].imag() ) );
+
+  sections = fromRoots( zeros, poles, b[0] / a[0] );
+
+  // A section with a free numerator slot takes one sample of the delay.
+  for ( i=0; i<sections.size() && delay > 0; i++ ) {
+    Section &s = sections[i];
+    while ( s.b2 == 0.0 && delay > 0 ) {
+      s.b2 = s.b1; s.b1 = s.b0; s.b0 = 0.0;
+      delay--;
+    }
+  }
+  while ( delay > 0 ) {
+    Section s = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    if ( delay > 1 ) s.b2 = 1.0;
+    else s.b1 = 1.0;
+    delay -= std::min( delay, 2u );
+    sections.push_back( s );
+  }
+
+  this->setSections( sections, clearState );
+}
+
+} // stk namespace
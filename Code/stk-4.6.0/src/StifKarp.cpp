@@ -34,9 +34,9 @@ StifKarp :: StifKarp( StkFloat lowestFrequency )
     handleError( StkError::FUNCTION_ARGUMENT );
   }
 
-  unsigned long nDelays = (unsigned long) ( Stk::sampleRate() / lowestFrequency );
-  delayLine_.setMaximumDelay( nDelays + 1 );
-  combDelay_.setMaximumDelay( nDelays + 1 );
+  length_ = (unsigned long) ( Stk::sampleRate() / lowestFrequency ) + 1;
+  delayLine_.setMaximumDelay( length_ );
+  combDelay_.setMaximumDelay( length_ );
 
   pluckAmplitude_ = 0.3;
   pickupPosition_ = 0.4;
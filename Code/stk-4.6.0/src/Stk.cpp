@@ -224,55 +224,144 @@ void Stk :: handleError( std::string message, StkError::Type type )
   }
 }
 
+//
+// StkArena definitions
+//
+
+// Round a byte count up to the storage alignment.
+static inline size_t alignedSize( size_t bytes )
+{
+  return ( bytes + STK_ALIGNMENT - 1 ) & ~( STK_ALIGNMENT - 1 );
+}
+
+// Heap memory aligned to STK_ALIGNMENT, or NULL on failure.
+static void *alignedAlloc( size_t bytes )
+{
+#if defined(_MSC_VER)
+  return _aligned_malloc( bytes, STK_ALIGNMENT );
+#else
+  void *ptr = 0;
+  if ( posix_memalign( &ptr, STK_ALIGNMENT, bytes ) != 0 ) return 0;
+  return ptr;
+#endif
+}
+
+static void alignedFree( void *ptr )
+{
+#if defined(_MSC_VER)
+  _aligned_free( ptr );
+#else
+  free( ptr );
+#endif
+}
+
+StkArena :: StkArena( size_t bytes )
+  : data_( 0 ), capacity_( alignedSize( bytes ) ), used_( 0 )
+{
+  if ( capacity_ > 0 ) {
+    data_ = (char *) alignedAlloc( capacity_ );
+    if ( data_ == NULL ) {
+      std::string error = "StkArena: memory allocation error in constructor!";
+      Stk::handleError( error, StkError::MEMORY_ALLOCATION );
+    }
+  }
+}
+
+StkArena :: ~StkArena()
+{
+  if ( data_ ) alignedFree( data_ );
+}
+
+void *StkArena :: allocate( size_t bytes )
+{
+  bytes = alignedSize( bytes );
+  if ( bytes > capacity_ - used_ ) return NULL;
+
+  void *ptr = data_ + used_;
+  used_ += bytes;
+  return ptr;
+}
+
 //
 // StkFrames definitions
 //
 
+// Storage for n samples from the arena, or from the heap when arena is NULL.
+static StkFloat *allocateSamples( size_t n, StkArena *arena )
+{
+  if ( arena ) {
+    StkFloat *data = (StkFloat *) arena->allocate( n * sizeof( StkFloat ) );
+    if ( data == NULL ) {
+      std::string error = "StkFrames: StkArena is exhausted!";
+      Stk::handleError( error, StkError::MEMORY_ALLOCATION );
+    }
+    return data;
+  }
+
+  StkFloat *data = (StkFloat *) alignedAlloc( n * sizeof( StkFloat ) );
+#if defined(_STK_DEBUG_)
+  if ( data == NULL ) {
+    std::string error = "StkFrames: memory allocation error!";
+    Stk::handleError( error, StkError::MEMORY_ALLOCATION );
+  }
+#endif
+  return data;
+}
+
+// Arena memory is only released with the arena itself.
+static void releaseSamples( StkFloat *data, StkArena *arena )
+{
+  if ( data && !arena ) alignedFree( data );
+}
+
 StkFrames :: StkFrames( unsigned int nFrames, unsigned int nChannels )
-  : data_( 0 ), nFrames_( nFrames ), nChannels_( nChannels )
+  : data_( 0 ), nFrames_( nFrames ), nChannels_( nChannels ), arena_( 0 ), owner_( true )
 {
   size_ = nFrames_ * nChannels_;
   bufferSize_ = size_;
 
   if ( size_ > 0 ) {
-    data_ = (StkFloat *) calloc( size_, sizeof( StkFloat ) );
-#if defined(_STK_DEBUG_)
-    if ( data_ == NULL ) {
-      std::string error = "StkFrames: memory allocation error in constructor!";
-      Stk::handleError( error, StkError::MEMORY_ALLOCATION );
-    }
-#endif
+    data_ = allocateSamples( size_, arena_ );
+    memset( data_, 0, size_ * sizeof( StkFloat ) );
   }
 
   dataRate_ = Stk::sampleRate();
 }
 
 StkFrames :: StkFrames( const StkFloat& value, unsigned int nFrames, unsigned int nChannels )
-  : data_( 0 ), nFrames_( nFrames ), nChannels_( nChannels )
+  : data_( 0 ), nFrames_( nFrames ), nChannels_( nChannels ), arena_( 0 ), owner_( true )
 {
   size_ = nFrames_ * nChannels_;
   bufferSize_ = size_;
   if ( size_ > 0 ) {
-    data_ = (StkFloat *) malloc( size_ * sizeof( StkFloat ) );
-#if defined(_STK_DEBUG_)
-    if ( data_ == NULL ) {
-      std::string error = "StkFrames: memory allocation error in constructor!";
-      Stk::handleError( error, StkError::MEMORY_ALLOCATION );
-    }
-#endif
+    data_ = allocateSamples( size_, arena_ );
     for ( long i=0; i<(long)size_; i++ ) data_[i] = value;
   }
 
   dataRate_ = Stk::sampleRate();
 }
 
+StkFrames :: StkFrames( StkArena& arena, unsigned int nFrames, unsigned int nChannels )
+  : data_( 0 ), nFrames_( nFrames ), nChannels_( nChannels ), arena_( &arena ), owner_( true )
+{
+  size_ = nFrames_ * nChannels_;
+  bufferSize_ = size_;
+
+  if ( size_ > 0 ) {
+    data_ = allocateSamples( size_, arena_ );
+    memset( data_, 0, size_ * sizeof( StkFloat ) );
+  }
+
+  dataRate_ = Stk::sampleRate();
+}
+
 StkFrames :: ~StkFrames()
 {
-  if ( data_ ) free( data_ );
+  if ( owner_ ) releaseSamples( data_, arena_ );
 }
 
 StkFrames :: StkFrames( const StkFrames& f )
-  : data_(0), size_(0), bufferSize_(0)
+  : data_(0), size_(0), bufferSize_(0), arena_(0), owner_(true)
 {
   resize( f.frames(), f.channels() );
   dataRate_ = Stk::sampleRate();
@@ -281,7 +370,16 @@ StkFrames :: StkFrames( const StkFrames& f )
 
 StkFrames& StkFrames :: operator= ( const StkFrames& f )
 {
-  if ( data_ ) free( data_ );
+  if ( !owner_ ) {
+    if ( f.frames() != nFrames_ || f.channels() != nChannels_ ) {
+      std::string error = "StkFrames::operator=: a view can only be assigned frames of equal dimensions!";
+      Stk::handleError( error, StkError::FUNCTION_ARGUMENT );
+    }
+    if ( f.data_ != data_ ) memmove( data_, f.data_, size_ * sizeof( StkFloat ) );
+    return *this;
+  }
+
+  if ( data_ ) releaseSamples( data_, arena_ );
   data_ = 0;
   size_ = 0;
   bufferSize_ = 0;
@@ -293,19 +391,18 @@ StkFrames& StkFrames :: operator= ( const StkFrames& f )
 
 void StkFrames :: resize( size_t nFrames, unsigned int nChannels )
 {
+  if ( !owner_ && nFrames * nChannels > bufferSize_ ) {
+    std::string error = "StkFrames::resize: a view cannot grow beyond the memory it wraps!";
+    Stk::handleError( error, StkError::MEMORY_ALLOCATION );
+  }
+
   nFrames_ = nFrames;
   nChannels_ = nChannels;
 
   size_ = nFrames_ * nChannels_;
   if ( size_ > bufferSize_ ) {
-    if ( data_ ) free( data_ );
-    data_ = (StkFloat *) malloc( size_ * sizeof( StkFloat ) );
-#if defined(_STK_DEBUG_)
-    if ( data_ == NULL ) {
-      std::string error = "StkFrames::resize: memory allocation error!";
-      Stk::handleError( error, StkError::MEMORY_ALLOCATION );
-    }
-#endif
+    releaseSamples( data_, arena_ );
+    data_ = allocateSamples( size_, arena_ );
     bufferSize_ = size_;
   }
 }
@@ -316,7 +413,49 @@ void StkFrames :: resize( size_t nFrames, unsigned int nChannels, StkFloat value
 
   for ( size_t i=0; i<size_; i++ ) data_[i] = value;
 }
-    
+
+//
+// StkFramesView definitions
+//
+
+StkFramesView :: StkFramesView( StkFloat *data, unsigned int nFrames, unsigned int nChannels )
+  : StkFrames()
+{
+  this->wrap( data, nFrames, nChannels );
+}
+
+StkFramesView :: StkFramesView( StkFrames& frames, unsigned int offset, unsigned int nFrames )
+  : StkFrames()
+{
+#if defined(_STK_DEBUG_)
+  if ( offset + nFrames > frames.frames() ) {
+    std::ostringstream error;
+    error << "StkFramesView: frames " << offset << " to " << offset + nFrames << " are out of range!";
+    Stk::handleError( error.str(), StkError::MEMORY_ACCESS );
+  }
+#endif
+
+  this->wrap( frames.size() ? &frames[offset * frames.channels()] : 0, nFrames, frames.channels() );
+  dataRate_ = frames.dataRate();
+}
+
+StkFramesView :: StkFramesView( const StkFramesView& v )
+  : StkFrames()
+{
+  this->wrap( v.data_, (unsigned int) v.nFrames_, v.nChannels_ );
+  dataRate_ = v.dataRate_;
+}
+
+void StkFramesView :: wrap( StkFloat *data, unsigned int nFrames, unsigned int nChannels )
+{
+  owner_ = false;
+  data_ = data;
+  nFrames_ = nFrames;
+  nChannels_ = nChannels;
+  size_ = nFrames_ * nChannels_;
+  bufferSize_ = size_;
+}
+
 StkFrames& StkFrames::getChannel(unsigned int sourceChannel,StkFrames& destinationFrames, unsigned int destinationChannel) const
 {
 #if defined(_STK_DEBUG_)
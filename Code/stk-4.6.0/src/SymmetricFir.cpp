@@ -0,0 +1,205 @@
+/***************************************************/
+/*! \class SymmetricFir
+    \brief STK linear-phase finite impulse response filter class.
+
+    This class is a Fir that looks at the coefficients it is given.
+    When they are symmetric (b[i] == b[N-1-i]) or antisymmetric
+    (b[i] == -b[N-1-i]), as with any linear-phase design, the two
+    input samples that share a coefficient are added (or subtracted)
+    before the multiply, so each output costs about N/2 multiplies
+    instead of N.  Other coefficient vectors run the plain Fir
+    computation.
+
+    For this, a second copy of the input history is kept in the
+    opposite time order, so the folded sum is a single vectorizable
+    loop over two contiguous arrays (see Simd.h).
+
+    A linear-phase filter delays every frequency by (N-1)/2 samples.
+    setMinimumPhase() replaces the coefficients with the minimum-phase
+    filter of the same length and magnitude response, found with the
+    real cepstrum, which moves most of the energy to the first taps
+    and cuts the delay to a few samples at the cost of a nonlinear
+    phase.  This is meant for live monitoring, where latency matters
+    more than waveform shape.  A minimum-phase filter is not symmetric
+    and runs at the plain Fir cost.
+*/
+/***************************************************/
+
+#include "SymmetricFir.h"
+#include <cmath>
+#include <algorithm>
+
+namespace stk {
+
+// Cepstral aliasing falls off with the transform size; this many times the filter length.
+const unsigned int CEPSTRUM_OVERSAMPLING = 32;
+
+// Floor for the log magnitude, relative to the peak, as stopband zeros have none.
+const StkFloat MAGNITUDE_FLOOR = 1e-9;
+
+SymmetricFir :: SymmetricFir() : Fir()
+{
+  minimumPhase_ = false;
+  prototype_ = b_;
+  fold();
+}
+
+SymmetricFir :: SymmetricFir( std::vector<StkFloat> &coefficients, bool minimumPhase )
+  : Fir( coefficients )
+{
+  minimumPhase_ = false;
+  prototype_ = b_;
+  fold();
+  if ( minimumPhase ) setMinimumPhase( true );
+}
+
+SymmetricFir :: ~SymmetricFir()
+{
+}
+
+void SymmetricFir :: clear( void )
+{
+  Fir::clear();
+  for ( unsigned int i=0; i<reversed_.size(); i++ )
+    reversed_[i] = 0.0;
+}
+
+void SymmetricFir :: setCoefficients( std::vector<StkFloat> &coefficients, bool clearState )
+{
+  prototype_ = coefficients;
+  if ( minimumPhase_ && coefficients.size() > 1 ) {
+    std::vector<StkFloat> converted = minimumPhase( coefficients );
+    Fir::setCoefficients( converted, clearState );
+  }
+  else
+    Fir::setCoefficients( coefficients, clearState );
+  fold();
+}
+
+void SymmetricFir :: setMinimumPhase( bool state )
+{
+  if ( state == minimumPhase_ ) return;
+
+  minimumPhase_ = state;
+  std::vector<StkFloat> coefficients = prototype_;
+  this->setCoefficients( coefficients, true );
+}
+
+// Sort the coefficients and, when they are symmetric, set up the folded form.
+void SymmetricFir :: fold( void )
+{
+  unsigned int order = (unsigned int) b_.size();
+  unsigned int half = order / 2;
+  StkFloat peak = 0.0;
+  unsigned int i;
+
+  for ( i=0; i<order; i++ ) peak = std::max( peak, (StkFloat) fabs( b_[i] ) );
+  StkFloat tolerance = 1e-9 * peak;
+
+  bool even = true, odd = true;
+  for ( i=0; i<half; i++ ) {
+    if ( fabs( b_[i] - b_[order-1-i] ) > tolerance ) even = false;
+    if ( fabs( b_[i] + b_[order-1-i] ) > tolerance ) odd = false;
+  }
+  if ( order & 1 && fabs( b_[half] ) > tolerance ) odd = false;
+
+  symmetry_ = even ? SYMMETRIC : ( odd ? ANTISYMMETRIC : NONE );
+  sign_ = symmetry_ == ANTISYMMETRIC ? -1.0 : 1.0;
+
+  folded_.resize( std::max( half, 1u ) );
+  for ( i=0; i<half; i++ )
+    folded_[i] = 0.5 * ( b_[i] + sign_ * b_[order-1-i] );
+  middle_ = ( order & 1 && symmetry_ == SYMMETRIC ) ? b_[half] : 0.0;
+
+  // Rebuild the reversed history from the forward one, so no state is lost.
+  reversed_.resize( 2 * order, 1, 0.0 );
+  rIndex_ = order - 1 - index_;
+  for ( i=0; i<order; i++ )
+    reversed_[rIndex_ + 1 + i] = sign_ * inputs_[index_ + order - 1 - i];
+  for ( i=0; i<order; i++ ) {
+    if ( rIndex_ + 1 + i >= order ) reversed_[rIndex_ + 1 + i - order] = reversed_[rIndex_ + 1 + i];
+    else reversed_[rIndex_ + 1 + i + order] = reversed_[rIndex_ + 1 + i];
+  }
+}
+
+// In-place radix-2 complex FFT, size a power of two.
+static void transform( std::vector<StkFloat> &real, std::vector<StkFloat> &imag, bool inverse )
+{
+  unsigned int size = real.size();
+  unsigned int i, j, k, m;
+
+  for ( i=1, j=0; i<size; i++ ) {
+    for ( m=size>>1; j & m; m>>=1 ) j ^= m;
+    j |= m;
+    if ( i < j ) {
+      std::swap( real[i], real[j] );
+      std::swap( imag[i], imag[j] );
+    }
+  }
+
+  for ( m=2; m<=size; m<<=1 ) {
+    StkFloat angle = ( inverse ? TWO_PI : -TWO_PI ) / m;
+    for ( k=0; k<m/2; k++ ) {
+      StkFloat wr = cos( angle * k ), wi = sin( angle * k );
+      for ( i=k; i<size; i+=m ) {
+        j = i + m / 2;
+        StkFloat tr = wr * real[j] - wi * imag[j];
+        StkFloat ti = wr * imag[j] + wi * real[j];
+        real[j] = real[i] - tr; imag[j] = imag[i] - ti;
+        real[i] += tr; imag[i] += ti;
+      }
+    }
+  }
+
+  if ( inverse ) {
+    for ( i=0; i<size; i++ ) {
+      real[i] /= size;
+      imag[i] /= size;
+    }
+  }
+}
+
+/* The log magnitude response is transformed to the real cepstrum,
+   whose anticausal half is folded onto the causal half; the exponent
+   of its transform is the minimum-phase response, truncated to the
+   original length.
+*/
+std::vector<StkFloat> SymmetricFir :: minimumPhase( const std::vector<StkFloat> &coefficients )
+{
+  unsigned int length = coefficients.size();
+  unsigned int size = 2, i;
+  while ( size < CEPSTRUM_OVERSAMPLING * length ) size <<= 1;
+
+  std::vector<StkFloat> real( size, 0.0 ), imag( size, 0.0 );
+  for ( i=0; i<length; i++ ) real[i] = coefficients[i];
+  transform( real, imag, false );
+
+  StkFloat peak = 0.0;
+  for ( i=0; i<size; i++ ) {
+    real[i] = sqrt( real[i] * real[i] + imag[i] * imag[i] );
+    peak = std::max( peak, real[i] );
+  }
+  for ( i=0; i<size; i++ ) {
+    real[i] = log( std::max( real[i], MAGNITUDE_FLOOR * peak ) );
+    imag[i] = 0.0;
+  }
+  transform( real, imag, true );
+
+  for ( i=1; i<size/2; i++ ) {
+    real[i] *= 2.0;
+    real[size-i] = 0.0;
+  }
+  for ( i=0; i<size; i++ ) imag[i] = 0.0;
+  transform( real, imag, false );
+
+  for ( i=0; i<size; i++ ) {
+    StkFloat magnitude = exp( real[i] );
+    real[i] = magnitude * cos( imag[i] );
+    imag[i] = magnitude * sin( imag[i] );
+  }
+  transform( real, imag, true );
+
+  return std::vector<StkFloat>( real.begin(), real.begin() + length );
+}
+
+} // stk namespace
@@ -21,12 +21,17 @@
 /***************************************************/
 
 #include "Thread.h"
+#include "Realtime.h"
 
 namespace stk {
 
 Thread :: Thread()
 {
   thread_ = 0;
+  routine_ = 0;
+  ptr_ = 0;
+  priority_ = 0;
+  cpu_ = -1;
 }
 
 Thread :: ~Thread()
@@ -55,6 +60,30 @@ bool Thread :: start( THREAD_FUNCTION routine, void * ptr )
   return false;
 }
 
+bool Thread :: start( THREAD_FUNCTION routine, void * ptr, int priority, int cpu )
+{
+  if ( thread_ ) {
+    oStream_ << "Thread:: a thread is already running!";
+    handleError( StkError::WARNING );
+    return false;
+  }
+
+  // Read by realtimeStart() in the new thread, which then calls routine.
+  routine_ = routine;
+  ptr_ = ptr;
+  priority_ = priority;
+  cpu_ = cpu;
+  return start( realtimeStart, this );
+}
+
+THREAD_RETURN THREAD_TYPE Thread :: realtimeStart( void *ptr )
+{
+  Thread *thread = (Thread *) ptr;
+
+  Realtime::setupThread( thread->priority_, thread->cpu_ );
+  return thread->routine_( thread->ptr_ );
+}
+
 bool Thread :: cancel()
 {
 #if (defined(__OS_IRIX__) || defined(__OS_LINUX__) || defined(__OS_MACOSX__))
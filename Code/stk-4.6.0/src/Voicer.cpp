@@ -19,11 +19,33 @@
     Alternately, control changes can be sent to all voices in a given
     group.
 
+    Voices are allocated in constant time.  Each group keeps a list of
+    its free voices and a list of its sounding voices in the order
+    they were started, and the sounding voices are indexed by note
+    number and every voice by its tag, so noteOn(), noteOff() and the
+    functions that take a tag do not search the voices.  When all the
+    voices of a group are sounding, noteOn() interrupts the one chosen
+    by the stealing policy (see setStealPolicy()).  The voice manager
+    takes no locks: its functions must be called from the thread that
+    calls tick(), between ticks.
+
+    The StkFrames tick() function renders each voice a block at a
+    time with Instrmnt::process() and adds the voices with vector
+    instructions.  After setThreads(), the sounding voices are split
+    between the calling thread and a pool of worker threads, each of
+    which mixes its own share.  On one thread the samples are the same
+    as those of the single-sample tick().  With more threads the
+    shares are added in a different order, which can change the last
+    bits, and instruments that use Noise share the rand() state, so
+    their noise depends on the thread timing.
+
     by Perry R. Cook and Gary P. Scavone, 1995--2017.
 */
 /***************************************************/
 
 #include "Voicer.h"
+#include "Simd.h"
+#include <algorithm>
 #include <cmath>
 
 namespace stk {
@@ -38,6 +60,20 @@ Voicer :: Voicer( StkFloat decayTime )
   tags_ = 23456;
   muteTime_ = (int) ( decayTime * Stk::sampleRate() );
   lastFrame_.resize( 1, 1, 0.0 );
+
+  // The level used by STEAL_QUIETEST falls by 60 dB in 100 ms.
+  levelDecay_ = pow( 0.001, 1.0 / ( 0.1 * Stk::sampleRate() ) );
+  stealPolicy_ = STEAL_OLDEST;
+  threads_ = 1;
+  this->rebuildIndex();
+  this->resizeBuffers();
+}
+
+Voicer :: ~Voicer( void )
+{
+#if defined(__STK_REALTIME__)
+  this->stopWorkers();
+#endif
 }
 
 void Voicer :: addInstrument( Instrmnt *instrument, int group )
@@ -47,6 +83,7 @@ void Voicer :: addInstrument( Instrmnt *instrument, int group )
   voice.group = group;
   voice.noteNumber = -1;
   voices_.push_back( voice );
+  this->rebuildIndex();
 
   // Check output channels and resize lastFrame_ if necessary.
   if ( instrument->channelsOut() > lastFrame_.channels() ) {
@@ -55,6 +92,7 @@ void Voicer :: addInstrument( Instrmnt *instrument, int group )
     for ( unsigned int i=startChannel; i<lastFrame_.size(); i++ )
       lastFrame_[i] = 0.0;
   }
+  this->resizeBuffers();
 }
 
 void Voicer :: removeInstrument( Instrmnt *instrument )
@@ -69,6 +107,8 @@ void Voicer :: removeInstrument( Instrmnt *instrument )
   }
 
   if ( found ) {
+    this->rebuildIndex();
+
     // Check output channels and resize lastFrame_ if necessary.
     unsigned int maxChannels = 1;
     for ( i=voices_.begin(); i!=voices_.end(); ++i ) {
@@ -76,6 +116,7 @@ void Voicer :: removeInstrument( Instrmnt *instrument )
     }
     if ( maxChannels < lastFrame_.channels() )
       lastFrame_.resize( 1, maxChannels );
+    this->resizeBuffers();
   }
   else {
     oStream_ << "Voicer::removeInstrument: instrument pointer not found in current voices!";
@@ -85,61 +126,49 @@ void Voicer :: removeInstrument( Instrmnt *instrument )
 
 long Voicer :: noteOn(StkFloat noteNumber, StkFloat amplitude, int group )
 {
-  unsigned int i;
-  StkFloat frequency = (StkFloat) 220.0 * pow( 2.0, (noteNumber - 57.0) / 12.0 );
-  for ( i=0; i<voices_.size(); i++ ) {
-    if (voices_[i].noteNumber < 0 && voices_[i].group == group) {
-      voices_[i].tag = tags_++;
-      voices_[i].group = group;
-      voices_[i].noteNumber = noteNumber;
-      voices_[i].frequency = frequency;
-      voices_[i].instrument->noteOn( frequency, amplitude * ONE_OVER_128 );
-      voices_[i].sounding = 1;
-      return voices_[i].tag;
-    }
-  }
+  int slot = findGroup( group );
+  if ( slot < 0 ) return -1;
 
-  // All voices are sounding, so interrupt the oldest voice.
-  int voice = -1;
-  for ( i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].group == group ) {
-      if ( voice == -1 ) voice = i;
-      else if ( voices_[i].tag < voices_[voice].tag ) voice = (int) i;
-    }
+  int voice = groups_[slot].free;
+  if ( voice >= 0 )
+    groups_[slot].free = voices_[voice].next;
+  else {
+    // All voices are sounding, so interrupt one of them.
+    voice = stealVoice( group, noteNumber );
+    if ( voice < 0 ) return -1;
+    unlinkSounding( voice );
+    unlinkNote( voice );
   }
 
-  if ( voice >= 0 ) {
-    voices_[voice].tag = tags_++;
-    voices_[voice].group = group;
-    voices_[voice].noteNumber = noteNumber;
-    voices_[voice].frequency = frequency;
-    voices_[voice].instrument->noteOn( frequency, amplitude * ONE_OVER_128 );
-    voices_[voice].sounding = 1;
-    return voices_[voice].tag;
-  }
+  if ( voices_[voice].tag != 0 ) unlinkTag( voice );
+  voices_[voice].tag = tags_++;
+  voices_[voice].noteNumber = noteNumber;
+  voices_[voice].frequency = (StkFloat) 220.0 * pow( 2.0, (noteNumber - 57.0) / 12.0 );
+  voices_[voice].sounding = 1;
+  voices_[voice].level = amplitude * ONE_OVER_128;
+  linkSounding( voice );
+  linkNote( voice );
+  linkTag( voice );
 
-  return -1;
+  voices_[voice].instrument->noteOn( voices_[voice].frequency, amplitude * ONE_OVER_128 );
+  return voices_[voice].tag;
 }
 
 void Voicer :: noteOff( StkFloat noteNumber, StkFloat amplitude, int group )
 {
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].noteNumber == noteNumber && voices_[i].group == group ) {
-      voices_[i].instrument->noteOff( amplitude * ONE_OVER_128 );
-      voices_[i].sounding = -muteTime_;
-    }
+  int next;
+  for ( int i=noteIndex_[noteBucket( noteNumber, group )]; i>=0; i=next ) {
+    next = voices_[i].noteNext;
+    if ( voices_[i].noteNumber == noteNumber && voices_[i].group == group )
+      releaseVoice( i, amplitude );
   }
 }
 
 void Voicer :: noteOff( long tag, StkFloat amplitude )
 {
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].tag == tag ) {
-      voices_[i].instrument->noteOff( amplitude * ONE_OVER_128 );
-      voices_[i].sounding = -muteTime_;
-      break;
-    }
-  }
+  int voice = findTag( tag );
+  if ( voice >= 0 && voices_[voice].sounding != 0 )
+    releaseVoice( voice, amplitude );
 }
 
 void Voicer :: setFrequency( StkFloat noteNumber, int group )
@@ -147,7 +176,9 @@ void Voicer :: setFrequency( StkFloat noteNumber, int group )
   StkFloat frequency = (StkFloat) 220.0 * pow( 2.0, (noteNumber - 57.0) / 12.0 );
   for ( unsigned int i=0; i<voices_.size(); i++ ) {
     if ( voices_[i].group == group ) {
+      if ( voices_[i].sounding != 0 ) unlinkNote( i );
       voices_[i].noteNumber = noteNumber;
+      if ( voices_[i].sounding != 0 ) linkNote( i );
       voices_[i].frequency = frequency;
       voices_[i].instrument->setFrequency( frequency );
     }
@@ -156,15 +187,14 @@ void Voicer :: setFrequency( StkFloat noteNumber, int group )
 
 void Voicer :: setFrequency( long tag, StkFloat noteNumber )
 {
-  StkFloat frequency = (StkFloat) 220.0 * pow( 2.0, (noteNumber - 57.0) / 12.0 );
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].tag == tag ) {
-      voices_[i].noteNumber = noteNumber;
-      voices_[i].frequency = frequency;
-      voices_[i].instrument->setFrequency( frequency );
-      break;
-    }
-  }
+  int voice = findTag( tag );
+  if ( voice < 0 ) return;
+
+  if ( voices_[voice].sounding != 0 ) unlinkNote( voice );
+  voices_[voice].noteNumber = noteNumber;
+  if ( voices_[voice].sounding != 0 ) linkNote( voice );
+  voices_[voice].frequency = (StkFloat) 220.0 * pow( 2.0, (noteNumber - 57.0) / 12.0 );
+  voices_[voice].instrument->setFrequency( voices_[voice].frequency );
 }
 
 void Voicer :: pitchBend( StkFloat value, int group )
@@ -187,12 +217,9 @@ void Voicer :: pitchBend( long tag, StkFloat value )
     pitchScaler = pow( 0.5, (8192.0-value) / 8192.0 );
   else
     pitchScaler = pow( 2.0, (value-8192.0) / 8192.0 );
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].tag == tag ) {
-      voices_[i].instrument->setFrequency( (StkFloat) (voices_[i].frequency * pitchScaler) );
-      break;
-    }
-  }
+  int voice = findTag( tag );
+  if ( voice >= 0 )
+    voices_[voice].instrument->setFrequency( (StkFloat) (voices_[voice].frequency * pitchScaler) );
 }
 
 void Voicer :: controlChange( int number, StkFloat value, int group )
@@ -205,12 +232,9 @@ void Voicer :: controlChange( int number, StkFloat value, int group )
 
 void Voicer :: controlChange( long tag, int number, StkFloat value )
 {
-  for ( unsigned int i=0; i<voices_.size(); i++ ) {
-    if ( voices_[i].tag == tag ) {
-      voices_[i].instrument->controlChange( number, value );
-      break;
-    }
-  }
+  int voice = findTag( tag );
+  if ( voice >= 0 )
+    voices_[voice].instrument->controlChange( number, value );
 }
 
 void Voicer :: silence( void )
@@ -221,4 +245,315 @@ void Voicer :: silence( void )
   }
 }
 
+int Voicer :: stealVoice( int group, StkFloat noteNumber )
+{
+  int slot = findGroup( group );
+  if ( slot < 0 ) return -1;
+
+  int voice = groups_[slot].oldest;
+  if ( stealPolicy_ == STEAL_SAME_NOTE ) {
+    for ( int i=noteIndex_[noteBucket( noteNumber, group )]; i>=0; i=voices_[i].noteNext ) {
+      if ( voices_[i].noteNumber == noteNumber && voices_[i].group == group )
+        return i;
+    }
+  }
+  else if ( stealPolicy_ == STEAL_QUIETEST ) {
+    for ( int i=voice; i>=0; i=voices_[i].next ) {
+      if ( voices_[i].level < voices_[voice].level ) voice = i;
+    }
+  }
+
+  return voice;
+}
+
+int Voicer :: findGroup( int group ) const
+{
+  // There are rarely more than a few groups.
+  for ( unsigned int i=0; i<groups_.size(); i++ )
+    if ( groups_[i].group == group ) return (int) i;
+  return -1;
+}
+
+int Voicer :: findTag( long tag ) const
+{
+  for ( int i=tagIndex_[tagBucket( tag )]; i>=0; i=voices_[i].tagNext )
+    if ( voices_[i].tag == tag ) return i;
+  return -1;
+}
+
+void Voicer :: linkSounding( int voice )
+{
+  Group& group = groups_[voices_[voice].slot];
+  voices_[voice].prev = group.newest;
+  voices_[voice].next = -1;
+  if ( group.newest >= 0 ) voices_[group.newest].next = voice;
+  else group.oldest = voice;
+  group.newest = voice;
+}
+
+void Voicer :: unlinkSounding( int voice )
+{
+  Group& group = groups_[voices_[voice].slot];
+  if ( voices_[voice].prev >= 0 ) voices_[voices_[voice].prev].next = voices_[voice].next;
+  else group.oldest = voices_[voice].next;
+  if ( voices_[voice].next >= 0 ) voices_[voices_[voice].next].prev = voices_[voice].prev;
+  else group.newest = voices_[voice].prev;
+}
+
+void Voicer :: linkNote( int voice )
+{
+  int& head = noteIndex_[noteBucket( voices_[voice].noteNumber, voices_[voice].group )];
+  voices_[voice].notePrev = -1;
+  voices_[voice].noteNext = head;
+  if ( head >= 0 ) voices_[head].notePrev = voice;
+  head = voice;
+}
+
+void Voicer :: unlinkNote( int voice )
+{
+  if ( voices_[voice].notePrev >= 0 ) voices_[voices_[voice].notePrev].noteNext = voices_[voice].noteNext;
+  else noteIndex_[noteBucket( voices_[voice].noteNumber, voices_[voice].group )] = voices_[voice].noteNext;
+  if ( voices_[voice].noteNext >= 0 ) voices_[voices_[voice].noteNext].notePrev = voices_[voice].notePrev;
+}
+
+void Voicer :: linkTag( int voice )
+{
+  int& head = tagIndex_[tagBucket( voices_[voice].tag )];
+  voices_[voice].tagPrev = -1;
+  voices_[voice].tagNext = head;
+  if ( head >= 0 ) voices_[head].tagPrev = voice;
+  head = voice;
+}
+
+void Voicer :: unlinkTag( int voice )
+{
+  if ( voices_[voice].tagPrev >= 0 ) voices_[voices_[voice].tagPrev].tagNext = voices_[voice].tagNext;
+  else tagIndex_[tagBucket( voices_[voice].tag )] = voices_[voice].tagNext;
+  if ( voices_[voice].tagNext >= 0 ) voices_[voices_[voice].tagNext].tagPrev = voices_[voice].tagPrev;
+}
+
+void Voicer :: releaseVoice( int voice, StkFloat amplitude )
+{
+  voices_[voice].instrument->noteOff( amplitude * ONE_OVER_128 );
+  voices_[voice].sounding = -muteTime_;
+
+  // With no decay time the voice is silenced at once.
+  if ( muteTime_ == 0 ) freeVoice( voice );
+}
+
+void Voicer :: freeVoice( int voice )
+{
+  unlinkSounding( voice );
+  unlinkNote( voice );
+  voices_[voice].noteNumber = -1;
+  voices_[voice].sounding = 0;
+
+  Group& group = groups_[voices_[voice].slot];
+  voices_[voice].next = group.free;
+  group.free = voice;
+}
+
+void Voicer :: rebuildIndex( void )
+{
+  unsigned int i, size = 16;
+  while ( size < 2 * voices_.size() ) size *= 2;
+  noteIndex_.assign( size, -1 );
+  tagIndex_.assign( size, -1 );
+  groups_.clear();
+
+  std::vector< std::pair<long, int> > sounding;
+  for ( i=0; i<voices_.size(); i++ ) {
+    int slot = findGroup( voices_[i].group );
+    if ( slot < 0 ) {
+      Group group;
+      group.group = voices_[i].group;
+      group.free = group.oldest = group.newest = -1;
+      slot = groups_.size();
+      groups_.push_back( group );
+    }
+    voices_[i].slot = slot;
+    if ( voices_[i].tag != 0 ) linkTag( i );
+    if ( voices_[i].sounding != 0 ) sounding.push_back( std::make_pair( voices_[i].tag, (int) i ) );
+  }
+
+  // Free voices are handed out lowest first, sounding ones are kept
+  // in the order they were started.
+  for ( i=voices_.size(); i>0; i-- ) {
+    if ( voices_[i-1].sounding != 0 ) continue;
+    voices_[i-1].next = groups_[voices_[i-1].slot].free;
+    groups_[voices_[i-1].slot].free = i - 1;
+  }
+
+  std::sort( sounding.begin(), sounding.end() );
+  for ( i=0; i<sounding.size(); i++ ) {
+    linkSounding( sounding[i].second );
+    linkNote( sounding[i].second );
+  }
+}
+
+void Voicer :: resizeBuffers( void )
+{
+  mix_.resize( BLOCK_FRAMES * threads_, lastFrame_.channels() );
+  voiceFrames_.resize( BLOCK_FRAMES * threads_, lastFrame_.channels() );
+  active_.reserve( voices_.size() );
+}
+
+void Voicer :: setThreads( unsigned int nThreads, int priority )
+{
+  if ( nThreads == 0 ) {
+    oStream_ << "Voicer::setThreads: argument must be greater than zero!";
+    handleError( StkError::WARNING ); return;
+  }
+
+#if defined(__STK_REALTIME__)
+  this->stopWorkers();
+  for ( unsigned int i=1; i<nThreads; i++ ) {
+    Worker *worker = new Worker;
+    worker->voicer = this;
+    worker->thread = i;
+    worker->busy = false;
+    worker->quit = false;
+
+    bool started;
+    if ( priority > 0 )
+      started = worker->handle.start( &Voicer::workerThread, worker, priority );
+    else
+      started = worker->handle.start( &Voicer::workerThread, worker );
+    if ( !started ) {
+      delete worker;
+      oStream_ << "Voicer::setThreads: unable to start worker thread, using " << i << " thread(s)!";
+      handleError( StkError::WARNING );
+      break;
+    }
+    workers_.push_back( worker );
+  }
+  threads_ = workers_.size() + 1;
+#else
+  if ( nThreads > 1 ) {
+    oStream_ << "Voicer::setThreads: worker threads need realtime support, using one thread!";
+    handleError( StkError::WARNING );
+  }
+#endif
+
+  this->resizeBuffers();
+}
+
+void Voicer :: render( unsigned int nFrames )
+{
+  unsigned int i, nChannels = lastFrame_.channels();
+
+  active_.clear();
+  for ( i=0; i<voices_.size(); i++ )
+    if ( voices_[i].sounding != 0 ) active_.push_back( i );
+
+  // Each thread takes a run of voices in index order, so one thread
+  // adds them in the same order as tick().
+  unsigned int nActive = active_.size(), nThreads = nActive / THREAD_VOICES;
+  if ( nThreads > threads_ ) nThreads = threads_;
+  if ( nThreads == 0 ) nThreads = 1;
+
+#if defined(__STK_REALTIME__)
+  for ( i=1; i<nThreads; i++ ) {
+    Worker *worker = workers_[i-1];
+    worker->mutex.lock();
+    worker->first = i * nActive / nThreads;
+    worker->last = ( i + 1 ) * nActive / nThreads;
+    worker->nFrames = nFrames;
+    worker->busy = true;
+    worker->mutex.signal();
+    worker->mutex.unlock();
+  }
+#endif
+
+  renderVoices( 0, nActive / nThreads, nFrames, 0 );
+
+#if defined(__STK_REALTIME__)
+  for ( i=1; i<nThreads; i++ ) {
+    Worker *worker = workers_[i-1];
+    worker->mutex.lock();
+    while ( worker->busy ) worker->mutex.wait();
+    worker->mutex.unlock();
+    accumulate( &mix_[0], &mix_[i * BLOCK_FRAMES * nChannels], nFrames * nChannels );
+  }
+#endif
+
+  // Count down the voices decaying after a noteOff.
+  for ( i=0; i<nActive; i++ ) {
+    Voice& voice = voices_[active_[i]];
+    if ( voice.sounding >= 0 ) continue;
+    if ( (unsigned int) -voice.sounding > nFrames ) voice.sounding += nFrames;
+    else freeVoice( active_[i] );
+  }
+
+  for ( i=0; i<nChannels; i++ )
+    lastFrame_[i] = mix_[( nFrames - 1 ) * nChannels + i];
+}
+
+void Voicer :: renderVoices( unsigned int first, unsigned int last, unsigned int nFrames, unsigned int thread )
+{
+  unsigned int i, j, nChannels = lastFrame_.channels();
+  StkFloat *mix = &mix_[thread * BLOCK_FRAMES * nChannels];
+  StkFloat *samples = &voiceFrames_[thread * BLOCK_FRAMES * nChannels];
+  for ( i=0; i<nFrames * nChannels; i++ ) mix[i] = 0.0;
+
+  for ( unsigned int k=first; k<last; k++ ) {
+    Voice& voice = voices_[active_[k]];
+    unsigned int n = nFrames, channels = voice.instrument->channelsOut();
+
+    // A decaying voice stops in the middle of the block, as with tick().
+    if ( voice.sounding < 0 && (unsigned int) -voice.sounding < n ) n = -voice.sounding;
+    voice.instrument->process( StkFramesView( samples, n, channels ), n );
+
+    if ( channels == nChannels )
+      accumulate( mix, samples, n * nChannels );
+    else {
+      for ( i=0; i<n; i++ )
+        for ( j=0; j<channels; j++ ) mix[i * nChannels + j] += samples[i * channels + j];
+    }
+
+    if ( stealPolicy_ == STEAL_QUIETEST ) {
+      for ( i=0; i<n; i++ ) followLevel( voice, samples[i * channels] );
+    }
+  }
+}
+
+#if defined(__STK_REALTIME__)
+
+THREAD_RETURN THREAD_TYPE Voicer :: workerThread( void *ptr )
+{
+  Worker *worker = (Worker *) ptr;
+
+  worker->mutex.lock();
+  while ( true ) {
+    while ( !worker->busy && !worker->quit ) worker->mutex.wait();
+    if ( worker->quit ) break;
+    worker->mutex.unlock();
+
+    worker->voicer->renderVoices( worker->first, worker->last, worker->nFrames, worker->thread );
+
+    worker->mutex.lock();
+    worker->busy = false;
+    worker->mutex.signal();
+  }
+  worker->mutex.unlock();
+
+  return 0;
+}
+
+void Voicer :: stopWorkers( void )
+{
+  for ( unsigned int i=0; i<workers_.size(); i++ ) {
+    workers_[i]->mutex.lock();
+    workers_[i]->quit = true;
+    workers_[i]->mutex.signal();
+    workers_[i]->mutex.unlock();
+    workers_[i]->handle.wait();
+    delete workers_[i];
+  }
+  workers_.clear();
+  threads_ = 1;
+}
+
+#endif // __STK_REALTIME__
+
 } // stk namespace
@@ -0,0 +1,158 @@
+/***************************************************/
+/*! \class WaveCache
+    \brief STK process-wide cache of audio file data.
+
+    This class holds the decoded data of audio files, such as the
+    rawwaves used by the instruments, so that any number of FileWvIn
+    and FileLoop objects can play a file from a single copy in memory.
+    A file is read when it is first acquired and its data is freed
+    when the last reference to it is released.
+
+    FileWvIn::openShared() and FileLoop::openShared() acquire a file
+    by name and play the cached data without copying it.  An
+    instrument can also acquire its waves when it is constructed and
+    pass them to openShared() later, which then neither reads a file
+    nor allocates memory.
+
+    A file is cached separately for each combination of the raw,
+    normalize and integer scaling flags it is read with.  The data of
+    a file of N frames holds N + 1 frames, the last a copy of the
+    first, so that the same data can be looped or played once.  The
+    cached data is read-only.
+
+    In a realtime build the cache is guarded by a mutex, so objects
+    on different threads can share it.  The mutex is not held while a
+    file is read.
+*/
+/***************************************************/
+
+#include "WaveCache.h"
+#include "FileRead.h"
+#include <cmath>
+#include <map>
+
+#if defined(__STK_REALTIME__)
+#include "Mutex.h"
+#endif
+
+namespace stk {
+
+typedef std::map<std::string, WaveCache::Wave *> WaveMap;
+
+// The map and its mutex are created on first use and never destroyed,
+// so that objects destroyed at program exit can still release waves.
+static WaveMap& waveMap( void )
+{
+  static WaveMap *waves = new WaveMap;
+  return *waves;
+}
+
+// Holds the cache mutex for its lifetime in a realtime build.
+class WaveLock
+{
+ public:
+#if defined(__STK_REALTIME__)
+  WaveLock( void ) { mutex().lock(); };
+  ~WaveLock( void ) { mutex().unlock(); };
+
+ private:
+  static Mutex& mutex( void )
+  {
+    static Mutex *mutex = new Mutex;
+    return *mutex;
+  };
+#else
+  WaveLock( void ) {};
+  ~WaveLock( void ) {};
+#endif
+};
+
+const WaveCache::Wave *WaveCache :: acquire( std::string fileName, bool raw, bool doNormalize,
+                                             bool doInt2FloatScaling )
+{
+  std::string key( 1, (char) ( '0' + raw + 2 * doNormalize + 4 * doInt2FloatScaling ) );
+  key += fileName;
+
+  {
+    WaveLock lock;
+    WaveMap::iterator it = waveMap().find( key );
+    if ( it != waveMap().end() ) {
+      it->second->references_++;
+      return it->second;
+    }
+  }
+
+  // Attempt to read the file ... an error might be thrown here.
+  FileRead file( fileName, raw );
+  Wave *wave = new Wave;
+  try {
+    wave->data_.resize( file.fileSize() + 1, file.channels() );
+    file.read( wave->data_, 0, doInt2FloatScaling );
+  }
+  catch ( StkError & ) {
+    delete wave;
+    throw;
+  }
+
+  // Copy the first sample frame to the last, for looping.
+  StkFrames& data = wave->data_;
+  for ( unsigned int i=0; i<data.channels(); i++ )
+    data( data.frames() - 1, i ) = data[i];
+
+  // Normalize as FileWvIn::normalize() does.
+  if ( doNormalize ) {
+    size_t i;
+    StkFloat max = 0.0;
+    for ( i=0; i<data.size(); i++ ) {
+      if ( fabs( data[i] ) > max )
+        max = (StkFloat) fabs((double) data[i]);
+    }
+
+    if ( max > 0.0 ) {
+      max = 1.0 / max;
+      for ( i=0; i<data.size(); i++ )
+        data[i] *= max;
+    }
+  }
+
+  wave->fileSize_ = file.fileSize();
+  wave->references_ = 1;
+  wave->key_ = key;
+
+  // Another thread may have cached the same file meanwhile.
+  WaveLock lock;
+  std::pair<WaveMap::iterator, bool> result = waveMap().insert( WaveMap::value_type( key, wave ) );
+  if ( !result.second ) {
+    delete wave;
+    wave = result.first->second;
+    wave->references_++;
+  }
+  return wave;
+}
+
+void WaveCache :: retain( const Wave *wave )
+{
+  if ( !wave ) return;
+
+  WaveLock lock;
+  wave->references_++;
+}
+
+void WaveCache :: release( const Wave *wave )
+{
+  if ( !wave ) return;
+
+  WaveLock lock;
+  if ( --wave->references_ > 0 ) return;
+
+  waveMap().erase( wave->key_ );
+  delete wave;
+}
+
+unsigned int WaveCache :: size( void )
+{
+  WaveLock lock;
+  return (unsigned int) waveMap().size();
+}
+
+} // stk namespace
@@ -0,0 +1,319 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <algorithm>
+
+#include "MySynth.h"
+#include "telemetry.h"
+
+#define LOAD_BINS	101		// 1% of the period each, the last is >= 100%
+#define FADE_ROW	effect_max	// periods that ran two effects
+
+struct load_stats {
+	unsigned long hist[LOAD_BINS];
+	unsigned long periods;
+	unsigned int worst_ns;
+};
+
+struct telemetry_report {
+	FILE *fp;			// file or stdout target
+	int sock;			// unix socket target
+	struct sockaddr_un addr;
+
+	unsigned long long period_ns;
+	unsigned int rate;
+	unsigned long long start_ns;
+
+	// since start
+	struct load_stats effect[effect_max + 1];
+
+	// this interval
+	struct load_stats interval;
+	int capture_min, capture_max;
+	int playback_min, playback_max;
+	long latency_sum;
+	int latency_min, latency_max;
+	unsigned long latency_count;
+	unsigned long long last_ns;
+	unsigned long long max_gap_ns;	// longest time between two periods
+	unsigned int xruns;
+};
+
+static unsigned int load_bin(struct telemetry_report *r, unsigned int dsp_ns)
+{
+	unsigned long long bin = dsp_ns * 100ULL / r->period_ns;
+
+	return bin < LOAD_BINS - 1 ? bin : LOAD_BINS - 1;
+}
+
+static void load_add(struct load_stats *s, unsigned int bin, unsigned int dsp_ns)
+{
+	s->hist[bin]++;
+	s->periods++;
+	if (dsp_ns > s->worst_ns)
+		s->worst_ns = dsp_ns;
+}
+
+static double load_percent(struct telemetry_report *r, unsigned int ns)
+{
+	return ns * 100.0 / r->period_ns;
+}
+
+/* Load percentage below which fraction of the periods fall, the upper
+ * edge of the histogram bin it lands in but never above the worst case.
+ */
+static double load_percentile(struct telemetry_report *r,
+			      const struct load_stats *s, double fraction)
+{
+	unsigned long need = (unsigned long)(s->periods * fraction + 0.5);
+	unsigned long seen = 0;
+	unsigned int bin;
+
+	for (bin = 0; bin < LOAD_BINS - 1; bin++) {
+		seen += s->hist[bin];
+		if (seen >= need)
+			break;
+	}
+	return std::min((double)(bin + 1), load_percent(r, s->worst_ns));
+}
+
+static void interval_reset(struct telemetry_report *r)
+{
+	memset(&r->interval, 0, sizeof(r->interval));
+	r->capture_min = r->playback_min = r->latency_min = -1;
+	r->capture_max = r->playback_max = r->latency_max = -1;
+	r->latency_sum = 0;
+	r->latency_count = 0;
+	r->max_gap_ns = 0;
+}
+
+static void range_add(int *min, int *max, int value)
+{
+	if (value < 0)
+		return;
+	if (*min < 0 || value < *min)
+		*min = value;
+	if (value > *max)
+		*max = value;
+}
+
+static void consume(struct telemetry_report *r, const struct telemetry_sample *s)
+{
+	unsigned int bin = load_bin(r, s->dsp_ns);
+	int row = s->fading ? FADE_ROW : s->effect;
+
+	load_add(&r->effect[row], bin, s->dsp_ns);
+	load_add(&r->interval, bin, s->dsp_ns);
+
+	range_add(&r->capture_min, &r->capture_max, s->capture_queue);
+	range_add(&r->playback_min, &r->playback_max, s->playback_queue);
+	if (s->capture_queue >= 0 && s->playback_queue >= 0) {
+		int latency = s->capture_queue + s->playback_queue;
+
+		range_add(&r->latency_min, &r->latency_max, latency);
+		r->latency_sum += latency;
+		r->latency_count++;
+	}
+	if (r->last_ns && s->time_ns - r->last_ns > r->max_gap_ns)
+		r->max_gap_ns = s->time_ns - r->last_ns;
+	r->last_ns = s->time_ns;
+	r->xruns = s->xruns;
+}
+
+static void write_report(struct telemetry *t, struct telemetry_report *r)
+{
+	char text[4096];
+	int len = 0;
+	unsigned long long now = telemetry_clock();
+	long latency;
+	int i;
+
+#define OUT(...) \
+	do { \
+		if (len < (int)sizeof(text)) \
+			len += snprintf(text + len, sizeof(text) - len, __VA_ARGS__); \
+	} while (0)
+
+	OUT("telemetry t=%.1fs periods=%lu dropped=%u xruns=%u\n",
+	    (now - r->start_ns) / 1e9, r->interval.periods,
+	    t->dropped.load(std::memory_order_relaxed), r->xruns);
+
+	if (r->interval.periods) {
+		OUT("  load: p99 %.1f%% worst %.1f%% of %.2f ms\n",
+		    load_percentile(r, &r->interval, 0.99),
+		    load_percent(r, r->interval.worst_ns), r->period_ns / 1e6);
+		OUT("  queue: capture %d..%d playback %d..%d frames\n",
+		    r->capture_min, r->capture_max, r->playback_min, r->playback_max);
+		OUT("  longest gap between periods: %.2f ms\n", r->max_gap_ns / 1e6);
+	}
+	if (r->latency_count) {
+		latency = r->latency_sum / (long)r->latency_count;
+		OUT("  latency: %ld frames %.1f ms (%d..%d)\n", latency,
+		    latency * 1000.0 / r->rate, r->latency_min, r->latency_max);
+	}
+
+	OUT("  %-20s %8s %6s %6s %6s\n", "effect", "periods", "p50", "p99", "worst");
+	for (i = 0; i <= effect_max; i++) {
+		struct load_stats *s = &r->effect[i];
+		int bin;
+
+		if (!s->periods)
+			continue;
+		OUT("  %-20s %8lu %5.1f%% %5.1f%% %5.1f%%\n",
+		    i == FADE_ROW ? "(crossfade)" : effect_str[i], s->periods,
+		    load_percentile(r, s, 0.50), load_percentile(r, s, 0.99),
+		    load_percent(r, s->worst_ns));
+
+		// histogram as "load%:periods" for the non-empty bins
+		OUT("    hist");
+		for (bin = 0; bin < LOAD_BINS; bin++)
+			if (s->hist[bin])
+				OUT(" %d%s:%lu", bin, bin == LOAD_BINS - 1 ? "+" : "", s->hist[bin]);
+		OUT("\n");
+	}
+#undef OUT
+
+	if (len >= (int)sizeof(text))
+		len = sizeof(text) - 1;
+
+	if (r->fp) {
+		fwrite(text, 1, len, r->fp);
+		fflush(r->fp);
+	} else {
+		// nobody listening is fine, the report is simply lost
+		sendto(r->sock, text, len, MSG_DONTWAIT,
+		       (struct sockaddr *)&r->addr, sizeof(r->addr));
+	}
+}
+
+static void *reporter(void *args)
+{
+	struct telemetry *t = (struct telemetry *)args;
+	struct telemetry_report *r = t->report;
+	struct telemetry_sample s;
+	struct timespec interval;
+
+	interval.tv_sec = t->interval_ms / 1000;
+	interval.tv_nsec = (t->interval_ms % 1000) * 1000000L;
+
+	while (1) {
+		while (nanosleep(&interval, &interval) == -1 && errno == EINTR)
+			;
+		interval.tv_sec = t->interval_ms / 1000;
+		interval.tv_nsec = (t->interval_ms % 1000) * 1000000L;
+
+		interval_reset(r);
+		while (t->samples.pop(s))
+			consume(r, &s);
+		write_report(t, r);
+	}
+
+	return NULL;
+}
+
+int telemetry_init(struct telemetry *t, const char *target, unsigned int interval_ms)
+{
+	t->dropped.store(0, std::memory_order_relaxed);
+	t->xruns = 0;
+	t->target = target;
+	t->interval_ms = interval_ms ? interval_ms : 1000;
+	t->report = NULL;
+	return 0;
+}
+
+int telemetry_start(struct telemetry *t, struct audio_stream *stream)
+{
+	struct telemetry_report *r;
+	struct sched_param param;
+	pthread_attr_t attr;
+	pthread_t thread;
+	int err;
+
+	r = (struct telemetry_report *)calloc(1, sizeof(*r));
+	if (!r) {
+		perror("calloc():");
+		return -1;
+	}
+
+	if (!strncmp(t->target, "unix:", 5)) {
+		r->sock = socket(AF_UNIX, SOCK_DGRAM, 0);
+		if (r->sock < 0) {
+			perror("socket():");
+			free(r);
+			return -1;
+		}
+		r->addr.sun_family = AF_UNIX;
+		strncpy(r->addr.sun_path, t->target + 5, sizeof(r->addr.sun_path) - 1);
+	} else if (!strcmp(t->target, "-")) {
+		r->fp = stdout;
+	} else {
+		r->fp = fopen(t->target, "a");
+		if (!r->fp) {
+			fprintf(stderr, "cannot open telemetry file %s (%s)\n",
+				t->target, strerror(errno));
+			free(r);
+			return -1;
+		}
+	}
+
+	r->rate = stream->sample_rate;
+	r->period_ns = stream->frame_size * 1000000000ULL / stream->sample_rate;
+	r->start_ns = telemetry_clock();
+	t->report = r;
+
+	// the reporter only runs when nothing else wants the CPU
+	pthread_attr_init(&attr);
+	pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setschedpolicy(&attr, SCHED_IDLE);
+	param.sched_priority = 0;
+	pthread_attr_setschedparam(&attr, &param);
+
+	err = pthread_create(&thread, &attr, reporter, t);
+	if (err) {
+		// SCHED_IDLE refused, run it as a normal thread
+		err = pthread_create(&thread, NULL, reporter, t);
+	}
+	pthread_attr_destroy(&attr);
+	if (err) {
+		fprintf(stderr, "pthread_create(): %s\n", strerror(err));
+		return -1;
+	}
+	pthread_detach(thread);
+
+	return 0;
+}
+
+void telemetry_period(struct audio_stream *stream, unsigned int dsp_ns)
+{
+	struct telemetry *t = stream->telemetry;
+	struct telemetry_sample s;
+	snd_pcm_sframes_t avail, delay;
+
+	s.dsp_ns = dsp_ns;
+	s.effect = stream->current_effect;
+	s.fading = effect_switching(stream);
+
+	if (snd_pcm_avail_delay(capture_handle, &avail, &delay) < 0)
+		s.capture_queue = -1;
+	else
+		s.capture_queue = delay;
+
+	if (snd_pcm_avail_delay(playback_handle, &avail, &delay) < 0)
+		s.playback_queue = -1;
+	else
+		s.playback_queue = delay;
+
+	s.xruns = t->xruns;
+	s.time_ns = telemetry_clock();
+
+	// the audio thread is the only writer of dropped
+	if (!t->samples.push(s))
+		t->dropped.store(t->dropped.load(std::memory_order_relaxed) + 1,
+				 std::memory_order_relaxed);
+}
@@ -0,0 +1,69 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <time.h>
+#include <atomic>
+
+#include "spsc_ring.h"
+
+struct audio_stream;
+
+/* Per-period instrumentation of the audio loop.
+ *
+ * The audio thread times applyEffect() and, once per period, reads the
+ * capture and playback queue depths and pushes one telemetry_sample into
+ * a ring.  That is all it does: a full ring drops the sample and bumps a
+ * counter.  A reporter thread at SCHED_IDLE drains the ring, keeps the
+ * per-effect DSP load histograms and writes a report every interval to a
+ * file, stdout ("-") or a Unix datagram socket ("unix:/path").
+ *
+ * Round-trip latency is taken as capture delay plus playback delay at the
+ * end of the period: the oldest sample of the period just written was
+ * captured capture_queue + frame_size frames ago and plays in
+ * playback_queue - frame_size frames.
+ */
+
+struct telemetry_sample {
+	unsigned long long time_ns;	// CLOCK_MONOTONIC at the end of the period
+	unsigned int dsp_ns;		// applyEffect() time in the period
+	short effect;			// current_effect while processing
+	short fading;			// a crossfade ran both effects
+	int capture_queue;		// frames captured and not yet read, -1 unknown
+	int playback_queue;		// frames queued for playback, -1 unknown
+	unsigned int xruns;		// running total
+};
+
+struct telemetry_report;
+
+struct telemetry {
+	spsc_ring<struct telemetry_sample, 1024> samples;	// audio -> reporter
+	std::atomic<unsigned int> dropped;	// written by the audio thread
+	unsigned int xruns;			// audio thread only
+
+	const char *target;
+	unsigned int interval_ms;
+	struct telemetry_report *report;	// reporter thread only
+};
+
+int telemetry_init(struct telemetry *t, const char *target, unsigned int interval_ms);
+// after open_and_init(), the reporter needs the period length
+int telemetry_start(struct telemetry *t, struct audio_stream *stream);
+
+// audio thread
+void telemetry_period(struct audio_stream *stream, unsigned int dsp_ns);
+
+static inline void telemetry_xrun(struct telemetry *t)
+{
+	if (t)
+		t->xruns++;
+}
+
+static inline unsigned long long telemetry_clock(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#endif